@@ -4,5 +4,6 @@
 #include "stm32f4xx_hal.h"
 
 void System_NVIC_SetVectorTable(uint32_t baseAddress, uint32_t offset);
+uint32_t System_GetHeapHighWater(void);
 
 #endif // !__SYSTEM_H__
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "stm32f4xx_hal.h"
 
+#include "system.h"
 #include "bsp_clock.h"
 #include "bsp_systick.h"
 
@@ -8,32 +9,151 @@
 #include "bsp_timer.h"
 
 #include "w5500/w5500_tcp.h"
+#include "w5500/w5500_event.h"
+#include "w5500/w5500_tcp_server.h"
+#include "w5500/w5500_dhcp.h"
+#include "w5500/w5500_bench.h"
+
+#include "metrics/metrics.h"
+#include "binlog/binlog.h"
+
+#define NETWORK_BENCHMARK   0                                                   // 1: 运行吞吐量测试，配合Tools/w5500_bench/w5500_bench.py使用
+
+uint16_t Echo_Receive(uint8_t socket_index, const W5500_RxView_t *view);
+void Network_Event(W5500_DHCPEvent_t event);
+bool Log_Output(const uint8_t *data, uint16_t length);
+
+const W5500_TCPServerHandler_t g_echo_handler = 
+{
+    .on_connect = NULL,
+    .on_receive = Echo_Receive,
+    .on_disconnect = NULL
+};
+
+// 主循环一圈的耗时，单位us
+static const uint32_t g_loop_time_bounds[] = {10, 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000};
+static Metrics_Histogram_t g_loop_time = {g_loop_time_bounds, sizeof(g_loop_time_bounds) / sizeof(g_loop_time_bounds[0])};
+
+static const Metrics_Entry_t g_loop_time_metric =
+{
+    .name = "main_loop_microseconds",
+    .help = "Time of one pass of the main loop",
+    .type = METRICS_TYPE_HISTOGRAM,
+    .histogram = &g_loop_time
+};
+
+static const Metrics_Entry_t g_heap_metric =
+{
+    .name = "heap_high_water_bytes",
+    .help = "Highest heap break since reset",
+    .type = METRICS_TYPE_GAUGE,
+    .read = System_GetHeapHighWater
+};
 
 int main(void)
 {
+    uint32_t loop_start = 0;
+
     HAL_Init();
     System_Clock_Init(8, 336, 2, 7);
     Delay_Init();
     HAL_NVIC_SetPriorityGrouping(NVIC_PRIORITYGROUP_4);
   
     BSP_UART_Init(&g_usart1_handle, USART1, 115200);
+    BinLog_Init(Log_Output);                                                    // 二进制日志和printf()共用USART1，用Tools/binlog/binlog_decode.py查看
     BSP_SPI_Init(&g_spi1_handle, SPI1, SPI_POLARITY_LOW, SPI_PHASE_1EDGE, SPI_BAUDRATEPRESCALER_4, SPI_FIRSTBIT_MSB);
     BSP_Timer_Base_Init(&g_timer6_handle, TIM6, 8399, 9999);
 
     W5500_Init(&g_spi1_handle);
     wizchip_init(NULL, NULL);                                                   // 缓冲区默认
+#if !NETWORK_BENCHMARK
+    W5500_Buffer_ApplyProfile(&g_w5500_buffer_profile_server);                  // socket 0给DHCP，其余7个socket给回显服务器，吞吐量测试自己切换方案
+#endif
 
     __HAL_TIM_CLEAR_IT(&g_timer6_handle, TIM_IT_UPDATE); 
     HAL_TIM_Base_Start_IT(&g_timer6_handle);
 
-    DHCP_TryToGetIp(0);
-  
-    PrintInfo();                                                                // 打印网络信息
+    W5500_Event_Init();                                                         // 使用INT引脚获取socket事件
+    W5500_DHCP_Start(0, Network_Event);                                         // socket 0给DHCP用，不会阻塞
+#if NETWORK_BENCHMARK
+    W5500_Bench_Start();                                                        // socket 1传输数据，socket 7接收命令
+#else
+    W5500_TCPServer_Listen(8080, 1, W5500_SOCKET_COUNT - 1, &g_echo_handler);   // 其余7个socket同时监听8080端口
+#endif
+
+    Metrics_Register(&g_loop_time_metric);
+    Metrics_Register(&g_heap_metric);
   
     while (1)
     {
-        W5500_TCP_Server(0, 8080);
+        loop_start = SysTick_GetMicros();
+
+        W5500_Event_Process();
+        W5500_DHCP_Process();
+#if NETWORK_BENCHMARK
+        W5500_Bench_Process();
+#else
+        W5500_TCPServer_Process();
+        W5500_Coalesce_Process();
+#endif
+        BinLog_Process();
+
+        Metrics_Observe(&g_loop_time, SysTick_GetMicros() - loop_start);
     }
   
     return 0;
+}
+
+/**
+ * @brief 回显服务器的接收处理函数
+ * 
+ * @param socket_index socket索引
+ * @param view 接收到的数据
+ * @return uint16_t 消费的字节数，发送缓冲区满时没有发出去的数据留到下一次
+ */
+uint16_t Echo_Receive(uint8_t socket_index, const W5500_RxView_t *view)
+{
+    uint16_t consumed = 0;
+
+    for (uint8_t i = 0; i < 2 && view->length[i] > 0; i++)
+    {
+        if (W5500_TCPServer_Send(socket_index, view->data[i], view->length[i]) != view->length[i])
+        {
+            break;
+        }
+        consumed += view->length[i];
+    }
+
+    return consumed;
+}
+
+/**
+ * @brief 网络地址变化的回调函数
+ * 
+ * @param event 事件
+ */
+void Network_Event(W5500_DHCPEvent_t event)
+{
+    if (event != W5500_DHCP_EVENT_CONFLICT)
+    {
+        PrintInfo();                                                            // 打印网络信息
+    }
+}
+
+/**
+ * @brief 二进制日志的输出函数
+ * 
+ * @param data 一条完整的记录
+ * @param length 记录的长度
+ * @return true 已经放进串口发送队列
+ * @return false 发送队列放不下，记录不能被截断，下次再发
+ */
+bool Log_Output(const uint8_t *data, uint16_t length)
+{
+    if (BSP_UART_TxSpace(&g_usart1_handle) < length)
+    {
+        return false;
+    }
+    BSP_UART_Write(&g_usart1_handle, data, length);
+    return true;
 }
\ No newline at end of file
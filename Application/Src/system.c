@@ -1,5 +1,9 @@
 #include "system.h"
 
+#include <unistd.h>
+
+extern char end;                                                                // 链接脚本中堆的起始地址
+
 /**
  * @brief 设置中断向量表偏移地址
  * 
@@ -10,4 +14,16 @@ void System_NVIC_SetVectorTable(uint32_t baseAddress, uint32_t offset)
 {
     // 设置NVIC的向量表偏移寄存器，VTOR低9位保留，即[8:0]保留
     SCB->VTOR = baseAddress | (offset & (uint32_t)0xFFFFFE00);
+}
+
+/**
+ * @brief 获取堆使用的最高水位
+ * 
+ * @return uint32_t 从堆的起始地址到当前堆顶的字节数
+ * 
+ * @note malloc()通过sbrk()向上扩展堆，释放的内存留在堆里不还回去，所以堆顶就是最高水位
+ */
+uint32_t System_GetHeapHighWater(void)
+{
+    return (uint32_t)((char *)sbrk(0) - &end);
 }
\ No newline at end of file
@@ -38,7 +38,7 @@ bool ESP32_SendAtCmd(char *cmd, char *ack, uint32_t timeOut)
     {
         while (timeOut > 0)
         {
-            if (pg_uart_esp32_frameData->finsh)                                 // 判断是否接收完成
+            if (BSP_UART_ReceiveFrame(pg_uart_esp32_frameData))                 // 判断是否接收完成
             {
                 if (strstr((char *)pg_uart_esp32_frameData->data, ack) != NULL) // 获取数据帧中是否包含期待的应答结果
                 {
@@ -86,8 +86,10 @@ void ESP32_EchoConfig(uint8_t echo)
  */
 void ESP32_ExitUnvarnished(void)
 {
+    BSP_UART_Flush(pg_uart_esp32_handler, 100);                                 // "+++"前后都要求线路静默，先等发送队列里的数据发完
     HAL_Delay(20);
     BSP_UART_Printf(pg_uart_esp32_handler, "+++");
+    BSP_UART_Flush(pg_uart_esp32_handler, 100);
     HAL_Delay(20);
 
     printf("退出透传模式成功\r\n");
@@ -59,7 +59,7 @@ void ESP32_BLE_Init(void)
 ESP32_BLE_Status_t ESP32_BLE_HandlerConnectChange(void)
 {
     // 如果还没有接收完，直接结束方法
-    if (!pg_uart_esp32_frameData->finsh)
+    if (!BSP_UART_ReceiveFrame(pg_uart_esp32_frameData))
     {
         return BLE_ERROR;
     }
@@ -116,7 +116,7 @@ void ESP32_BLE_ReadData(char *data, uint16_t *length)
     *length = 0;
 
     // 如果还没有接收完，直接结束方法
-    if (!pg_uart_esp32_frameData->finsh)
+    if (!BSP_UART_ReceiveFrame(pg_uart_esp32_frameData))
     {
         return;
     }
@@ -143,5 +143,5 @@ void ESP32_BLE_SendData(char *data, uint16_t length)
         return;
     }
     
-    HAL_UART_Transmit(pg_uart_esp32_handler, (uint8_t *)data, length, 100);
+    BSP_UART_Write(pg_uart_esp32_handler, (uint8_t *)data, length);
 }
\ No newline at end of file
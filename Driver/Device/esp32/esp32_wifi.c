@@ -174,7 +174,7 @@ void ESP32_WiFi_StartTcpServer(uint16_t port)
  */
 void ESP32_WiFi_ReadTcpData(uint16_t *id, char ip[], uint16_t *port, char *data, uint16_t *length)
 {
-    if (pg_uart_esp32_frameData->finsh)
+    if (BSP_UART_ReceiveFrame(pg_uart_esp32_frameData))
     {
         if (strstr((const char *)pg_uart_esp32_frameData->data, "+IPD"))        // 收到TCP传输的数据
         {
@@ -245,8 +245,8 @@ bool ESP32_WiFi_MQTT_KeepAlive(void)
 
     for (i = 0; i < 5; i++)
     {
-        HAL_UART_Transmit(pg_uart_esp32_handler, message, 2, 0xFFFF);
-        if (pg_uart_esp32_frameData->finsh == 1)
+        BSP_UART_Write(pg_uart_esp32_handler, message, 2);
+        if (BSP_UART_ReceiveFrame(pg_uart_esp32_frameData))
         {
             if (pg_uart_esp32_frameData->data[0] == 0xD0 && pg_uart_esp32_frameData->data[1] == 0x00)
             {
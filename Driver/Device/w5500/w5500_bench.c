@@ -0,0 +1,636 @@
+#include "w5500_bench.h"
+
+static W5500_BenchTest_t g_w5500_bench_test;
+static W5500_BenchResult_t g_w5500_bench_result;
+
+static uint32_t g_w5500_bench_target;                                           // 要收发的字节数
+static uint16_t g_w5500_bench_chunk;                                            // 每次send()的长度或者UDP数据报的长度
+static uint8_t g_w5500_bench_udp_ip[4];
+static uint16_t g_w5500_bench_udp_port;
+static uint32_t g_w5500_bench_sequence;                                         // UDP数据报序号，写在数据报的前4个字节，主机用来统计丢包
+
+static uint8_t g_w5500_bench_started;                                           // 第一个数据已经收发，开始计时
+static uint32_t g_w5500_bench_start_us;
+static uint32_t g_w5500_bench_last_us;                                          // 最后一次成功收发的时间
+static uint32_t g_w5500_bench_spi_start;
+static uint32_t g_w5500_bench_tick;                                             // 等待连接和UDP空闲超时用的毫秒计时
+
+static const W5500_BufferProfile_t *g_w5500_bench_profile;                      // 等待切换的缓冲区方案
+
+static char g_w5500_bench_line[W5500_BENCH_LINE_SIZE];
+static uint8_t g_w5500_bench_line_length;
+
+static const W5500_BufferProfile_t *const g_w5500_bench_profiles[] = 
+{
+    &g_w5500_buffer_profile_default, &g_w5500_buffer_profile_bulk, &g_w5500_buffer_profile_server
+};
+
+// 下标i对应2^(i+1)分频
+static const uint32_t g_w5500_bench_prescalers[] = 
+{
+    SPI_BAUDRATEPRESCALER_2, SPI_BAUDRATEPRESCALER_4, SPI_BAUDRATEPRESCALER_8, SPI_BAUDRATEPRESCALER_16,
+    SPI_BAUDRATEPRESCALER_32, SPI_BAUDRATEPRESCALER_64, SPI_BAUDRATEPRESCALER_128, SPI_BAUDRATEPRESCALER_256
+};
+
+/**
+ * @brief 在控制连接上发送一行应答
+ * 
+ * @param fmt 格式化字符串，不包含换行
+ * @param ... 参数
+ */
+static void W5500_Bench_Reply(const char *fmt, ...)
+{
+    char buffer[192];
+    va_list args;
+    int length = 0;
+    uint32_t start = HAL_GetTick();
+
+    va_start(args, fmt);
+    length = vsnprintf(buffer, sizeof(buffer) - 1, fmt, args);
+    va_end(args);
+
+    if (length < 0)
+    {
+        return;
+    }
+    if (length > (int)sizeof(buffer) - 2)
+    {
+        length = sizeof(buffer) - 2;
+    }
+    buffer[length++] = '\n';
+
+    // 应答很短，只有上一次应答还没有发送完成时才会忙
+    while (send(W5500_BENCH_CONTROL_SOCKET, (uint8_t *)buffer, (uint16_t)length) == SOCK_BUSY && HAL_GetTick() - start < 100);
+}
+
+/**
+ * @brief 清空测试结果，开始等待数据
+ * 
+ * @param test 测试项目
+ */
+static void W5500_Bench_Begin(W5500_BenchTest_t test)
+{
+    memset(&g_w5500_bench_result, 0, sizeof(g_w5500_bench_result));
+    g_w5500_bench_result.min_us = 0xFFFFFFFF;
+    g_w5500_bench_started = 0;
+    g_w5500_bench_sequence = 0;
+    g_w5500_bench_tick = HAL_GetTick();
+    g_w5500_bench_test = test;
+
+    W5500_Bench_Reply("READY");
+}
+
+static void W5500_Bench_MarkStart(void)
+{
+    g_w5500_bench_started = 1;
+    g_w5500_bench_start_us = SysTick_GetMicros();
+    g_w5500_bench_last_us = g_w5500_bench_start_us;
+    g_w5500_bench_spi_start = g_w5500_spi_byte_count;
+}
+
+/**
+ * @brief 记录一次收发调用的结果
+ * 
+ * @param start_us 调用开始的时间
+ * @param result send()/recv()等函数的返回值
+ */
+static void W5500_Bench_Record(uint32_t start_us, int32_t result)
+{
+    W5500_BenchResult_t *bench = &g_w5500_bench_result;
+    uint32_t now = SysTick_GetMicros();
+    uint32_t duration = now - start_us;
+
+    if (result == SOCK_BUSY)
+    {
+        bench->busy++;
+        return;
+    }
+    if (result <= 0)
+    {
+        return;
+    }
+
+    bench->bytes += (uint32_t)result;
+    bench->sends++;
+    bench->total_us += duration;
+    if (duration < bench->min_us)
+    {
+        bench->min_us = duration;
+    }
+    if (duration > bench->max_us)
+    {
+        bench->max_us = duration;
+    }
+
+    g_w5500_bench_last_us = now;
+    g_w5500_bench_tick = HAL_GetTick();
+}
+
+/**
+ * @brief 测试结束，发送结果并关闭数据socket
+ * 
+ * @param name 测试项目名称
+ */
+static void W5500_Bench_Finish(const char *name)
+{
+    W5500_BenchResult_t *bench = &g_w5500_bench_result;
+
+    if (!g_w5500_bench_started)
+    {
+        W5500_Bench_MarkStart();
+    }
+    if (bench->sends == 0)
+    {
+        bench->min_us = 0;
+    }
+    bench->elapsed_us = g_w5500_bench_last_us - g_w5500_bench_start_us;
+    bench->spi_bytes = g_w5500_spi_byte_count - g_w5500_bench_spi_start;
+
+    W5500_Bench_Reply("DONE test=%s bytes=%lu us=%lu spi=%lu sends=%lu busy=%lu min=%lu avg=%lu max=%lu clock=%lu profile=%s",
+                      name, (unsigned long)bench->bytes, (unsigned long)bench->elapsed_us, (unsigned long)bench->spi_bytes,
+                      (unsigned long)bench->sends, (unsigned long)bench->busy, (unsigned long)bench->min_us,
+                      (unsigned long)(bench->sends ? bench->total_us / bench->sends : 0), (unsigned long)bench->max_us,
+                      (unsigned long)W5500_SPI_GetClock(), g_w5500_buffer_profile->name);
+
+    // TCP用disconnect()，没有发完的数据发完之后才发送FIN
+    if ((getSn_MR(W5500_BENCH_DATA_SOCKET) & 0x0F) == Sn_MR_TCP)
+    {
+        disconnect(W5500_BENCH_DATA_SOCKET);
+    }
+    else
+    {
+        close(W5500_BENCH_DATA_SOCKET);
+    }
+    g_w5500_bench_test = W5500_BENCH_IDLE;
+}
+
+static void W5500_Bench_Abort(void)
+{
+    close(W5500_BENCH_DATA_SOCKET);
+    g_w5500_bench_test = W5500_BENCH_IDLE;
+}
+
+/**
+ * @brief 打开数据socket
+ * 
+ * @param protocol Sn_MR_TCP或Sn_MR_UDP
+ * @return uint8_t 1: 成功; 0: 失败
+ */
+static uint8_t W5500_Bench_OpenData(uint8_t protocol)
+{
+    uint8_t flag = SF_IO_NONBLOCK | (protocol == Sn_MR_TCP ? SF_TCP_NODELAY : 0);
+
+    if (socket(W5500_BENCH_DATA_SOCKET, protocol, W5500_BENCH_DATA_PORT, flag) != W5500_BENCH_DATA_SOCKET)
+    {
+        W5500_Bench_Reply("ERR socket");
+        return 0;
+    }
+    if (protocol == Sn_MR_TCP && listen(W5500_BENCH_DATA_SOCKET) != SOCK_OK)
+    {
+        close(W5500_BENCH_DATA_SOCKET);
+        W5500_Bench_Reply("ERR listen");
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief 限制每次发送的长度，不能超过数据socket的发送缓冲区和g_w5500_data_buff
+ * 
+ * @param length 主机要求的长度
+ * @param limit 协议限制的最大长度
+ * @return uint16_t 实际使用的长度
+ */
+static uint16_t W5500_Bench_Chunk(unsigned long length, uint16_t limit)
+{
+    uint16_t max = getSn_TxMAX(W5500_BENCH_DATA_SOCKET);
+
+    if (max > DATA_BUFFER_SIZE)
+    {
+        max = DATA_BUFFER_SIZE;
+    }
+    if (max > limit)
+    {
+        max = limit;
+    }
+    if (length == 0 || length > max)
+    {
+        return max;
+    }
+    return length < 4 ? 4 : (uint16_t)length;
+}
+
+/**
+ * @brief 处理一条控制命令
+ * 
+ * @param line 命令，不包含换行
+ */
+static void W5500_Bench_Command(char *line)
+{
+    unsigned long a = 0;
+    unsigned long b = 0;
+    unsigned long c = 0;
+    char name[16] = {0};
+
+    if (strncmp(line, "STATS", 5) == 0)
+    {
+        W5500_Bench_Reply("STATS profile=%s clock=%lu spi=%lu stall=%lu", g_w5500_buffer_profile->name,
+                          (unsigned long)W5500_SPI_GetClock(), (unsigned long)g_w5500_spi_byte_count,
+                          (unsigned long)g_w5500_tx_stall_count[W5500_BENCH_DATA_SOCKET]);
+        return;
+    }
+    if (strncmp(line, "ABORT", 5) == 0)
+    {
+        W5500_Bench_Abort();
+        W5500_Bench_Reply("OK");
+        return;
+    }
+    if (g_w5500_bench_test != W5500_BENCH_IDLE)
+    {
+        W5500_Bench_Reply("ERR busy");
+        return;
+    }
+
+    if (sscanf(line, "TCP_TX %lu %lu", &a, &b) >= 1)
+    {
+        if (W5500_Bench_OpenData(Sn_MR_TCP))
+        {
+            g_w5500_bench_target = a;
+            g_w5500_bench_chunk = W5500_Bench_Chunk(b, 0xFFFF);
+            W5500_Bench_Begin(W5500_BENCH_TCP_TX);
+        }
+    }
+    else if (sscanf(line, "TCP_RX %lu", &a) == 1)
+    {
+        if (W5500_Bench_OpenData(Sn_MR_TCP))
+        {
+            g_w5500_bench_target = a;
+            W5500_Bench_Begin(W5500_BENCH_TCP_RX);
+        }
+    }
+    else if (sscanf(line, "UDP_TX %lu %lu %lu", &a, &b, &c) == 3)
+    {
+        if (W5500_Bench_OpenData(Sn_MR_UDP))
+        {
+            g_w5500_bench_target = a;
+            g_w5500_bench_chunk = W5500_Bench_Chunk(b, 1472);
+            g_w5500_bench_udp_port = (uint16_t)c;
+            getSn_DIPR(W5500_BENCH_CONTROL_SOCKET, g_w5500_bench_udp_ip);      // 发给控制连接的主机
+            W5500_Bench_Begin(W5500_BENCH_UDP_TX);
+        }
+    }
+    else if (sscanf(line, "UDP_RX %lu", &a) == 1)
+    {
+        if (W5500_Bench_OpenData(Sn_MR_UDP))
+        {
+            g_w5500_bench_target = a;
+            W5500_Bench_Begin(W5500_BENCH_UDP_RX);
+        }
+    }
+    else if (sscanf(line, "PRESCALER %lu", &a) == 1)
+    {
+        for (uint8_t i = 0; i < sizeof(g_w5500_bench_prescalers) / sizeof(g_w5500_bench_prescalers[0]); i++)
+        {
+            if (a == (2UL << i))
+            {
+                W5500_SPI_SetPrescaler(g_w5500_bench_prescalers[i]);
+                W5500_Bench_Reply("OK clock=%lu", (unsigned long)W5500_SPI_GetClock());
+                return;
+            }
+        }
+        W5500_Bench_Reply("ERR prescaler");
+    }
+    else if (sscanf(line, "PROFILE %15s", name) == 1)
+    {
+        for (uint8_t i = 0; i < sizeof(g_w5500_bench_profiles) / sizeof(g_w5500_bench_profiles[0]); i++)
+        {
+            if (strcmp(name, g_w5500_bench_profiles[i]->name) == 0)
+            {
+                // 缓冲区地址连续分配，要等所有socket都关闭才能切换，主机收到OK后重新连接
+                W5500_Bench_Reply("OK");
+                g_w5500_bench_profile = g_w5500_bench_profiles[i];
+                g_w5500_bench_test = W5500_BENCH_PROFILE;
+                g_w5500_bench_tick = HAL_GetTick();
+                close(W5500_BENCH_DATA_SOCKET);
+                disconnect(W5500_BENCH_CONTROL_SOCKET);
+                return;
+            }
+        }
+        W5500_Bench_Reply("ERR profile");
+    }
+    else
+    {
+        W5500_Bench_Reply("ERR unknown");
+    }
+}
+
+/**
+ * @brief 处理控制连接，接收命令行
+ * 
+ */
+static void W5500_Bench_Control(void)
+{
+    int32_t length = 0;
+    char *end = NULL;
+
+    switch (getSn_SR(W5500_BENCH_CONTROL_SOCKET))
+    {
+    case SOCK_CLOSED:
+        g_w5500_bench_line_length = 0;
+        if (socket(W5500_BENCH_CONTROL_SOCKET, Sn_MR_TCP, W5500_BENCH_CONTROL_PORT, SF_TCP_NODELAY | SF_IO_NONBLOCK) == W5500_BENCH_CONTROL_SOCKET)
+        {
+            listen(W5500_BENCH_CONTROL_SOCKET);                                 // 还没有IP地址时socket()会失败，下一轮再试
+        }
+        break;
+
+    case SOCK_ESTABLISHED:
+        length = recv(W5500_BENCH_CONTROL_SOCKET, (uint8_t *)&g_w5500_bench_line[g_w5500_bench_line_length],
+                      W5500_BENCH_LINE_SIZE - 1 - g_w5500_bench_line_length);
+        if (length <= 0)
+        {
+            break;
+        }
+        g_w5500_bench_line_length += (uint8_t)length;
+        g_w5500_bench_line[g_w5500_bench_line_length] = '\0';
+
+        while ((end = strchr(g_w5500_bench_line, '\n')) != NULL)
+        {
+            *end = '\0';
+            if (end > g_w5500_bench_line && end[-1] == '\r')
+            {
+                end[-1] = '\0';
+            }
+            W5500_Bench_Command(g_w5500_bench_line);
+            if (g_w5500_bench_test == W5500_BENCH_PROFILE)
+            {
+                g_w5500_bench_line_length = 0;                                  // 控制连接已经断开，剩下的命令丢掉
+                return;
+            }
+
+            g_w5500_bench_line_length -= (uint8_t)(end + 1 - g_w5500_bench_line);
+            memmove(g_w5500_bench_line, end + 1, g_w5500_bench_line_length + 1);
+        }
+
+        if (g_w5500_bench_line_length >= W5500_BENCH_LINE_SIZE - 1)
+        {
+            g_w5500_bench_line_length = 0;
+            W5500_Bench_Reply("ERR line");
+        }
+        break;
+
+    case SOCK_CLOSE_WAIT:
+        // 主机断开控制连接，正在进行的测试也结束
+        if (g_w5500_bench_test != W5500_BENCH_IDLE)
+        {
+            W5500_Bench_Abort();
+        }
+        disconnect(W5500_BENCH_CONTROL_SOCKET);
+        break;
+
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief 等待所有socket关闭后切换缓冲区分配方案
+ * 
+ * @note DHCP的socket也要关闭，IP地址保持不变，但是不会再续租，测试时间应该比租期短
+ */
+static void W5500_Bench_ApplyProfile(void)
+{
+    int8_t result = 0;
+
+    if (getSn_SR(W5500_BENCH_CONTROL_SOCKET) != SOCK_CLOSED && HAL_GetTick() - g_w5500_bench_tick < W5500_BENCH_WAIT_TIMEOUT)
+    {
+        return;                                                                 // 等待FIN握手完成，保证OK应答送达
+    }
+
+    close(W5500_BENCH_CONTROL_SOCKET);
+    W5500_DHCP_Stop();
+
+    result = W5500_Buffer_ApplyProfile(g_w5500_bench_profile);
+    printf("缓冲区分配方案切换为%s: %d\r\n", g_w5500_bench_profile->name, result);
+
+    g_w5500_bench_test = W5500_BENCH_IDLE;
+}
+
+static void W5500_Bench_TcpTx(void)
+{
+    uint32_t start = 0;
+    int32_t result = 0;
+    uint16_t length = 0;
+
+    if (!g_w5500_bench_started)
+    {
+        if (getSn_SR(W5500_BENCH_DATA_SOCKET) != SOCK_ESTABLISHED)
+        {
+            if (HAL_GetTick() - g_w5500_bench_tick > W5500_BENCH_WAIT_TIMEOUT)
+            {
+                W5500_Bench_Abort();
+                W5500_Bench_Reply("ERR timeout");
+            }
+            return;
+        }
+        W5500_Bench_MarkStart();
+    }
+
+    for (uint8_t i = 0; i < W5500_BENCH_BURST && g_w5500_bench_result.bytes < g_w5500_bench_target; i++)
+    {
+        length = g_w5500_bench_chunk;
+        if (g_w5500_bench_target - g_w5500_bench_result.bytes < length)
+        {
+            length = (uint16_t)(g_w5500_bench_target - g_w5500_bench_result.bytes);
+        }
+
+        start = SysTick_GetMicros();
+        result = send(W5500_BENCH_DATA_SOCKET, g_w5500_data_buff, length);
+        W5500_Bench_Record(start, result);
+
+        if (result == SOCK_BUSY)
+        {
+            break;
+        }
+        if (result < 0)
+        {
+            W5500_Bench_Abort();
+            W5500_Bench_Reply("ERR send %ld", (long)result);
+            return;
+        }
+    }
+
+    // 所有数据都被对方确认之后才算结束
+    if (g_w5500_bench_result.bytes >= g_w5500_bench_target && getSn_TX_FSR(W5500_BENCH_DATA_SOCKET) == getSn_TxMAX(W5500_BENCH_DATA_SOCKET))
+    {
+        g_w5500_bench_last_us = SysTick_GetMicros();
+        W5500_Bench_Finish("tcp_tx");
+    }
+}
+
+static void W5500_Bench_TcpRx(void)
+{
+    uint32_t start = 0;
+    int32_t result = 0;
+    uint8_t state = getSn_SR(W5500_BENCH_DATA_SOCKET);
+
+    if (!g_w5500_bench_started)
+    {
+        if (state != SOCK_ESTABLISHED && state != SOCK_CLOSE_WAIT)
+        {
+            if (HAL_GetTick() - g_w5500_bench_tick > W5500_BENCH_WAIT_TIMEOUT)
+            {
+                W5500_Bench_Abort();
+                W5500_Bench_Reply("ERR timeout");
+            }
+            return;
+        }
+        W5500_Bench_MarkStart();
+    }
+
+    for (uint8_t i = 0; i < W5500_BENCH_BURST && g_w5500_bench_result.bytes < g_w5500_bench_target; i++)
+    {
+        start = SysTick_GetMicros();
+        result = recv(W5500_BENCH_DATA_SOCKET, g_w5500_data_buff, DATA_BUFFER_SIZE);
+        W5500_Bench_Record(start, result);
+
+        if (result == SOCK_BUSY)
+        {
+            return;
+        }
+        if (result < 0)
+        {
+            break;                                                              // 主机提前关闭了连接
+        }
+    }
+
+    if (result < 0 || g_w5500_bench_result.bytes >= g_w5500_bench_target)
+    {
+        W5500_Bench_Finish("tcp_rx");
+    }
+}
+
+static void W5500_Bench_UdpTx(void)
+{
+    uint32_t start = 0;
+    int32_t result = 0;
+    uint16_t length = 0;
+
+    if (!g_w5500_bench_started)
+    {
+        W5500_Bench_MarkStart();
+    }
+
+    for (uint8_t i = 0; i < W5500_BENCH_BURST && g_w5500_bench_result.bytes < g_w5500_bench_target; i++)
+    {
+        length = g_w5500_bench_chunk;
+        if (g_w5500_bench_target - g_w5500_bench_result.bytes < length)
+        {
+            length = (uint16_t)(g_w5500_bench_target - g_w5500_bench_result.bytes);
+            length = length < 4 ? 4 : length;
+        }
+
+        g_w5500_data_buff[0] = (uint8_t)(g_w5500_bench_sequence >> 24);
+        g_w5500_data_buff[1] = (uint8_t)(g_w5500_bench_sequence >> 16);
+        g_w5500_data_buff[2] = (uint8_t)(g_w5500_bench_sequence >> 8);
+        g_w5500_data_buff[3] = (uint8_t)g_w5500_bench_sequence;
+
+        start = SysTick_GetMicros();
+        result = sendto(W5500_BENCH_DATA_SOCKET, g_w5500_data_buff, length, g_w5500_bench_udp_ip, g_w5500_bench_udp_port);
+        W5500_Bench_Record(start, result);
+
+        if (result == SOCK_BUSY)
+        {
+            break;
+        }
+        if (result < 0)
+        {
+            W5500_Bench_Abort();
+            W5500_Bench_Reply("ERR sendto %ld", (long)result);
+            return;
+        }
+        g_w5500_bench_sequence++;
+    }
+
+    if (g_w5500_bench_result.bytes >= g_w5500_bench_target)
+    {
+        W5500_Bench_Finish("udp_tx");
+    }
+}
+
+static void W5500_Bench_UdpRx(void)
+{
+    uint32_t start = 0;
+    int32_t result = 0;
+    uint8_t ip[4];
+    uint16_t port = 0;
+
+    for (uint8_t i = 0; i < W5500_BENCH_BURST && g_w5500_bench_result.bytes < g_w5500_bench_target; i++)
+    {
+        start = SysTick_GetMicros();
+        result = recvfrom(W5500_BENCH_DATA_SOCKET, g_w5500_data_buff, DATA_BUFFER_SIZE, ip, &port);
+        if (result > 0 && !g_w5500_bench_started)
+        {
+            W5500_Bench_MarkStart();
+        }
+        W5500_Bench_Record(start, result);
+
+        if (result <= 0)
+        {
+            break;
+        }
+    }
+
+    // 数据报可能丢失，收够了或者主机发送结束一段时间后就结束
+    if (g_w5500_bench_result.bytes >= g_w5500_bench_target ||
+        HAL_GetTick() - g_w5500_bench_tick > (g_w5500_bench_started ? W5500_BENCH_UDP_IDLE_TIMEOUT : W5500_BENCH_WAIT_TIMEOUT))
+    {
+        W5500_Bench_Finish("udp_rx");
+    }
+}
+
+/**
+ * @brief 启动吞吐量测试服务，在DHCP或者设置静态IP之后调用
+ * 
+ * @note 控制和数据socket在W5500_Bench_Process()中打开，和TCP服务器、回显服务器不能同时使用
+ */
+void W5500_Bench_Start(void)
+{
+    g_w5500_bench_test = W5500_BENCH_IDLE;
+    g_w5500_bench_line_length = 0;
+
+    printf("吞吐量测试: 控制端口%d, 数据端口%d, 缓冲区方案%s, SPI时钟%luHz\r\n", W5500_BENCH_CONTROL_PORT, W5500_BENCH_DATA_PORT,
+           g_w5500_buffer_profile->name, (unsigned long)W5500_SPI_GetClock());
+}
+
+/**
+ * @brief 吞吐量测试处理函数，在主循环中调用，不会阻塞
+ * 
+ */
+void W5500_Bench_Process(void)
+{
+    if (g_w5500_bench_test == W5500_BENCH_PROFILE)
+    {
+        W5500_Bench_ApplyProfile();
+        return;
+    }
+
+    W5500_Bench_Control();
+
+    switch (g_w5500_bench_test)
+    {
+    case W5500_BENCH_TCP_TX:
+        W5500_Bench_TcpTx();
+        break;
+    case W5500_BENCH_TCP_RX:
+        W5500_Bench_TcpRx();
+        break;
+    case W5500_BENCH_UDP_TX:
+        W5500_Bench_UdpTx();
+        break;
+    case W5500_BENCH_UDP_RX:
+        W5500_Bench_UdpRx();
+        break;
+    default:
+        break;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+#ifndef __W5500_BENCH_H__
+#define __W5500_BENCH_H__
+
+#include <stdarg.h>
+
+#include "socket.h"
+
+#include "bsp_systick.h"
+
+#include "w5500/w5500_device.h"
+#include "w5500/w5500_buffer.h"
+#include "w5500/w5500_dhcp.h"
+
+#define W5500_BENCH_CONTROL_SOCKET      7                                       // 控制连接，bulk方案中socket 7的缓冲区最小
+#define W5500_BENCH_DATA_SOCKET         1                                       // 测试数据，bulk方案中socket 1的缓冲区最大
+#define W5500_BENCH_CONTROL_PORT        5201
+#define W5500_BENCH_DATA_PORT           5202                                    // TCP和UDP测试都使用这个端口
+
+#define W5500_BENCH_LINE_SIZE           64                                      // 一条命令的最大长度
+#define W5500_BENCH_BURST               8                                       // 每次W5500_Bench_Process()最多收发的次数，保证控制连接能及时处理
+#define W5500_BENCH_WAIT_TIMEOUT        5000                                    // 等待数据连接或者第一个UDP数据报的时间，单位ms
+#define W5500_BENCH_UDP_IDLE_TIMEOUT    1000                                    // UDP接收测试中超过这个时间没有数据就认为发送结束，单位ms
+
+/**
+ * 控制连接上的命令和应答都是一行文本：
+ *   TCP_TX <bytes> <chunk>          板子发送，主机连接数据端口接收（下载）
+ *   TCP_RX <bytes>                  主机连接数据端口发送，板子接收（上传）
+ *   UDP_TX <bytes> <size> <port>    板子向控制连接的主机IP和port发送数据报
+ *   UDP_RX <bytes>                  主机向数据端口发送数据报
+ *   PROFILE <default|bulk|server>   切换缓冲区分配方案，应答之后关闭所有socket
+ *   PRESCALER <2|4|...|256>         修改SPI时钟分频
+ *   STATS / ABORT
+ * 测试命令先应答READY，结束时应答：
+ *   DONE test=... bytes=... us=... spi=... sends=... busy=... min=... avg=... max=... clock=... profile=...
+ */
+
+typedef enum W5500_BenchTest_t
+{
+    W5500_BENCH_IDLE = 0,
+    W5500_BENCH_TCP_TX,
+    W5500_BENCH_TCP_RX,
+    W5500_BENCH_UDP_TX,
+    W5500_BENCH_UDP_RX,
+    W5500_BENCH_PROFILE,                                                        // 等待所有socket关闭后切换缓冲区方案
+} W5500_BenchTest_t;
+
+typedef struct W5500_BenchResult_t
+{
+    uint32_t bytes;                                                             // 收发的有效数据字节数
+    uint32_t elapsed_us;                                                        // 从第一个数据到最后一个数据的时间
+    uint32_t spi_bytes;                                                         // 测试期间SPI总线上传输的字节数
+    uint32_t sends;                                                             // send()/sendto()/recv()/recvfrom()成功的次数
+    uint32_t busy;                                                              // 返回SOCK_BUSY的次数
+    uint32_t min_us;                                                            // 单次调用的最短时间
+    uint32_t max_us;                                                            // 单次调用的最长时间
+    uint32_t total_us;                                                          // 所有成功调用的时间之和
+} W5500_BenchResult_t;
+
+void W5500_Bench_Start(void);
+void W5500_Bench_Process(void);
+
+#endif // !__W5500_BENCH_H__
\ No newline at end of file
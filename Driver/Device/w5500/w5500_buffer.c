@@ -0,0 +1,125 @@
+#include "w5500_buffer.h"
+
+// 默认分配，和wizchip_init(NULL, NULL)一样，每个socket收发各2KB
+const W5500_BufferProfile_t g_w5500_buffer_profile_default = 
+{
+    .name = "default",
+    .tx_size = {2, 2, 2, 2, 2, 2, 2, 2},
+    .rx_size = {2, 2, 2, 2, 2, 2, 2, 2}
+};
+
+// 大量上传数据，socket 1发送8KB，socket 0给DHCP等控制用途
+const W5500_BufferProfile_t g_w5500_buffer_profile_bulk = 
+{
+    .name = "bulk",
+    .tx_size = {1, 8, 1, 1, 1, 1, 1, 2},
+    .rx_size = {1, 4, 2, 2, 2, 2, 2, 1}
+};
+
+// 网页服务器，socket 0控制，其余7个socket发送多于接收
+const W5500_BufferProfile_t g_w5500_buffer_profile_server = 
+{
+    .name = "server",
+    .tx_size = {1, 4, 2, 2, 2, 2, 2, 1},
+    .rx_size = {1, 2, 2, 2, 2, 2, 2, 1}
+};
+
+const W5500_BufferProfile_t *g_w5500_buffer_profile = &g_w5500_buffer_profile_default;
+
+uint32_t g_w5500_tx_stall_count[W5500_SOCKET_COUNT];                            // 发送缓冲区满导致send()返回SOCK_BUSY的次数
+
+/**
+ * @brief 检查缓冲区大小是否合法
+ * 
+ * @param size 每个socket的缓冲区大小
+ * @return uint8_t 1: 合法; 0: 不合法
+ */
+static uint8_t W5500_Buffer_CheckSize(const uint8_t *size)
+{
+    uint8_t total = 0;
+
+    for (uint8_t i = 0; i < W5500_SOCKET_COUNT; i++)
+    {
+        // 只能是0或者2的幂
+        if (size[i] > W5500_BUFFER_TOTAL_SIZE || (size[i] & (size[i] - 1)) != 0)
+        {
+            return 0;
+        }
+        total += size[i];
+    }
+
+    return total <= W5500_BUFFER_TOTAL_SIZE;
+}
+
+/**
+ * @brief 应用socket缓冲区分配方案
+ * 
+ * @param profile 缓冲区分配方案
+ * @return int8_t 0: 成功; -1: 方案不合法; -2: 有需要调整的socket还没有关闭
+ * 
+ * @note W5500按照socket的顺序连续分配缓冲区，一个socket的大小改变后，后面所有socket的缓冲区地址都会改变，
+ *       所以从第一个改变的socket开始，后面的socket都必须处于关闭状态
+ */
+int8_t W5500_Buffer_ApplyProfile(const W5500_BufferProfile_t *profile)
+{
+    uint8_t first_changed = W5500_SOCKET_COUNT;
+
+    if (profile == NULL || !W5500_Buffer_CheckSize(profile->tx_size) || !W5500_Buffer_CheckSize(profile->rx_size))
+    {
+        return -1;
+    }
+
+    for (uint8_t i = 0; i < W5500_SOCKET_COUNT; i++)
+    {
+        if (getSn_TXBUF_SIZE(i) != profile->tx_size[i] || getSn_RXBUF_SIZE(i) != profile->rx_size[i])
+        {
+            first_changed = i;
+            break;
+        }
+    }
+
+    for (uint8_t i = first_changed; i < W5500_SOCKET_COUNT; i++)
+    {
+        if (getSn_SR(i) != SOCK_CLOSED)
+        {
+            return -2;
+        }
+    }
+
+    for (uint8_t i = first_changed; i < W5500_SOCKET_COUNT; i++)
+    {
+        setSn_TXBUF_SIZE(i, profile->tx_size[i]);
+        setSn_RXBUF_SIZE(i, profile->rx_size[i]);
+        g_w5500_tx_stall_count[i] = 0;                                          // 大小变了，以前的统计没有参考价值
+    }
+
+    g_w5500_buffer_profile = profile;
+
+    return 0;
+}
+
+/**
+ * @brief 记录一次发送缓冲区满
+ * 
+ * @param socket_index socket索引
+ */
+void W5500_Buffer_TxStall(uint8_t socket_index)
+{
+    if (socket_index < W5500_SOCKET_COUNT)
+    {
+        g_w5500_tx_stall_count[socket_index]++;
+    }
+}
+
+/**
+ * @brief 打印当前的缓冲区分配和发送缓冲区满的次数
+ * 
+ */
+void W5500_Buffer_PrintStall(void)
+{
+    printf("缓冲区分配方案: %s\r\n", g_w5500_buffer_profile->name);
+    for (uint8_t i = 0; i < W5500_SOCKET_COUNT; i++)
+    {
+        printf("socket %d: TX %dKB, RX %dKB, 发送缓冲区满 %lu 次\r\n", i, getSn_TXBUF_SIZE(i), getSn_RXBUF_SIZE(i), g_w5500_tx_stall_count[i]);
+    }
+}
\ No newline at end of file
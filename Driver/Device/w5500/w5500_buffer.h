@@ -0,0 +1,29 @@
+#ifndef __W5500_BUFFER_H__
+#define __W5500_BUFFER_H__
+
+#include "socket.h"
+
+#include "w5500/w5500_device.h"
+#include "w5500/w5500_event.h"
+
+#define W5500_BUFFER_TOTAL_SIZE     16                                          // TX和RX缓冲区各16KB
+
+typedef struct W5500_BufferProfile_t
+{
+    const char *name;
+    uint8_t tx_size[W5500_SOCKET_COUNT];                                        // 每个socket的发送缓冲区大小，单位KB，可选值: 0, 1, 2, 4, 8, 16
+    uint8_t rx_size[W5500_SOCKET_COUNT];                                        // 每个socket的接收缓冲区大小，单位KB，可选值: 0, 1, 2, 4, 8, 16
+} W5500_BufferProfile_t;
+
+extern const W5500_BufferProfile_t g_w5500_buffer_profile_default;
+extern const W5500_BufferProfile_t g_w5500_buffer_profile_bulk;
+extern const W5500_BufferProfile_t g_w5500_buffer_profile_server;
+
+extern const W5500_BufferProfile_t *g_w5500_buffer_profile;
+extern uint32_t g_w5500_tx_stall_count[W5500_SOCKET_COUNT];
+
+int8_t W5500_Buffer_ApplyProfile(const W5500_BufferProfile_t *profile);
+void W5500_Buffer_TxStall(uint8_t socket_index);
+void W5500_Buffer_PrintStall(void);
+
+#endif // !__W5500_BUFFER_H__
\ No newline at end of file
@@ -0,0 +1,267 @@
+#include "w5500_coalesce.h"
+
+#include <string.h>
+
+static W5500_Coalesce_t g_w5500_coalesce[W5500_SOCKET_COUNT];
+static uint32_t g_w5500_coalesce_window_tick;                                   // 统计窗口开始的时间
+
+/**
+ * @brief 使能socket的发送合并
+ * 
+ * @param socket_index socket索引
+ * @param buffer 合并缓冲区
+ * @param size 缓冲区大小
+ * @param threshold 缓冲区中的数据达到这个字节数马上发送，不能大于size
+ * @param deadline 第一个字节写入后最多等待的时间，单位ms
+ * @return int8_t 0: 成功; -1: 参数错误
+ */
+int8_t W5500_Coalesce_Enable(uint8_t socket_index, uint8_t *buffer, uint16_t size, uint16_t threshold, uint16_t deadline)
+{
+    if (socket_index >= W5500_SOCKET_COUNT || buffer == NULL || size == 0 || threshold == 0 || threshold > size)
+    {
+        return -1;
+    }
+
+    memset(&g_w5500_coalesce[socket_index], 0, sizeof(W5500_Coalesce_t));
+    g_w5500_coalesce[socket_index].buffer = buffer;
+    g_w5500_coalesce[socket_index].size = size;
+    g_w5500_coalesce[socket_index].threshold = threshold;
+    g_w5500_coalesce[socket_index].deadline = deadline;
+
+    return 0;
+}
+
+/**
+ * @brief 失能socket的发送合并，缓冲区中剩余的数据会先发送出去
+ * 
+ * @param socket_index socket索引
+ */
+void W5500_Coalesce_Disable(uint8_t socket_index)
+{
+    if (socket_index >= W5500_SOCKET_COUNT)
+    {
+        return;
+    }
+
+    W5500_Coalesce_Flush(socket_index);
+    g_w5500_coalesce[socket_index].buffer = NULL;
+}
+
+/**
+ * @brief 调用send()发送一个报文段并统计
+ * 
+ * @param socket_index socket索引
+ * @param data 发送数据缓冲区
+ * @param length 发送数据长度
+ * @return int32_t send()的返回值
+ */
+static int32_t W5500_Coalesce_Send(uint8_t socket_index, uint8_t *data, uint16_t length)
+{
+    W5500_Coalesce_t *coalesce = &g_w5500_coalesce[socket_index];
+    int32_t result = send(socket_index, data, length);
+
+    if (result > 0)
+    {
+        coalesce->stats.segments++;
+        coalesce->stats.bytes += result;
+        coalesce->window_segments++;
+        coalesce->window_bytes += result;
+    }
+    else if (result == SOCK_BUSY)
+    {
+        coalesce->stats.busy++;
+
+        // 非阻塞模式下上一次SEND还没有收到SENDOK时也返回SOCK_BUSY，空闲空间真的不够才算发送缓冲区满
+        if (getSn_TX_FSR(socket_index) < (length < getSn_TxMAX(socket_index) ? length : getSn_TxMAX(socket_index)))
+        {
+            W5500_Buffer_TxStall(socket_index);
+        }
+    }
+
+    return result;
+}
+
+/**
+ * @brief 写入要发送的数据，小数据先合并到缓冲区中
+ * 
+ * @param socket_index socket索引
+ * @param data 发送数据缓冲区
+ * @param length 发送数据长度
+ * @return int32_t 写入的字节数; SOCK_BUSY: 非阻塞模式下缓冲区满; 其它负数: 发送失败
+ */
+int32_t W5500_Coalesce_Write(uint8_t socket_index, uint8_t *data, uint16_t length)
+{
+    W5500_Coalesce_t *coalesce = NULL;
+    int32_t result = 0;
+
+    if (socket_index >= W5500_SOCKET_COUNT)
+    {
+        return SOCKERR_SOCKNUM;
+    }
+
+    coalesce = &g_w5500_coalesce[socket_index];
+    if (coalesce->buffer == NULL)
+    {
+        return W5500_Coalesce_Send(socket_index, data, length);                 // 没有使能合并，直接发送
+    }
+
+    coalesce->stats.writes++;
+
+    // 比阈值还大的数据没有合并的必要，直接发送，但必须排在缓冲区中已有的数据后面，否则TCP数据流的顺序会乱
+    if (length >= coalesce->threshold)
+    {
+        result = W5500_Coalesce_Flush(socket_index);
+        if (result < 0)
+        {
+            return result;
+        }
+        if (coalesce->length > 0)
+        {
+            if (result > 0)
+            {
+                coalesce->stats.busy++;                                         // 只发出一部分时send()没有返回SOCK_BUSY，补上计数，调用者靠它判断要重试
+            }
+            return SOCK_BUSY;
+        }
+        return W5500_Coalesce_Send(socket_index, data, length);
+    }
+
+    // 放不下了，先把缓冲区中的数据发出去
+    if (coalesce->length + length > coalesce->size)
+    {
+        result = W5500_Coalesce_Flush(socket_index);
+        if (result < 0)
+        {
+            return result;
+        }
+        if (coalesce->length + length > coalesce->size)
+        {
+            if (result > 0)
+            {
+                coalesce->stats.busy++;                                         // 同上，补上SOCK_BUSY的计数
+            }
+            return SOCK_BUSY;
+        }
+    }
+
+    if (coalesce->length == 0)
+    {
+        coalesce->first_tick = HAL_GetTick();
+    }
+    memcpy(coalesce->buffer + coalesce->length, data, length);
+    coalesce->length += length;
+
+    if (coalesce->length >= coalesce->threshold)
+    {
+        result = W5500_Coalesce_Flush(socket_index);
+        if (result < 0 && result != SOCK_BUSY)
+        {
+            return result;
+        }
+    }
+
+    return length;
+}
+
+/**
+ * @brief 把缓冲区中的数据作为一个报文段发送出去
+ * 
+ * @param socket_index socket索引
+ * @return int32_t 发送的字节数; SOCK_BUSY: 非阻塞模式下W5500发送缓冲区满，数据保留在缓冲区中; 其它负数: 发送失败
+ */
+int32_t W5500_Coalesce_Flush(uint8_t socket_index)
+{
+    W5500_Coalesce_t *coalesce = NULL;
+    int32_t result = 0;
+
+    if (socket_index >= W5500_SOCKET_COUNT)
+    {
+        return SOCKERR_SOCKNUM;
+    }
+
+    coalesce = &g_w5500_coalesce[socket_index];
+    if (coalesce->buffer == NULL || coalesce->length == 0)
+    {
+        return 0;
+    }
+
+    result = W5500_Coalesce_Send(socket_index, coalesce->buffer, coalesce->length);
+    if (result == SOCK_BUSY)
+    {
+        return result;
+    }
+
+    if (result > 0 && result < coalesce->length)
+    {
+        // W5500发送缓冲区比合并缓冲区小时只会发出一部分
+        memmove(coalesce->buffer, coalesce->buffer + result, coalesce->length - result);
+        coalesce->length -= result;
+        coalesce->first_tick = HAL_GetTick();
+        return result;
+    }
+
+    coalesce->length = 0;                                                       // 发送失败时socket已经关闭，丢弃数据
+
+    return result;
+}
+
+/**
+ * @brief 丢弃缓冲区中的数据，socket关闭时调用
+ * 
+ * @param socket_index socket索引
+ */
+void W5500_Coalesce_Discard(uint8_t socket_index)
+{
+    if (socket_index < W5500_SOCKET_COUNT)
+    {
+        g_w5500_coalesce[socket_index].length = 0;
+    }
+}
+
+/**
+ * @brief 发送合并处理函数，在主循环中调用，发送到期的数据并更新统计
+ * 
+ */
+void W5500_Coalesce_Process(void)
+{
+    W5500_Coalesce_t *coalesce = NULL;
+    uint32_t tick = HAL_GetTick();
+
+    for (uint8_t i = 0; i < W5500_SOCKET_COUNT; i++)
+    {
+        coalesce = &g_w5500_coalesce[i];
+        if (coalesce->buffer != NULL && coalesce->length > 0 && tick - coalesce->first_tick >= coalesce->deadline)
+        {
+            W5500_Coalesce_Flush(i);
+        }
+    }
+
+    if (tick - g_w5500_coalesce_window_tick < 1000)
+    {
+        return;
+    }
+    g_w5500_coalesce_window_tick = tick;
+
+    for (uint8_t i = 0; i < W5500_SOCKET_COUNT; i++)
+    {
+        coalesce = &g_w5500_coalesce[i];
+        coalesce->stats.segments_per_second = coalesce->window_segments;
+        coalesce->stats.bytes_per_segment = coalesce->window_segments ? coalesce->window_bytes / coalesce->window_segments : 0;
+        coalesce->window_segments = 0;
+        coalesce->window_bytes = 0;
+    }
+}
+
+/**
+ * @brief 获取socket的发送统计
+ * 
+ * @param socket_index socket索引
+ * @param stats 保存统计数据
+ */
+void W5500_Coalesce_GetStats(uint8_t socket_index, W5500_CoalesceStats_t *stats)
+{
+    if (socket_index < W5500_SOCKET_COUNT)
+    {
+        *stats = g_w5500_coalesce[socket_index].stats;
+    }
+}
\ No newline at end of file
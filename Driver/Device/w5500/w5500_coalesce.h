@@ -0,0 +1,43 @@
+#ifndef __W5500_COALESCE_H__
+#define __W5500_COALESCE_H__
+
+#include "socket.h"
+
+#include "w5500/w5500_device.h"
+#include "w5500/w5500_event.h"
+#include "w5500/w5500_buffer.h"
+
+typedef struct W5500_CoalesceStats_t
+{
+    uint32_t writes;                                                            // 调用写入的次数
+    uint32_t segments;                                                          // 调用send()的次数，每次对应一个TCP报文段
+    uint32_t bytes;                                                             // 发送的总字节数
+    uint32_t busy;                                                              // send()返回SOCK_BUSY的次数，包括上一次SEND还在等待SENDOK
+    uint32_t segments_per_second;                                               // 上一秒发送的报文段数
+    uint32_t bytes_per_segment;                                                 // 上一秒平均每个报文段的字节数
+} W5500_CoalesceStats_t;
+
+typedef struct W5500_Coalesce_t
+{
+    uint8_t *buffer;                                                            // 合并缓冲区，为NULL时不合并，直接发送
+    uint16_t size;                                                              // 缓冲区大小
+    uint16_t length;                                                            // 缓冲区中的字节数
+    uint16_t threshold;                                                         // 达到这个字节数马上发送
+    uint16_t deadline;                                                          // 第一个字节写入后最多等待的时间，单位ms
+    uint32_t first_tick;                                                        // 第一个字节写入的时间
+    uint32_t window_segments;                                                   // 统计窗口内的报文段数
+    uint32_t window_bytes;                                                      // 统计窗口内的字节数
+    W5500_CoalesceStats_t stats;
+} W5500_Coalesce_t;
+
+int8_t W5500_Coalesce_Enable(uint8_t socket_index, uint8_t *buffer, uint16_t size, uint16_t threshold, uint16_t deadline);
+void W5500_Coalesce_Disable(uint8_t socket_index);
+
+int32_t W5500_Coalesce_Write(uint8_t socket_index, uint8_t *data, uint16_t length);
+int32_t W5500_Coalesce_Flush(uint8_t socket_index);
+void W5500_Coalesce_Discard(uint8_t socket_index);
+void W5500_Coalesce_Process(void);
+
+void W5500_Coalesce_GetStats(uint8_t socket_index, W5500_CoalesceStats_t *stats);
+
+#endif // !__W5500_COALESCE_H__
\ No newline at end of file
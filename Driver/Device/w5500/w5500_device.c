@@ -1,6 +1,14 @@
 #include "w5500_device.h"
+#include "w5500_buffer.h"
 
 SPI_HandleTypeDef g_w5500_spi_handle;
+DMA_HandleTypeDef g_w5500_spi_dma_tx_handle;
+DMA_HandleTypeDef g_w5500_spi_dma_rx_handle;
+
+volatile uint32_t g_w5500_spi_byte_count;
+volatile uint32_t g_w5500_spi_error_count;
+
+static volatile uint8_t g_w5500_spi_dma_finished;                               // DMA传输完成标志，0: 传输中; 1: 传输完成; 2: 传输出错
 
 wiz_NetInfo g_w5500_net_info = 
 {
@@ -14,6 +22,33 @@ wiz_NetInfo g_w5500_net_info =
 
 uint8_t g_w5500_data_buff[DATA_BUFFER_SIZE];                                    // 数据缓冲区
 
+// 指标，值就是驱动里的计数，注册后由Metrics_Render()读取
+static const Metrics_Entry_t g_w5500_spi_bytes_metric =
+{
+    .name = "w5500_spi_bytes_total",
+    .help = "Bytes transferred on the W5500 SPI bus, frame headers included",
+    .type = METRICS_TYPE_COUNTER,
+    .value = &g_w5500_spi_byte_count
+};
+
+static const Metrics_Entry_t g_w5500_spi_error_metric =
+{
+    .name = "w5500_spi_errors_total",
+    .help = "W5500 SPI DMA bursts that failed or timed out and were retried",
+    .type = METRICS_TYPE_COUNTER,
+    .value = &g_w5500_spi_error_count
+};
+
+static const Metrics_Entry_t g_w5500_tx_stall_metric =
+{
+    .name = "w5500_socket_tx_stalls_total",
+    .help = "Sends refused because the socket TX buffer was full",
+    .type = METRICS_TYPE_COUNTER,
+    .index_label = "socket",
+    .count = W5500_SOCKET_COUNT,
+    .value = g_w5500_tx_stall_count
+};
+
 /**
  * @brief W5500初始化函数
  * 
@@ -45,9 +80,15 @@ void W5500_Init(SPI_HandleTypeDef *hspi)
     GPIO_InitStruct.Pull = GPIO_PULLUP;
     HAL_GPIO_Init(W5500_INTERRUPT_GPIO_PORT, &GPIO_InitStruct);
 
+    W5500_SPI_DMA_Init();                                                       // 初始化SPI的DMA
+
     W5500_Reset();                                                              // 重启芯片
 
     register_wizchip_function();                                                // 调用注册函数
+
+    Metrics_Register(&g_w5500_spi_bytes_metric);
+    Metrics_Register(&g_w5500_spi_error_metric);
+    Metrics_Register(&g_w5500_tx_stall_metric);
 }
 
 /**
@@ -64,105 +105,268 @@ void W5500_Reset(void)
 }
 
 /**
- * @brief W5500设置MAC地址
+ * @brief W5500的SPI DMA初始化函数
  * 
+ * @note DMA句柄链接到g_w5500_spi_handle上，因为W5500_Init()保存的是SPI句柄的副本
  */
-void W5500_SetMac(void)
+void W5500_SPI_DMA_Init(void)
 {
-    setSHAR(g_w5500_net_info.mac);                                              // 设置MAC地址
-    printf("设置MAC地址成功\r\n");
+    BSP_DMA_MemoryToPeripheral_Init(&g_w5500_spi_dma_tx_handle, W5500_SPI_DMA_TX_STREAM, W5500_SPI_DMA_TX_CHANNEL, 8, DMA_NORMAL, DMA_PRIORITY_HIGH);
+    BSP_DMA_PeripheralToMemory_Init(&g_w5500_spi_dma_rx_handle, W5500_SPI_DMA_RX_STREAM, W5500_SPI_DMA_RX_CHANNEL, 8, DMA_NORMAL, DMA_PRIORITY_VERY_HIGH);
+
+    __HAL_LINKDMA(&g_w5500_spi_handle, hdmatx, g_w5500_spi_dma_tx_handle);
+    __HAL_LINKDMA(&g_w5500_spi_handle, hdmarx, g_w5500_spi_dma_rx_handle);
+
+    HAL_NVIC_SetPriority(W5500_SPI_DMA_TX_IRQn, 3, 0);
+    HAL_NVIC_EnableIRQ(W5500_SPI_DMA_TX_IRQn);
+    HAL_NVIC_SetPriority(W5500_SPI_DMA_RX_IRQn, 3, 0);
+    HAL_NVIC_EnableIRQ(W5500_SPI_DMA_RX_IRQn);
+
+    // SPI的DMA传输会使能SPI错误中断
+    HAL_NVIC_SetPriority(SPI1_IRQn, 3, 0);
+    HAL_NVIC_EnableIRQ(SPI1_IRQn);
 }
 
 /**
- * @brief W5500设置IP地址
+ * @brief 等待W5500的SPI DMA传输完成
+ * 
+ * @param length 传输的字节数
+ * @return HAL_StatusTypeDef HAL_OK: 传输完成; HAL_ERROR: 传输出错; HAL_TIMEOUT: 传输超时
  * 
+ * @note 出错或超时时已经中止了传输，W5500的地址指针停在哪里不确定，调用者需要重发整帧
  */
-void W5500_SetIp(void)
+static HAL_StatusTypeDef W5500_SPI_WaitDMA(uint16_t length)
 {
-    setSIPR(g_w5500_net_info.ip);                                               // 设置IP地址
-    setSUBR(g_w5500_net_info.sn);                                               // 设置子网掩码
-    setGAR(g_w5500_net_info.gw);                                                // 设置网关
-    printf("设置IP地址成功\r\n");
+    uint32_t start = HAL_GetTick();
+
+    // SPI时钟最低也有几百KHz，按每毫秒至少传输64字节估算超时时间
+    uint32_t timeout = 10 + length / 64;
+
+    while (g_w5500_spi_dma_finished == 0)
+    {
+        if (HAL_GetTick() - start > timeout)
+        {
+            HAL_SPI_Abort(&g_w5500_spi_handle);
+            g_w5500_spi_error_count++;
+            BINLOG("W5500 SPI DMA传输超时\r\n");
+            return HAL_TIMEOUT;
+        }
+    }
+
+    if (g_w5500_spi_dma_finished != 1)
+    {
+        HAL_SPI_Abort(&g_w5500_spi_handle);
+        g_w5500_spi_error_count++;
+        BINLOG("W5500 SPI DMA传输出错\r\n");
+        return HAL_ERROR;
+    }
+
+    return HAL_OK;
 }
 
 /**
- * @brief 打印网络信息函数
+ * @brief W5500通过SPI发送多个字节
+ * 
+ * @param data 要发送的数据
+ * @param length 要发送的数据长度
+ * @return HAL_StatusTypeDef HAL_OK: 发送完成; 其它: 发送失败，需要重发整帧
  * 
+ * @note 长度小于W5500_SPI_DMA_THRESHOLD时轮询发送，否则使用DMA发送并等待完成
  */
-void PrintInfo(void)
+HAL_StatusTypeDef W5500_SPI_Transmit(uint8_t *data, uint16_t length)
 {
-    uint8_t info[6] = {0};
-    wiz_NetInfo netInfo;
+    g_w5500_spi_byte_count += length;
 
-    ctlnetwork(CN_GET_NETINFO, (void*)&netInfo);                                // 获取网络信息
-    ctlwizchip(CW_GET_ID,(void*)info);                                          // 显示网络信息
+    if (length < W5500_SPI_DMA_THRESHOLD)
+    {
+        return HAL_SPI_Transmit(&g_w5500_spi_handle, data, length, 1000);
+    }
 
-    if(netInfo.dhcp == NETINFO_DHCP) 
+    g_w5500_spi_dma_finished = 0;
+    if (HAL_SPI_Transmit_DMA(&g_w5500_spi_handle, data, length) != HAL_OK)
     {
-        printf("\r\n=== %s NET CONF : DHCP ===\r\n",(char*)info);
+        return HAL_SPI_Transmit(&g_w5500_spi_handle, data, length, 1000);       // DMA启动失败，退回轮询方式
     }
-    else 
+    return W5500_SPI_WaitDMA(length);
+}
+
+/**
+ * @brief W5500通过SPI接收多个字节
+ * 
+ * @param data 保存接收数据的缓冲区
+ * @param length 要接收的数据长度
+ * @return HAL_StatusTypeDef HAL_OK: 接收完成; 其它: 接收失败，需要重发整帧
+ * 
+ * @note 全双工主机模式下HAL库会把缓冲区原有内容作为哑数据发送出去，W5500在数据阶段会忽略MOSI
+ */
+HAL_StatusTypeDef W5500_SPI_Receive(uint8_t *data, uint16_t length)
+{
+    g_w5500_spi_byte_count += length;
+
+    if (length < W5500_SPI_DMA_THRESHOLD)
     {
-        printf("\r\n=== %s NET CONF : Static ===\r\n",(char*)info);
+        return HAL_SPI_Receive(&g_w5500_spi_handle, data, length, 1000);
     }
 
-    printf("MAC: %02X:%02X:%02X:%02X:%02X:%02X\r\n", netInfo.mac[0], netInfo.mac[1], netInfo.mac[2], netInfo.mac[3], netInfo.mac[4], netInfo.mac[5]);
-    printf("SIP: %d.%d.%d.%d\r\n", netInfo.ip[0], netInfo.ip[1], netInfo.ip[2], netInfo.ip[3]);
-    printf("GAR: %d.%d.%d.%d\r\n", netInfo.gw[0], netInfo.gw[1], netInfo.gw[2], netInfo.gw[3]);
-    printf("SUB: %d.%d.%d.%d\r\n", netInfo.sn[0], netInfo.sn[1], netInfo.sn[2], netInfo.sn[3]);
-    printf("DNS: %d.%d.%d.%d\r\n", netInfo.dns[0], netInfo.dns[1], netInfo.dns[2], netInfo.dns[3]);
-    printf("===========================\r\n");
+    g_w5500_spi_dma_finished = 0;
+    if (HAL_SPI_Receive_DMA(&g_w5500_spi_handle, data, length) != HAL_OK)
+    {
+        return HAL_SPI_Receive(&g_w5500_spi_handle, data, length, 1000);        // DMA启动失败，退回轮询方式
+    }
+    return W5500_SPI_WaitDMA(length);
 }
 
 /**
- * @brief DHCP分配IP地址
+ * @brief 修改W5500的SPI时钟分频
+ * 
+ * @param prescaler 分频系数，SPI_BAUDRATEPRESCALER_2 ~ SPI_BAUDRATEPRESCALER_256
  * 
- * @param socket_index 端口号
+ * @note 只能在没有SPI传输的时候调用，也就是主循环中
  */
-void DHCP_TryToGetIp(uint8_t socket_index)
+void W5500_SPI_SetPrescaler(uint32_t prescaler)
 {
-    static uint8_t retry_count = 0;
-    uint8_t state = 0;
-
-    memset(g_w5500_data_buff, 0, DATA_BUFFER_SIZE);
+    g_w5500_spi_handle.Init.BaudRatePrescaler = prescaler;
+    HAL_SPI_Init(&g_w5500_spi_handle);
+}
 
-    g_w5500_net_info.dhcp = NETINFO_DHCP;                                       // 设置为DHCP模式
+/**
+ * @brief 获取W5500的SPI时钟频率
+ * 
+ * @return uint32_t SPI时钟频率，单位Hz
+ * 
+ * @note SPI1挂在APB2上，分频系数的BR[2:0]位为n时分频为2^(n+1)
+ */
+uint32_t W5500_SPI_GetClock(void)
+{
+    return HAL_RCC_GetPCLK2Freq() >> (((g_w5500_spi_handle.Init.BaudRatePrescaler >> 3) & 0x07) + 1);
+}
 
-    setSHAR(g_w5500_net_info.mac);                                              // 在DPCH开始之前需要手动设置MAC地址
+/**
+ * @brief SPI1的TX DMA中断服务函数
+ * 
+ */
+void DMA2_Stream3_IRQHandler(void)
+{
+    HAL_DMA_IRQHandler(&g_w5500_spi_dma_tx_handle);
+}
 
-    // 注册分配IP时，IP更新时，IP冲突时的回调函数，如果参数为NULL，则使用默认的注册函数
-    reg_dhcp_cbfunc(NULL, NULL, NULL);  
+/**
+ * @brief SPI1的RX DMA中断服务函数
+ * 
+ */
+void DMA2_Stream2_IRQHandler(void)
+{
+    HAL_DMA_IRQHandler(&g_w5500_spi_dma_rx_handle);
+}
 
-    DHCP_init(socket_index, g_w5500_data_buff);                                 // 初始化DHCP
+/**
+ * @brief SPI1中断服务函数
+ * 
+ */
+void SPI1_IRQHandler(void)
+{
+    HAL_SPI_IRQHandler(&g_w5500_spi_handle);
+}
 
-    printf("DHCP开始分配IP\r\n");
+/**
+ * @brief SPI DMA发送完成回调函数
+ * 
+ * @param hspi SPI句柄
+ */
+void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+    if (hspi == &g_w5500_spi_handle)
+    {
+        g_w5500_spi_dma_finished = 1;
+    }
+}
 
-    // 返回DHCP_IP_LEASED说明申请租赁IP地址成功，如果没成功，重新申请
-    state = DHCP_run();
+/**
+ * @brief SPI DMA接收完成回调函数
+ * 
+ * @param hspi SPI句柄
+ * 
+ * @note 全双工主机模式下HAL_SPI_Receive_DMA()虽然借用TransmitReceive_DMA，但状态是BUSY_RX，完成时调用的是这个回调
+ */
+void HAL_SPI_RxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+    if (hspi == &g_w5500_spi_handle)
+    {
+        g_w5500_spi_dma_finished = 1;
+    }
+}
 
-    while(state != DHCP_IP_LEASED && retry_count < DHCP_MAX_RETRY_COUNT)
+/**
+ * @brief SPI DMA收发完成回调函数
+ * 
+ * @param hspi SPI句柄
+ */
+void HAL_SPI_TxRxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+    if (hspi == &g_w5500_spi_handle)
     {
-        retry_count++;
-        printf("DHCP第%d次分配IP失败\r\n", retry_count);
-        state = DHCP_run();
-        Delay_ms(1000);
+        g_w5500_spi_dma_finished = 1;
     }
-    
-    if (state != DHCP_IP_LEASED && retry_count == DHCP_MAX_RETRY_COUNT)
+}
+
+/**
+ * @brief SPI错误回调函数
+ * 
+ * @param hspi SPI句柄
+ */
+void HAL_SPI_ErrorCallback(SPI_HandleTypeDef *hspi)
+{
+    if (hspi == &g_w5500_spi_handle)
     {
-        retry_count = 0;
-        printf("DHCP分配IP失败，采用静态分配IP的方式\r\n");
-        g_w5500_net_info.dhcp = NETINFO_STATIC;
+        g_w5500_spi_dma_finished = 2;
     }
+}
 
-    DHCP_stop();
+/**
+ * @brief W5500设置MAC地址
+ * 
+ */
+void W5500_SetMac(void)
+{
+    setSHAR(g_w5500_net_info.mac);                                              // 设置MAC地址
+    BINLOG("设置MAC地址成功\r\n");
+}
 
-    getIPfromDHCP(g_w5500_net_info.ip);
-    getGWfromDHCP(g_w5500_net_info.gw);
-    getSNfromDHCP(g_w5500_net_info.sn);
-    getDNSfromDHCP(g_w5500_net_info.dns);
+/**
+ * @brief W5500设置IP地址
+ * 
+ */
+void W5500_SetIp(void)
+{
+    setSIPR(g_w5500_net_info.ip);                                               // 设置IP地址
+    setSUBR(g_w5500_net_info.sn);                                               // 设置子网掩码
+    setGAR(g_w5500_net_info.gw);                                                // 设置网关
+    BINLOG("设置IP地址成功\r\n");
+}
+
+/**
+ * @brief 打印网络信息函数
+ * 
+ */
+void PrintInfo(void)
+{
+    wiz_NetInfo netInfo;
 
-    ctlnetwork(CN_SET_NETINFO, (void*)&g_w5500_net_info);                       // 设置网络信息
+    ctlnetwork(CN_GET_NETINFO, (void*)&netInfo);                                // 获取网络信息
+
+    if(netInfo.dhcp == NETINFO_DHCP) 
+    {
+        BINLOG("\r\n=== %s NET CONF : DHCP ===\r\n", _WIZCHIP_ID_);             // 芯片名是FLASH里的常量，BINLOG()可以还原
+    }
+    else 
+    {
+        BINLOG("\r\n=== %s NET CONF : Static ===\r\n", _WIZCHIP_ID_);
+    }
 
-    close(socket_index);                                                        // 关闭端口
+    BINLOG("MAC: %02X:%02X:%02X:%02X:%02X:%02X\r\n", netInfo.mac[0], netInfo.mac[1], netInfo.mac[2], netInfo.mac[3], netInfo.mac[4], netInfo.mac[5]);
+    BINLOG("SIP: %d.%d.%d.%d\r\n", netInfo.ip[0], netInfo.ip[1], netInfo.ip[2], netInfo.ip[3]);
+    BINLOG("GAR: %d.%d.%d.%d\r\n", netInfo.gw[0], netInfo.gw[1], netInfo.gw[2], netInfo.gw[3]);
+    BINLOG("SUB: %d.%d.%d.%d\r\n", netInfo.sn[0], netInfo.sn[1], netInfo.sn[2], netInfo.sn[3]);
+    BINLOG("DNS: %d.%d.%d.%d\r\n", netInfo.dns[0], netInfo.dns[1], netInfo.dns[2], netInfo.dns[3]);
+    BINLOG("===========================\r\n");
 }
\ No newline at end of file
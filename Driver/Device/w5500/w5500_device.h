@@ -7,9 +7,13 @@
 #include "socket.h"
 #include "DHCP/dhcp.h"
 
+#include "bsp_dma.h"
 #include "bsp_uart.h"
 #include "bsp_systick.h"
 
+#include "metrics/metrics.h"
+#include "binlog/binlog.h"
+
 #define W5500_CS_GPIO_PORT                      GPIOA
 #define W5500_CS_GPIO_PIN                       GPIO_PIN_4
 #define RCC_W5500_CS_GPIO_CLK_ENABLE()          __HAL_RCC_GPIOA_CLK_ENABLE()
@@ -22,6 +26,16 @@
 #define W5500_INTERRUPT_GPIO_PIN                GPIO_PIN_9
 #define RCC_W5500_INTERRUPT_GPIO_CLK_ENABLE()   __HAL_RCC_GPIOD_CLK_ENABLE()
 
+// SPI1的DMA数据流，SPI1_TX: DMA2_Stream3通道3，SPI1_RX: DMA2_Stream2通道3
+#define W5500_SPI_DMA_TX_STREAM                 DMA2_Stream3
+#define W5500_SPI_DMA_TX_CHANNEL                DMA_CHANNEL_3
+#define W5500_SPI_DMA_TX_IRQn                   DMA2_Stream3_IRQn
+#define W5500_SPI_DMA_RX_STREAM                 DMA2_Stream2
+#define W5500_SPI_DMA_RX_CHANNEL                DMA_CHANNEL_3
+#define W5500_SPI_DMA_RX_IRQn                   DMA2_Stream2_IRQn
+
+#define W5500_SPI_DMA_THRESHOLD                 32                              // 小于该长度的突发传输使用轮询方式，DMA启动开销比直接收发还大
+
 #define W5500_CS(x)                             do{ x ? \
                                                     HAL_GPIO_WritePin(W5500_CS_GPIO_PORT, W5500_CS_GPIO_PIN, GPIO_PIN_SET):\
                                                     HAL_GPIO_WritePin(W5500_CS_GPIO_PORT, W5500_CS_GPIO_PIN, GPIO_PIN_RESET);\
@@ -34,9 +48,13 @@
 
 
 #define DATA_BUFFER_SIZE        2048
-#define DHCP_MAX_RETRY_COUNT    30
 
 extern SPI_HandleTypeDef g_w5500_spi_handle;
+extern DMA_HandleTypeDef g_w5500_spi_dma_tx_handle;
+extern DMA_HandleTypeDef g_w5500_spi_dma_rx_handle;
+
+extern volatile uint32_t g_w5500_spi_byte_count;                                // SPI总线上传输的字节数，包括帧头，用于计算SPI开销
+extern volatile uint32_t g_w5500_spi_error_count;                               // 出错或超时的SPI DMA传输次数
 
 extern struct wiz_NetInfo_t g_w5500_net_info;                                   // 网络信息
 extern uint8_t g_w5500_data_buff[DATA_BUFFER_SIZE];                             // 数据缓冲区
@@ -44,11 +62,16 @@ extern uint8_t g_w5500_data_buff[DATA_BUFFER_SIZE];
 void W5500_Init(SPI_HandleTypeDef *hspi);
 void W5500_Reset(void);
 
+void W5500_SPI_DMA_Init(void);
+HAL_StatusTypeDef W5500_SPI_Transmit(uint8_t *data, uint16_t length);
+HAL_StatusTypeDef W5500_SPI_Receive(uint8_t *data, uint16_t length);
+void W5500_SPI_SetPrescaler(uint32_t prescaler);
+uint32_t W5500_SPI_GetClock(void);
+
 void W5500_SetMac(void);
 void W5500_SetIp(void);
 
 void PrintInfo(void);
 
-void DHCP_TryToGetIp(uint8_t socket);
 
 #endif // !__DEVICE_H__
\ No newline at end of file
@@ -0,0 +1,197 @@
+#include "w5500_dhcp.h"
+
+static uint8_t g_w5500_dhcp_buffer[W5500_DHCP_BUFFER_SIZE];                     // DHCP一直在后台运行，使用单独的缓冲区
+static uint8_t g_w5500_dhcp_socket;
+static uint8_t g_w5500_dhcp_running;
+static uint8_t g_w5500_dhcp_leased;
+static uint8_t g_w5500_dhcp_static;                                             // 当前使用的是静态IP
+static volatile uint8_t g_w5500_dhcp_received;                                  // DHCP socket收到报文
+static uint32_t g_w5500_dhcp_tick;                                              // 上次运行状态机的时间
+static W5500_DHCPCallback_t g_w5500_dhcp_callback;
+
+static wiz_NetInfo g_w5500_static_net_info;                                     // 静态IP配置，获取IP失败或者租期到期时使用
+
+/**
+ * @brief 通知网络地址变化
+ * 
+ * @param event 事件
+ */
+static void W5500_DHCP_Notify(W5500_DHCPEvent_t event)
+{
+    if (g_w5500_dhcp_callback != NULL)
+    {
+        g_w5500_dhcp_callback(event);
+    }
+}
+
+/**
+ * @brief 把DHCP分配的地址写入W5500
+ * 
+ */
+static void W5500_DHCP_ApplyNetInfo(void)
+{
+    getIPfromDHCP(g_w5500_net_info.ip);
+    getGWfromDHCP(g_w5500_net_info.gw);
+    getSNfromDHCP(g_w5500_net_info.sn);
+    getDNSfromDHCP(g_w5500_net_info.dns);
+    g_w5500_net_info.dhcp = NETINFO_DHCP;
+
+    ctlnetwork(CN_SET_NETINFO, (void*)&g_w5500_net_info);                       // 设置网络信息
+    g_w5500_dhcp_leased = 1;
+    g_w5500_dhcp_static = 0;
+}
+
+/**
+ * @brief 切换回静态IP
+ * 
+ */
+static void W5500_DHCP_ApplyStatic(void)
+{
+    g_w5500_net_info = g_w5500_static_net_info;
+    g_w5500_net_info.dhcp = NETINFO_STATIC;
+
+    ctlnetwork(CN_SET_NETINFO, (void*)&g_w5500_net_info);                       // 设置网络信息
+    g_w5500_dhcp_leased = 0;
+    g_w5500_dhcp_static = 1;
+}
+
+/**
+ * @brief 第一次分配到IP的回调函数
+ * 
+ * @note 默认的回调函数会软件复位W5500，所有socket都会被关闭，所以这里只修改地址寄存器
+ */
+static void W5500_DHCP_IpAssign(void)
+{
+    W5500_DHCP_ApplyNetInfo();
+    W5500_DHCP_Notify(W5500_DHCP_EVENT_ASSIGN);
+}
+
+/**
+ * @brief 续租时IP发生变化的回调函数
+ * 
+ */
+static void W5500_DHCP_IpUpdate(void)
+{
+    W5500_DHCP_ApplyNetInfo();
+    W5500_DHCP_Notify(W5500_DHCP_EVENT_CHANGED);
+}
+
+/**
+ * @brief IP冲突的回调函数
+ * 
+ */
+static void W5500_DHCP_IpConflict(void)
+{
+    BINLOG("DHCP分配的IP地址冲突\r\n");
+    W5500_DHCP_Notify(W5500_DHCP_EVENT_CONFLICT);
+}
+
+/**
+ * @brief DHCP socket的事件回调函数
+ * 
+ * @param socket_index socket索引
+ * @param event 事件
+ */
+static void W5500_DHCP_EventCallback(uint8_t socket_index, uint8_t event)
+{
+    g_w5500_dhcp_received = 1;
+}
+
+/**
+ * @brief 开始DHCP，不会阻塞，地址分配的结果通过回调函数通知
+ * 
+ * @param socket_index DHCP使用的socket索引，DHCP运行期间一直占用
+ * @param callback 网络地址变化的回调函数，可以为NULL
+ * 
+ * @note 需要在W5500_Event_Init()之后调用，g_w5500_net_info中原来的地址作为静态IP备用
+ */
+void W5500_DHCP_Start(uint8_t socket_index, W5500_DHCPCallback_t callback)
+{
+    g_w5500_static_net_info = g_w5500_net_info;
+    g_w5500_dhcp_socket = socket_index;
+    g_w5500_dhcp_callback = callback;
+    g_w5500_dhcp_leased = 0;
+    g_w5500_dhcp_static = 0;
+
+    setSHAR(g_w5500_net_info.mac);                                              // 在DPCH开始之前需要手动设置MAC地址
+
+    // 注册分配IP时，IP更新时，IP冲突时的回调函数
+    reg_dhcp_cbfunc(W5500_DHCP_IpAssign, W5500_DHCP_IpUpdate, W5500_DHCP_IpConflict);
+
+    DHCP_init(socket_index, g_w5500_dhcp_buffer);                               // 初始化DHCP
+
+    W5500_Event_Enable(socket_index, W5500_EVENT_RECV, W5500_DHCP_EventCallback);
+
+    g_w5500_dhcp_running = 1;
+    g_w5500_dhcp_received = 1;                                                  // 马上发送DISCOVER
+    BINLOG("DHCP开始分配IP\r\n");
+}
+
+/**
+ * @brief 停止DHCP，释放socket
+ * 
+ */
+void W5500_DHCP_Stop(void)
+{
+    if (!g_w5500_dhcp_running)
+    {
+        return;
+    }
+
+    W5500_Event_Disable(g_w5500_dhcp_socket);
+    DHCP_stop();                                                                // 会关闭socket
+    g_w5500_dhcp_running = 0;
+}
+
+/**
+ * @brief DHCP处理函数，在主循环中调用，不会阻塞
+ * 
+ * @note 收到报文或者每隔W5500_DHCP_PERIOD毫秒运行一次状态机，超时、续租(T1)、重新绑定(T2)由TIM6每秒的DHCP_time_handler()计时
+ */
+void W5500_DHCP_Process(void)
+{
+    if (!g_w5500_dhcp_running)
+    {
+        return;
+    }
+
+    if (!g_w5500_dhcp_received && HAL_GetTick() - g_w5500_dhcp_tick < W5500_DHCP_PERIOD)
+    {
+        return;
+    }
+
+    g_w5500_dhcp_received = 0;
+    g_w5500_dhcp_tick = HAL_GetTick();
+
+    switch (DHCP_run())
+    {
+    case DHCP_FAILED:
+        // 一轮DISCOVER没有回应，先使用静态IP，DHCP继续在后台尝试
+        if (!g_w5500_dhcp_static)
+        {
+            BINLOG("DHCP分配IP失败，先采用静态分配IP的方式\r\n");
+            W5500_DHCP_ApplyStatic();
+            W5500_DHCP_Notify(W5500_DHCP_EVENT_STATIC);
+        }
+        break;
+
+    case DHCP_IP_EXPIRED:
+        BINLOG("DHCP租期到期，采用静态分配IP的方式\r\n");
+        W5500_DHCP_ApplyStatic();
+        W5500_DHCP_Notify(W5500_DHCP_EVENT_EXPIRED);
+        break;
+
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief 是否已经通过DHCP获取到IP
+ * 
+ * @return uint8_t 1: 已经获取到IP; 0: 没有获取到IP
+ */
+uint8_t W5500_DHCP_IsLeased(void)
+{
+    return g_w5500_dhcp_leased;
+}
\ No newline at end of file
@@ -0,0 +1,32 @@
+#ifndef __W5500_DHCP_H__
+#define __W5500_DHCP_H__
+
+#include "socket.h"
+#include "DHCP/dhcp.h"
+
+#include "bsp_uart.h"
+
+#include "w5500/w5500_device.h"
+#include "w5500/w5500_event.h"
+
+#define W5500_DHCP_BUFFER_SIZE      548                                         // DHCP报文最大长度，236 + 312字节选项
+#define W5500_DHCP_PERIOD           1000                                        // 没有收到报文时DHCP状态机的运行周期，单位ms
+
+// 网络地址变化事件
+typedef enum W5500_DHCPEvent_t
+{
+    W5500_DHCP_EVENT_ASSIGN = 0,                                                // 第一次获取到IP地址
+    W5500_DHCP_EVENT_CHANGED,                                                   // 续租时IP地址发生变化
+    W5500_DHCP_EVENT_EXPIRED,                                                   // 租期到期没有续租成功，已经切换回静态IP
+    W5500_DHCP_EVENT_CONFLICT,                                                  // 分配的IP地址和其它设备冲突
+    W5500_DHCP_EVENT_STATIC,                                                    // 获取IP失败，先使用静态IP，DHCP在后台继续运行
+} W5500_DHCPEvent_t;
+
+typedef void (*W5500_DHCPCallback_t)(W5500_DHCPEvent_t event);
+
+void W5500_DHCP_Start(uint8_t socket_index, W5500_DHCPCallback_t callback);
+void W5500_DHCP_Stop(void);
+void W5500_DHCP_Process(void);
+uint8_t W5500_DHCP_IsLeased(void);
+
+#endif // !__W5500_DHCP_H__
\ No newline at end of file
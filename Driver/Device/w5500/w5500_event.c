@@ -0,0 +1,227 @@
+#include "w5500_event.h"
+
+static volatile uint8_t g_w5500_event_pending;                                  // INT引脚下降沿标志，由EXTI中断置位
+
+static uint8_t g_w5500_event_socket_mask;                                       // 使能了中断的socket，对应SIMR寄存器
+static W5500_EventCallback_t g_w5500_event_callback[W5500_SOCKET_COUNT];
+static W5500_EventQueue_t g_w5500_event_queue[W5500_SOCKET_COUNT];
+
+// 同一次读取到多个事件时按照这个顺序入队，保证先处理接收再处理断开
+static const uint8_t g_w5500_event_order[] = 
+{
+    W5500_EVENT_CON, W5500_EVENT_RECV, W5500_EVENT_SENDOK, W5500_EVENT_DISCON, W5500_EVENT_TIMEOUT
+};
+
+/**
+ * @brief W5500事件分发初始化函数
+ * 
+ * @note 必须在wizchip_init()之后调用，因为软件复位会清除SIMR和Sn_IMR寄存器
+ */
+void W5500_Event_Init(void)
+{
+    GPIO_InitTypeDef GPIO_InitStruct = {0};
+
+    // INT引脚低电平有效，只要SIR不为0就一直保持低电平
+    GPIO_InitStruct.Pin = W5500_INTERRUPT_GPIO_PIN;
+    GPIO_InitStruct.Mode = GPIO_MODE_IT_FALLING;                                // 下降沿触发
+    GPIO_InitStruct.Pull = GPIO_PULLUP;                                         // 使用上拉
+    HAL_GPIO_Init(W5500_INTERRUPT_GPIO_PORT, &GPIO_InitStruct);
+
+    g_w5500_event_socket_mask = 0;
+    setSIMR(0);
+    setIMR(0);                                                                  // 不使用IP冲突、目标不可达等通用中断
+
+    g_w5500_event_pending = 1;                                                  // 先读一次，处理初始化之前已经产生的中断
+
+    HAL_NVIC_SetPriority(EXTI9_5_IRQn, 4, 0);                                   // 设置中断优先级
+    HAL_NVIC_EnableIRQ(EXTI9_5_IRQn);                                           // 使能中断
+}
+
+/**
+ * @brief 使能socket的中断事件
+ * 
+ * @param socket_index socket索引
+ * @param event_mask 要使能的事件，W5500_EVENT_XXX按位或
+ * @param callback 事件回调函数，为NULL时通过W5500_Event_Get()查询事件
+ */
+void W5500_Event_Enable(uint8_t socket_index, uint8_t event_mask, W5500_EventCallback_t callback)
+{
+    if (socket_index >= W5500_SOCKET_COUNT)
+    {
+        return;
+    }
+
+    g_w5500_event_callback[socket_index] = callback;
+    g_w5500_event_queue[socket_index].head = 0;
+    g_w5500_event_queue[socket_index].tail = 0;
+
+    event_mask &= W5500_EVENT_ALL;
+    ctlsocket(socket_index, CS_SET_INTMASK, &event_mask);
+
+    g_w5500_event_socket_mask |= (1 << socket_index);
+    setSIMR(g_w5500_event_socket_mask);
+}
+
+/**
+ * @brief 失能socket的中断事件
+ * 
+ * @param socket_index socket索引
+ */
+void W5500_Event_Disable(uint8_t socket_index)
+{
+    uint8_t event_mask = 0;
+
+    if (socket_index >= W5500_SOCKET_COUNT)
+    {
+        return;
+    }
+
+    g_w5500_event_socket_mask &= ~(1 << socket_index);
+    setSIMR(g_w5500_event_socket_mask);
+    ctlsocket(socket_index, CS_SET_INTMASK, &event_mask);
+
+    g_w5500_event_callback[socket_index] = NULL;
+}
+
+/**
+ * @brief W5500的INT引脚中断处理函数，在EXTI回调函数中调用
+ * 
+ * @note 这里不访问SPI，主循环里可能正在进行SPI传输，只记录有中断发生
+ */
+void W5500_Event_IRQHandler(void)
+{
+    g_w5500_event_pending = 1;
+}
+
+/**
+ * @brief 重写BSP的EXTI回调函数，W5500的INT引脚接在EXTI9上
+ * 
+ * @param GPIO_Pin EXTI的引脚
+ */
+void BSP_EXTI_Callback(uint16_t GPIO_Pin)
+{
+    if (GPIO_Pin == W5500_INTERRUPT_GPIO_PIN)
+    {
+        W5500_Event_IRQHandler();
+    }
+}
+
+/**
+ * @brief 事件入队
+ * 
+ * @param socket_index socket索引
+ * @param event 事件
+ */
+static void W5500_Event_Push(uint8_t socket_index, uint8_t event)
+{
+    W5500_EventQueue_t *queue = &g_w5500_event_queue[socket_index];
+
+    if ((uint8_t)(queue->tail - queue->head) >= W5500_EVENT_QUEUE_SIZE)
+    {
+        queue->overflow++;
+        return;
+    }
+
+    queue->events[queue->tail & (W5500_EVENT_QUEUE_SIZE - 1)] = event;
+    queue->tail++;
+}
+
+/**
+ * @brief 读取中断寄存器，把socket事件放入队列
+ * 
+ */
+static void W5500_Event_Collect(void)
+{
+    uint8_t socket_ir = 0;
+    uint8_t ir = 0;
+
+    g_w5500_event_pending = 0;                                                  // 先清标志，读寄存器期间的新下降沿不会丢失
+
+    socket_ir = getSIR() & g_w5500_event_socket_mask;
+
+    for (uint8_t i = 0; i < W5500_SOCKET_COUNT; i++)
+    {
+        if ((socket_ir & (1 << i)) == 0)
+        {
+            continue;
+        }
+
+        ir = getSn_IR(i) & getSn_IMR(i);
+        if (ir == 0)
+        {
+            continue;
+        }
+
+        // 通过ctlsocket()清除中断，清除SENDOK时同时清除socket库的发送中标志
+        ctlsocket(i, CS_CLR_INTERRUPT, &ir);
+
+        for (uint8_t j = 0; j < sizeof(g_w5500_event_order); j++)
+        {
+            if (ir & g_w5500_event_order[j])
+            {
+                W5500_Event_Push(i, g_w5500_event_order[j]);
+            }
+        }
+    }
+}
+
+/**
+ * @brief W5500事件处理函数，在主循环中调用，不会阻塞
+ * 
+ * @note 有下降沿或者INT引脚仍为低电平时才访问SPI，然后把队列中的事件分发给回调函数
+ */
+void W5500_Event_Process(void)
+{
+    W5500_EventQueue_t *queue = NULL;
+    uint8_t event = 0;
+
+    // 处理事件期间又产生的中断不会再有下降沿，所以还要检查引脚电平
+    if (g_w5500_event_pending || HAL_GPIO_ReadPin(W5500_INTERRUPT_GPIO_PORT, W5500_INTERRUPT_GPIO_PIN) == GPIO_PIN_RESET)
+    {
+        W5500_Event_Collect();
+    }
+
+    for (uint8_t i = 0; i < W5500_SOCKET_COUNT; i++)
+    {
+        if (g_w5500_event_callback[i] == NULL)
+        {
+            continue;
+        }
+
+        queue = &g_w5500_event_queue[i];
+        while (queue->head != queue->tail)
+        {
+            event = queue->events[queue->head & (W5500_EVENT_QUEUE_SIZE - 1)];
+            queue->head++;
+            g_w5500_event_callback[i](i, event);
+        }
+    }
+}
+
+/**
+ * @brief 获取socket的一个事件
+ * 
+ * @param socket_index socket索引
+ * @return uint8_t 事件，W5500_EVENT_XXX，0表示没有事件
+ */
+uint8_t W5500_Event_Get(uint8_t socket_index)
+{
+    W5500_EventQueue_t *queue = NULL;
+    uint8_t event = 0;
+
+    if (socket_index >= W5500_SOCKET_COUNT)
+    {
+        return 0;
+    }
+
+    queue = &g_w5500_event_queue[socket_index];
+    if (queue->head == queue->tail)
+    {
+        return 0;
+    }
+
+    event = queue->events[queue->head & (W5500_EVENT_QUEUE_SIZE - 1)];
+    queue->head++;
+
+    return event;
+}
\ No newline at end of file
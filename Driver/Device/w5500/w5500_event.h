@@ -0,0 +1,40 @@
+#ifndef __W5500_EVENT_H__
+#define __W5500_EVENT_H__
+
+#include "socket.h"
+
+#include "bsp_exti.h"
+
+#include "w5500/w5500_device.h"
+
+#define W5500_SOCKET_COUNT          _WIZCHIP_SOCK_NUM_
+
+#define W5500_EVENT_QUEUE_SIZE      8                                           // 每个socket的事件队列长度，必须是2的幂
+
+// socket事件，取值与Sn_IR寄存器的位一致
+#define W5500_EVENT_CON             Sn_IR_CON                                   // 建立连接
+#define W5500_EVENT_DISCON          Sn_IR_DISCON                                // 收到FIN或者FIN/ACK
+#define W5500_EVENT_RECV            Sn_IR_RECV                                  // 接收到数据
+#define W5500_EVENT_TIMEOUT         Sn_IR_TIMEOUT                               // ARP或者TCP超时
+#define W5500_EVENT_SENDOK          Sn_IR_SENDOK                                // 发送完成
+#define W5500_EVENT_ALL             (W5500_EVENT_CON | W5500_EVENT_DISCON | W5500_EVENT_RECV | W5500_EVENT_TIMEOUT | W5500_EVENT_SENDOK)
+
+typedef void (*W5500_EventCallback_t)(uint8_t socket_index, uint8_t event);
+
+typedef struct W5500_EventQueue_t
+{
+    uint8_t events[W5500_EVENT_QUEUE_SIZE];
+    uint8_t head;                                                               // 读位置
+    uint8_t tail;                                                               // 写位置
+    uint16_t overflow;                                                          // 队列满丢弃的事件数
+} W5500_EventQueue_t;
+
+void W5500_Event_Init(void);
+void W5500_Event_Enable(uint8_t socket_index, uint8_t event_mask, W5500_EventCallback_t callback);
+void W5500_Event_Disable(uint8_t socket_index);
+
+void W5500_Event_IRQHandler(void);
+void W5500_Event_Process(void);
+uint8_t W5500_Event_Get(uint8_t socket_index);
+
+#endif // !__W5500_EVENT_H__
\ No newline at end of file
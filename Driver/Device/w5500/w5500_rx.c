@@ -0,0 +1,156 @@
+#include "w5500_rx.h"
+
+static W5500_RxWindow_t g_w5500_rx_window[W5500_SOCKET_COUNT];
+
+/**
+ * @brief 给socket设置接收窗口
+ * 
+ * @param socket_index socket索引
+ * @param buffer 接收窗口的缓冲区
+ * @param size 缓冲区大小，必须是2的幂
+ * @return int8_t 0: 成功; -1: 参数错误
+ */
+int8_t W5500_RX_Attach(uint8_t socket_index, uint8_t *buffer, uint16_t size)
+{
+    if (socket_index >= W5500_SOCKET_COUNT || buffer == NULL || size == 0 || (size & (size - 1)) != 0)
+    {
+        return -1;
+    }
+
+    g_w5500_rx_window[socket_index].buffer = buffer;
+    g_w5500_rx_window[socket_index].size = size;
+    W5500_RX_Reset(socket_index);
+
+    return 0;
+}
+
+/**
+ * @brief 清空接收窗口，socket重新打开时调用
+ * 
+ * @param socket_index socket索引
+ */
+void W5500_RX_Reset(uint8_t socket_index)
+{
+    g_w5500_rx_window[socket_index].head = 0;
+    g_w5500_rx_window[socket_index].count = 0;
+}
+
+/**
+ * @brief 查看接收到的数据，不移动Sn_RX_RD
+ * 
+ * @param socket_index socket索引
+ * @param view 保存数据视图
+ * @return uint16_t 接收窗口装不下，还留在W5500中的字节数
+ * 
+ * @note 只从W5500读出上次之后新到的数据，已经在窗口中的数据不会重复读取
+ */
+uint16_t W5500_RX_Peek(uint8_t socket_index, W5500_RxView_t *view)
+{
+    W5500_RxWindow_t *window = &g_w5500_rx_window[socket_index];
+    uint16_t received = 0;
+    uint16_t length = 0;
+    uint16_t position = 0;
+    uint16_t first = 0;
+
+    view->total = 0;
+    view->length[0] = 0;
+    view->length[1] = 0;
+
+    if (window->buffer == NULL)
+    {
+        return 0;
+    }
+
+    // Sn_RX_RSR包括窗口中还没有消费的数据
+    received = getSn_RX_RSR(socket_index);
+    if (received < window->count)
+    {
+        W5500_RX_Reset(socket_index);                                           // socket重新打开过，窗口中的数据已经无效
+    }
+    length = (received > window->size ? window->size : received) - window->count;
+
+    if (length > 0)
+    {
+        position = (window->head + window->count) & (window->size - 1);
+        first = window->size - position;
+        if (first > length)
+        {
+            first = length;
+        }
+
+        wiz_recv_peek(socket_index, window->count, window->buffer + position, first);
+        if (length > first)
+        {
+            wiz_recv_peek(socket_index, window->count + first, window->buffer, length - first);
+        }
+        window->count += length;
+    }
+
+    view->data[0] = window->buffer + window->head;
+    view->length[0] = window->size - window->head;
+    if (view->length[0] > window->count)
+    {
+        view->length[0] = window->count;
+    }
+    view->data[1] = window->buffer;
+    view->length[1] = window->count - view->length[0];
+    view->total = window->count;
+
+    return received - window->count;
+}
+
+/**
+ * @brief 消费接收到的数据，Sn_RX_RD只前进消费的字节数
+ * 
+ * @param socket_index socket索引
+ * @param length 消费的字节数
+ */
+void W5500_RX_Consume(uint8_t socket_index, uint16_t length)
+{
+    W5500_RxWindow_t *window = &g_w5500_rx_window[socket_index];
+
+    if (length > window->count)
+    {
+        length = window->count;
+    }
+
+    if (length == 0)
+    {
+        return;
+    }
+
+    wiz_recv_ignore(socket_index, length);
+    setSn_CR(socket_index, Sn_CR_RECV);                                         // 通知W5500释放接收缓冲区
+    while (getSn_CR(socket_index));
+
+    window->head = (window->head + length) & (window->size - 1);
+    window->count -= length;
+}
+
+/**
+ * @brief 获取接收窗口中还没有消费的字节数
+ * 
+ * @param socket_index socket索引
+ * @return uint16_t 字节数
+ */
+uint16_t W5500_RX_Buffered(uint8_t socket_index)
+{
+    return g_w5500_rx_window[socket_index].count;
+}
+
+/**
+ * @brief 获取视图中的一个字节
+ * 
+ * @param view 数据视图
+ * @param index 字节的索引，必须小于view->total
+ * @return uint8_t 字节
+ */
+uint8_t W5500_RX_ViewAt(const W5500_RxView_t *view, uint16_t index)
+{
+    if (index < view->length[0])
+    {
+        return view->data[0][index];
+    }
+
+    return view->data[1][index - view->length[0]];
+}
\ No newline at end of file
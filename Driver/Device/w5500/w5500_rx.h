@@ -0,0 +1,35 @@
+#ifndef __W5500_RX_H__
+#define __W5500_RX_H__
+
+#include "socket.h"
+
+#include "w5500/w5500_device.h"
+#include "w5500/w5500_event.h"
+
+// 接收数据的视图，环形缓冲区回绕时分成两段
+typedef struct W5500_RxView_t
+{
+    uint8_t *data[2];
+    uint16_t length[2];
+    uint16_t total;                                                             // 两段的总长度
+} W5500_RxView_t;
+
+// socket接收窗口，在MCU这边按环形缓冲区的方式保存从W5500读出来但还没有被消费的数据
+typedef struct W5500_RxWindow_t
+{
+    uint8_t *buffer;
+    uint16_t size;                                                              // 缓冲区大小，必须是2的幂
+    uint16_t head;                                                              // 第一个未消费字节的位置
+    uint16_t count;                                                             // 已经读出来还没有消费的字节数
+} W5500_RxWindow_t;
+
+int8_t W5500_RX_Attach(uint8_t socket_index, uint8_t *buffer, uint16_t size);
+void W5500_RX_Reset(uint8_t socket_index);
+
+uint16_t W5500_RX_Peek(uint8_t socket_index, W5500_RxView_t *view);
+void W5500_RX_Consume(uint8_t socket_index, uint16_t length);
+uint16_t W5500_RX_Buffered(uint8_t socket_index);
+
+uint8_t W5500_RX_ViewAt(const W5500_RxView_t *view, uint16_t index);
+
+#endif // !__W5500_RX_H__
\ No newline at end of file
@@ -7,6 +7,8 @@ uint8_t g_w5500_connect_cloud_status = 0;
  * 
  * @param socket_index socket索引
  * @param monitor_port 监听的端口
+ * 
+ * @note 不会阻塞，需要在主循环中反复调用；多个连接使用W5500_TCPServer_Listen()
  */
 void W5500_TCP_Server(uint8_t socket_index, uint16_t monitor_port)
 {
@@ -19,11 +21,11 @@ void W5500_TCP_Server(uint8_t socket_index, uint16_t monitor_port)
         // 如果成功，返回socket索引
         if (socket(socket_index, Sn_MR_TCP, monitor_port, SF_TCP_NODELAY) == socket_index)
         {
-            printf("socket %d 打开成功\r\n", socket_index);
+            BINLOG("socket %d 打开成功\r\n", socket_index);
         }
         else
         {
-            printf("socket %d 打开失败\r\n", socket_index);
+            BINLOG("socket %d 打开失败\r\n", socket_index);
         }
         break;
     
@@ -32,19 +34,19 @@ void W5500_TCP_Server(uint8_t socket_index, uint16_t monitor_port)
         switch (listen(socket_index))
         {
         case SOCK_OK:
-            printf("socket %d 监听成功\r\n", socket_index);
+            BINLOG("socket %d 监听成功\r\n", socket_index);
             break;
         
         case SOCKERR_SOCKINIT:
-            printf("还未初始化 socket %d\r\n", socket_index);
+            BINLOG("还未初始化 socket %d\r\n", socket_index);
             break;
         
         case SOCKERR_SOCKCLOSED:
-            printf("socket %d 意外关闭\r\n", socket_index);
+            BINLOG("socket %d 意外关闭\r\n", socket_index);
             break;
 
         default:
-            printf("socket %d 监听失败\r\n", socket_index);
+            BINLOG("socket %d 监听失败\r\n", socket_index);
             break;
         }
         break;
@@ -57,37 +59,36 @@ void W5500_TCP_Server(uint8_t socket_index, uint16_t monitor_port)
         // 获取目标的IP地址和端口号
         getSn_DIPR(socket_index, cliendIP);
         cliendPort = getSn_DPORT(socket_index);
-        printf("客户端（%d.%d.%d.%d: %d）建立连接\r\n", cliendIP[0], cliendIP[1], cliendIP[2], cliendIP[3], cliendPort);
 
-        // 在这里实现正常通信
-        while (1)
+        if (getSn_IR(socket_index) & Sn_IR_CON)
         {
-            // 等待客户端发送信息
-            while ((getSn_IR(socket_index) & Sn_IR_RECV) == 0)                  // 通过中断寄存器的REVE位来判断
-            {
-                // 在客户端发送信息时，客户端有可能断开，连接状态发生变化
-                if (getSn_SR(socket_index) != SOCK_ESTABLISHED)
-                {
-                    printf("socket %d 连接发生变化\r\n", socket_index);
-                    close(socket_index);                                        // 关闭Socket
-                    return;
-                }
-            }
-            setSn_IR(socket_index, Sn_IR_RECV);                                 // 接收到数据了，清除中断标志位，写1清除，写0无效
-            length = getSn_RX_RSR(socket_index);                                // 获取接收到数据长度
-            if (length > 0)
-            {
-                memset(g_w5500_data_buff, 0, length + 1);
-                recv(socket_index, g_w5500_data_buff, length);                  // 接收数据
-                printf("客户端（%d.%d.%d.%d: %d）发来数据：%s\r\n", cliendIP[0], cliendIP[1], cliendIP[2], cliendIP[3], cliendPort, g_w5500_data_buff);
-                send(socket_index, g_w5500_data_buff, length);                  // 发送回客户端数据
-            }
+            setSn_IR(socket_index, Sn_IR_CON);                                  // 只在建立连接后打印一次
+            BINLOG("客户端（%d.%d.%d.%d: %d）建立连接\r\n", cliendIP[0], cliendIP[1], cliendIP[2], cliendIP[3], cliendPort);
+        }
+
+        // 每次调用只处理一次接收，不在这里等待，主循环还要处理其它事情
+        if ((getSn_IR(socket_index) & Sn_IR_RECV) == 0)                         // 通过中断寄存器的REVE位来判断
+        {
+            break;
+        }
+        setSn_IR(socket_index, Sn_IR_RECV);                                     // 接收到数据了，清除中断标志位，写1清除，写0无效
+        length = getSn_RX_RSR(socket_index);                                    // 获取接收到数据长度
+        if (length > DATA_BUFFER_SIZE - 1)
+        {
+            length = DATA_BUFFER_SIZE - 1;                                      // 留一个字节保存字符串结束符
+        }
+        if (length > 0)
+        {
+            recv(socket_index, g_w5500_data_buff, length);                      // 接收数据
+            g_w5500_data_buff[length] = '\0';
+            printf("客户端（%d.%d.%d.%d: %d）发来数据：%s\r\n", cliendIP[0], cliendIP[1], cliendIP[2], cliendIP[3], cliendPort, g_w5500_data_buff);
+            send(socket_index, g_w5500_data_buff, length);                      // 发送回客户端数据
         }
         break;
 
     case SOCK_CLOSE_WAIT:
         // 如果处于半不关闭状态，直接关闭socket
-        printf("服务端（%d.%d.%d.%d）异常关闭\r\n", g_w5500_net_info.ip[0], g_w5500_net_info.ip[1], g_w5500_net_info.ip[2], g_w5500_net_info.ip[3]);
+        BINLOG("服务端（%d.%d.%d.%d）异常关闭\r\n", g_w5500_net_info.ip[0], g_w5500_net_info.ip[1], g_w5500_net_info.ip[2], g_w5500_net_info.ip[3]);
         close(socket_index);
 
     default:
@@ -114,30 +115,30 @@ void W5500_TCP_Client(uint8_t socket_index, uint16_t port, uint8_t *server_ip, u
         // 如果成功，返回socket索引
         if (socket(socket_index, Sn_MR_TCP, port, SF_TCP_NODELAY) == socket_index)
         {
-            printf("socket %d 打开成功\r\n", socket_index);
+            BINLOG("socket %d 打开成功\r\n", socket_index);
         }
         else
         {
-            printf("socket %d 打开失败\r\n", socket_index);
+            BINLOG("socket %d 打开失败\r\n", socket_index);
         }
         break;
   
     case SOCK_INIT:                                                             // 表示Socket已经打开了
         if (connect(socket_index, server_ip, server_port) == SOCK_OK)            // 作为客户端主动连接服务器
         {
-            printf("socket %d 连接服务器成功\r\n", socket_index);
+            BINLOG("socket %d 连接服务器成功\r\n", socket_index);
         }
         else
         {
             close(socket_index);                                                // 关闭socket
-            printf("socket %d 连接服务器失败\r\n", socket_index);
+            BINLOG("socket %d 连接服务器失败\r\n", socket_index);
         }
         break;
 
     case SOCK_ESTABLISHED:                                                      // 表示Socket连接建立成功
         uint16_t length = 0;
 
-        printf("连接服务端（%d.%d.%d.%d: %d）成功\r\n", server_ip[0], server_ip[1], server_ip[2], server_ip[3], server_port);
+        BINLOG("连接服务端（%d.%d.%d.%d: %d）成功\r\n", server_ip[0], server_ip[1], server_ip[2], server_ip[3], server_port);
 
         // 客户端往服务端发送数据
         send(socket_index, (uint8_t *)"Hello World!", 12);
@@ -151,17 +152,21 @@ void W5500_TCP_Client(uint8_t socket_index, uint16_t port, uint8_t *server_ip, u
                 // 在服务端返回信息时，服务端有可能断开，连接状态发生变化
                 if (getSn_SR(socket_index) != SOCK_ESTABLISHED)
                 {
-                    printf("socket %d 连接发生变化\r\n", socket_index);
+                    BINLOG("socket %d 连接发生变化\r\n", socket_index);
                     close(socket_index);                                        // 关闭Socket
                     return;
                 }
             }
             setSn_IR(socket_index, Sn_IR_RECV);                                 // 接收到数据了，清除中断标志位，写1清除，写0无效
             length = getSn_RX_RSR(socket_index);                                // 获取接收到数据长度
+            if (length > DATA_BUFFER_SIZE - 1)
+            {
+                length = DATA_BUFFER_SIZE - 1;                                  // 留一个字节保存字符串结束符
+            }
             if (length > 0)
             {
-                memset(g_w5500_data_buff, 0, length + 1);
                 recv(socket_index, g_w5500_data_buff, length);                  // 接收数据
+                g_w5500_data_buff[length] = '\0';
                 printf("服务端（%d.%d.%d.%d: %d）返回数据：%s\r\n", server_ip[0], server_ip[1], server_ip[2], server_ip[3], server_port, g_w5500_data_buff);
                 send(socket_index, g_w5500_data_buff, length);                  // 发送回服务端数据
             }
@@ -170,7 +175,7 @@ void W5500_TCP_Client(uint8_t socket_index, uint16_t port, uint8_t *server_ip, u
 
     case SOCK_CLOSE_WAIT:
         // 如果处于半不关闭状态，直接关闭socket
-        printf("客户端（%d.%d.%d.%d: %d）异常关闭\r\n", g_w5500_net_info.ip[0], g_w5500_net_info.ip[1], g_w5500_net_info.ip[2], g_w5500_net_info.ip[3], port);
+        BINLOG("客户端（%d.%d.%d.%d: %d）异常关闭\r\n", g_w5500_net_info.ip[0], g_w5500_net_info.ip[1], g_w5500_net_info.ip[2], g_w5500_net_info.ip[3], port);
         close(socket_index);
 
     default:
@@ -200,11 +205,11 @@ void W5500_ConnectCloudServer(uint8_t socket_index, uint16_t port, uint8_t *serv
         // 如果成功，返回socket索引
         if (socket(socket_index, Sn_MR_TCP, port, SF_TCP_NODELAY) == socket_index)
         {
-            printf("socket %d 打开成功\r\n", socket_index);
+            BINLOG("socket %d 打开成功\r\n", socket_index);
         }
         else
         {
-            printf("socket %d 打开失败\r\n", socket_index);
+            BINLOG("socket %d 打开失败\r\n", socket_index);
         }
         g_w5500_connect_cloud_status = 0;
         break;
@@ -212,12 +217,12 @@ void W5500_ConnectCloudServer(uint8_t socket_index, uint16_t port, uint8_t *serv
     case SOCK_INIT:                                                             // 表示Socket已经打开了
         if (connect(socket_index, server_ip, server_port) == SOCK_OK)           // 作为客户端主动连接服务器
         {
-            printf("socket %d 连接服务器成功\r\n", socket_index);
+            BINLOG("socket %d 连接服务器成功\r\n", socket_index);
         }
         else
         {
             close(socket_index);                                                // 关闭socket
-            printf("socket %d 连接服务器失败\r\n", socket_index);
+            BINLOG("socket %d 连接服务器失败\r\n", socket_index);
         }
         g_w5500_connect_cloud_status = 0;
         break;
@@ -227,8 +232,16 @@ void W5500_ConnectCloudServer(uint8_t socket_index, uint16_t port, uint8_t *serv
 
         if (g_w5500_connect_cloud_status == 0)
         {
-            memset(g_w5500_data_buff, 0, DATA_BUFFER_SIZE);
-            length = MQTT_ConnectMessage(g_w5500_data_buff, client_id, username, password);
+            // 按主题注册表的协议版本构建连接包，默认MQTT 3.1.1，MQTT_Topic_Init()可以切换到MQTT 5
+            if (g_mqtt_topic_registry.version == MQTT_PROTOCOL_VERSION_5)
+            {
+                length = MQTT_ConnectMessageV5(g_w5500_data_buff, client_id, username, password);
+            }
+            else
+            {
+                length = MQTT_ConnectMessage(g_w5500_data_buff, client_id, username, password);
+            }
+
             // 客户端往服务端发送数据，返回成功发送的数据大小
             if (send(socket_index, g_w5500_data_buff, length) == length)
             {
@@ -239,7 +252,7 @@ void W5500_ConnectCloudServer(uint8_t socket_index, uint16_t port, uint8_t *serv
                     uint8_t status = getSn_SR(socket_index);
                     if (status != SOCK_ESTABLISHED)
                     {
-                        printf("socket %d 连接发生变化，状态值为：%#x\r\n", socket_index, status);
+                        BINLOG("socket %d 连接发生变化，状态值为：%#x\r\n", socket_index, status);
                         close(socket_index);                                    // 关闭Socket
                         g_w5500_connect_cloud_status = 0;
                         return;
@@ -248,20 +261,27 @@ void W5500_ConnectCloudServer(uint8_t socket_index, uint16_t port, uint8_t *serv
                 setSn_IR(socket_index, Sn_IR_RECV);                             // 接收到数据了，清除中断标志位，写1清除，写0无效
                 
                 length = getSn_RX_RSR(socket_index);                            // 获取接收到数据长度
+                if (length > DATA_BUFFER_SIZE)
+                {
+                    length = DATA_BUFFER_SIZE;
+                }
                 
-                if (length == 4)
+                if (length > 0)
                 {
-                    memset(g_w5500_data_buff, 0, length + 1);
+                    uint16_t alias_maximum = 0;
+
+                    // MQTT 5的CONNACK带属性，长度不固定，交给MQTT_ParseConnAck()解析
                     recv(socket_index, g_w5500_data_buff, length);              // 接收数据
                     
-                    if (g_w5500_data_buff[0] == 0x20 && g_w5500_data_buff[1] == 0x02)
+                    if (MQTT_ParseConnAck(g_w5500_data_buff, length, &alias_maximum) == 0)
                     {
-                        printf("阿里云连接成功\r\n");
+                        BINLOG("阿里云连接成功，主题别名最大值：%d\r\n", alias_maximum);
+                        MQTT_Topic_SetAliasMaximum(alias_maximum);              // 别名只在本次连接内有效，重新分配并绑定
                         g_w5500_connect_cloud_status = 1;
                     }
                     else
                     {
-                        printf("阿里云连接失败\r\n");
+                        BINLOG("阿里云连接失败\r\n");
                         close(socket_index);                                    // 关闭socket
                         g_w5500_connect_cloud_status = 0;
                     }
@@ -303,7 +323,7 @@ uint8_t W5500_MQTT_KeepAlive(uint8_t socket_index)
                     uint8_t status = getSn_SR(socket_index);
                     if (status != SOCK_ESTABLISHED)
                     {
-                        printf("socket %d 连接发生变化，状态值为：%#x\r\n", socket_index, status);
+                        BINLOG("socket %d 连接发生变化，状态值为：%#x\r\n", socket_index, status);
                         close(socket_index);                                    // 关闭Socket
                         g_w5500_connect_cloud_status = 0;
                         return 0;
@@ -320,7 +340,7 @@ uint8_t W5500_MQTT_KeepAlive(uint8_t socket_index)
                     
                     if (response[0] == 0xD0 && response[1] == 0x00)
                     {
-                        printf("心跳响应成功\r\n");
+                        BINLOG("心跳响应成功\r\n");
                         break;
                     }
                 } 
@@ -333,18 +353,61 @@ uint8_t W5500_MQTT_KeepAlive(uint8_t socket_index)
     return (i == 5) ? 0 : 1;
 }
 
+/**
+ * @brief W5500通过已注册的主题句柄发布MQTT消息
+ * 
+ * @param socket_index socket索引
+ * @param topic_handle 主题句柄，由MQTT_Topic_Register()返回
+ * @param message 发布消息
+ * @param length 发布消息长度
+ * @param QoS 发布质量, 0: 最多分发一次; 1: 至少分发一次; 2: 只分发一次
+ * @return int32_t 成功发送的字节数，小于等于0表示发送失败
+ */
+int32_t W5500_MQTT_Publish(uint8_t socket_index, uint8_t topic_handle, uint8_t *message, uint16_t length, uint8_t QoS)
+{
+    uint16_t packet_length = 0;
+    int32_t result = 0;
+
+    if (g_w5500_connect_cloud_status == 0)
+    {
+        return 0;
+    }
+
+    // 报文头部最多为：固定报头（5）+ 主题（2 + MQTT_TOPIC_MAX_LENGTH）+ 报文标识符（2）+ 属性（4）
+    if (length > DATA_BUFFER_SIZE - (MQTT_TOPIC_MAX_LENGTH + 13))
+    {
+        return 0;
+    }
+
+    packet_length = MQTT_PublishTopicMessage(g_w5500_data_buff, topic_handle, message, length, 0, QoS, 0);
+    if (packet_length == 0)
+    {
+        return 0;
+    }
+
+    result = send(socket_index, g_w5500_data_buff, packet_length);
+    if (result == packet_length)
+    {
+        MQTT_Topic_BindAlias(topic_handle);                                     // 整包发送出去后服务端才知道别名对应的主题
+    }
+
+    return result;
+}
+
 /**
  * @brief TCP发送数据
  * 
  * @param socket_index socket索引
  * @param data 发送数据缓冲区
  * @param length 发送数据长度
+ * 
+ * @note 使能发送合并后需要在主循环中调用W5500_Coalesce_Process()发送到期的数据
  */
 void TCP_SendData(uint8_t socket_index, uint8_t *data, uint16_t length)
 {                                 
     if (getSn_SR(socket_index) == SOCK_ESTABLISHED)                             // 获取Socket状态
     {
-        send(socket_index, data, length);                                       // 发送数据
+        W5500_Coalesce_Write(socket_index, data, length);                       // 发送数据，使能了发送合并时小数据会先合并
     }
 }
 
@@ -6,13 +6,16 @@
 #include "bsp_uart.h"
 
 #include "w5500/w5500_device.h"
+#include "w5500/w5500_coalesce.h"
 
 #include "mqtt/mqtt.h"
+#include "binlog/binlog.h"
 
 void W5500_TCP_Server(uint8_t socket_index, uint16_t monitor_port);
 void W5500_TCP_Client(uint8_t socket_index, uint16_t port, uint8_t *server_ip, uint16_t server_port);
 void W5500_ConnectCloudServer(uint8_t socket_index, uint16_t port, uint8_t *server_ip, uint16_t server_port, char *client_id, char *username, char *password);
 uint8_t W5500_MQTT_KeepAlive(uint8_t socket_index);
+int32_t W5500_MQTT_Publish(uint8_t socket_index, uint8_t topic_handle, uint8_t *message, uint16_t length, uint8_t QoS);
 
 void TCP_SendData(uint8_t socket_index, uint8_t *data, uint16_t length);
 void TCP_ReceiveData(uint8_t socket_index, uint8_t *data, uint16_t *length);
@@ -0,0 +1,281 @@
+#include "w5500_tcp_server.h"
+
+W5500_TCPConnection_t g_w5500_tcp_connection[W5500_SOCKET_COUNT];
+
+static uint8_t g_w5500_tcp_server_rx_window[W5500_SOCKET_COUNT][W5500_TCP_SERVER_RX_WINDOW_SIZE];
+
+/**
+ * @brief TCP服务器的socket事件回调函数
+ * 
+ * @param socket_index socket索引
+ * @param event 事件
+ */
+static void W5500_TCPServer_EventCallback(uint8_t socket_index, uint8_t event)
+{
+    g_w5500_tcp_connection[socket_index].events |= event;
+}
+
+/**
+ * @brief TCP服务器开始监听
+ * 
+ * @param port 监听的端口
+ * @param first_socket 使用的第一个socket索引
+ * @param socket_count 使用的socket个数，也就是同一个端口最多同时连接的客户端个数
+ * @param handler 连接的处理函数
+ * @return int8_t SOCK_OK: 成功; SOCKERR_SOCKNUM: socket索引超出范围或者已经被使用
+ */
+int8_t W5500_TCPServer_Listen(uint16_t port, uint8_t first_socket, uint8_t socket_count, const W5500_TCPServerHandler_t *handler)
+{
+    W5500_TCPConnection_t *connection = NULL;
+
+    if (first_socket + socket_count > W5500_SOCKET_COUNT || handler == NULL)
+    {
+        return SOCKERR_SOCKNUM;
+    }
+
+    for (uint8_t i = first_socket; i < first_socket + socket_count; i++)
+    {
+        if (g_w5500_tcp_connection[i].state != W5500_TCP_CONN_UNUSED)
+        {
+            return SOCKERR_SOCKNUM;
+        }
+    }
+
+    for (uint8_t i = first_socket; i < first_socket + socket_count; i++)
+    {
+        connection = &g_w5500_tcp_connection[i];
+        connection->state = W5500_TCP_CONN_CLOSED;                              // 在W5500_TCPServer_Process()中打开监听
+        connection->port = port;
+        connection->events = 0;
+        connection->handler = handler;
+        W5500_RX_Attach(i, g_w5500_tcp_server_rx_window[i], W5500_TCP_SERVER_RX_WINDOW_SIZE);
+
+        // SENDOK由send()自己查询，这里不使能
+        W5500_Event_Enable(i, W5500_EVENT_CON | W5500_EVENT_DISCON | W5500_EVENT_RECV | W5500_EVENT_TIMEOUT, W5500_TCPServer_EventCallback);
+    }
+
+    return SOCK_OK;
+}
+
+/**
+ * @brief 停止socket上的TCP服务器
+ * 
+ * @param socket_index socket索引
+ */
+void W5500_TCPServer_Stop(uint8_t socket_index)
+{
+    if (socket_index >= W5500_SOCKET_COUNT || g_w5500_tcp_connection[socket_index].state == W5500_TCP_CONN_UNUSED)
+    {
+        return;
+    }
+
+    W5500_Event_Disable(socket_index);
+    close(socket_index);
+    g_w5500_tcp_connection[socket_index].state = W5500_TCP_CONN_UNUSED;
+}
+
+/**
+ * @brief 连接断开，通知处理函数并进入关闭状态
+ * 
+ * @param socket_index socket索引
+ * @param state 下一个状态
+ */
+static void W5500_TCPServer_Disconnected(uint8_t socket_index, W5500_TCPConnState_t state)
+{
+    W5500_TCPConnection_t *connection = &g_w5500_tcp_connection[socket_index];
+
+    connection->state = state;
+    connection->tick = HAL_GetTick();
+    W5500_Coalesce_Discard(socket_index);                                       // 连接已经断开，没有发出去的数据也不用发了
+
+    if (connection->handler->on_disconnect != NULL)
+    {
+        connection->handler->on_disconnect(socket_index);
+    }
+}
+
+/**
+ * @brief 把接收到的数据交给处理函数
+ * 
+ * @param socket_index socket索引
+ * 
+ * @note 处理函数直接在接收窗口中解析数据，每次最多处理一个窗口，剩余的数据在下一轮处理，避免一个连接占用其它连接的时间。
+ *       窗口满了处理函数返回0时按消息过长处理，关闭连接并调用on_disconnect
+ */
+static void W5500_TCPServer_Receive(uint8_t socket_index)
+{
+    W5500_TCPConnection_t *connection = &g_w5500_tcp_connection[socket_index];
+    W5500_RxView_t view = {0};
+    uint16_t remain = 0;
+    uint16_t consumed = 0;
+    W5500_CoalesceStats_t before = {0};
+    W5500_CoalesceStats_t after = {0};
+
+    connection->events &= ~W5500_EVENT_RECV;
+
+    remain = W5500_RX_Peek(socket_index, &view);
+    if (view.total == 0)
+    {
+        return;
+    }
+
+    W5500_Coalesce_GetStats(socket_index, &before);
+    consumed = connection->handler->on_receive(socket_index, &view);
+    W5500_Coalesce_GetStats(socket_index, &after);
+
+    // 窗口满了处理函数还是一点都没有消费，说明一条消息比窗口还大，W5500的接收缓冲区也不会再有进展，只能断开
+    if (consumed == 0 && view.total == W5500_TCP_SERVER_RX_WINDOW_SIZE && before.busy == after.busy)
+    {
+        close(socket_index);
+        W5500_TCPServer_Disconnected(socket_index, W5500_TCP_CONN_CLOSED);
+        return;
+    }
+
+    W5500_RX_Consume(socket_index, consumed);
+
+    // W5500中还有数据，处理函数只消费了一部分，或者因为send()返回SOCK_BUSY没有处理完，下一轮继续处理
+    // 其它情况下一点都没有消费说明数据不完整，等待新的数据到来
+    if (remain > 0 || (consumed > 0 && consumed < view.total) || before.busy != after.busy)
+    {
+        connection->events |= W5500_EVENT_RECV;
+    }
+}
+
+/**
+ * @brief 处理一个连接的状态机
+ * 
+ * @param socket_index socket索引
+ */
+static void W5500_TCPServer_Poll(uint8_t socket_index)
+{
+    W5500_TCPConnection_t *connection = &g_w5500_tcp_connection[socket_index];
+
+    switch (connection->state)
+    {
+    case W5500_TCP_CONN_CLOSED:
+        // 非阻塞模式，send()和disconnect()不会等待
+        if (socket(socket_index, Sn_MR_TCP, connection->port, SF_TCP_NODELAY | SF_IO_NONBLOCK) != socket_index)
+        {
+            break;                                                              // 下一轮再试
+        }
+        connection->events = 0;
+        W5500_RX_Reset(socket_index);
+        if (listen(socket_index) == SOCK_OK)
+        {
+            connection->state = W5500_TCP_CONN_LISTEN;
+        }
+        break;
+
+    case W5500_TCP_CONN_LISTEN:
+        if (connection->events & (W5500_EVENT_DISCON | W5500_EVENT_TIMEOUT))
+        {
+            close(socket_index);
+            connection->state = W5500_TCP_CONN_CLOSED;
+            break;
+        }
+
+        if ((connection->events & W5500_EVENT_CON) == 0)
+        {
+            break;
+        }
+
+        connection->events &= ~W5500_EVENT_CON;
+        connection->state = W5500_TCP_CONN_ESTABLISHED;
+        connection->tick = HAL_GetTick();
+        getSn_DIPR(socket_index, connection->remote_ip);                        // 获取客户端的IP地址和端口号
+        connection->remote_port = getSn_DPORT(socket_index);
+
+        if (connection->handler->on_connect != NULL)
+        {
+            connection->handler->on_connect(socket_index);
+        }
+        // 同一次读取到的RECV事件直接处理
+        // fall through
+
+    case W5500_TCP_CONN_ESTABLISHED:
+        if (connection->events & W5500_EVENT_TIMEOUT)
+        {
+            close(socket_index);
+            W5500_TCPServer_Disconnected(socket_index, W5500_TCP_CONN_CLOSED);
+            break;
+        }
+
+        if (connection->events & W5500_EVENT_RECV)
+        {
+            W5500_TCPServer_Receive(socket_index);
+        }
+
+        // 客户端发送FIN之后，先把剩下的数据读完再断开
+        if ((connection->events & W5500_EVENT_DISCON) && (connection->events & W5500_EVENT_RECV) == 0 && connection->state == W5500_TCP_CONN_ESTABLISHED)
+        {
+            if (getSn_RX_RSR(socket_index) > W5500_RX_Buffered(socket_index))
+            {
+                connection->events |= W5500_EVENT_RECV;
+                break;
+            }
+            disconnect(socket_index);
+            W5500_TCPServer_Disconnected(socket_index, W5500_TCP_CONN_CLOSING);
+        }
+        break;
+
+    case W5500_TCP_CONN_CLOSING:
+        if (getSn_SR(socket_index) == SOCK_CLOSED || HAL_GetTick() - connection->tick > W5500_TCP_SERVER_CLOSE_TIMEOUT)
+        {
+            close(socket_index);
+            connection->state = W5500_TCP_CONN_CLOSED;                          // 下一轮重新监听
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief TCP服务器处理函数，在主循环中调用，不会阻塞
+ * 
+ * @note 需要同时调用W5500_Event_Process()来获取socket事件
+ */
+void W5500_TCPServer_Process(void)
+{
+    for (uint8_t i = 0; i < W5500_SOCKET_COUNT; i++)
+    {
+        W5500_TCPServer_Poll(i);
+    }
+}
+
+/**
+ * @brief TCP服务器发送数据
+ * 
+ * @param socket_index socket索引
+ * @param data 发送数据缓冲区
+ * @param length 发送数据长度
+ * @return int32_t 成功发送的字节数; SOCK_BUSY: 发送缓冲区空间不够; 其它负数: 发送失败
+ */
+int32_t W5500_TCPServer_Send(uint8_t socket_index, uint8_t *data, uint16_t length)
+{
+    if (socket_index >= W5500_SOCKET_COUNT || g_w5500_tcp_connection[socket_index].state != W5500_TCP_CONN_ESTABLISHED)
+    {
+        return SOCKERR_SOCKSTATUS;
+    }
+
+    // 使能了发送合并时小数据先合并，发送缓冲区满会记录到W5500_Buffer的统计中
+    return W5500_Coalesce_Write(socket_index, data, length);
+}
+
+/**
+ * @brief TCP服务器主动断开连接
+ * 
+ * @param socket_index socket索引
+ */
+void W5500_TCPServer_Close(uint8_t socket_index)
+{
+    if (socket_index >= W5500_SOCKET_COUNT || g_w5500_tcp_connection[socket_index].state != W5500_TCP_CONN_ESTABLISHED)
+    {
+        return;
+    }
+
+    W5500_Coalesce_Flush(socket_index);                                         // 断开之前把合并的数据发出去
+    disconnect(socket_index);
+    W5500_TCPServer_Disconnected(socket_index, W5500_TCP_CONN_CLOSING);
+}
\ No newline at end of file
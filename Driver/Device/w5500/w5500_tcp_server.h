@@ -0,0 +1,54 @@
+#ifndef __W5500_TCP_SERVER_H__
+#define __W5500_TCP_SERVER_H__
+
+#include "socket.h"
+
+#include "bsp_uart.h"
+
+#include "w5500/w5500_device.h"
+#include "w5500/w5500_event.h"
+#include "w5500/w5500_buffer.h"
+#include "w5500/w5500_rx.h"
+#include "w5500/w5500_coalesce.h"
+
+#define W5500_TCP_SERVER_RX_WINDOW_SIZE     1024                                // 每个连接的接收窗口大小，必须是2的幂
+#define W5500_TCP_SERVER_CLOSE_TIMEOUT      3000                                // 主动断开后等待四次挥手完成的时间，单位ms
+
+// 连接的状态
+typedef enum W5500_TCPConnState_t
+{
+    W5500_TCP_CONN_UNUSED = 0,                                                  // socket没有分配给服务器
+    W5500_TCP_CONN_CLOSED,                                                      // 等待重新打开监听
+    W5500_TCP_CONN_LISTEN,                                                      // 正在监听
+    W5500_TCP_CONN_ESTABLISHED,                                                 // 连接已建立
+    W5500_TCP_CONN_CLOSING,                                                     // 已发送FIN，等待关闭
+} W5500_TCPConnState_t;
+
+typedef struct W5500_TCPServerHandler_t
+{
+    void (*on_connect)(uint8_t socket_index);                                   // 建立连接，可以为NULL
+    uint16_t (*on_receive)(uint8_t socket_index, const W5500_RxView_t *view);   // 接收到数据，返回消费的字节数，没有消费的数据下次还在视图中
+    void (*on_disconnect)(uint8_t socket_index);                                // 连接断开，可以为NULL
+} W5500_TCPServerHandler_t;
+
+typedef struct W5500_TCPConnection_t
+{
+    W5500_TCPConnState_t state;
+    uint16_t port;                                                              // 监听的端口
+    uint8_t remote_ip[4];                                                       // 客户端的IP地址
+    uint16_t remote_port;                                                       // 客户端的端口
+    uint8_t events;                                                             // 待处理的事件，W5500_EVENT_XXX按位或
+    uint32_t tick;                                                              // 进入当前状态的时间
+    const W5500_TCPServerHandler_t *handler;
+} W5500_TCPConnection_t;
+
+extern W5500_TCPConnection_t g_w5500_tcp_connection[W5500_SOCKET_COUNT];
+
+int8_t W5500_TCPServer_Listen(uint16_t port, uint8_t first_socket, uint8_t socket_count, const W5500_TCPServerHandler_t *handler);
+void W5500_TCPServer_Stop(uint8_t socket_index);
+void W5500_TCPServer_Process(void);
+
+int32_t W5500_TCPServer_Send(uint8_t socket_index, uint8_t *data, uint16_t length);
+void W5500_TCPServer_Close(uint8_t socket_index);
+
+#endif // !__W5500_TCP_SERVER_H__
\ No newline at end of file
@@ -5,6 +5,8 @@
  * 
  * @param socket_index socket的索引
  * @param port 端口号
+ * 
+ * @note 不会阻塞，需要在主循环中反复调用；高速发送传感器数据使用W5500_UDPStream
  */
 void W5500_UDP(uint8_t socket_index, uint16_t port)
 {
@@ -26,33 +28,38 @@ void W5500_UDP(uint8_t socket_index, uint16_t port)
         break;
     
     case SOCK_UDP:                                                              // 表示Socket已经打开了
-        uint8_t length = 0;
+        uint16_t length = 0;                                                    // 接收缓冲区最大16KB，不能用uint8_t
         uint8_t targetIP[4];
         uint16_t targetPort = 0;
+        int32_t received = 0;
 
-        while (1)
+        // 每次调用只处理一次接收，不在这里等待
+        if ((getSn_IR(socket_index) & Sn_IR_RECV) == 0)                         // 等待接收数据
         {
-            while ((getSn_IR(socket_index) & Sn_IR_RECV) == 0)                  // 等待接收数据
+            break;
+        }
+        setSn_IR(socket_index, Sn_IR_RECV);                                     // 清除接收标志
+
+        // 对于UDP而言，接收的数据长度比实际接收的数据要大，因为UDP协议在数据前面加了包头，包头长度为8字节，所以要减去8字节
+        length = getSn_RX_RSR(socket_index);                                    // 获取接收数据的长度
+        if (length > 8)
+        {
+            length -= 8;
+            if (length > DATA_BUFFER_SIZE - 1)
             {
-                if (getSn_SR(socket_index) != SOCK_UDP)                         // 如果socket状态不是SOCK_UDP，则跳出循环
-                {
-                    printf("socket %d 意外关闭\r\n", socket_index);
-                    close(socket_index);
-                }
-                
+                length = DATA_BUFFER_SIZE - 1;                                  // 超出的部分recvfrom()下次再读
             }
-            setSn_IR(socket_index, Sn_IR_RECV);                                 // 清除接收标志
-            
-            // 对于UDP而言，接收的数据长度比实际接收的数据要大，因为UDP协议在数据前面加了包头，包头长度为8字节，所以要减去8字节
-            length = getSn_RX_RSR(socket_index);                                // 获取接收数据的长度
-            if (length > 8)
+            received = recvfrom(socket_index, g_w5500_data_buff, length, targetIP, &targetPort);    // 接收数据
+            if (received <= 0)
             {
-                memset(g_w5500_data_buff, 0, length + 1);
-                recvfrom(socket_index, g_w5500_data_buff, length - 8, targetIP, &targetPort);   // 接收数据
-                printf("%d.%d.%d.%d:%d 发来数据：%s\r\n", targetIP[0], targetIP[1], targetIP[2], targetIP[3], targetPort, g_w5500_data_buff);
-                sendto(socket_index, g_w5500_data_buff, length - 8, targetIP, targetPort);      // 发送回对方
+                break;
             }
+            length = received;
+            g_w5500_data_buff[length] = '\0';
+            printf("%d.%d.%d.%d:%d 发来数据：%s\r\n", targetIP[0], targetIP[1], targetIP[2], targetIP[3], targetPort, g_w5500_data_buff);
+            sendto(socket_index, g_w5500_data_buff, length, targetIP, targetPort);  // 发送回对方
         }
+        break;
 
     default:
         break;
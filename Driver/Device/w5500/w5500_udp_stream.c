@@ -0,0 +1,237 @@
+#include "w5500_udp_stream.h"
+
+#include <string.h>
+
+/**
+ * @brief 按大端写入16位数据
+ * 
+ * @param buffer 缓冲区
+ * @param value 数据
+ */
+static void W5500_UDPStream_Put16(uint8_t *buffer, uint16_t value)
+{
+    buffer[0] = value >> 8;
+    buffer[1] = value & 0xFF;
+}
+
+/**
+ * @brief 按大端写入32位数据
+ * 
+ * @param buffer 缓冲区
+ * @param value 数据
+ */
+static void W5500_UDPStream_Put32(uint8_t *buffer, uint32_t value)
+{
+    buffer[0] = value >> 24;
+    buffer[1] = (value >> 16) & 0xFF;
+    buffer[2] = (value >> 8) & 0xFF;
+    buffer[3] = value & 0xFF;
+}
+
+/**
+ * @brief 打开UDP数据流
+ * 
+ * @param stream 数据流
+ * @param socket_index socket索引
+ * @param local_port 本地端口
+ * @param ip 目标IP，224.0.0.0 ~ 239.255.255.255时使用组播
+ * @param port 目标端口
+ * @param sample_size 每个采样的字节数
+ * @return int8_t 0: 成功; -1: 参数错误; -2: socket打开失败
+ * 
+ * @note 每个数据报最多占用socket发送缓冲区的一半，这样上一个数据报还在发送时可以写入下一个
+ */
+int8_t W5500_UDPStream_Open(W5500_UDPStream_t *stream, uint8_t socket_index, uint16_t local_port, uint8_t *ip, uint16_t port, uint16_t sample_size)
+{
+    uint8_t flag = 0;
+    uint16_t payload = W5500_UDP_STREAM_MTU;
+
+    if (socket_index >= W5500_SOCKET_COUNT || sample_size == 0 || sample_size > W5500_UDP_STREAM_MTU - W5500_UDP_STREAM_HEADER_SIZE)
+    {
+        return -1;
+    }
+
+    if (payload > getSn_TxMAX(socket_index) / 2)
+    {
+        payload = getSn_TxMAX(socket_index) / 2;
+    }
+    if (payload < W5500_UDP_STREAM_HEADER_SIZE + sample_size)
+    {
+        return -1;
+    }
+
+    memset(stream, 0, sizeof(W5500_UDPStream_t));
+    stream->socket_index = socket_index;
+    stream->sample_size = sample_size;
+    stream->samples_per_datagram = (payload - W5500_UDP_STREAM_HEADER_SIZE) / sample_size;
+
+    // 组播需要在打开socket之前设置目标IP、端口和对应的组播MAC地址
+    if (ip[0] >= 224 && ip[0] <= 239)
+    {
+        uint8_t mac[6] = {0x01, 0x00, 0x5E, ip[1] & 0x7F, ip[2], ip[3]};
+
+        setSn_DHAR(socket_index, mac);
+        setSn_DIPR(socket_index, ip);
+        setSn_DPORT(socket_index, port);
+        flag = SF_MULTI_ENABLE;
+    }
+
+    if (socket(socket_index, Sn_MR_UDP, local_port, flag) != socket_index)
+    {
+        return -2;
+    }
+
+    // 目标固定，只设置一次，后面直接发出SEND命令
+    setSn_DIPR(socket_index, ip);
+    setSn_DPORT(socket_index, port);
+
+    return 0;
+}
+
+/**
+ * @brief 关闭UDP数据流
+ * 
+ * @param stream 数据流
+ */
+void W5500_UDPStream_Close(W5500_UDPStream_t *stream)
+{
+    close(stream->socket_index);
+    stream->count = 0;
+    stream->staged_length = 0;
+    stream->in_flight = 0;
+}
+
+/**
+ * @brief 发出SEND命令
+ * 
+ * @param stream 数据流
+ */
+static void W5500_UDPStream_Send(W5500_UDPStream_t *stream)
+{
+    setSn_CR(stream->socket_index, Sn_CR_SEND);
+    while (getSn_CR(stream->socket_index));
+    stream->in_flight = 1;
+}
+
+/**
+ * @brief 写入一个采样，凑够一个数据报时自动发送
+ * 
+ * @param stream 数据流
+ * @param sample 采样数据，长度为打开时的sample_size
+ * @return int8_t 0: 成功; SOCK_BUSY: 前面的数据报还没有发送出去，采样被丢弃
+ */
+int8_t W5500_UDPStream_Write(W5500_UDPStream_t *stream, const void *sample)
+{
+    // 上次凑满之后没能发送出去，再试一次
+    if (stream->count == stream->samples_per_datagram && W5500_UDPStream_Flush(stream) != 0)
+    {
+        stream->stats.dropped_samples++;
+        return SOCK_BUSY;
+    }
+
+    if (stream->count == 0)
+    {
+        stream->first_tick = HAL_GetTick();
+        W5500_UDPStream_Put32(stream->buffer + 12, SysTick_GetMicros());        // 第一个采样的时间戳
+    }
+
+    memcpy(stream->buffer + W5500_UDP_STREAM_HEADER_SIZE + stream->count * stream->sample_size, sample, stream->sample_size);
+    stream->count++;
+
+    if (stream->count == stream->samples_per_datagram)
+    {
+        W5500_UDPStream_Flush(stream);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief 把正在打包的数据报写入W5500发送缓冲区
+ * 
+ * @param stream 数据流
+ * @return int8_t 0: 成功; SOCK_BUSY: 已经有一个数据报在发送，一个在等待
+ * 
+ * @note 上一个数据报还在发送时，先把数据写入发送缓冲区，等收到SENDOK后在W5500_UDPStream_Process()中发出SEND命令
+ */
+int8_t W5500_UDPStream_Flush(W5500_UDPStream_t *stream)
+{
+    uint16_t length = 0;
+
+    if (stream->count == 0)
+    {
+        return 0;
+    }
+
+    if (stream->staged_length > 0)
+    {
+        return SOCK_BUSY;
+    }
+
+    length = W5500_UDP_STREAM_HEADER_SIZE + stream->count * stream->sample_size;
+    if (getSn_TX_FSR(stream->socket_index) < length)
+    {
+        return SOCK_BUSY;
+    }
+
+    W5500_UDPStream_Put16(stream->buffer + 0, W5500_UDP_STREAM_MAGIC);
+    W5500_UDPStream_Put16(stream->buffer + 2, stream->sample_size);
+    W5500_UDPStream_Put16(stream->buffer + 4, stream->count);
+    W5500_UDPStream_Put16(stream->buffer + 6, 0);
+    W5500_UDPStream_Put32(stream->buffer + 8, stream->sequence);
+
+    wiz_send_data(stream->socket_index, stream->buffer, length);               // 只移动Sn_TX_WR，不影响正在发送的数据报
+
+    stream->sequence++;
+    stream->stats.samples += stream->count;
+    stream->count = 0;
+
+    if (stream->in_flight)
+    {
+        stream->staged_length = length;
+    }
+    else
+    {
+        W5500_UDPStream_Send(stream);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief UDP数据流处理函数，在主循环中调用，不会阻塞
+ * 
+ * @param stream 数据流
+ */
+void W5500_UDPStream_Process(W5500_UDPStream_t *stream)
+{
+    uint8_t ir = 0;
+
+    if (stream->in_flight)
+    {
+        ir = getSn_IR(stream->socket_index);
+        if (ir & Sn_IR_SENDOK)
+        {
+            setSn_IR(stream->socket_index, Sn_IR_SENDOK);
+            stream->in_flight = 0;
+            stream->stats.datagrams++;
+        }
+        else if (ir & Sn_IR_TIMEOUT)
+        {
+            setSn_IR(stream->socket_index, Sn_IR_TIMEOUT);                      // 目标的ARP没有回应
+            stream->in_flight = 0;
+            stream->stats.timeouts++;
+        }
+    }
+
+    if (!stream->in_flight && stream->staged_length > 0)
+    {
+        stream->staged_length = 0;
+        W5500_UDPStream_Send(stream);
+    }
+
+    if (stream->count > 0 && HAL_GetTick() - stream->first_tick >= W5500_UDP_STREAM_DEADLINE)
+    {
+        W5500_UDPStream_Flush(stream);
+    }
+}
\ No newline at end of file
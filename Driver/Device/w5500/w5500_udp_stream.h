@@ -0,0 +1,51 @@
+#ifndef __W5500_UDP_STREAM_H__
+#define __W5500_UDP_STREAM_H__
+
+#include "socket.h"
+
+#include "bsp_systick.h"
+
+#include "w5500/w5500_device.h"
+#include "w5500/w5500_event.h"
+
+#define W5500_UDP_STREAM_MTU            1472                                    // 以太网MTU 1500减去IP头20字节和UDP头8字节
+#define W5500_UDP_STREAM_HEADER_SIZE    16
+#define W5500_UDP_STREAM_MAGIC          0x544D                                  // "TM"
+#define W5500_UDP_STREAM_DEADLINE       20                                      // 采样不够一个数据报时最多等待的时间，单位ms
+
+/**
+ * 数据报格式，多字节字段都是大端：
+ * | magic(2) | sample_size(2) | sample_count(2) | reserved(2) | sequence(4) | timestamp_us(4) | samples... |
+ * timestamp_us是数据报中第一个采样写入的时间
+ */
+
+typedef struct W5500_UDPStreamStats_t
+{
+    uint32_t datagrams;                                                         // 发送的数据报数
+    uint32_t samples;                                                           // 发送的采样数
+    uint32_t dropped_samples;                                                   // 两个数据报都在等待发送时丢弃的采样数
+    uint32_t timeouts;                                                          // ARP超时次数
+} W5500_UDPStreamStats_t;
+
+typedef struct W5500_UDPStream_t
+{
+    uint8_t socket_index;
+    uint16_t sample_size;                                                       // 每个采样的字节数
+    uint16_t samples_per_datagram;                                              // 每个数据报最多的采样数
+    uint8_t buffer[W5500_UDP_STREAM_MTU];                                       // 正在打包的数据报
+    uint16_t count;                                                             // 正在打包的数据报中的采样数
+    uint32_t sequence;                                                          // 下一个数据报的序号
+    uint32_t first_tick;                                                        // 正在打包的数据报第一个采样的时间，单位ms
+    uint16_t staged_length;                                                     // 已经写入W5500发送缓冲区，等待上一个数据报发送完成的长度
+    uint8_t in_flight;                                                          // 已经发出SEND命令，还没有收到SENDOK
+    W5500_UDPStreamStats_t stats;
+} W5500_UDPStream_t;
+
+int8_t W5500_UDPStream_Open(W5500_UDPStream_t *stream, uint8_t socket_index, uint16_t local_port, uint8_t *ip, uint16_t port, uint16_t sample_size);
+void W5500_UDPStream_Close(W5500_UDPStream_t *stream);
+
+int8_t W5500_UDPStream_Write(W5500_UDPStream_t *stream, const void *sample);
+int8_t W5500_UDPStream_Flush(W5500_UDPStream_t *stream);
+void W5500_UDPStream_Process(W5500_UDPStream_t *stream);
+
+#endif // !__W5500_UDP_STREAM_H__
\ No newline at end of file
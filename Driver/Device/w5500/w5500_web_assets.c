@@ -0,0 +1,170 @@
+/**
+ * 由Tools/web_assets/web_assets.py根据www/生成，不要手动修改
+ * 
+ * index.html                  1443 ->     661 字节  ETag "0001bf77c20b3873"
+ * 合计                        1443 ->     661 字节
+ * 镜像                        2489 字节，内容按4字节对齐
+ */
+
+#include "w5500_web_assets.h"
+
+const uint8_t g_w5500_web_romfs[2489] __attribute__((aligned(4))) = {
+    0x57, 0x52, 0x46, 0x53, 0x01, 0x00, 0x01, 0x00, 0xb9, 0x09, 0x00, 0x00, 0x24, 0xb9, 0x8d, 0x12,
+    0x34, 0x00, 0x00, 0x00, 0x3f, 0x00, 0x00, 0x00, 0x52, 0x00, 0x00, 0x00, 0x8a, 0x00, 0xa4, 0x00,
+    0x80, 0x01, 0x00, 0x00, 0xa3, 0x05, 0x00, 0x00, 0x24, 0x07, 0x00, 0x00, 0x95, 0x02, 0x00, 0x00,
+    0x0a, 0x12, 0x00, 0x00, 0x69, 0x6e, 0x64, 0x65, 0x78, 0x2e, 0x68, 0x74, 0x6d, 0x6c, 0x00, 0x22,
+    0x30, 0x30, 0x30, 0x31, 0x62, 0x66, 0x37, 0x37, 0x63, 0x32, 0x30, 0x62, 0x33, 0x38, 0x37, 0x33,
+    0x22, 0x00, 0x48, 0x54, 0x54, 0x50, 0x2f, 0x31, 0x2e, 0x31, 0x20, 0x32, 0x30, 0x30, 0x20, 0x4f,
+    0x4b, 0x0d, 0x0a, 0x43, 0x6f, 0x6e, 0x74, 0x65, 0x6e, 0x74, 0x2d, 0x54, 0x79, 0x70, 0x65, 0x3a,
+    0x20, 0x74, 0x65, 0x78, 0x74, 0x2f, 0x68, 0x74, 0x6d, 0x6c, 0x0d, 0x0a, 0x43, 0x6f, 0x6e, 0x74,
+    0x65, 0x6e, 0x74, 0x2d, 0x4c, 0x65, 0x6e, 0x67, 0x74, 0x68, 0x3a, 0x20, 0x31, 0x34, 0x34, 0x33,
+    0x0d, 0x0a, 0x45, 0x54, 0x61, 0x67, 0x3a, 0x20, 0x22, 0x30, 0x30, 0x30, 0x31, 0x62, 0x66, 0x37,
+    0x37, 0x63, 0x32, 0x30, 0x62, 0x33, 0x38, 0x37, 0x33, 0x22, 0x0d, 0x0a, 0x43, 0x61, 0x63, 0x68,
+    0x65, 0x2d, 0x43, 0x6f, 0x6e, 0x74, 0x72, 0x6f, 0x6c, 0x3a, 0x20, 0x6e, 0x6f, 0x2d, 0x63, 0x61,
+    0x63, 0x68, 0x65, 0x0d, 0x0a, 0x56, 0x61, 0x72, 0x79, 0x3a, 0x20, 0x41, 0x63, 0x63, 0x65, 0x70,
+    0x74, 0x2d, 0x45, 0x6e, 0x63, 0x6f, 0x64, 0x69, 0x6e, 0x67, 0x0d, 0x0a, 0x48, 0x54, 0x54, 0x50,
+    0x2f, 0x31, 0x2e, 0x31, 0x20, 0x32, 0x30, 0x30, 0x20, 0x4f, 0x4b, 0x0d, 0x0a, 0x43, 0x6f, 0x6e,
+    0x74, 0x65, 0x6e, 0x74, 0x2d, 0x54, 0x79, 0x70, 0x65, 0x3a, 0x20, 0x74, 0x65, 0x78, 0x74, 0x2f,
+    0x68, 0x74, 0x6d, 0x6c, 0x0d, 0x0a, 0x43, 0x6f, 0x6e, 0x74, 0x65, 0x6e, 0x74, 0x2d, 0x4c, 0x65,
+    0x6e, 0x67, 0x74, 0x68, 0x3a, 0x20, 0x36, 0x36, 0x31, 0x0d, 0x0a, 0x45, 0x54, 0x61, 0x67, 0x3a,
+    0x20, 0x22, 0x30, 0x30, 0x30, 0x31, 0x62, 0x66, 0x37, 0x37, 0x63, 0x32, 0x30, 0x62, 0x33, 0x38,
+    0x37, 0x33, 0x2d, 0x67, 0x7a, 0x22, 0x0d, 0x0a, 0x43, 0x61, 0x63, 0x68, 0x65, 0x2d, 0x43, 0x6f,
+    0x6e, 0x74, 0x72, 0x6f, 0x6c, 0x3a, 0x20, 0x6e, 0x6f, 0x2d, 0x63, 0x61, 0x63, 0x68, 0x65, 0x0d,
+    0x0a, 0x56, 0x61, 0x72, 0x79, 0x3a, 0x20, 0x41, 0x63, 0x63, 0x65, 0x70, 0x74, 0x2d, 0x45, 0x6e,
+    0x63, 0x6f, 0x64, 0x69, 0x6e, 0x67, 0x0d, 0x0a, 0x43, 0x6f, 0x6e, 0x74, 0x65, 0x6e, 0x74, 0x2d,
+    0x45, 0x6e, 0x63, 0x6f, 0x64, 0x69, 0x6e, 0x67, 0x3a, 0x20, 0x67, 0x7a, 0x69, 0x70, 0x0d, 0x0a,
+    0x3c, 0x21, 0x44, 0x4f, 0x43, 0x54, 0x59, 0x50, 0x45, 0x20, 0x68, 0x74, 0x6d, 0x6c, 0x3e, 0x0a,
+    0x3c, 0x68, 0x74, 0x6d, 0x6c, 0x3e, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x3c, 0x68, 0x65, 0x61, 0x64,
+    0x3e, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x3c, 0x74, 0x69, 0x74, 0x6c, 0x65,
+    0x3e, 0x57, 0x35, 0x35, 0x30, 0x30, 0x20, 0x57, 0x65, 0x62, 0x20, 0x53, 0x65, 0x72, 0x76, 0x65,
+    0x72, 0x3c, 0x2f, 0x74, 0x69, 0x74, 0x6c, 0x65, 0x3e, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x3c, 0x6d, 0x65, 0x74, 0x61, 0x20, 0x63, 0x68, 0x61, 0x72, 0x73, 0x65, 0x74, 0x3d,
+    0x22, 0x75, 0x74, 0x66, 0x2d, 0x38, 0x22, 0x3e, 0x3c, 0x2f, 0x6d, 0x65, 0x74, 0x61, 0x3e, 0x0a,
+    0x20, 0x20, 0x20, 0x20, 0x3c, 0x2f, 0x68, 0x65, 0x61, 0x64, 0x3e, 0x0a, 0x20, 0x20, 0x20, 0x20,
+    0x3c, 0x62, 0x6f, 0x64, 0x79, 0x3e, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x3c,
+    0x62, 0x75, 0x74, 0x74, 0x6f, 0x6e, 0x20, 0x6f, 0x6e, 0x63, 0x6c, 0x69, 0x63, 0x6b, 0x3d, 0x22,
+    0x6c, 0x65, 0x64, 0x28, 0x31, 0x29, 0x22, 0x3e, 0xe5, 0xbc, 0x80, 0xe7, 0x81, 0xaf, 0x3c, 0x2f,
+    0x62, 0x75, 0x74, 0x74, 0x6f, 0x6e, 0x3e, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x3c, 0x62, 0x75, 0x74, 0x74, 0x6f, 0x6e, 0x20, 0x6f, 0x6e, 0x63, 0x6c, 0x69, 0x63, 0x6b, 0x3d,
+    0x22, 0x6c, 0x65, 0x64, 0x28, 0x32, 0x29, 0x22, 0x3e, 0xe5, 0x85, 0xb3, 0xe7, 0x81, 0xaf, 0x3c,
+    0x2f, 0x62, 0x75, 0x74, 0x74, 0x6f, 0x6e, 0x3e, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x3c, 0x73, 0x70, 0x61, 0x6e, 0x20, 0x69, 0x64, 0x3d, 0x22, 0x6c, 0x65, 0x64, 0x22, 0x3e,
+    0x3c, 0x2f, 0x73, 0x70, 0x61, 0x6e, 0x3e, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x3c, 0x70, 0x3e, 0x53, 0x50, 0x49, 0x3a, 0x20, 0x3c, 0x73, 0x70, 0x61, 0x6e, 0x20, 0x69, 0x64,
+    0x3d, 0x22, 0x73, 0x70, 0x69, 0x22, 0x3e, 0x2d, 0x3c, 0x2f, 0x73, 0x70, 0x61, 0x6e, 0x3e, 0x20,
+    0x62, 0x79, 0x74, 0x65, 0x2f, 0x73, 0x3c, 0x2f, 0x70, 0x3e, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x3c, 0x73, 0x63, 0x72, 0x69, 0x70, 0x74, 0x3e, 0x0a, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x66, 0x75, 0x6e, 0x63, 0x74, 0x69, 0x6f, 0x6e,
+    0x20, 0x6c, 0x65, 0x64, 0x28, 0x61, 0x63, 0x74, 0x69, 0x6f, 0x6e, 0x29, 0x20, 0x7b, 0x0a, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x66,
+    0x65, 0x74, 0x63, 0x68, 0x28, 0x22, 0x2f, 0x61, 0x70, 0x69, 0x2f, 0x6c, 0x65, 0x64, 0x3f, 0x61,
+    0x63, 0x74, 0x69, 0x6f, 0x6e, 0x3d, 0x22, 0x20, 0x2b, 0x20, 0x61, 0x63, 0x74, 0x69, 0x6f, 0x6e,
+    0x29, 0x2e, 0x74, 0x68, 0x65, 0x6e, 0x28, 0x72, 0x20, 0x3d, 0x3e, 0x20, 0x72, 0x2e, 0x6a, 0x73,
+    0x6f, 0x6e, 0x28, 0x29, 0x29, 0x2e, 0x74, 0x68, 0x65, 0x6e, 0x28, 0x73, 0x20, 0x3d, 0x3e, 0x20,
+    0x7b, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x64, 0x6f, 0x63, 0x75, 0x6d, 0x65, 0x6e, 0x74, 0x2e, 0x67,
+    0x65, 0x74, 0x45, 0x6c, 0x65, 0x6d, 0x65, 0x6e, 0x74, 0x42, 0x79, 0x49, 0x64, 0x28, 0x22, 0x6c,
+    0x65, 0x64, 0x22, 0x29, 0x2e, 0x74, 0x65, 0x78, 0x74, 0x43, 0x6f, 0x6e, 0x74, 0x65, 0x6e, 0x74,
+    0x20, 0x3d, 0x20, 0x73, 0x2e, 0x6c, 0x65, 0x64, 0x20, 0x3f, 0x20, 0x22, 0xe5, 0xb7, 0xb2, 0xe5,
+    0xbc, 0x80, 0xe7, 0x81, 0xaf, 0x22, 0x20, 0x3a, 0x20, 0x22, 0xe5, 0xb7, 0xb2, 0xe5, 0x85, 0xb3,
+    0xe7, 0x81, 0xaf, 0x22, 0x3b, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x7d, 0x29, 0x3b, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x7d, 0x0a, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x2f, 0x2f, 0x20, 0xe6, 0x9c, 0x8d, 0xe5, 0x8a, 0xa1, 0xe5, 0x99,
+    0xa8, 0xe6, 0xaf, 0x8f, 0x35, 0x30, 0x6d, 0x73, 0xe9, 0x87, 0x87, 0xe6, 0xa0, 0xb7, 0xe4, 0xb8,
+    0x80, 0xe6, 0xac, 0xa1, 0xef, 0xbc, 0x8c, 0xe4, 0xb8, 0x80, 0xe4, 0xb8, 0xaa, 0xe6, 0xb6, 0x88,
+    0xe6, 0x81, 0xaf, 0xe6, 0x98, 0xaf, 0xe8, 0x8b, 0xa5, 0xe5, 0xb9, 0xb2, 0xe6, 0x9d, 0xa1, 0xe8,
+    0xae, 0xb0, 0xe5, 0xbd, 0x95, 0xe7, 0x9a, 0x84, 0xe6, 0x95, 0xb0, 0xe7, 0xbb, 0x84, 0x0a, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x6c, 0x65, 0x74, 0x20, 0x6c,
+    0x61, 0x73, 0x74, 0x20, 0x3d, 0x20, 0x6e, 0x75, 0x6c, 0x6c, 0x3b, 0x0a, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x66, 0x75, 0x6e, 0x63, 0x74, 0x69, 0x6f, 0x6e,
+    0x20, 0x74, 0x65, 0x6c, 0x65, 0x6d, 0x65, 0x74, 0x72, 0x79, 0x28, 0x29, 0x20, 0x7b, 0x0a, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x63,
+    0x6f, 0x6e, 0x73, 0x74, 0x20, 0x77, 0x73, 0x20, 0x3d, 0x20, 0x6e, 0x65, 0x77, 0x20, 0x57, 0x65,
+    0x62, 0x53, 0x6f, 0x63, 0x6b, 0x65, 0x74, 0x28, 0x22, 0x77, 0x73, 0x3a, 0x2f, 0x2f, 0x22, 0x20,
+    0x2b, 0x20, 0x6c, 0x6f, 0x63, 0x61, 0x74, 0x69, 0x6f, 0x6e, 0x2e, 0x68, 0x6f, 0x73, 0x74, 0x20,
+    0x2b, 0x20, 0x22, 0x2f, 0x77, 0x73, 0x2f, 0x74, 0x65, 0x6c, 0x65, 0x6d, 0x65, 0x74, 0x72, 0x79,
+    0x22, 0x29, 0x3b, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x77, 0x73, 0x2e, 0x6f, 0x6e, 0x6d, 0x65, 0x73, 0x73, 0x61, 0x67, 0x65,
+    0x20, 0x3d, 0x20, 0x65, 0x20, 0x3d, 0x3e, 0x20, 0x7b, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x66, 0x6f,
+    0x72, 0x20, 0x28, 0x63, 0x6f, 0x6e, 0x73, 0x74, 0x20, 0x73, 0x20, 0x6f, 0x66, 0x20, 0x4a, 0x53,
+    0x4f, 0x4e, 0x2e, 0x70, 0x61, 0x72, 0x73, 0x65, 0x28, 0x65, 0x2e, 0x64, 0x61, 0x74, 0x61, 0x29,
+    0x29, 0x20, 0x7b, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x69, 0x66, 0x20, 0x28,
+    0x6c, 0x61, 0x73, 0x74, 0x20, 0x26, 0x26, 0x20, 0x73, 0x2e, 0x74, 0x20, 0x3e, 0x20, 0x6c, 0x61,
+    0x73, 0x74, 0x2e, 0x74, 0x29, 0x20, 0x7b, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x64, 0x6f, 0x63, 0x75, 0x6d, 0x65, 0x6e, 0x74, 0x2e, 0x67, 0x65, 0x74,
+    0x45, 0x6c, 0x65, 0x6d, 0x65, 0x6e, 0x74, 0x42, 0x79, 0x49, 0x64, 0x28, 0x22, 0x73, 0x70, 0x69,
+    0x22, 0x29, 0x2e, 0x74, 0x65, 0x78, 0x74, 0x43, 0x6f, 0x6e, 0x74, 0x65, 0x6e, 0x74, 0x20, 0x3d,
+    0x20, 0x4d, 0x61, 0x74, 0x68, 0x2e, 0x72, 0x6f, 0x75, 0x6e, 0x64, 0x28, 0x28, 0x73, 0x2e, 0x73,
+    0x70, 0x69, 0x20, 0x2d, 0x20, 0x6c, 0x61, 0x73, 0x74, 0x2e, 0x73, 0x70, 0x69, 0x29, 0x20, 0x2a,
+    0x20, 0x31, 0x30, 0x30, 0x30, 0x20, 0x2f, 0x20, 0x28, 0x73, 0x2e, 0x74, 0x20, 0x2d, 0x20, 0x6c,
+    0x61, 0x73, 0x74, 0x2e, 0x74, 0x29, 0x29, 0x3b, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x7d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x64, 0x6f, 0x63, 0x75, 0x6d,
+    0x65, 0x6e, 0x74, 0x2e, 0x67, 0x65, 0x74, 0x45, 0x6c, 0x65, 0x6d, 0x65, 0x6e, 0x74, 0x42, 0x79,
+    0x49, 0x64, 0x28, 0x22, 0x6c, 0x65, 0x64, 0x22, 0x29, 0x2e, 0x74, 0x65, 0x78, 0x74, 0x43, 0x6f,
+    0x6e, 0x74, 0x65, 0x6e, 0x74, 0x20, 0x3d, 0x20, 0x73, 0x2e, 0x6c, 0x65, 0x64, 0x20, 0x3f, 0x20,
+    0x22, 0xe5, 0xb7, 0xb2, 0xe5, 0xbc, 0x80, 0xe7, 0x81, 0xaf, 0x22, 0x20, 0x3a, 0x20, 0x22, 0xe5,
+    0xb7, 0xb2, 0xe5, 0x85, 0xb3, 0xe7, 0x81, 0xaf, 0x22, 0x3b, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x6c, 0x61, 0x73, 0x74, 0x20, 0x3d, 0x20, 0x73, 0x3b, 0x0a, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x7d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x7d, 0x3b, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x77, 0x73, 0x2e, 0x6f, 0x6e, 0x63, 0x6c, 0x6f, 0x73, 0x65,
+    0x20, 0x3d, 0x20, 0x28, 0x29, 0x20, 0x3d, 0x3e, 0x20, 0x73, 0x65, 0x74, 0x54, 0x69, 0x6d, 0x65,
+    0x6f, 0x75, 0x74, 0x28, 0x74, 0x65, 0x6c, 0x65, 0x6d, 0x65, 0x74, 0x72, 0x79, 0x2c, 0x20, 0x31,
+    0x30, 0x30, 0x30, 0x29, 0x3b, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x7d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x74, 0x65, 0x6c, 0x65, 0x6d, 0x65, 0x74, 0x72, 0x79, 0x28, 0x29, 0x3b, 0x0a, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x3c, 0x2f, 0x73, 0x63, 0x72, 0x69, 0x70, 0x74, 0x3e, 0x0a, 0x20,
+    0x20, 0x20, 0x20, 0x3c, 0x2f, 0x62, 0x6f, 0x64, 0x79, 0x3e, 0x0a, 0x3c, 0x2f, 0x68, 0x74, 0x6d,
+    0x6c, 0x3e, 0x0a, 0x00, 0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xad, 0x54,
+    0xdf, 0x6b, 0xd4, 0x40, 0x10, 0x7e, 0xef, 0x5f, 0x31, 0xe6, 0xa1, 0x6c, 0xac, 0x97, 0xbd, 0x0a,
+    0x05, 0xb9, 0xe6, 0x52, 0xb0, 0xf6, 0xa1, 0x82, 0xb6, 0x70, 0x85, 0xe2, 0x63, 0x2e, 0xd9, 0x6b,
+    0x62, 0x73, 0xd9, 0x90, 0x9d, 0x78, 0x1e, 0x52, 0x68, 0xa1, 0x52, 0xf1, 0x07, 0x3e, 0x15, 0x54,
+    0x14, 0xbc, 0x07, 0x41, 0x44, 0xbc, 0x52, 0xc1, 0x56, 0xac, 0xff, 0x4d, 0x2f, 0xad, 0x4f, 0xfe,
+    0x0b, 0xee, 0x26, 0x67, 0x2f, 0xe7, 0x5d, 0x2b, 0x82, 0xfb, 0x92, 0x99, 0xc9, 0x37, 0x5f, 0x26,
+    0x33, 0xdf, 0x8e, 0x79, 0xe9, 0xc6, 0xd2, 0xfc, 0xca, 0x9d, 0xe5, 0x05, 0xf0, 0xb0, 0x19, 0x58,
+    0x13, 0x66, 0xfe, 0x00, 0x79, 0x4c, 0x8f, 0xd9, 0x6e, 0x6e, 0x66, 0x2e, 0xfa, 0x18, 0x30, 0x6b,
+    0x75, 0x66, 0xa6, 0x5c, 0x86, 0x55, 0x56, 0x87, 0x1a, 0x8b, 0xef, 0xb1, 0xd8, 0xa4, 0x79, 0x7c,
+    0x80, 0x6b, 0x32, 0xb4, 0xc1, 0xf1, 0xec, 0x58, 0x30, 0xac, 0x6a, 0x09, 0x36, 0x4a, 0xd7, 0x34,
+    0xcb, 0xa4, 0x2a, 0xdc, 0x27, 0xa6, 0x03, 0x66, 0xb3, 0xce, 0xdd, 0x76, 0x21, 0xb9, 0x9e, 0x20,
+    0xf2, 0x10, 0x78, 0xe8, 0x04, 0xbe, 0xb3, 0x5e, 0xd5, 0x02, 0xe6, 0x92, 0x69, 0x5d, 0xb3, 0x7a,
+    0x47, 0x9b, 0x27, 0x5b, 0x5d, 0x93, 0xe6, 0xef, 0xff, 0x92, 0x70, 0x55, 0x25, 0x3c, 0xfc, 0x3c,
+    0x3e, 0x41, 0x44, 0x76, 0x08, 0xbe, 0x9b, 0x21, 0x55, 0x5d, 0xca, 0x2f, 0xbc, 0x8e, 0xac, 0xda,
+    0xf2, 0x62, 0xa5, 0x00, 0x13, 0x91, 0xaf, 0x59, 0xa5, 0x3e, 0x0e, 0xea, 0x6d, 0x64, 0x54, 0x98,
+    0x34, 0x2a, 0x32, 0x3a, 0xb1, 0x1f, 0xe1, 0x20, 0xa0, 0x4e, 0x23, 0x09, 0x1d, 0xf4, 0x65, 0x61,
+    0xaa, 0x1e, 0x3b, 0x33, 0x75, 0x78, 0x30, 0x04, 0xc9, 0x60, 0x0c, 0x1d, 0x8f, 0x68, 0xd4, 0x8e,
+    0x7c, 0x2a, 0x91, 0x73, 0x39, 0xb2, 0xaa, 0xc1, 0x14, 0xf4, 0x93, 0x0c, 0xf4, 0x58, 0x48, 0x62,
+    0xa8, 0x5a, 0x10, 0x1b, 0x77, 0x05, 0x0f, 0x89, 0xde, 0x8f, 0x09, 0x15, 0x1b, 0xa5, 0x54, 0xc7,
+    0xe5, 0x4e, 0xd2, 0x64, 0x21, 0x1a, 0x6b, 0x0c, 0x17, 0x02, 0xa6, 0xcc, 0xeb, 0xed, 0x45, 0x97,
+    0x64, 0xff, 0x2c, 0xd3, 0xd9, 0x7d, 0x9c, 0xe7, 0x21, 0xca, 0x30, 0x54, 0x41, 0x18, 0x32, 0x0a,
+    0x73, 0xa0, 0xf5, 0x0e, 0xf6, 0xf3, 0x36, 0x6b, 0x50, 0xc9, 0xbd, 0xac, 0x87, 0xda, 0xec, 0xc8,
+    0x37, 0x36, 0xf4, 0xe1, 0xd8, 0xc6, 0xc4, 0x90, 0x4b, 0x29, 0xa4, 0xaf, 0x9f, 0xf5, 0x1e, 0x77,
+    0x7a, 0x2f, 0xdf, 0xa7, 0xdd, 0xe7, 0x33, 0xe5, 0xa6, 0xf8, 0xb1, 0xb3, 0x93, 0xbe, 0x3d, 0x38,
+    0x3e, 0xdc, 0x4c, 0x3f, 0x76, 0x7e, 0x1e, 0x3d, 0x95, 0xc6, 0xf1, 0xe1, 0x87, 0xf4, 0xcb, 0xa3,
+    0x74, 0xab, 0x9b, 0xbe, 0xe8, 0x9e, 0x3e, 0x79, 0xd7, 0xfb, 0xba, 0x9f, 0xbe, 0xe9, 0x9c, 0x7e,
+    0xda, 0xeb, 0x7d, 0xdf, 0x3d, 0x79, 0xb5, 0x9d, 0xee, 0xee, 0x9d, 0x7c, 0xdb, 0x1e, 0x62, 0x0d,
+    0x18, 0x42, 0x60, 0x0b, 0x55, 0x72, 0x98, 0x04, 0xc1, 0xec, 0xf8, 0x7e, 0x23, 0x53, 0xff, 0x8b,
+    0x71, 0x9b, 0x8c, 0xeb, 0xb7, 0xc3, 0x43, 0x49, 0xd0, 0x12, 0x8a, 0x83, 0xb5, 0x94, 0x8c, 0x6b,
+    0xdc, 0x59, 0x67, 0x48, 0xb4, 0x96, 0xa8, 0x50, 0xaa, 0xfa, 0x1e, 0x70, 0xc7, 0x56, 0x4c, 0x86,
+    0xc7, 0x25, 0x74, 0x0a, 0x34, 0xda, 0x12, 0xf4, 0x8c, 0x55, 0xd3, 0x47, 0xbb, 0xd1, 0x12, 0x06,
+    0x0f, 0x9b, 0x4c, 0x08, 0x7b, 0x8d, 0x49, 0x62, 0x76, 0xfe, 0x5c, 0x1a, 0x3c, 0x06, 0x92, 0xd7,
+    0x20, 0x80, 0x37, 0xe0, 0x66, 0x6d, 0xe9, 0xb6, 0x11, 0xa9, 0x9b, 0x42, 0x98, 0xe1, 0xda, 0x68,
+    0xeb, 0xfa, 0x39, 0x99, 0xea, 0xf8, 0x0d, 0x20, 0x59, 0x03, 0x26, 0x27, 0xe5, 0xd0, 0x10, 0xac,
+    0xac, 0x1d, 0x06, 0x5e, 0x94, 0x73, 0xa1, 0x1a, 0x94, 0xb4, 0xff, 0x54, 0xc3, 0x2d, 0x1b, 0x3d,
+    0x23, 0xe6, 0x49, 0xe8, 0x12, 0x22, 0x0c, 0x89, 0x80, 0x52, 0xfe, 0x19, 0x69, 0xea, 0x70, 0x19,
+    0xa6, 0xcb, 0xf2, 0xfa, 0x53, 0x20, 0xaa, 0x80, 0xd2, 0xef, 0x02, 0xc6, 0x34, 0x65, 0x20, 0x8d,
+    0x7f, 0x2e, 0xeb, 0x3f, 0x89, 0xf4, 0x4c, 0x37, 0xb9, 0x66, 0xc4, 0x78, 0xc4, 0x68, 0x7d, 0x1b,
+    0xe7, 0x4c, 0xd8, 0x09, 0xb8, 0x50, 0xf3, 0x95, 0xc2, 0x92, 0x03, 0x96, 0xcb, 0x6d, 0xc5, 0x6f,
+    0x32, 0x9e, 0x20, 0x39, 0x13, 0xc7, 0x95, 0xac, 0x3b, 0x23, 0x77, 0xa3, 0xe8, 0x15, 0xe4, 0x39,
+    0x80, 0xc9, 0xe5, 0x52, 0x58, 0x21, 0x72, 0x67, 0x65, 0x3b, 0x51, 0xae, 0xc9, 0x6c, 0x17, 0xff,
+    0x02, 0xac, 0x84, 0x12, 0xf1, 0xa3, 0x05, 0x00, 0x00,
+};
+
+const uint32_t g_w5500_web_romfs_size = sizeof(g_w5500_web_romfs);
\ No newline at end of file
@@ -0,0 +1,11 @@
+#ifndef __W5500_WEB_ASSETS_H__
+#define __W5500_WEB_ASSETS_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+// 网页资源的只读镜像（格式见httpServer/httpRomfs.h），由Tools/web_assets/web_assets.py生成，见w5500_web_assets.c
+extern const uint8_t g_w5500_web_romfs[];
+extern const uint32_t g_w5500_web_romfs_size;
+
+#endif // !__W5500_WEB_ASSETS_H__
\ No newline at end of file
@@ -6,27 +6,248 @@ uint8_t g_w5500_web_server_rx_buff[2048];
 uint8_t *g_w5500_web_server_socket_list;
 uint8_t g_w5500_web_server_socket_count;
 
-char *g_web_server_content_name = "index.html";
-char *g_web_server_content = 
-    "<!DOCTYPE html> \
-    <html> \
-        <head> \
-            <title>W5500 Web Server</title> \
-            <meta charset=\"utf-8\"></meta> \
-        </head> \
-        <body> \
-            <a href=\"/index.html?action=1\"><button>开灯</button></a> \
-            <a href=\"/index.html?action=2\"><button>关灯</button></a> \
-        </body> \
-    </html>";
+#ifdef _USE_SDCARD_
+FATFS g_w5500_web_server_fatfs;
+#endif
+
+static uint32_t g_w5500_web_telemetry_tick;                                     // 上一次写入遥测数据的时间
+static int8_t g_w5500_web_status_led = -1;                                      // 状态文档中LED的部分
+
+static char g_w5500_web_metrics_text[W5500_WEB_METRICS_SIZE];                   // 输出的指标，发送时不复制
+static uint32_t g_w5500_web_metrics_length;
+static uint8_t g_w5500_web_metrics_readers;                                     // 正在发送指标的连接，按socket序号的位
+
+/**
+ * @brief LED控制接口，GET /api/led?action=1开灯，action=2关灯，返回LED的状态
+ * 
+ * @param request 请求，参数在request->query里
+ * @param buf 响应内容的缓冲区
+ * @param len 输入缓冲区的大小，输出响应内容的长度
+ * @return uint8_t HTTP_OK：成功，HTTP_FAILED：参数错误，回复400
+ */
+static uint8_t W5500_WebServer_LedHandler(const st_http_route_request *request, uint8_t *buf, uint16_t *len)
+{
+    int32_t action = 0;
+    char value[12];
+
+    // 没有action参数时只返回状态，参数不是数字时回复400
+    if (get_http_query_value(request->query, request->query_len, "action", value, sizeof(value)))
+    {
+        if (!get_http_query_int(request->query, request->query_len, "action", &action))
+        {
+            return HTTP_FAILED;
+        }
+
+        switch (action)
+        {
+        case 1:
+            // 打开灯
+            LED_SetStatus(GPIOF, GPIO_PIN_9, LED_ON);
+            break;
+        case 2:
+            // 关闭灯
+            LED_SetStatus(GPIOF, GPIO_PIN_9, LED_OFF);
+            break;
+        default:
+            return HTTP_FAILED;
+        }
+        W5500_WebStatus_Invalidate(g_w5500_web_status_led);
+    }
+
+    *len = snprintf((char *)buf, *len, "{\"led\":%d}", HAL_GPIO_ReadPin(GPIOF, GPIO_PIN_9) == GPIO_PIN_RESET);
+
+    return HTTP_OK;
+}
+
+/**
+ * @brief 状态文档中LED的部分，LED只在W5500_WebServer_LedHandler()中改变，改变时标记为脏
+ * 
+ * @param buf 缓冲区
+ * @param size 缓冲区大小
+ * @return uint16_t 值的长度
+ */
+static uint16_t W5500_WebServer_RenderLed(char *buf, uint16_t size)
+{
+    return snprintf(buf, size, "%d", HAL_GPIO_ReadPin(GPIOF, GPIO_PIN_9) == GPIO_PIN_RESET);
+}
+
+/**
+ * @brief 状态文档中运行时间的部分，单位s
+ * 
+ * @param buf 缓冲区
+ * @param size 缓冲区大小
+ * @return uint16_t 值的长度
+ */
+static uint16_t W5500_WebServer_RenderUptime(char *buf, uint16_t size)
+{
+    return snprintf(buf, size, "%lu", (unsigned long)(HAL_GetTick() / 1000));
+}
+
+/**
+ * @brief 状态文档中网络的部分，IP地址和SPI总线上传输的字节数
+ * 
+ * @param buf 缓冲区
+ * @param size 缓冲区大小
+ * @return uint16_t 值的长度
+ */
+static uint16_t W5500_WebServer_RenderNetwork(char *buf, uint16_t size)
+{
+    return snprintf(buf, size, "{\"ip\":\"%d.%d.%d.%d\",\"spi\":%lu}", g_w5500_net_info.ip[0], g_w5500_net_info.ip[1],
+                    g_w5500_net_info.ip[2], g_w5500_net_info.ip[3], (unsigned long)g_w5500_spi_byte_count);
+}
+
+// 状态文档，各部分的渲染结果缓存起来，所有连接共用一份，直接从缓存发送
+static const httpServer_document g_w5500_web_status_document =
+{
+    .open = W5500_WebStatus_Open,
+    .close = W5500_WebStatus_Close
+};
+
+/**
+ * @brief 打开指标的文本，httpServer_document的open
+ * 
+ * @param seqnum HTTP socket序号
+ * @param request 请求，没有使用
+ * @param len 输出文本的长度
+ * @param etag 不使用ETag，每次请求都是新的值
+ * @return const uint8_t* Prometheus格式的文本
+ * 
+ * @note 有连接正在发送时不能重新输出，后来的请求共用同一份文本
+ */
+static const uint8_t *W5500_WebServer_MetricsOpen(uint8_t seqnum, const st_http_route_request *request, uint32_t *len,
+                                                  const char **etag)
+{
+    (void)request;
+    (void)etag;
+
+    if (g_w5500_web_metrics_readers == 0)
+    {
+        g_w5500_web_metrics_length = Metrics_Render(g_w5500_web_metrics_text, sizeof(g_w5500_web_metrics_text));
+    }
+    g_w5500_web_metrics_readers |= 1 << seqnum;
+    *len = g_w5500_web_metrics_length;
+
+    return (const uint8_t *)g_w5500_web_metrics_text;
+}
+
+/**
+ * @brief 指标的文本发送完了或者连接关闭了，httpServer_document的close
+ * 
+ * @param seqnum HTTP socket序号
+ */
+static void W5500_WebServer_MetricsClose(uint8_t seqnum)
+{
+    g_w5500_web_metrics_readers &= ~(1 << seqnum);
+}
+
+// 指标，Prometheus的文本格式，监控系统定时抓取
+static const httpServer_document g_w5500_web_metrics_document =
+{
+    .open = W5500_WebServer_MetricsOpen,
+    .close = W5500_WebServer_MetricsClose
+};
+
+// 遥测数据的WebSocket，socket可以发送时把新的记录合成一个消息
+static const httpServer_websocket g_w5500_web_telemetry_websocket =
+{
+    .on_open = W5500_WebTelemetry_Open,
+    .on_message = NULL,
+    .on_send = W5500_WebTelemetry_Read,
+    .on_close = W5500_WebTelemetry_Close
+};
+
+#ifdef _USE_SDCARD_
+// 上传文件到SD卡，POST /api/upload，请求体边收边写入，大小不受接收缓冲区限制
+static const httpServer_upload g_w5500_web_upload =
+{
+    .on_begin = W5500_WebUpload_Begin,
+    .on_part = W5500_WebUpload_Part,
+    .on_data = W5500_WebUpload_Data,
+    .on_end = W5500_WebUpload_End
+};
+#endif
+
+#if W5500_WEB_ROMFS_IN_W25Q
+/**
+ * @brief 读取W25Q中的网页资源镜像
+ * 
+ * @param offset 镜像中的偏移
+ * @param buf 缓冲区
+ * @param len 读取的字节数
+ */
+static void W5500_WebServer_RomfsRead(uint32_t offset, uint8_t *buf, uint16_t len)
+{
+    SPI_FLASH_ReadData(W5500_WEB_ROMFS_ADDRESS + offset, buf, len);
+}
+
+#ifdef _USE_SDCARD_
+/**
+ * @brief SD卡上的镜像和W25Q中的不同时写到W25Q
+ * 
+ * @param path 镜像文件，由web_assets.py -b生成
+ * @return int8_t 0: 已经写入或者不需要写入; -1: 没有镜像文件; -2: 不是镜像文件; -3: 读文件失败
+ * 
+ * @note 先写镜像头以外的部分，最后写镜像头，中途断电时W25Q里没有有效的镜像，下次启动重新写入
+ */
+static int8_t W5500_WebServer_InstallRomfs(const char *path)
+{
+    st_http_romfs_header header, installed;
+    uint8_t *buffer = g_w5500_web_server_rx_buff;
+    uint8_t invalid[4] = {0};
+    uint32_t offset;
+    FIL file;
+    UINT length;
+
+    if (f_open(&file, path, FA_READ) != FR_OK)
+    {
+        return -1;
+    }
+
+    if (f_read(&file, &header, sizeof(header), &length) != FR_OK || length != sizeof(header) ||
+        header.magic != HTTP_ROMFS_MAGIC || header.size != f_size(&file))
+    {
+        f_close(&file);
+        return -2;
+    }
+
+    // 镜像头里有CRC，相同就是同一个镜像
+    SPI_FLASH_ReadData(W5500_WEB_ROMFS_ADDRESS, (uint8_t *)&installed, sizeof(installed));
+    if (memcmp(&header, &installed, sizeof(header)) == 0)
+    {
+        f_close(&file);
+        return 0;
+    }
+
+    printf("写入网页资源镜像: %lu字节\r\n", (unsigned long)header.size);
+    SPI_FLASH_WriteData(W5500_WEB_ROMFS_ADDRESS, invalid, sizeof(invalid));
+
+    for (offset = sizeof(header); offset < header.size; offset += length)
+    {
+        if (f_read(&file, buffer, sizeof(g_w5500_web_server_rx_buff), &length) != FR_OK || length == 0)
+        {
+            f_close(&file);
+            return -3;
+        }
+        SPI_FLASH_WriteData(W5500_WEB_ROMFS_ADDRESS + offset, buffer, length);
+    }
+    SPI_FLASH_WriteData(W5500_WEB_ROMFS_ADDRESS, (uint8_t *)&header, sizeof(header));
+
+    f_close(&file);
+    return 0;
+}
+#endif
+#endif
 
 /**
  * @brief W5500 Web服务器初始化
  * 
  * @param socket_list socket 列表
  * @param socket_count socket 个数
- * @param content_name 响应的内容文件名
+ * @param content_name 响应的内容文件名，为NULL时只使用网页资源镜像
  * @param content 响应的内容
+ * 
+ * @note 网页资源在Tools/web_assets/www目录下，用web_assets.py打包成镜像（带gzip压缩版本、响应头和ETag），
+ *       编译进内部FLASH时生成w5500_web_assets.c，放在W25Q时见W5500_WEB_ROMFS_IN_W25Q
  */
 void W5500_WebServer_Init(uint8_t *socket_list, uint8_t socket_count, char *content_name, char *content)
 {
@@ -37,7 +258,51 @@ void W5500_WebServer_Init(uint8_t *socket_list, uint8_t socket_count, char *cont
     httpServer_init(g_w5500_web_server_tx_buff, g_w5500_web_server_rx_buff, socket_count, socket_list);
 
     // 注册HTML页面，表示服务器要响应的内容（网页）
-    reg_httpServer_webContent((uint8_t *)content_name, (uint8_t *)content);
+    if (content_name != NULL)
+    {
+        reg_httpServer_webContent((uint8_t *)content_name, (uint8_t *)content);
+    }
+
+    // 注册接口，请求按路径的哈希找到处理函数
+    reg_httpServer_route("/api/led", HTTP_ROUTE_GET | HTTP_ROUTE_HEAD, PTYPE_JSON, W5500_WebServer_LedHandler);
+
+    // 注册状态文档，GET /api/status，每个部分在变化或者到了周期时才重新渲染
+    g_w5500_web_status_led = W5500_WebStatus_Register("led", W5500_WebServer_RenderLed, 0);
+    W5500_WebStatus_Register("uptime", W5500_WebServer_RenderUptime, W5500_WEB_STATUS_PERIOD);
+    W5500_WebStatus_Register("network", W5500_WebServer_RenderNetwork, W5500_WEB_STATUS_PERIOD);
+    reg_httpServer_document("/api/status", PTYPE_JSON, &g_w5500_web_status_document);
+
+    // 注册指标，GET /metrics，驱动用Metrics_Register()注册的计数、当前值和直方图
+    reg_httpServer_document("/metrics", PTYPE_METRICS, &g_w5500_web_metrics_document);
+
+    // 注册WebSocket，网页通过ws://<IP>/ws/telemetry接收服务器推送的遥测数据
+    reg_httpServer_websocket("/ws/telemetry", &g_w5500_web_telemetry_websocket);
+
+#ifdef _USE_SDCARD_
+    // 挂载SD卡，没有注册的页面到SD卡的HTTP_SDCARD_ROOT目录下查找，挂载失败时只响应注册的内容
+    FRESULT result = f_mount(&g_w5500_web_server_fatfs, "0:", 1);
+    if (result != FR_OK)
+    {
+        printf("SD卡挂载失败: %d\r\n", result);
+    }
+    else
+    {
+        // 注册上传接口，multipart/form-data或者?name=<文件名>的请求体，支持Content-Length和chunked
+        W5500_WebUpload_Init();
+        reg_httpServer_upload("/api/upload", PTYPE_JSON, &g_w5500_web_upload);
+    }
+#endif
+
+    // 网页资源镜像，按文件名二分查找，响应头在镜像里，客户端支持时发送gzip压缩的版本
+#if W5500_WEB_ROMFS_IN_W25Q
+    SPI_FLASH_Init();
+#ifdef _USE_SDCARD_
+    W5500_WebServer_InstallRomfs(W5500_WEB_ROMFS_SDCARD_PATH);
+#endif
+    reg_httpServer_romfs(NULL, W5500_WebServer_RomfsRead);
+#else
+    reg_httpServer_romfs(g_w5500_web_romfs, NULL);
+#endif
 }
 
 /**
@@ -46,41 +311,17 @@ void W5500_WebServer_Init(uint8_t *socket_list, uint8_t socket_count, char *cont
  */
 void W5500_WebServer_Start(void)
 {
-    // 处理HTTP服务器
-    for (uint8_t i = 0; i < g_w5500_web_server_socket_count; i++)
+    // 定时采样，没有WebSocket连接时不写入
+    if (HAL_GetTick() - g_w5500_web_telemetry_tick >= W5500_WEB_TELEMETRY_PERIOD)
     {
-        httpServer_run(g_w5500_web_server_socket_list[i]);
+        g_w5500_web_telemetry_tick = HAL_GetTick();
+        W5500_WebTelemetry_Push("{\"t\":%lu,\"spi\":%lu,\"led\":%d}", (unsigned long)g_w5500_web_telemetry_tick,
+                                (unsigned long)g_w5500_spi_byte_count, HAL_GPIO_ReadPin(GPIOF, GPIO_PIN_9) == GPIO_PIN_RESET);
     }
-}
 
-/**
- * @brief W55000 Web服务器用户自定义函数
- * 
- * @param url 返回的URL
- */
-void handler_user_funcion(char *url)
-{
-    // 从URL里提取出参数
-    char *pAction = strstr(url, "action=");
-    if (pAction != NULL)
+    // 处理HTTP服务器
+    for (uint8_t i = 0; i < g_w5500_web_server_socket_count; i++)
     {
-        // 获取具体的参数值
-        int action = 0;
-        if (sscanf(pAction, "action=%d", &action) == 1)
-        {
-            switch (action)
-            {
-            case 1:
-                // 打开灯
-                LED_SetStatus(GPIOF, GPIO_PIN_9, LED_ON);
-                break;
-            case 2:
-                // 关闭灯
-                LED_SetStatus(GPIOF, GPIO_PIN_9, LED_OFF);
-                break;
-            default:
-                break;
-            }
-        }
+        httpServer_run(g_w5500_web_server_socket_list[i]);
     }
 }
\ No newline at end of file
@@ -5,11 +5,37 @@
 #include <string.h>
 
 #include "httpServer/httpServer.h"
+#include "httpServer/httpParser.h"
+
+#ifdef _USE_SDCARD_
+#include "ff.h"
+#endif
 
 #include "led/led.h"
+#include "metrics/metrics.h"
+
+#include "w5500/w5500_device.h"
+#include "w5500/w5500_web_assets.h"
+#include "w5500/w5500_web_status.h"
+#include "w5500/w5500_web_telemetry.h"
+#include "w5500/w5500_web_upload.h"
+
+#define W5500_WEB_TELEMETRY_PERIOD      50                                      // WebSocket推送遥测数据的周期，单位ms
+#define W5500_WEB_STATUS_PERIOD         1000                                    // 状态文档中计数类部分重新渲染的周期，单位ms
+#define W5500_WEB_METRICS_SIZE          4096                                    // Prometheus格式的指标最长的字节数
+
+// 网页资源镜像的位置，0: 编译进内部FLASH（w5500_web_assets.c）; 1: W25Q的W5500_WEB_ROMFS_ADDRESS处
+#define W5500_WEB_ROMFS_IN_W25Q         0
+#define W5500_WEB_ROMFS_ADDRESS         0x00F00000                              // W25Q128最后的1MB
+#define W5500_WEB_ROMFS_SDCARD_PATH     "0:/www.rom"                            // SD卡上有新的镜像时写到W25Q，见W5500_WebServer_InstallRomfs()
+
+#if W5500_WEB_ROMFS_IN_W25Q
+#include "flash/spi_flash.h"
+#endif
 
-extern char *g_web_server_content_name;
-extern char *g_web_server_content;
+#ifdef _USE_SDCARD_
+extern FATFS g_w5500_web_server_fatfs;
+#endif
 
 void W5500_WebServer_Init(uint8_t *socket_list, uint8_t socket_count, char *content_name, char *content);
 void W5500_WebServer_Start(void);
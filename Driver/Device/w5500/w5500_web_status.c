@@ -0,0 +1,204 @@
+#include "w5500_web_status.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static W5500_WebStatus_t g_w5500_web_status;
+
+/**
+ * @brief 重新渲染脏的和到了周期的部分
+ * 
+ * @note 渲染到临时缓冲区，和上一次的结果相同时不算变化
+ */
+static void W5500_WebStatus_Render(void)
+{
+    W5500_WebStatus_t *status = &g_w5500_web_status;
+    W5500_WebStatus_Section_t *section;
+    char value[W5500_WEB_STATUS_VALUE_SIZE];
+    uint32_t tick = HAL_GetTick();
+    uint16_t length;
+
+    for (uint8_t i = 0; i < status->count; i++)
+    {
+        section = &status->section[i];
+        if (!section->dirty && (section->period == 0 || tick - section->tick < section->period))
+        {
+            continue;
+        }
+
+        length = section->render(value, sizeof(value));
+        if (length == 0 || length >= sizeof(value))
+        {
+            length = 4;
+            memcpy(value, "null", 4);
+        }
+        status->renders++;
+
+        if (length != section->length || memcmp(value, section->value, length) != 0)
+        {
+            memcpy(section->value, value, length);
+            section->length = length;
+            status->changed = 1;
+        }
+        section->dirty = 0;
+        section->tick = tick;
+    }
+}
+
+/**
+ * @brief 把所有部分的值拼接成文档
+ * 
+ * @param index 文档缓冲区，不能正在发送
+ */
+static void W5500_WebStatus_Build(uint8_t index)
+{
+    W5500_WebStatus_t *status = &g_w5500_web_status;
+    W5500_WebStatus_Section_t *section;
+    char *document = status->document[index];
+    uint16_t length = 0;
+
+    document[length++] = '{';
+    for (uint8_t i = 0; i < status->count; i++)
+    {
+        section = &status->section[i];
+        if (i != 0)
+        {
+            document[length++] = ',';
+        }
+        document[length++] = '"';
+        memcpy(&document[length], section->name, strlen(section->name));
+        length += strlen(section->name);
+        document[length++] = '"';
+        document[length++] = ':';
+        memcpy(&document[length], section->value, section->length);
+        length += section->length;
+    }
+    document[length++] = '}';
+
+    status->length[index] = length;
+    status->version++;
+    snprintf(status->etag[index], W5500_WEB_STATUS_ETAG_SIZE, "\"%08lx\"", (unsigned long)status->version);
+    status->current = index;
+    status->changed = 0;
+    status->builds++;
+}
+
+/**
+ * @brief 注册状态文档的一个部分
+ * 
+ * @param name 文档里的键，只能是字母、数字和下划线
+ * @param render 渲染函数
+ * @param period 定时重新渲染的周期，单位ms，0: 只在W5500_WebStatus_Invalidate()之后渲染
+ * @return int8_t 部分的编号; -1: 已经注册满了或者名字太长
+ * 
+ * @note 在HTTP服务器开始处理请求之前注册
+ */
+int8_t W5500_WebStatus_Register(const char *name, W5500_WebStatus_Render_t render, uint32_t period)
+{
+    W5500_WebStatus_t *status = &g_w5500_web_status;
+    W5500_WebStatus_Section_t *section;
+
+    if (status->count >= W5500_WEB_STATUS_SECTIONS || render == NULL || strlen(name) >= W5500_WEB_STATUS_NAME_SIZE)
+    {
+        return -1;
+    }
+
+    section = &status->section[status->count];
+    strcpy(section->name, name);
+    section->render = render;
+    section->period = period;
+    section->length = 0;
+    section->dirty = 1;
+
+    return status->count++;
+}
+
+/**
+ * @brief 标记一个部分为脏，下次请求时重新渲染
+ * 
+ * @param id W5500_WebStatus_Register()返回的编号
+ * 
+ * @note 只是设置标志，可以在状态变化的地方随时调用
+ */
+void W5500_WebStatus_Invalidate(int8_t id)
+{
+    if (id < 0 || id >= g_w5500_web_status.count)
+    {
+        return;
+    }
+
+    g_w5500_web_status.section[id].dirty = 1;
+}
+
+/**
+ * @brief 打开状态文档，httpServer_document的open
+ * 
+ * @param seqnum HTTP socket序号
+ * @param request 请求，没有使用
+ * @param len 输出文档的长度
+ * @param etag 输出文档的ETag
+ * @return const uint8_t* 文档，W5500_WebStatus_Close()之前不会修改
+ */
+const uint8_t *W5500_WebStatus_Open(uint8_t seqnum, const st_http_route_request *request, uint32_t *len, const char **etag)
+{
+    W5500_WebStatus_t *status = &g_w5500_web_status;
+    uint8_t index;
+
+    (void)request;
+
+    if (seqnum >= W5500_SOCKET_COUNT)
+    {
+        return NULL;
+    }
+
+    W5500_WebStatus_Render();
+
+    // 拼接到没有在发送的缓冲区，优先用另一个，正在发送的连接读到的还是完整的旧文档
+    if (status->changed || status->builds == 0)
+    {
+        index = status->current ^ 1;
+        if (status->readers[index] == 0)
+        {
+            W5500_WebStatus_Build(index);
+        }
+        else if (status->readers[status->current] == 0)
+        {
+            W5500_WebStatus_Build(status->current);
+        }
+    }
+
+    index = status->current;
+    status->readers[index] |= 1 << seqnum;
+    *len = status->length[index];
+    *etag = status->etag[index];
+
+    return (const uint8_t *)status->document[index];
+}
+
+/**
+ * @brief 文档发送完了或者连接关闭了，httpServer_document的close
+ * 
+ * @param seqnum HTTP socket序号
+ */
+void W5500_WebStatus_Close(uint8_t seqnum)
+{
+    if (seqnum >= W5500_SOCKET_COUNT)
+    {
+        return;
+    }
+
+    g_w5500_web_status.readers[0] &= ~(1 << seqnum);
+    g_w5500_web_status.readers[1] &= ~(1 << seqnum);
+}
+
+/**
+ * @brief 获取渲染和拼接的次数，用来确认轮询的连接数不影响渲染的开销
+ * 
+ * @param renders 部分渲染的次数
+ * @param builds 文档拼接的次数
+ */
+void W5500_WebStatus_GetStats(uint32_t *renders, uint32_t *builds)
+{
+    *renders = g_w5500_web_status.renders;
+    *builds = g_w5500_web_status.builds;
+}
\ No newline at end of file
@@ -0,0 +1,63 @@
+#ifndef __W5500_WEB_STATUS_H__
+#define __W5500_WEB_STATUS_H__
+
+#include <stdint.h>
+
+#include "httpServer/httpServer.h"
+
+#include "w5500/w5500_event.h"
+
+#define W5500_WEB_STATUS_SECTIONS       8                                       // 最多注册的部分数
+#define W5500_WEB_STATUS_NAME_SIZE      16                                      // 部分名字最长的字节数，包括'\0'
+#define W5500_WEB_STATUS_VALUE_SIZE     128                                     // 部分渲染结果最长的字节数，包括'\0'
+#define W5500_WEB_STATUS_DOCUMENT_SIZE  (W5500_WEB_STATUS_SECTIONS * (W5500_WEB_STATUS_NAME_SIZE + W5500_WEB_STATUS_VALUE_SIZE + 4) + 2)
+#define W5500_WEB_STATUS_ETAG_SIZE      12                                      // "\"xxxxxxxx\""，包括'\0'
+
+/**
+ * @brief 渲染一个部分的值，写入buf的是一个JSON值（数字、字符串、对象等）
+ * 
+ * @param buf 缓冲区
+ * @param size 缓冲区大小
+ * @return uint16_t 值的长度，0或者不小于size时这个部分输出null
+ */
+typedef uint16_t (*W5500_WebStatus_Render_t)(char *buf, uint16_t size);
+
+typedef struct W5500_WebStatus_Section_t
+{
+    char name[W5500_WEB_STATUS_NAME_SIZE];                                      // 文档里的键
+    W5500_WebStatus_Render_t render;
+    uint32_t period;                                                            // 定时重新渲染的周期，单位ms，0: 只在标记为脏之后
+    uint32_t tick;                                                              // 上一次渲染的时间
+    char value[W5500_WEB_STATUS_VALUE_SIZE];                                    // 上一次渲染的结果
+    uint16_t length;
+    uint8_t dirty;                                                              // W5500_WebStatus_Invalidate()标记，下次请求时重新渲染
+} W5500_WebStatus_Section_t;
+
+/**
+ * 状态文档由各个子系统注册的部分组成：{"名字":值,...}。每个部分的渲染结果单独缓存，请求时只重新渲染标记为脏
+ * 或者到了周期的部分，结果和上一次相同时不重新拼接文档，ETag不变，带If-None-Match的请求回复304。
+ * 文档直接从这里写到socket，不复制到HTTP服务器的缓冲区，所有连接共用一份。发送中的文档不能修改，
+ * 所以有两个缓冲区，一个在发送时在另一个里拼接；两个都在发送时继续发送旧的文档，下次请求再拼接
+ */
+typedef struct W5500_WebStatus_t
+{
+    W5500_WebStatus_Section_t section[W5500_WEB_STATUS_SECTIONS];
+    uint8_t count;
+    uint8_t changed;                                                            // 有部分的值变了，文档还没有重新拼接
+    char document[2][W5500_WEB_STATUS_DOCUMENT_SIZE];
+    uint16_t length[2];
+    char etag[2][W5500_WEB_STATUS_ETAG_SIZE];
+    uint8_t current;                                                            // 最新的文档
+    uint8_t readers[2];                                                         // 正在发送每个文档的连接，按socket序号的位
+    uint32_t version;                                                           // 文档的版本，用作ETag
+    uint32_t renders;                                                           // 部分渲染的次数
+    uint32_t builds;                                                            // 文档拼接的次数
+} W5500_WebStatus_t;
+
+int8_t W5500_WebStatus_Register(const char *name, W5500_WebStatus_Render_t render, uint32_t period);
+void W5500_WebStatus_Invalidate(int8_t id);
+const uint8_t *W5500_WebStatus_Open(uint8_t seqnum, const st_http_route_request *request, uint32_t *len, const char **etag);
+void W5500_WebStatus_Close(uint8_t seqnum);
+void W5500_WebStatus_GetStats(uint32_t *renders, uint32_t *builds);
+
+#endif // !__W5500_WEB_STATUS_H__
\ No newline at end of file
@@ -0,0 +1,139 @@
+#include "w5500_web_telemetry.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static W5500_WebTelemetry_t g_w5500_web_telemetry;
+
+/**
+ * @brief 打开一个连接的读位置，先发送缓冲区里已有的记录，网页打开时就能画出最近的曲线
+ * 
+ * @param seqnum HTTP socket序号
+ */
+void W5500_WebTelemetry_Open(uint8_t seqnum)
+{
+    W5500_WebTelemetry_t *telemetry = &g_w5500_web_telemetry;
+
+    if (seqnum >= W5500_SOCKET_COUNT)
+    {
+        return;
+    }
+
+    telemetry->cursor[seqnum] = telemetry->head > W5500_WEB_TELEMETRY_RECORDS ? telemetry->head - W5500_WEB_TELEMETRY_RECORDS : 0;
+    telemetry->dropped[seqnum] = 0;
+    telemetry->readers |= 1 << seqnum;
+}
+
+/**
+ * @brief 关闭一个连接的读位置
+ * 
+ * @param seqnum HTTP socket序号
+ */
+void W5500_WebTelemetry_Close(uint8_t seqnum)
+{
+    if (seqnum >= W5500_SOCKET_COUNT)
+    {
+        return;
+    }
+
+    g_w5500_web_telemetry.readers &= ~(1 << seqnum);
+}
+
+/**
+ * @brief 写入一条记录，缓冲区满时覆盖最旧的记录
+ * 
+ * @param format 格式化字符串，结果是一个JSON对象
+ * @return int8_t 0: 成功; -1: 没有打开的连接，不写入; -2: 记录太长
+ * 
+ * @note 只能在主循环中调用，读和写在同一个上下文中，不需要加锁
+ */
+int8_t W5500_WebTelemetry_Push(const char *format, ...)
+{
+    W5500_WebTelemetry_t *telemetry = &g_w5500_web_telemetry;
+    uint32_t index = telemetry->head & (W5500_WEB_TELEMETRY_RECORDS - 1);
+    va_list args;
+    int length;
+
+    if (telemetry->readers == 0)
+    {
+        return -1;
+    }
+
+    va_start(args, format);
+    length = vsnprintf(telemetry->record[index], W5500_WEB_TELEMETRY_RECORD_SIZE, format, args);
+    va_end(args);
+
+    // 截断的记录不是完整的JSON，丢弃
+    if (length < 0 || length >= W5500_WEB_TELEMETRY_RECORD_SIZE)
+    {
+        return -2;
+    }
+
+    telemetry->length[index] = length;
+    telemetry->head++;
+
+    return 0;
+}
+
+/**
+ * @brief 把一个连接还没有读的记录打包成一个JSON数组
+ * 
+ * @param seqnum HTTP socket序号
+ * @param buf 缓冲区
+ * @param size 缓冲区大小，放不下的记录留到下一次
+ * @return uint16_t 数组的长度，没有新记录时为0
+ */
+uint16_t W5500_WebTelemetry_Read(uint8_t seqnum, uint8_t *buf, uint16_t size)
+{
+    W5500_WebTelemetry_t *telemetry = &g_w5500_web_telemetry;
+    uint32_t index;
+    uint16_t length = 0;
+
+    if (seqnum >= W5500_SOCKET_COUNT || telemetry->cursor[seqnum] == telemetry->head)
+    {
+        return 0;
+    }
+
+    // 落后超过一圈，被覆盖的记录跳过
+    if (telemetry->head - telemetry->cursor[seqnum] > W5500_WEB_TELEMETRY_RECORDS)
+    {
+        telemetry->dropped[seqnum] += telemetry->head - telemetry->cursor[seqnum] - W5500_WEB_TELEMETRY_RECORDS;
+        telemetry->cursor[seqnum] = telemetry->head - W5500_WEB_TELEMETRY_RECORDS;
+    }
+
+    while (telemetry->cursor[seqnum] != telemetry->head)
+    {
+        index = telemetry->cursor[seqnum] & (W5500_WEB_TELEMETRY_RECORDS - 1);
+
+        // '['或','，记录本身，还要留一个字节给']'
+        if (length + 1 + telemetry->length[index] + 1 > size)
+        {
+            break;
+        }
+
+        buf[length] = length == 0 ? '[' : ',';
+        length++;
+        memcpy(&buf[length], telemetry->record[index], telemetry->length[index]);
+        length += telemetry->length[index];
+        telemetry->cursor[seqnum]++;
+    }
+
+    if (length == 0)
+    {
+        return 0;
+    }
+    buf[length++] = ']';
+
+    return length;
+}
+
+/**
+ * @brief 获取一个连接被覆盖的记录数
+ * 
+ * @param seqnum HTTP socket序号
+ * @return uint32_t 记录数
+ */
+uint32_t W5500_WebTelemetry_GetDropped(uint8_t seqnum)
+{
+    return seqnum < W5500_SOCKET_COUNT ? g_w5500_web_telemetry.dropped[seqnum] : 0;
+}
\ No newline at end of file
@@ -0,0 +1,32 @@
+#ifndef __W5500_WEB_TELEMETRY_H__
+#define __W5500_WEB_TELEMETRY_H__
+
+#include <stdint.h>
+#include <stdarg.h>
+
+#include "w5500/w5500_event.h"
+
+#define W5500_WEB_TELEMETRY_RECORDS         32                                  // 环形缓冲区的记录数，必须是2的幂
+#define W5500_WEB_TELEMETRY_RECORD_SIZE     96                                  // 每条记录最长的字节数，包括'\0'
+
+/**
+ * 所有WebSocket连接共用一个环形缓冲区，主循环写入，每个连接有自己的读位置。
+ * 连接读得太慢时最旧的记录被覆盖，读位置跳到最旧的有效记录并计入dropped
+ */
+typedef struct W5500_WebTelemetry_t
+{
+    char record[W5500_WEB_TELEMETRY_RECORDS][W5500_WEB_TELEMETRY_RECORD_SIZE];  // 一条记录是一个JSON对象
+    uint8_t length[W5500_WEB_TELEMETRY_RECORDS];
+    uint32_t head;                                                              // 写入的记录总数
+    uint32_t cursor[W5500_SOCKET_COUNT];                                        // 每个连接下一条要读的记录
+    uint32_t dropped[W5500_SOCKET_COUNT];                                       // 每个连接没来得及发送就被覆盖的记录数
+    uint8_t readers;                                                            // 打开的连接，按socket序号的位
+} W5500_WebTelemetry_t;
+
+void W5500_WebTelemetry_Open(uint8_t seqnum);
+void W5500_WebTelemetry_Close(uint8_t seqnum);
+int8_t W5500_WebTelemetry_Push(const char *format, ...);
+uint16_t W5500_WebTelemetry_Read(uint8_t seqnum, uint8_t *buf, uint16_t size);
+uint32_t W5500_WebTelemetry_GetDropped(uint8_t seqnum);
+
+#endif // !__W5500_WEB_TELEMETRY_H__
\ No newline at end of file
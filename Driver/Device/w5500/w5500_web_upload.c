@@ -0,0 +1,213 @@
+#include "w5500_web_upload.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _USE_SDCARD_
+static W5500_WebUpload_t g_w5500_web_upload = {.seqnum = -1};
+
+/**
+ * @brief 关闭正在写入的文件
+ * 
+ * @param keep 1: 文件写完了，临时文件改成原来的名字; 0: 删除临时文件
+ * @return uint8_t 1: 成功; 0: 失败
+ */
+static uint8_t W5500_WebUpload_Close(uint8_t keep)
+{
+    W5500_WebUpload_t *upload = &g_w5500_web_upload;
+    char path[W5500_WEB_UPLOAD_PATH_SIZE];
+    uint8_t result = 1;
+
+    if (!upload->writing)
+    {
+        return 1;
+    }
+    upload->writing = 0;
+
+    if (f_close(&upload->file) != FR_OK || !keep)
+    {
+        f_unlink(upload->path);
+        return 0;
+    }
+
+    // 同名的旧文件在新文件完整写入后才被替换
+    strcpy(path, upload->path);
+    path[strlen(path) - strlen(W5500_WEB_UPLOAD_TEMP_SUFFIX)] = '\0';
+    f_unlink(path);
+    if (f_rename(upload->path, path) != FR_OK)
+    {
+        f_unlink(upload->path);
+        result = 0;
+    }
+    else
+    {
+        upload->files++;
+    }
+
+    return result;
+}
+
+/**
+ * @brief 初始化上传目录
+ * 
+ * @note 在SD卡挂载之后调用
+ */
+void W5500_WebUpload_Init(void)
+{
+    FRESULT result = f_mkdir(W5500_WEB_UPLOAD_DIR);
+
+    if (result != FR_OK && result != FR_EXIST)
+    {
+        printf("创建上传目录失败: %d\r\n", result);
+    }
+}
+
+/**
+ * @brief 开始一个上传
+ * 
+ * @param seqnum HTTP socket序号
+ * @param request 请求，没有请求体，参数name是不是multipart/form-data时的文件名
+ * @return uint8_t HTTP_OK: 接受; HTTP_FAILED: 已经有一个上传在进行，回复400
+ */
+uint8_t W5500_WebUpload_Begin(uint8_t seqnum, const st_http_route_request *request)
+{
+    W5500_WebUpload_t *upload = &g_w5500_web_upload;
+
+    if (upload->seqnum >= 0)
+    {
+        return HTTP_FAILED;
+    }
+
+    if (!get_http_query_value(request->query, request->query_len, "name", upload->name, sizeof(upload->name)))
+    {
+        upload->name[0] = '\0';
+    }
+    upload->seqnum = seqnum;
+    upload->writing = 0;
+    upload->files = 0;
+    upload->bytes = 0;
+
+    return HTTP_OK;
+}
+
+/**
+ * @brief 开始请求体的一个部分，有文件名时创建临时文件，上一个文件已经写完
+ * 
+ * @param seqnum HTTP socket序号
+ * @param name 部分的name，用不到
+ * @param filename 部分的filename，没有时这个部分不保存; 为NULL时请求体不是multipart/form-data，用请求参数name
+ * @return uint8_t 1: 继续; 0: 停止上传
+ */
+uint8_t W5500_WebUpload_Part(uint8_t seqnum, const char *name, const char *filename)
+{
+    W5500_WebUpload_t *upload = &g_w5500_web_upload;
+    const char *separator;
+
+    (void)name;
+    if (seqnum != upload->seqnum || !W5500_WebUpload_Close(1))
+    {
+        return 0;
+    }
+
+    if (filename == NULL)
+    {
+        filename = upload->name;
+        if (filename[0] == '\0')
+        {
+            return 0;
+        }
+    }
+
+    // 只保留文件名，浏览器可能带上客户端的路径
+    if ((separator = strrchr(filename, '/')) != NULL || (separator = strrchr(filename, '\\')) != NULL)
+    {
+        filename = separator + 1;
+    }
+    if (filename[0] == '\0')
+    {
+        return 1;
+    }
+    // 名字太长时截断的路径可能丢掉后缀，关闭时就会改错文件名
+    if (strlen(filename) >= HTTP_UPLOAD_MAX_FILENAME || strcmp(filename, ".") == 0 || strcmp(filename, "..") == 0 || strchr(filename, ':') != NULL)
+    {
+        return 0;
+    }
+
+    snprintf(upload->path, sizeof(upload->path), "%s/%s%s", W5500_WEB_UPLOAD_DIR, filename, W5500_WEB_UPLOAD_TEMP_SUFFIX);
+    if (f_open(&upload->file, upload->path, FA_CREATE_ALWAYS | FA_WRITE) != FR_OK)
+    {
+        return 0;
+    }
+    upload->writing = 1;
+
+    return 1;
+}
+
+/**
+ * @brief 写入当前部分的数据
+ * 
+ * @param seqnum HTTP socket序号
+ * @param data 数据，在HTTP服务器的接收缓冲区里
+ * @param len 数据的长度
+ * @return uint8_t 1: 继续; 0: 写入失败（SD卡满），停止上传
+ */
+uint8_t W5500_WebUpload_Data(uint8_t seqnum, const uint8_t *data, uint16_t len)
+{
+    W5500_WebUpload_t *upload = &g_w5500_web_upload;
+    UINT written;
+
+    if (seqnum != upload->seqnum)
+    {
+        return 0;
+    }
+    if (!upload->writing)
+    {
+        return 1;
+    }
+
+    if (f_write(&upload->file, data, len, &written) != FR_OK || written != len)
+    {
+        return 0;
+    }
+    upload->bytes += len;
+
+    return 1;
+}
+
+/**
+ * @brief 结束上传，回复写入的文件数和字节数
+ * 
+ * @param seqnum HTTP socket序号
+ * @param complete 1: 收到了完整的请求体; 0: 请求体有错误、写入失败或者连接断开
+ * @param buf 响应内容的缓冲区，为NULL时连接已经断开，不回复
+ * @param len 输入缓冲区的大小，输出响应内容的长度
+ * @return uint8_t HTTP_OK: 成功; HTTP_FAILED: 失败，回复400
+ * 
+ * @note 失败时正在写入的文件被删除，已经写完的文件保留
+ */
+uint8_t W5500_WebUpload_End(uint8_t seqnum, uint8_t complete, uint8_t *buf, uint16_t *len)
+{
+    W5500_WebUpload_t *upload = &g_w5500_web_upload;
+
+    if (seqnum != upload->seqnum)
+    {
+        return HTTP_FAILED;
+    }
+
+    if (!W5500_WebUpload_Close(complete))
+    {
+        complete = 0;
+    }
+    upload->seqnum = -1;
+    printf("上传%s: %u个文件，%lu字节\r\n", complete ? "完成" : "失败", upload->files, (unsigned long)upload->bytes);
+
+    if (buf == NULL || !complete)
+    {
+        return HTTP_FAILED;
+    }
+
+    *len = snprintf((char *)buf, *len, "{\"files\":%u,\"bytes\":%lu}", upload->files, (unsigned long)upload->bytes);
+
+    return HTTP_OK;
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,38 @@
+#ifndef __W5500_WEB_UPLOAD_H__
+#define __W5500_WEB_UPLOAD_H__
+
+#include <stdint.h>
+
+#include "httpServer/httpServer.h"
+#include "httpServer/httpParser.h"
+
+#ifdef _USE_SDCARD_
+#include "ff.h"
+
+#define W5500_WEB_UPLOAD_DIR            "0:/upload"                             // 上传的文件保存在SD卡的这个目录下
+#define W5500_WEB_UPLOAD_TEMP_SUFFIX    ".part"                                 // 写入时的临时文件名后缀，写完才改成原来的名字
+#define W5500_WEB_UPLOAD_PATH_SIZE      (sizeof(W5500_WEB_UPLOAD_DIR) + HTTP_UPLOAD_MAX_FILENAME + sizeof(W5500_WEB_UPLOAD_TEMP_SUFFIX))
+
+/**
+ * 同一时间只有一个上传，请求体边收边写入SD卡，内存只有这个结构体和HTTP服务器的接收缓冲区。
+ * multipart/form-data的每个带filename的部分保存为一个文件，其它类型的请求体保存为请求参数name指定的文件
+ */
+typedef struct W5500_WebUpload_t
+{
+    FIL file;
+    char path[W5500_WEB_UPLOAD_PATH_SIZE];                                      // 正在写入的临时文件
+    char name[HTTP_UPLOAD_MAX_FILENAME];                                        // 请求参数name
+    int8_t seqnum;                                                              // 正在上传的HTTP socket序号，-1: 空闲
+    uint8_t writing;                                                            // file已经打开
+    uint16_t files;                                                             // 这次上传写完的文件数
+    uint32_t bytes;                                                             // 这次上传写入的字节数
+} W5500_WebUpload_t;
+
+void W5500_WebUpload_Init(void);
+uint8_t W5500_WebUpload_Begin(uint8_t seqnum, const st_http_route_request *request);
+uint8_t W5500_WebUpload_Part(uint8_t seqnum, const char *name, const char *filename);
+uint8_t W5500_WebUpload_Data(uint8_t seqnum, const uint8_t *data, uint16_t len);
+uint8_t W5500_WebUpload_End(uint8_t seqnum, uint8_t complete, uint8_t *buf, uint16_t *len);
+#endif
+
+#endif // !__W5500_WEB_UPLOAD_H__
\ No newline at end of file
@@ -6,4 +6,6 @@
 void BSP_EXTI2_Init(void);
 void BSP_EXTI0_Init(void);
 
+void BSP_EXTI_Callback(uint16_t GPIO_Pin);
+
 #endif // !__BSP_EXTI_H__
\ No newline at end of file
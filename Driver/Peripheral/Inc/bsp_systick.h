@@ -7,4 +7,6 @@ void Delay_Init(void);
 void Delay_us(uint32_t us);
 void Delay_ms(uint32_t ms);
 
+uint32_t SysTick_GetMicros(void);
+
 #endif // !__BSP_SYSTICK_H__
\ No newline at end of file
@@ -8,24 +8,127 @@
 
 #include "stm32f4xx_hal.h"
 
+#include "bsp_dma.h"
+
+#include "metrics/metrics.h"
+#include "frame/frame.h"
+
 #define UART_RECEIVE_LENGTH 200
 
+#define UART_RX_BUFFER_SIZE                     1024                            // DMA循环接收缓冲区大小，必须是2的幂
+
+// USART1_RX: DMA2_Stream5通道4（DMA2_Stream2已经给SPI1_RX使用），USART2_RX: DMA1_Stream5通道4
+#define USART1_RX_DMA_STREAM                    DMA2_Stream5
+#define USART1_RX_DMA_CHANNEL                   DMA_CHANNEL_4
+#define USART1_RX_DMA_IRQn                      DMA2_Stream5_IRQn
+#define USART2_RX_DMA_STREAM                    DMA1_Stream5
+#define USART2_RX_DMA_CHANNEL                   DMA_CHANNEL_4
+#define USART2_RX_DMA_IRQn                      DMA1_Stream5_IRQn
+
+#define UART_TX_BUFFER_SIZE                     2048                            // DMA发送队列大小，必须是2的幂
+
+// USART1_TX: DMA2_Stream7通道4，USART2_TX: DMA1_Stream6通道4
+#define USART1_TX_DMA_STREAM                    DMA2_Stream7
+#define USART1_TX_DMA_CHANNEL                   DMA_CHANNEL_4
+#define USART1_TX_DMA_IRQn                      DMA2_Stream7_IRQn
+#define USART2_TX_DMA_STREAM                    DMA1_Stream6
+#define USART2_TX_DMA_CHANNEL                   DMA_CHANNEL_4
+#define USART2_TX_DMA_IRQn                      DMA1_Stream6_IRQn
+
+#define USART1_TX_POLICY                        UART_TX_POLICY_DROP             // 调试串口，日志宁可丢掉也不能拖慢主循环
+#define USART2_TX_POLICY                        UART_TX_POLICY_BLOCK            // ESP32串口，AT指令不能丢
+
+// 发送队列满了时的处理策略
+typedef enum UART_TxPolicy_t
+{
+    UART_TX_POLICY_DROP,                                                        // 丢弃放不下的新数据
+    UART_TX_POLICY_BLOCK,                                                       // 等待DMA腾出空间，在中断里或者关中断时退化为丢弃
+    UART_TX_POLICY_OVERWRITE,                                                   // 丢弃最旧的还没有交给DMA的数据
+} UART_TxPolicy_t;
+
+// 串口DMA发送队列，上一段DMA发送完成后在中断里接着发送下一段
+typedef struct UART_TxQueue_t
+{
+    uint8_t *buffer;
+    uint16_t size;                                                              // 缓冲区大小，必须是2的幂
+    DMA_HandleTypeDef *hdma;                                                    // 普通模式的发送DMA句柄
+    UART_HandleTypeDef *huart;                                                  // 为NULL时队列还没有初始化
+    UART_TxPolicy_t policy;                                                     // 队列满了时的处理策略
+    volatile uint32_t head;                                                     // 写入队列的总字节数
+    volatile uint32_t tail;                                                     // 交给DMA的总字节数
+    volatile uint16_t active;                                                   // 正在DMA发送的字节数
+    volatile uint32_t sent;                                                     // DMA发送完成的总字节数
+    volatile uint32_t dropped;                                                  // 队列满了丢弃的字节数
+} UART_TxQueue_t;
+
+// 串口DMA循环接收的环形缓冲区，DMA是写者，主循环是唯一的读者
+typedef struct UART_RxRing_t
+{
+    uint8_t *buffer;
+    uint16_t size;                                                              // 缓冲区大小，必须是2的幂
+    DMA_HandleTypeDef *hdma;                                                    // 循环模式的接收DMA句柄
+    volatile uint32_t head;                                                     // DMA写入的总字节数，只在半传输、传输完成和总线空闲中断里更新
+    volatile uint32_t idle;                                                     // 最近一次总线空闲时的head，用来划分数据帧
+    uint32_t tail;                                                              // 读者读走的总字节数，只由读者修改
+    volatile uint32_t overflow;                                                 // DMA套圈读者后丢弃的字节数
+    volatile uint32_t overrun;                                                  // 接收过载的次数，DMA没有及时读走数据寄存器
+} UART_RxRing_t;
+
+// 接收数据的视图，环形缓冲区回绕时分成两段
+typedef struct UART_RxView_t
+{
+    uint8_t *data[2];
+    uint16_t length[2];
+    uint16_t total;                                                             // 两段的总长度
+} UART_RxView_t;
+
+// 按总线空闲划分的文本帧，由BSP_UART_ReceiveFrame()从环形缓冲区里拼出来，给ESP32的AT指令使用；
+// 二进制数据用BSP_UART_ReceiveFrames()和BSP_UART_SendFrame()收发COBS编码的帧
 typedef struct UART_FrameData_t
 {
     uint16_t length;                                                            // 数据长度
     bool finsh;                                                                 // 是否接收完成
     uint8_t data[UART_RECEIVE_LENGTH];                                          // 帧接收缓冲
+    uint32_t truncated;                                                         // 帧太长放不下被丢掉的字节数
+    UART_RxRing_t *ring;                                                        // 数据来源的环形缓冲区
 } UART_FrameData_t;
 
 extern UART_HandleTypeDef g_usart1_handle;                                      // USART1句柄
 extern UART_HandleTypeDef g_usart2_handle;                                      // USART1句柄
 
+extern DMA_HandleTypeDef g_usart1_dma_rx_handle;                                // USART1接收DMA句柄
+extern DMA_HandleTypeDef g_usart2_dma_rx_handle;                                // USART2接收DMA句柄
+
+extern UART_RxRing_t g_usart1_rx_ring;                                          // USART1接收环形缓冲区
+extern UART_RxRing_t g_usart2_rx_ring;                                          // USART2接收环形缓冲区
+
+extern DMA_HandleTypeDef g_usart1_dma_tx_handle;                                // USART1发送DMA句柄
+extern DMA_HandleTypeDef g_usart2_dma_tx_handle;                                // USART2发送DMA句柄
+
+extern UART_TxQueue_t g_usart1_tx_queue;                                        // USART1发送队列
+extern UART_TxQueue_t g_usart2_tx_queue;                                        // USART2发送队列
+
 extern UART_FrameData_t g_usart1_frame_data;                                    // USART1帧数据
 extern UART_FrameData_t g_usart2_frame_data;                                    // USART2帧数据
 
 void BSP_UART_Init(UART_HandleTypeDef *huart, USART_TypeDef *UARTx, uint32_t band);
+
+uint16_t BSP_UART_RxAvailable(UART_RxRing_t *ring);
+uint16_t BSP_UART_RxPeek(UART_RxRing_t *ring, UART_RxView_t *view);
+bool BSP_UART_RxConsume(UART_RxRing_t *ring, uint16_t length);
+uint16_t BSP_UART_RxRead(UART_RxRing_t *ring, uint8_t *data, uint16_t length);
+
+uint32_t BSP_UART_ReceiveFrames(UART_RxRing_t *ring, Frame_Parser_t *parser);
+bool BSP_UART_SendFrame(UART_HandleTypeDef *huart, const uint8_t *payload, uint16_t length);
+
+bool BSP_UART_ReceiveFrame(UART_FrameData_t *frameData);
 uint16_t BSP_UART_GetFrameDataLength(UART_FrameData_t *frameData);
 void BSP_UART_ClearFrameData(UART_FrameData_t *frameData);
+
+uint16_t BSP_UART_Write(UART_HandleTypeDef *huart, const uint8_t *data, uint16_t length);
+void BSP_UART_SetTxPolicy(UART_HandleTypeDef *huart, UART_TxPolicy_t policy);
+uint16_t BSP_UART_TxSpace(UART_HandleTypeDef *huart);
+bool BSP_UART_Flush(UART_HandleTypeDef *huart, uint32_t timeout);
 void BSP_UART_Printf(UART_HandleTypeDef *huart, char *fmt, ...);
 
 
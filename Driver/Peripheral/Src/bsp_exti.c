@@ -56,6 +56,27 @@ void EXTI2_IRQHandler(void)
     HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_2);                                       // 调用HAL库的EXTI公共中断处理函数
 }
 
+/**
+ * @brief EXTI9_5中断服务函数
+ * 
+ */
+void EXTI9_5_IRQHandler(void)
+{
+    HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_9);                                       // 调用HAL库的EXTI公共中断处理函数
+}
+
+/**
+ * @brief BSP没有使用的EXTI引脚的回调函数，设备驱动重写该函数处理自己的中断引脚
+ * 
+ * @param GPIO_Pin EXTI的引脚
+ * 
+ * @note 在中断中调用
+ */
+__weak void BSP_EXTI_Callback(uint16_t GPIO_Pin)
+{
+    UNUSED(GPIO_Pin);
+}
+
 /**
  * @brief 重写HAL库的EXTI回调函数
  * 
@@ -75,5 +96,9 @@ void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
             HAL_GPIO_TogglePin(GPIOF, GPIO_PIN_9);                              // GPIO引脚电平的翻转
         }  
     }
+    else
+    {
+        BSP_EXTI_Callback(GPIO_Pin);                                            // 外部设备的中断引脚，交给设备驱动处理
+    }
 }
 
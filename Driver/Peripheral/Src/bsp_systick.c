@@ -68,6 +68,36 @@ void Delay_ms(uint32_t time)
     }
 }
 
+/**
+ * @brief 获取上电以来的微秒数
+ * 
+ * @return uint32_t 微秒数，大约71分钟溢出一次
+ * 
+ * @note 由HAL库的毫秒计数和SysTick->VAL组合而成，读取期间发生SysTick中断时重新读取。
+ *       关中断或者在更高优先级的中断里调用时，SysTick已经重装但中断还挂起着，毫秒计数要补上1
+ */
+uint32_t SysTick_GetMicros(void)
+{
+    uint32_t ms = 0;
+    uint32_t value = 0;
+    uint32_t pending = 0;
+
+    do
+    {
+        ms = HAL_GetTick();
+        value = SysTick->VAL;
+        pending = SCB->ICSR & SCB_ICSR_PENDSTSET_Msk;
+    } while (ms != HAL_GetTick());
+
+    // 挂起标志置位并且VAL接近LOAD，说明读VAL之前SysTick就已经重装了
+    if (pending && value > SysTick->LOAD / 2)
+    {
+        ms++;
+    }
+
+    return ms * 1000 + (SysTick->LOAD - value) / g_frequency_us;
+}
+
 /**
  * @brief 重写HAL的延迟函数
  * 
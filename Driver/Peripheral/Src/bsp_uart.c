@@ -3,10 +3,245 @@
 UART_HandleTypeDef g_usart1_handle;                                             // USART1句柄
 UART_HandleTypeDef g_usart2_handle;                                             // USART2句柄
 
-UART_FrameData_t g_usart1_frame_data;                                           // USART1帧数据
-UART_FrameData_t g_usart2_frame_data;                                           // USART2帧数据
+DMA_HandleTypeDef g_usart1_dma_rx_handle;                                       // USART1接收DMA句柄
+DMA_HandleTypeDef g_usart2_dma_rx_handle;                                       // USART2接收DMA句柄
 
-static void BSP_UART_IRQHandler(UART_HandleTypeDef *huart, UART_FrameData_t *pFrameData);
+static uint8_t g_usart1_rx_buffer[UART_RX_BUFFER_SIZE];                         // USART1的DMA循环接收缓冲区
+static uint8_t g_usart2_rx_buffer[UART_RX_BUFFER_SIZE];                         // USART2的DMA循环接收缓冲区
+
+UART_RxRing_t g_usart1_rx_ring = {g_usart1_rx_buffer, UART_RX_BUFFER_SIZE, &g_usart1_dma_rx_handle};
+UART_RxRing_t g_usart2_rx_ring = {g_usart2_rx_buffer, UART_RX_BUFFER_SIZE, &g_usart2_dma_rx_handle};
+
+DMA_HandleTypeDef g_usart1_dma_tx_handle;                                       // USART1发送DMA句柄
+DMA_HandleTypeDef g_usart2_dma_tx_handle;                                       // USART2发送DMA句柄
+
+static uint8_t g_usart1_tx_buffer[UART_TX_BUFFER_SIZE];                         // USART1的DMA发送队列缓冲区
+static uint8_t g_usart2_tx_buffer[UART_TX_BUFFER_SIZE];                         // USART2的DMA发送队列缓冲区
+
+UART_TxQueue_t g_usart1_tx_queue = {g_usart1_tx_buffer, UART_TX_BUFFER_SIZE, &g_usart1_dma_tx_handle, NULL, USART1_TX_POLICY};
+UART_TxQueue_t g_usart2_tx_queue = {g_usart2_tx_buffer, UART_TX_BUFFER_SIZE, &g_usart2_dma_tx_handle, NULL, USART2_TX_POLICY};
+
+UART_FrameData_t g_usart1_frame_data = {.ring = &g_usart1_rx_ring};             // USART1帧数据
+UART_FrameData_t g_usart2_frame_data = {.ring = &g_usart2_rx_ring};             // USART2帧数据
+
+static const Metrics_Entry_t g_usart1_metrics[] =
+{
+    {
+        .name = "uart_rx_bytes_total",
+        .help = "Bytes received by UART DMA",
+        .type = METRICS_TYPE_COUNTER,
+        .labels = "uart=\"1\"",
+        .value = &g_usart1_rx_ring.head
+    },
+    {
+        .name = "uart_rx_overflow_bytes_total",
+        .help = "Received bytes dropped because the DMA ring lapped the reader",
+        .type = METRICS_TYPE_COUNTER,
+        .labels = "uart=\"1\"",
+        .value = &g_usart1_rx_ring.overflow
+    },
+    {
+        .name = "uart_overruns_total",
+        .help = "UART receive overrun errors, bytes lost before they were read",
+        .type = METRICS_TYPE_COUNTER,
+        .labels = "uart=\"1\"",
+        .value = &g_usart1_rx_ring.overrun
+    },
+    {
+        .name = "uart_tx_bytes_total",
+        .help = "Bytes sent by UART DMA",
+        .type = METRICS_TYPE_COUNTER,
+        .labels = "uart=\"1\"",
+        .value = &g_usart1_tx_queue.sent
+    },
+    {
+        .name = "uart_tx_dropped_bytes_total",
+        .help = "Bytes dropped because the UART transmit queue was full",
+        .type = METRICS_TYPE_COUNTER,
+        .labels = "uart=\"1\"",
+        .value = &g_usart1_tx_queue.dropped
+    }
+};
+
+static const Metrics_Entry_t g_usart2_metrics[] =
+{
+    {
+        .name = "uart_rx_bytes_total",
+        .help = "Bytes received by UART DMA",
+        .type = METRICS_TYPE_COUNTER,
+        .labels = "uart=\"2\"",
+        .value = &g_usart2_rx_ring.head
+    },
+    {
+        .name = "uart_rx_overflow_bytes_total",
+        .help = "Received bytes dropped because the DMA ring lapped the reader",
+        .type = METRICS_TYPE_COUNTER,
+        .labels = "uart=\"2\"",
+        .value = &g_usart2_rx_ring.overflow
+    },
+    {
+        .name = "uart_overruns_total",
+        .help = "UART receive overrun errors, bytes lost before they were read",
+        .type = METRICS_TYPE_COUNTER,
+        .labels = "uart=\"2\"",
+        .value = &g_usart2_rx_ring.overrun
+    },
+    {
+        .name = "uart_tx_bytes_total",
+        .help = "Bytes sent by UART DMA",
+        .type = METRICS_TYPE_COUNTER,
+        .labels = "uart=\"2\"",
+        .value = &g_usart2_tx_queue.sent
+    },
+    {
+        .name = "uart_tx_dropped_bytes_total",
+        .help = "Bytes dropped because the UART transmit queue was full",
+        .type = METRICS_TYPE_COUNTER,
+        .labels = "uart=\"2\"",
+        .value = &g_usart2_tx_queue.dropped
+    }
+};
+
+/**
+ * @brief 根据DMA剩余传输计数发布环形缓冲区的写位置
+ * 
+ * @param ring 环形缓冲区
+ * 
+ * @note 只在半传输、传输完成和总线空闲中断里调用，这几个中断优先级相同不会互相抢占，所以head只有一个写者；
+ *       半传输和传输完成中断保证两次更新之间DMA最多写入半个缓冲区，不会漏掉整圈
+ */
+static void BSP_UART_RxRing_Update(UART_RxRing_t *ring)
+{
+    uint32_t mask = ring->size - 1;
+    uint32_t position = (ring->size - __HAL_DMA_GET_COUNTER(ring->hdma)) & mask;
+
+    ring->head += (position - ring->head) & mask;
+}
+
+/**
+ * @brief 接收DMA半传输和传输完成回调函数
+ * 
+ * @param hdma DMA句柄，Parent指向对应的环形缓冲区
+ */
+static void BSP_UART_RxDMA_Callback(DMA_HandleTypeDef *hdma)
+{
+    BSP_UART_RxRing_Update((UART_RxRing_t *)hdma->Parent);
+}
+
+/**
+ * @brief 启动串口的DMA循环接收
+ * 
+ * @param huart 串口句柄
+ * @param ring 环形缓冲区
+ * @param stream DMA数据流
+ * @param channel DMA通道
+ * @param irq DMA数据流的中断号
+ * 
+ * @note 不走HAL_UART_Receive_DMA()，HAL库在过载错误时会终止DMA接收，错误由BSP_UART_IRQHandler()自己清除
+ */
+static void BSP_UART_RxDMA_Start(UART_HandleTypeDef *huart, UART_RxRing_t *ring, DMA_Stream_TypeDef *stream, uint32_t channel, IRQn_Type irq)
+{
+    BSP_DMA_PeripheralToMemory_Init(ring->hdma, stream, channel, 8, DMA_CIRCULAR, DMA_PRIORITY_HIGH);
+    ring->hdma->Parent = ring;
+    ring->hdma->XferHalfCpltCallback = BSP_UART_RxDMA_Callback;                 // 设置了半传输回调HAL库才会打开半传输中断
+    ring->hdma->XferCpltCallback = BSP_UART_RxDMA_Callback;
+
+    HAL_NVIC_SetPriority(irq, 4, 0);                                            // 和串口中断同一个优先级
+    HAL_NVIC_EnableIRQ(irq);
+
+    ring->head = 0;
+    ring->idle = 0;
+    ring->tail = 0;
+
+    HAL_DMA_Start_IT(ring->hdma, (uint32_t)&huart->Instance->DR, (uint32_t)ring->buffer, ring->size);
+    SET_BIT(huart->Instance->CR3, USART_CR3_DMAR);                              // 使能串口的DMA接收请求
+}
+
+/**
+ * @brief 启动发送队列中下一段数据的DMA发送
+ * 
+ * @param queue 发送队列
+ * 
+ * @note 只能在关中断或者发送DMA中断里调用；回绕处分成两次DMA发送
+ */
+static void BSP_UART_TxQueue_Kick(UART_TxQueue_t *queue)
+{
+    uint32_t offset = queue->tail & (queue->size - 1);
+    uint32_t length = queue->head - queue->tail;
+
+    if ((queue->active != 0) || (length == 0))
+    {
+        return;
+    }
+
+    if (length > queue->size - offset)
+    {
+        length = queue->size - offset;
+    }
+
+    queue->active = length;
+    queue->tail += length;
+    HAL_DMA_Start_IT(queue->hdma, (uint32_t)(queue->buffer + offset), (uint32_t)&queue->huart->Instance->DR, length);
+}
+
+/**
+ * @brief 发送DMA传输完成回调函数
+ * 
+ * @param hdma DMA句柄，Parent指向对应的发送队列
+ */
+static void BSP_UART_TxDMA_Callback(DMA_HandleTypeDef *hdma)
+{
+    UART_TxQueue_t *queue = (UART_TxQueue_t *)hdma->Parent;
+
+    queue->sent += queue->active;
+    queue->active = 0;
+    BSP_UART_TxQueue_Kick(queue);                                               // 接着发送队列中剩下的数据
+}
+
+/**
+ * @brief 初始化串口的DMA发送队列
+ * 
+ * @param huart 串口句柄
+ * @param queue 发送队列
+ * @param stream DMA数据流
+ * @param channel DMA通道
+ * @param irq DMA数据流的中断号
+ */
+static void BSP_UART_TxDMA_Start(UART_HandleTypeDef *huart, UART_TxQueue_t *queue, DMA_Stream_TypeDef *stream, uint32_t channel, IRQn_Type irq)
+{
+    BSP_DMA_MemoryToPeripheral_Init(queue->hdma, stream, channel, 8, DMA_NORMAL, DMA_PRIORITY_MEDIUM);
+    queue->hdma->Parent = queue;
+    queue->hdma->XferCpltCallback = BSP_UART_TxDMA_Callback;
+
+    HAL_NVIC_SetPriority(irq, 4, 0);                                            // 和串口中断同一个优先级
+    HAL_NVIC_EnableIRQ(irq);
+
+    queue->head = 0;
+    queue->tail = 0;
+    queue->active = 0;
+
+    SET_BIT(huart->Instance->CR3, USART_CR3_DMAT);                              // 使能串口的DMA发送请求
+    queue->huart = huart;                                                       // 最后再设置，之前的输出都走轮询发送
+}
+
+/**
+ * @brief 根据串口句柄找到对应的发送队列
+ * 
+ * @param huart 串口句柄
+ * @return UART_TxQueue_t* 发送队列，串口没有发送队列或者还没有初始化时返回NULL
+ */
+static UART_TxQueue_t *BSP_UART_GetTxQueue(UART_HandleTypeDef *huart)
+{
+    if (g_usart1_tx_queue.huart == huart)
+    {
+        return &g_usart1_tx_queue;
+    }
+    else if (g_usart2_tx_queue.huart == huart)
+    {
+        return &g_usart2_tx_queue;
+    }
+    return NULL;
+}
 
 /**
  * @brief 串口初始化函数
@@ -27,8 +262,27 @@ void BSP_UART_Init(UART_HandleTypeDef *huart, USART_TypeDef *UARTx, uint32_t ban
     huart->Init.OverSampling = UART_OVERSAMPLING_16;                            // 过采样
     HAL_UART_Init(huart);
 
-    __HAL_UART_ENABLE_IT(huart, UART_IT_RXNE);                                  // 使能USART接收中断
     __HAL_UART_ENABLE_IT(huart, UART_IT_IDLE);                                  // 使能USART总线空闲中断
+    __HAL_UART_ENABLE_IT(huart, UART_IT_ERR);                                   // 使能USART错误中断，DMA接收时过载错误靠它上报
+
+    if (UARTx == USART1)
+    {
+        BSP_UART_RxDMA_Start(huart, &g_usart1_rx_ring, USART1_RX_DMA_STREAM, USART1_RX_DMA_CHANNEL, USART1_RX_DMA_IRQn);
+        BSP_UART_TxDMA_Start(huart, &g_usart1_tx_queue, USART1_TX_DMA_STREAM, USART1_TX_DMA_CHANNEL, USART1_TX_DMA_IRQn);
+        for (uint8_t i = 0; i < sizeof(g_usart1_metrics) / sizeof(g_usart1_metrics[0]); i++)
+        {
+            Metrics_Register(&g_usart1_metrics[i]);
+        }
+    }
+    else if (UARTx == USART2)
+    {
+        BSP_UART_RxDMA_Start(huart, &g_usart2_rx_ring, USART2_RX_DMA_STREAM, USART2_RX_DMA_CHANNEL, USART2_RX_DMA_IRQn);
+        BSP_UART_TxDMA_Start(huart, &g_usart2_tx_queue, USART2_TX_DMA_STREAM, USART2_TX_DMA_CHANNEL, USART2_TX_DMA_IRQn);
+        for (uint8_t i = 0; i < sizeof(g_usart2_metrics) / sizeof(g_usart2_metrics[0]); i++)
+        {
+            Metrics_Register(&g_usart2_metrics[i]);
+        }
+    }
 }
 
 /**
@@ -82,6 +336,235 @@ void HAL_UART_MspInit(UART_HandleTypeDef *huart)
     }
 }
 
+/**
+ * @brief 检查DMA有没有套圈读者，套圈了就丢弃已经发布的数据重新同步
+ * 
+ * @param ring 环形缓冲区
+ * @return true 发生了套圈，未读的数据已经丢弃
+ * @return false 未读的数据完好
+ * 
+ * @note 用DMA当前的剩余计数推算实际写位置，比已发布的head更靠前，只读不写head
+ */
+static bool BSP_UART_RxRing_CheckOverflow(UART_RxRing_t *ring)
+{
+    uint32_t mask = ring->size - 1;
+    uint32_t head = ring->head;
+    uint32_t position = (ring->size - __HAL_DMA_GET_COUNTER(ring->hdma)) & mask;
+    uint32_t written = head + ((position - head) & mask);
+
+    if (written - ring->tail <= ring->size)
+    {
+        return false;
+    }
+
+    ring->overflow += head - ring->tail;                                        // 未读的数据已经被部分覆盖，全部丢弃
+    ring->tail = head;
+    return true;
+}
+
+/**
+ * @brief 获取环形缓冲区中可以读取的字节数
+ * 
+ * @param ring 环形缓冲区
+ * @return uint16_t 可以读取的字节数
+ */
+uint16_t BSP_UART_RxAvailable(UART_RxRing_t *ring)
+{
+    BSP_UART_RxRing_CheckOverflow(ring);
+    return ring->head - ring->tail;
+}
+
+/**
+ * @brief 不拷贝地查看环形缓冲区中可以读取的数据
+ * 
+ * @param ring 环形缓冲区
+ * @param view 数据视图，回绕时分成两段
+ * @return uint16_t 可以读取的字节数
+ * 
+ * @note 视图指向DMA正在写的缓冲区，用完后要调用BSP_UART_RxConsume()确认数据在使用期间没有被覆盖
+ */
+uint16_t BSP_UART_RxPeek(UART_RxRing_t *ring, UART_RxView_t *view)
+{
+    uint16_t offset = 0;
+
+    view->total = BSP_UART_RxAvailable(ring);                                   // 先检查套圈，重新同步后tail会变
+    offset = ring->tail & (ring->size - 1);
+    view->data[0] = ring->buffer + offset;
+    view->length[0] = (view->total < ring->size - offset) ? view->total : ring->size - offset;
+    view->data[1] = ring->buffer;
+    view->length[1] = view->total - view->length[0];
+
+    return view->total;
+}
+
+/**
+ * @brief 消费环形缓冲区中的数据
+ * 
+ * @param ring 环形缓冲区
+ * @param length 消费的字节数
+ * @return true 消费成功，之前查看或拷贝的数据有效
+ * @return false 数据在使用期间被DMA覆盖，已经丢弃重新同步
+ */
+bool BSP_UART_RxConsume(UART_RxRing_t *ring, uint16_t length)
+{
+    if (BSP_UART_RxRing_CheckOverflow(ring))
+    {
+        return false;
+    }
+
+    if (length > ring->head - ring->tail)
+    {
+        length = ring->head - ring->tail;
+    }
+    ring->tail += length;
+    return true;
+}
+
+/**
+ * @brief 从环形缓冲区中读取数据
+ * 
+ * @param ring 环形缓冲区
+ * @param data 保存数据的缓冲区
+ * @param length 最多读取的字节数
+ * @return uint16_t 实际读取的字节数，数据在拷贝期间被覆盖时返回0
+ */
+uint16_t BSP_UART_RxRead(UART_RxRing_t *ring, uint8_t *data, uint16_t length)
+{
+    UART_RxView_t view;
+
+    BSP_UART_RxPeek(ring, &view);
+    if (length > view.total)
+    {
+        length = view.total;
+    }
+
+    if (length <= view.length[0])
+    {
+        memcpy(data, view.data[0], length);
+    }
+    else
+    {
+        memcpy(data, view.data[0], view.length[0]);
+        memcpy(data + view.length[0], view.data[1], length - view.length[0]);
+    }
+
+    return BSP_UART_RxConsume(ring, length) ? length : 0;
+}
+
+/**
+ * @brief 从环形缓冲区中解析出COBS编码的二进制帧，交给解析器的处理函数
+ * 
+ * @param ring 环形缓冲区
+ * @param parser 帧解析器
+ * @return uint32_t 处理完的字节数
+ * 
+ * @note 帧在环形缓冲区里原地解码，不拷贝；DMA套圈丢了数据时解析器丢弃到下一个分隔符
+ */
+uint32_t BSP_UART_ReceiveFrames(UART_RxRing_t *ring, Frame_Parser_t *parser)
+{
+    UART_RxView_t view;
+    uint32_t overflow = ring->overflow;
+    uint32_t consumed = 0;
+
+    BSP_UART_RxPeek(ring, &view);
+    if (ring->overflow != overflow)                                             // 查看时发生了套圈，之前扫描到的位置作废
+    {
+        Frame_Resync(parser);
+    }
+
+    if (view.total == 0)
+    {
+        return 0;
+    }
+
+    consumed = Frame_Parse(parser, view.data, view.length);
+    if (!BSP_UART_RxConsume(ring, consumed))
+    {
+        Frame_Resync(parser);
+    }
+
+    return consumed;
+}
+
+/**
+ * @brief 把数据编码成一帧发送出去
+ * 
+ * @param huart 串口句柄
+ * @param payload 数据
+ * @param length 数据长度，不大于FRAME_MAX_PAYLOAD
+ * @return true 整帧放进了发送队列
+ * @return false 数据太长，或者发送队列放不下
+ * 
+ * @note 不是阻塞策略的发送队列放不下时整帧丢弃，不会发出去半帧
+ */
+bool BSP_UART_SendFrame(UART_HandleTypeDef *huart, const uint8_t *payload, uint16_t length)
+{
+    UART_TxQueue_t *queue = BSP_UART_GetTxQueue(huart);
+    uint8_t buffer[FRAME_ENCODED_SIZE(FRAME_MAX_PAYLOAD)];
+    uint16_t size = 0;
+
+    if (length > FRAME_MAX_PAYLOAD)
+    {
+        return false;
+    }
+
+    size = Frame_Encode(payload, length, buffer, sizeof(buffer));
+    if ((queue != NULL) && (queue->policy != UART_TX_POLICY_BLOCK) && (BSP_UART_TxSpace(huart) < size))
+    {
+        queue->dropped += size;
+        return false;
+    }
+
+    return BSP_UART_Write(huart, buffer, size) == size;
+}
+
+/**
+ * @brief 把环形缓冲区中到最近一次总线空闲为止的数据拼成一帧
+ * 
+ * @param frameData 串口接收的数据帧
+ * @return true 帧接收完成
+ * @return false 还没有收到完整的帧
+ * 
+ * @note 两次调用之间收到的多帧会拼在一起，超出帧缓冲的部分丢弃并计入truncated
+ */
+bool BSP_UART_ReceiveFrame(UART_FrameData_t *frameData)
+{
+    UART_RxRing_t *ring = frameData->ring;
+    int32_t pending = 0;
+    uint16_t length = 0;
+
+    if (frameData->finsh)
+    {
+        return true;
+    }
+
+    BSP_UART_RxRing_CheckOverflow(ring);
+    pending = (int32_t)(ring->idle - ring->tail);
+    if (pending <= 0)
+    {
+        return false;
+    }
+
+    length = (pending < UART_RECEIVE_LENGTH - 1) ? pending : UART_RECEIVE_LENGTH - 1; // 留出一位给结束符'\0'
+    length = BSP_UART_RxRead(ring, frameData->data, length);
+    if (length == 0)
+    {
+        return false;
+    }
+
+    pending = (int32_t)(ring->idle - ring->tail);
+    if (pending > 0)
+    {
+        frameData->truncated += pending;
+        BSP_UART_RxConsume(ring, pending);
+    }
+
+    frameData->length = length;
+    frameData->data[length] = '\0';                                             // 添加结束符
+    frameData->finsh = true;                                                    // 标记帧接收完成
+    return true;
+}
+
 /**
  * @brief 获取串口接收到的数据帧的有效长度函数
  * 
@@ -90,19 +573,51 @@ void HAL_UART_MspInit(UART_HandleTypeDef *huart)
  */
 uint16_t BSP_UART_GetFrameDataLength(UART_FrameData_t *frameData)
 {
-    return (frameData->finsh) ? frameData->length : 0;
+    return BSP_UART_ReceiveFrame(frameData) ? frameData->length : 0;
 }
 
 /**
  * @brief 清除串口接收到的数据帧函数
  * 
  * @param frameData 串口接收的数据帧
+ * 
+ * @note 同时丢弃环形缓冲区里已经收到但还没有拼成帧的数据，和原来清空接收缓冲的行为一致
  */
 void BSP_UART_ClearFrameData(UART_FrameData_t *frameData)
 {
     memset(frameData->data, 0, frameData->length);
     frameData->length = 0;
     frameData->finsh = false;
+    BSP_UART_RxConsume(frameData->ring, BSP_UART_RxAvailable(frameData->ring));
+}
+
+/**
+ * @brief UART中断服务函数
+ * 
+ * @param huart 串口句柄
+ * @param ring 串口的接收环形缓冲区
+ * 
+ * @note 数据由DMA搬运，这里只处理总线空闲和接收错误，不再每个字节进一次中断
+ */
+static void BSP_UART_IRQHandler(UART_HandleTypeDef *huart, UART_RxRing_t *ring)
+{
+    uint32_t status = huart->Instance->SR;
+
+    if (status & (USART_SR_ORE | USART_SR_NE | USART_SR_FE | USART_SR_IDLE))
+    {
+        (void)huart->Instance->DR;                                              // 先读SR寄存器，再读DR寄存器，清除错误和总线空闲标志
+    }
+
+    if (status & USART_SR_ORE)                                                  // USART接收过载错误
+    {
+        ring->overrun++;                                                        // 记录过载次数
+    }
+
+    if (status & USART_SR_IDLE)                                                 // UART总线空闲中断
+    {
+        BSP_UART_RxRing_Update(ring);
+        ring->idle = ring->head;                                                // 标记帧接收完成
+    }
 }
 
 /**
@@ -111,8 +626,7 @@ void BSP_UART_ClearFrameData(UART_FrameData_t *frameData)
  */
 void USART1_IRQHandler(void)
 {
-    g_usart1_frame_data.finsh = false;
-    BSP_UART_IRQHandler(&g_usart1_handle, &g_usart1_frame_data);
+    BSP_UART_IRQHandler(&g_usart1_handle, &g_usart1_rx_ring);
 }
 
 /**
@@ -121,52 +635,188 @@ void USART1_IRQHandler(void)
  */
 void USART2_IRQHandler(void)
 {
-    g_usart2_frame_data.finsh = false;
-    BSP_UART_IRQHandler(&g_usart2_handle, &g_usart2_frame_data);
+    BSP_UART_IRQHandler(&g_usart2_handle, &g_usart2_rx_ring);
 }
 
 /**
- * @brief UART中断服务函数
+ * @brief USART1接收DMA中断服务函数
+ * 
+ */
+void DMA2_Stream5_IRQHandler(void)
+{
+    HAL_DMA_IRQHandler(&g_usart1_dma_rx_handle);
+}
+
+/**
+ * @brief USART2接收DMA中断服务函数
+ * 
+ */
+void DMA1_Stream5_IRQHandler(void)
+{
+    HAL_DMA_IRQHandler(&g_usart2_dma_rx_handle);
+}
+
+/**
+ * @brief 把数据放进串口的DMA发送队列
  * 
  * @param huart 串口句柄
- * @param pFrameData 串口接收的数据帧
+ * @param data 要发送的数据
+ * @param length 要发送的数据长度
+ * @return uint16_t 放进队列的字节数，队列满了时按发送队列的策略处理，丢弃的部分计入dropped
+ * 
+ * @note 数据放进队列就返回，不等待发送完成；串口还没有初始化发送队列时退回轮询发送
  */
-static void BSP_UART_IRQHandler(UART_HandleTypeDef *huart, UART_FrameData_t *pFrameData)
+uint16_t BSP_UART_Write(UART_HandleTypeDef *huart, const uint8_t *data, uint16_t length)
 {
-    uint8_t temp = 0;
-  
-    if (__HAL_UART_GET_FLAG(huart, UART_FLAG_ORE) != RESET)                     // USART接收过载错误中
+    UART_TxQueue_t *queue = BSP_UART_GetTxQueue(huart);
+    uint32_t primask = __get_PRIMASK();
+    uint32_t mask = 0;
+    uint32_t space = 0;
+    uint32_t chunk = 0;
+    uint32_t first = 0;
+    uint32_t discard = 0;
+    uint32_t i = 0;
+    uint16_t written = 0;
+    bool wait = false;
+
+    if (queue == NULL)
     {
-        __HAL_UART_CLEAR_OREFLAG(huart);                                        // 清除接收过载错误中断标志
-        (void)huart->Instance->SR;                                              // 先读SR寄存器，再读DR寄存器 
-        (void)huart->Instance->DR;
+        HAL_UART_Transmit(huart, (uint8_t *)data, length, 1000);
+        return length;
     }
-  
-    if (__HAL_UART_GET_FLAG(huart, UART_FLAG_RXNE) != RESET)                    // UART接收中断
+
+    mask = queue->size - 1;
+    wait = (queue->policy == UART_TX_POLICY_BLOCK) && (primask == 0) && (__get_IPSR() == 0); // 中断里或者关中断时等不到DMA腾出空间
+
+    while (written < length)
     {
-        HAL_UART_Receive(huart, &temp, 1, HAL_MAX_DELAY);                       // UART接收数据
-  
-        if (pFrameData->length < (UART_RECEIVE_LENGTH - 1))                     // 判断USART接收缓冲是否溢出，留出一位给结束符'\0'
+        __disable_irq();                                                        // 发送DMA中断也会修改队列，和其它中断里的printf()互斥
+
+        space = queue->size - (queue->head - queue->tail) - queue->active;
+        if ((space < length - written) && (queue->policy == UART_TX_POLICY_OVERWRITE))
         {
-            pFrameData->data[pFrameData->length] = temp;                        // 将接收到的数据写入缓冲
-            pFrameData->length++;                                               // 更新接收到的数据长度
+            discard = queue->head - queue->tail;                                // 只能丢弃还没有交给DMA的数据
+            if (discard > length - written - space)
+            {
+                discard = length - written - space;
+            }
+            for (i = queue->tail; i + discard < queue->head; i++)               // 正在发送的数据紧挨在tail前面，只能把较新的数据往前挪
+            {
+                queue->buffer[i & mask] = queue->buffer[(i + discard) & mask];
+            }
+            queue->head -= discard;
+            queue->dropped += discard;
+            space += discard;
         }
-        else                                                                    // UART接收缓冲溢出
+
+        chunk = (space < length - written) ? space : length - written;
+        first = (chunk < queue->size - (queue->head & mask)) ? chunk : queue->size - (queue->head & mask);
+        memcpy(queue->buffer + (queue->head & mask), data + written, first);
+        memcpy(queue->buffer, data + written + first, chunk - first);
+        queue->head += chunk;
+        written += chunk;
+
+        BSP_UART_TxQueue_Kick(queue);
+
+        if ((written < length) && !wait)
         {
-            pFrameData->length = 0;                                             // 覆盖之前收到的数据
-            pFrameData->data[pFrameData->length] = temp;                        // 将接收到的数据写入缓冲
-            pFrameData->length++;                                               // 更新接收到的数据长度
+            queue->dropped += length - written;
+            __set_PRIMASK(primask);
+            break;
         }
+
+        __set_PRIMASK(primask);
     }
-  
-    if (__HAL_UART_GET_FLAG(huart, UART_FLAG_IDLE) != RESET)                    // UART总线空闲中断
+
+    return written;
+}
+
+/**
+ * @brief 设置串口发送队列满了时的处理策略
+ * 
+ * @param huart 串口句柄
+ * @param policy 处理策略，可选值: [UART_TX_POLICY_DROP, UART_TX_POLICY_BLOCK, UART_TX_POLICY_OVERWRITE]
+ */
+void BSP_UART_SetTxPolicy(UART_HandleTypeDef *huart, UART_TxPolicy_t policy)
+{
+    UART_TxQueue_t *queue = BSP_UART_GetTxQueue(huart);
+
+    if (queue != NULL)
     {
-        pFrameData->finsh = true;                                               // 标记帧接收完成
-        pFrameData->data[pFrameData->length] = '\0';                            // 添加结束符
-        __HAL_UART_CLEAR_IDLEFLAG(huart);                                       // 清除USART总线空闲中断
+        queue->policy = policy;
     }
 }
 
+/**
+ * @brief 获取串口发送队列的空闲空间
+ * 
+ * @param huart 串口句柄
+ * @return uint16_t 现在写入不会被丢弃的字节数，串口没有发送队列时返回0
+ * 
+ * @note 用于整条写入的场合，比如二进制日志的记录不能被截断
+ */
+uint16_t BSP_UART_TxSpace(UART_HandleTypeDef *huart)
+{
+    UART_TxQueue_t *queue = BSP_UART_GetTxQueue(huart);
+
+    if (queue == NULL)
+    {
+        return 0;
+    }
+    return queue->size - (queue->head - queue->tail) - queue->active;
+}
+
+/**
+ * @brief 等待串口发送队列中的数据全部发送出去
+ * 
+ * @param huart 串口句柄
+ * @param timeout 超时时间，单位ms
+ * @return true 数据已经全部移出移位寄存器
+ * @return false 等待超时
+ * 
+ * @note 用在需要线路静默的场合，比如ESP32退出透传前后和复位之前
+ */
+bool BSP_UART_Flush(UART_HandleTypeDef *huart, uint32_t timeout)
+{
+    UART_TxQueue_t *queue = BSP_UART_GetTxQueue(huart);
+    uint32_t start = HAL_GetTick();
+
+    while ((queue != NULL) && ((queue->active != 0) || (queue->head != queue->tail)))
+    {
+        if (HAL_GetTick() - start > timeout)
+        {
+            return false;
+        }
+    }
+
+    while (__HAL_UART_GET_FLAG(huart, UART_FLAG_TC) == RESET)                   // DMA发送完成时最后一个字节还在移位寄存器里
+    {
+        if (HAL_GetTick() - start > timeout)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief USART1发送DMA中断服务函数
+ * 
+ */
+void DMA2_Stream7_IRQHandler(void)
+{
+    HAL_DMA_IRQHandler(&g_usart1_dma_tx_handle);
+}
+
+/**
+ * @brief USART2发送DMA中断服务函数
+ * 
+ */
+void DMA1_Stream6_IRQHandler(void)
+{
+    HAL_DMA_IRQHandler(&g_usart2_dma_tx_handle);
+}
+
 /**
  * @brief 重写_write使用printf()函数
  * 
@@ -177,7 +827,7 @@ static void BSP_UART_IRQHandler(UART_HandleTypeDef *huart, UART_FrameData_t *pFr
  */
 int _write(int fd, char *ptr, int length)
 {
-    HAL_UART_Transmit(&g_usart1_handle, (uint8_t *)ptr, length, 0xFFFF);        // g_usart1_handle是对应串口
+    BSP_UART_Write(&g_usart1_handle, (uint8_t *)ptr, length);                   // g_usart1_handle是对应串口，放进发送队列就返回
     return length;
 }
 
@@ -199,7 +849,7 @@ void BSP_UART_Printf(UART_HandleTypeDef *huart, char *fmt, ...)
 
     i = (strlen(buffer) > UART_RECEIVE_LENGTH) ? UART_RECEIVE_LENGTH : strlen(buffer);
 
-    HAL_UART_Transmit(huart, (uint8_t *)buffer, i, 1000);                         // 串口发送数据
+    BSP_UART_Write(huart, (uint8_t *)buffer, i);                                // 串口发送数据
 
     va_end(args);
 }
\ No newline at end of file
@@ -10,12 +10,39 @@
 #include "ff.h"			/* Obtains integer types */
 #include "diskio.h"		/* Declarations of disk functions */
 
+#include "bsp_systick.h"
+#include "metrics/metrics.h"
+
 /* Definitions of physical drive number for each drive */
 // #define DEV_RAM		0	/* Example: Map Ramdisk to physical drive 0 */
 // #define DEV_MMC		1	/* Example: Map MMC/SD card to physical drive 1 */
 // #define DEV_USB		2	/* Example: Map USB MSD to physical drive 2 */
 #define DEV_SD      0
 
+/* Latency of the sector reads and writes in us, exposed through the metrics registry */
+static const uint32_t sd_latency_bounds[] = {100, 250, 500, 1000, 2500, 5000, 10000, 25000, 50000, 100000};
+
+static Metrics_Histogram_t sd_read_latency = {sd_latency_bounds, sizeof(sd_latency_bounds) / sizeof(sd_latency_bounds[0])};
+static Metrics_Histogram_t sd_write_latency = {sd_latency_bounds, sizeof(sd_latency_bounds) / sizeof(sd_latency_bounds[0])};
+
+static const Metrics_Entry_t sd_read_latency_metric =
+{
+    .name = "sd_latency_microseconds",
+    .help = "Time of a disk_read() or disk_write() on the SD card",
+    .type = METRICS_TYPE_HISTOGRAM,
+    .labels = "op=\"read\"",
+    .histogram = &sd_read_latency
+};
+
+static const Metrics_Entry_t sd_write_latency_metric =
+{
+    .name = "sd_latency_microseconds",
+    .help = "Time of a disk_read() or disk_write() on the SD card",
+    .type = METRICS_TYPE_HISTOGRAM,
+    .labels = "op=\"write\"",
+    .histogram = &sd_write_latency
+};
+
 /*-----------------------------------------------------------------------*/
 /* Get Drive Status                                                      */
 /*-----------------------------------------------------------------------*/
@@ -43,6 +70,8 @@ DSTATUS disk_initialize (
         {
             return STA_NOINIT;
         }
+        Metrics_Register(&sd_read_latency_metric);
+        Metrics_Register(&sd_write_latency_metric);
     }
     return RES_OK;
 }
@@ -58,11 +87,14 @@ DRESULT disk_read (
 )
 {
     int result;
+    uint32_t start;
 
     switch (pdrv) 
     {
     case DEV_SD :
+        start = SysTick_GetMicros();
         result = SD_ReadData(&g_sd_handler, sector, count, buff);
+        Metrics_Observe(&sd_read_latency, SysTick_GetMicros() - start);
         if (result)
         {
             return RES_PARERR;
@@ -86,11 +118,14 @@ DRESULT disk_write (
 )
 {
     int result;
+    uint32_t start;
 
     switch (pdrv) 
     {
     case DEV_SD :
+        start = SysTick_GetMicros();
         result = SD_WriteData(&g_sd_handler, sector, count, (uint8_t *)buff);
+        Metrics_Observe(&sd_write_latency, SysTick_GetMicros() - start);
         if (result)
         {
             return RES_PARERR;
@@ -145,8 +145,16 @@ void     WIZCHIP_READ_BUF (uint32_t AddrSel, uint8_t* pBuf, uint16_t len)
 		spi_data[0] = (AddrSel & 0x00FF0000) >> 16;
 		spi_data[1] = (AddrSel & 0x0000FF00) >> 8;
 		spi_data[2] = (AddrSel & 0x000000FF) >> 0;
-		WIZCHIP.IF.SPI._write_burst(spi_data, 3);
-		WIZCHIP.IF.SPI._read_burst(pBuf, len);
+		//M20261019 : Send the whole frame again when the burst failed, up to _WIZCHIP_SPI_BURST_RETRY_ times
+		for(i = 0; i < _WIZCHIP_SPI_BURST_RETRY_; i++)
+		{
+		   wizchip_spi_burst_error = 0;
+		   WIZCHIP.IF.SPI._write_burst(spi_data, 3);
+		   WIZCHIP.IF.SPI._read_burst(pBuf, len);
+		   if(!wizchip_spi_burst_error) break;
+		   WIZCHIP.CS._deselect();
+		   WIZCHIP.CS._select();
+		}
    }
 
    WIZCHIP.CS._deselect();
@@ -176,8 +184,16 @@ void     WIZCHIP_WRITE_BUF(uint32_t AddrSel, uint8_t* pBuf, uint16_t len)
 		spi_data[0] = (AddrSel & 0x00FF0000) >> 16;
 		spi_data[1] = (AddrSel & 0x0000FF00) >> 8;
 		spi_data[2] = (AddrSel & 0x000000FF) >> 0;
-		WIZCHIP.IF.SPI._write_burst(spi_data, 3);
-		WIZCHIP.IF.SPI._write_burst(pBuf, len);
+		//M20261019 : Send the whole frame again when the burst failed, up to _WIZCHIP_SPI_BURST_RETRY_ times
+		for(i = 0; i < _WIZCHIP_SPI_BURST_RETRY_; i++)
+		{
+		   wizchip_spi_burst_error = 0;
+		   WIZCHIP.IF.SPI._write_burst(spi_data, 3);
+		   WIZCHIP.IF.SPI._write_burst(pBuf, len);
+		   if(!wizchip_spi_burst_error) break;
+		   WIZCHIP.CS._deselect();
+		   WIZCHIP.CS._select();
+		}
    }
 
    WIZCHIP.CS._deselect();
@@ -264,4 +280,16 @@ void wiz_recv_ignore(uint8_t sn, uint16_t len)
    setSn_RX_RD(sn,ptr);
 }
 
+//A20261019 : Read RX memory at an offset from Sn_RX_RD without moving it.
+void wiz_recv_peek(uint8_t sn, uint16_t offset, uint8_t *wizdata, uint16_t len)
+{
+   uint16_t ptr = 0;
+   uint32_t addrsel = 0;
+
+   if(len == 0) return;
+   ptr = getSn_RX_RD(sn) + offset;
+   addrsel = ((uint32_t)ptr << 8) + (WIZCHIP_RXBUF_BLOCK(sn) << 3);
+   WIZCHIP_READ_BUF(addrsel, wizdata, len);
+}
+
 #endif
@@ -2152,6 +2152,19 @@ void wiz_recv_data(uint8_t sn, uint8_t *wizdata, uint16_t len);
  */
 void wiz_recv_ignore(uint8_t sn, uint16_t len);
 
+/**
+ * @ingroup Basic_IO_function
+ * @brief It copies data to your buffer from internal RX memory without updating the Rx read pointer.
+ * @details It reads <i>len(variable)</i> bytes starting <i>offset(variable)</i> bytes after the Rx read pointer.
+ * The data stays in RX memory until wiz_recv_ignore() or wiz_recv_data() moves the pointer.
+ * @param (uint8_t)sn Socket number. It should be <b>0 ~ 7</b>.
+ * @param offset Offset from the Rx read pointer
+ * @param wizdata Pointer buffer to read data
+ * @param len Data length
+ * @sa wiz_recv_ignore()
+ */
+void wiz_recv_peek(uint8_t sn, uint16_t offset, uint8_t *wizdata, uint16_t len);
+
 /// @cond DOXY_APPLY_CODE
 #endif
 /// @endcond
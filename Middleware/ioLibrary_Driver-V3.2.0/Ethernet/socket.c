@@ -381,6 +381,47 @@ int32_t send(uint8_t sn, uint8_t * buf, uint16_t len)
    return (int32_t)len;
 }
 
+//A20261019 : Zero-copy send, the data is written to the TX buffer by the caller
+int32_t send_buffered(uint8_t sn, uint16_t len)
+{
+   uint8_t tmp=0;
+
+   CHECK_SOCKNUM();
+   CHECK_SOCKMODE(Sn_MR_TCP);
+   tmp = getSn_SR(sn);
+   if(tmp != SOCK_ESTABLISHED && tmp != SOCK_CLOSE_WAIT) return SOCKERR_SOCKSTATUS;
+   if( sock_is_sending & (1<<sn) )
+   {
+      tmp = getSn_IR(sn);
+      if(tmp & Sn_IR_SENDOK)
+      {
+         setSn_IR(sn, Sn_IR_SENDOK);
+         sock_is_sending &= ~(1<<sn);
+      }
+      else if(tmp & Sn_IR_TIMEOUT)
+      {
+         close(sn);
+         return SOCKERR_TIMEOUT;
+      }
+      else return SOCK_BUSY;
+   }
+   if(len == 0) return SOCK_OK;
+
+   #if _WIZCHIP_ == 5200
+      sock_next_rd[sn] = getSn_TX_RD(sn) + len;
+   #endif
+
+   #if _WIZCHIP_ == 5300
+      setSn_TX_WRSR(sn,len);
+   #endif
+
+   setSn_CR(sn,Sn_CR_SEND);
+   /* wait to process the command... */
+   while(getSn_CR(sn));
+   sock_is_sending |= (1 << sn);
+   return (int32_t)len;
+}
+
 
 int32_t recv(uint8_t sn, uint8_t * buf, uint16_t len)
 {
@@ -800,6 +841,9 @@ int8_t  ctlsocket(uint8_t sn, ctlsock_type cstype, void* arg)
       case CS_CLR_INTERRUPT:
          if( (*(uint8_t*)arg) > SIK_ALL) return SOCKERR_ARG;
          setSn_IR(sn,*(uint8_t*)arg);
+         //A20261019 : send() waits for SENDOK or TIMEOUT while sock_is_sending is set.
+         //            Once the interrupt dispatcher cleared them, send() would never see them.
+         if( (*(uint8_t*)arg) & (SIK_SENT | SIK_TIMEOUT) ) sock_is_sending &= ~(1<<sn);
          break;
       case CS_GET_INTERRUPT:
          *((uint8_t*)arg) = getSn_IR(sn);
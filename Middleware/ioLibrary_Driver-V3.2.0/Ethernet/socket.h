@@ -249,6 +249,25 @@ int8_t  disconnect(uint8_t sn);
  */
 int32_t send(uint8_t sn, uint8_t * buf, uint16_t len);
 
+//A20261019 : Zero-copy send
+/**
+ * @ingroup WIZnet_socket_APIs
+ * @brief	Send the data already written to the socket TX buffer in TCP socket.
+ * @details The caller writes the data with @ref wiz_send_data() (for example straight from a file system sector buffer)
+ *          and this function issues the SEND command for it, so the data is not copied into an intermediate buffer.
+ * @note    Call it with len 0 before writing the data: it returns @ref SOCK_OK only when the previous SEND is completed. \n
+ *          The data written must not exceed @ref getSn_TX_FSR(). It never blocks, it returns @ref SOCK_BUSY instead.
+ * @param sn Socket number. It should be <b>0 ~ @ref \_WIZCHIP_SOCK_NUM_</b>.
+ * @param len The byte length of data written to the TX buffer, 0 to check whether the socket is ready.
+ * @return	@b Success : The sent data size, @ref SOCK_OK when len is 0 \n
+ *          @b Fail    : \n @ref SOCKERR_SOCKSTATUS - Invalid socket status for socket operation \n
+ *                          @ref SOCKERR_TIMEOUT    - Timeout occurred \n
+ *                          @ref SOCKERR_SOCKMODE 	- Invalid operation in the socket \n
+ *                          @ref SOCKERR_SOCKNUM    - Invalid socket number \n
+ *                          @ref SOCK_BUSY          - Previous SEND is not completed.
+ */
+int32_t send_buffered(uint8_t sn, uint16_t len);
+
 /**
  * @ingroup WIZnet_socket_APIs
  * @brief	Receive data from the connected peer.
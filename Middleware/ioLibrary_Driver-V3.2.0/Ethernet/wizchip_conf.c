@@ -123,6 +123,7 @@ void 	wizchip_bus_writedata(uint32_t AddrSel, iodata_t wb)  { *((volatile iodata
 uint8_t wizchip_spi_readbyte(void) 
 {
    uint8_t value = 0;
+   g_w5500_spi_byte_count++;      //A20261019 : SPI overhead statistics
    if (HAL_SPI_Receive(&g_w5500_spi_handle, &value, 1, 1000) != HAL_OK) 
    {
         value = 0;
@@ -138,9 +139,13 @@ uint8_t wizchip_spi_readbyte(void)
 //void 	wizchip_spi_writebyte(uint8_t wb) {};
 void wizchip_spi_writebyte(uint8_t wb)
 {
+   g_w5500_spi_byte_count++;      //A20261019 : SPI overhead statistics
    HAL_SPI_Transmit(&g_w5500_spi_handle, &wb, 1, 1000);
 }
 
+//A20261019 : Set by the burst callbacks when a transfer failed, the W5500 address pointer is unknown after an aborted burst
+uint8_t wizchip_spi_burst_error = 0;
+
 /**
  * @brief Default function to burst read in SPI interface.
  * @note This function help not to access wrong address. If you do not describe this function or register any functions,
@@ -149,7 +154,7 @@ void wizchip_spi_writebyte(uint8_t wb)
 //void 	wizchip_spi_readburst(uint8_t* pBuf, uint16_t len) 	{}; 
 void wizchip_spi_readburst(uint8_t* pBuf, uint16_t len)
 {
-   HAL_SPI_Receive(&g_w5500_spi_handle, pBuf, len, 1000);
+   if (W5500_SPI_Receive(pBuf, len) != HAL_OK) wizchip_spi_burst_error = 1;   //A20261019 : WIZCHIP_READ_BUF retries the frame
 }
 
 /**
@@ -160,7 +165,7 @@ void wizchip_spi_readburst(uint8_t* pBuf, uint16_t len)
 //void 	wizchip_spi_writeburst(uint8_t* pBuf, uint16_t len) {};
 void wizchip_spi_writeburst(uint8_t* pBuf, uint16_t len)
 {
-   HAL_SPI_Transmit(&g_w5500_spi_handle, pBuf, len, 1000);
+   if (W5500_SPI_Transmit(pBuf, len) != HAL_OK) wizchip_spi_burst_error = 1;  //A20261019 : WIZCHIP_WRITE_BUF retries the frame
 }
 
 /**
@@ -938,5 +943,5 @@ void register_wizchip_function(void)
    // reg_wizchip_cris_cbfunc(wizchip_cris_enter, wizchip_cris_exit);               // 注册退出和进入临界区，使用操作系统时用
    reg_wizchip_cs_cbfunc(wizchip_cs_select, wizchip_cs_deselect);               // 注册SPI片选使能和失能
    reg_wizchip_spi_cbfunc(wizchip_spi_readbyte, wizchip_spi_writebyte);         // 注册SPI读写一个字节
-   // reg_wizchip_spi_cbfunc(wizchip_bus_readdata, wizchip_bus_writedata);         // 注册SPI读写多个字节
+   reg_wizchip_spiburst_cbfunc(wizchip_spi_readburst, wizchip_spi_writeburst);  // 注册SPI读写多个字节，长数据使用DMA
 }
\ No newline at end of file
@@ -290,6 +290,10 @@ typedef struct __WIZCHIP
 
 extern _WIZCHIP  WIZCHIP;
 
+//A20261019 : Set when a burst callback failed, WIZCHIP_READ_BUF()/WIZCHIP_WRITE_BUF() clear it and retry the whole frame
+#define _WIZCHIP_SPI_BURST_RETRY_   3
+extern uint8_t wizchip_spi_burst_error;
+
 /**
  * @ingroup DATA_TYPE
  *  WIZCHIP control type enumration used in @ref ctlwizchip().
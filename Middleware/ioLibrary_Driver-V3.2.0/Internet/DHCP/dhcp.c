@@ -67,6 +67,8 @@
 #define STATE_DHCP_REREQUEST     4        ///< send REQUEST for maintaining leased IP
 #define STATE_DHCP_RELEASE       5        ///< No use
 #define STATE_DHCP_STOP          6        ///< Stop processing DHCP
+//A20261019 : T2 expired without ACK from the leasing server, broadcast REQUEST to any server
+#define STATE_DHCP_REBIND        7        ///< send broadcast REQUEST for maintaining leased IP
 
 #define DHCP_FLAGSBROADCAST      0x8000   ///< The broadcast value of flags in @ref RIP_MSG 
 #define DHCP_FLAGSUNICAST        0x0000   ///< The unicast   value of flags in @ref RIP_MSG
@@ -210,6 +212,11 @@ uint32_t dhcp_lease_time   			= INFINITE_LEASETIME;
 volatile uint32_t dhcp_tick_1s      = 0;                 // unit 1 second
 uint32_t dhcp_tick_next    			= DHCP_WAIT_TIME ;
 
+//A20261019 : Renewal(T1) and rebinding(T2) time from the server, and the time since the lease was acknowledged
+uint32_t dhcp_t1_time                  = INFINITE_LEASETIME;
+uint32_t dhcp_t2_time                  = INFINITE_LEASETIME;
+volatile uint32_t dhcp_lease_tick   = 0;                 // unit 1 second
+
 uint32_t DHCP_XID;      // Any number
 
 RIP_MSG* pDHCPMSG;      // Buffer pointer for DHCP processing
@@ -432,7 +439,8 @@ void send_DHCP_REQUEST(void)
 
    makeDHCPMSG();
 
-   if(dhcp_state == STATE_DHCP_LEASED || dhcp_state == STATE_DHCP_REREQUEST)
+   //M20261019 : In REBIND, ciaddr is filled but the REQUEST is broadcast
+   if(dhcp_state == STATE_DHCP_LEASED || dhcp_state == STATE_DHCP_REREQUEST || dhcp_state == STATE_DHCP_REBIND)
    {
    	*((uint8_t*)(&pDHCPMSG->flags))   = ((DHCP_FLAGSUNICAST & 0xFF00)>> 8);
    	*((uint8_t*)(&pDHCPMSG->flags)+1) = (DHCP_FLAGSUNICAST & 0x00FF);
@@ -444,6 +452,13 @@ void send_DHCP_REQUEST(void)
    	ip[1] = DHCP_SIP[1];
    	ip[2] = DHCP_SIP[2];
    	ip[3] = DHCP_SIP[3];   	   	   	
+   	if(dhcp_state == STATE_DHCP_REBIND)
+   	{
+   	   ip[0] = 255;
+   	   ip[1] = 255;
+   	   ip[2] = 255;
+   	   ip[3] = 255;
+   	}
    }
    else
    {
@@ -470,7 +485,8 @@ void send_DHCP_REQUEST(void)
 	pDHCPMSG->OPT[k++] = DHCP_CHADDR[4];
 	pDHCPMSG->OPT[k++] = DHCP_CHADDR[5];
 
-   if(ip[3] == 255)  // if(dchp_state == STATE_DHCP_LEASED || dchp_state == DHCP_REREQUEST_STATE)
+   //M20261019 : RFC 2131, requested IP and server identifier MUST NOT be sent in REBIND
+   if(ip[3] == 255 && dhcp_state != STATE_DHCP_REBIND)  // if(dchp_state == STATE_DHCP_LEASED || dchp_state == DHCP_REREQUEST_STATE)
    {
 		pDHCPMSG->OPT[k++] = dhcpRequestedIPaddr;
 		pDHCPMSG->OPT[k++] = 0x04;
@@ -631,6 +647,10 @@ int8_t parseDHCPMSG(void)
 		p = p + 240;      // 240 = sizeof(RIP_MSG) + MAGIC_COOKIE size in RIP_MSG.opt - sizeof(RIP_MSG.opt)
 		e = p + (len - 240);
 
+		//A20261019 : T1 and T2 are optional, use the RFC 2131 defaults when the server omits them
+		dhcp_t1_time = INFINITE_LEASETIME;
+		dhcp_t2_time = INFINITE_LEASETIME;
+
 		while ( p < e ) {
 
 			switch ( *p ) {
@@ -683,6 +703,22 @@ int8_t parseDHCPMSG(void)
                dhcp_lease_time = 10;
  				#endif
    				break;
+   			case dhcpT1value :
+   				p++;
+   				opt_len = *p++;
+   				dhcp_t1_time  = *p++;
+   				dhcp_t1_time  = (dhcp_t1_time << 8) + *p++;
+   				dhcp_t1_time  = (dhcp_t1_time << 8) + *p++;
+   				dhcp_t1_time  = (dhcp_t1_time << 8) + *p++;
+   				break;
+   			case dhcpT2value :
+   				p++;
+   				opt_len = *p++;
+   				dhcp_t2_time  = *p++;
+   				dhcp_t2_time  = (dhcp_t2_time << 8) + *p++;
+   				dhcp_t2_time  = (dhcp_t2_time << 8) + *p++;
+   				dhcp_t2_time  = (dhcp_t2_time << 8) + *p++;
+   				break;
    			case dhcpServerIdentifier :
    				p++;
    				opt_len = *p++;
@@ -706,6 +742,51 @@ int8_t parseDHCPMSG(void)
 	return	type;
 }
 
+//A20261019 : Renewal time(T1), default 0.5 * lease time
+static uint32_t get_DHCP_renew_time(void)
+{
+	if(dhcp_t1_time != INFINITE_LEASETIME && dhcp_t1_time < dhcp_lease_time) return dhcp_t1_time;
+	return dhcp_lease_time / 2;
+}
+
+//A20261019 : Rebinding time(T2), default 0.875 * lease time
+static uint32_t get_DHCP_rebind_time(void)
+{
+	if(dhcp_t2_time != INFINITE_LEASETIME && dhcp_t2_time < dhcp_lease_time) return dhcp_t2_time;
+	return dhcp_lease_time / 8 * 7;
+}
+
+//A20261019 : ACK for RENEW or REBIND, the server may give back a different address
+static uint8_t check_DHCP_renewed_IP(void)
+{
+	uint8_t ret = DHCP_IP_LEASED;
+
+	DHCP_allocated_ip[0] = pDHCPMSG->yiaddr[0];
+	DHCP_allocated_ip[1] = pDHCPMSG->yiaddr[1];
+	DHCP_allocated_ip[2] = pDHCPMSG->yiaddr[2];
+	DHCP_allocated_ip[3] = pDHCPMSG->yiaddr[3];
+
+	dhcp_retry_count = 0;
+	if (OLD_allocated_ip[0] != DHCP_allocated_ip[0] || 
+	    OLD_allocated_ip[1] != DHCP_allocated_ip[1] ||
+	    OLD_allocated_ip[2] != DHCP_allocated_ip[2] ||
+	    OLD_allocated_ip[3] != DHCP_allocated_ip[3]) 
+	{
+		ret = DHCP_IP_CHANGED;
+		dhcp_ip_update();
+   #ifdef _DHCP_DEBUG_
+      printf(">IP changed.\r\n");
+   #endif
+	}
+   #ifdef _DHCP_DEBUG_
+   else printf(">IP is continued.\r\n");
+   #endif
+	reset_DHCP_timeout();
+	dhcp_lease_tick = 0;
+	dhcp_state = STATE_DHCP_LEASED;
+	return ret;
+}
+
 uint8_t DHCP_run(void)
 {
 	uint8_t  type;
@@ -753,6 +834,7 @@ uint8_t DHCP_run(void)
 					// Network info assignment from DHCP
 					dhcp_ip_assign();
 					reset_DHCP_timeout();
+					dhcp_lease_tick = 0;
 
 					dhcp_state = STATE_DHCP_LEASED;
 				} else {
@@ -775,7 +857,9 @@ uint8_t DHCP_run(void)
 
 		case STATE_DHCP_LEASED :
 		   ret = DHCP_IP_LEASED;
-			if ((dhcp_lease_time != INFINITE_LEASETIME) && ((dhcp_lease_time/2) < dhcp_tick_1s)) {
+			//M20261019 : Renew at T1, counted from the ACK
+			//if ((dhcp_lease_time != INFINITE_LEASETIME) && ((dhcp_lease_time/2) < dhcp_tick_1s)) {
+			if ((dhcp_lease_time != INFINITE_LEASETIME) && (get_DHCP_renew_time() < dhcp_lease_tick)) {
 				
 #ifdef _DHCP_DEBUG_
  				printf("> Maintains the IP address \r\n");
@@ -800,24 +884,7 @@ uint8_t DHCP_run(void)
 		case STATE_DHCP_REREQUEST :
 		   ret = DHCP_IP_LEASED;
 			if (type == DHCP_ACK) {
-				dhcp_retry_count = 0;
-				if (OLD_allocated_ip[0] != DHCP_allocated_ip[0] || 
-				    OLD_allocated_ip[1] != DHCP_allocated_ip[1] ||
-				    OLD_allocated_ip[2] != DHCP_allocated_ip[2] ||
-				    OLD_allocated_ip[3] != DHCP_allocated_ip[3]) 
-				{
-					ret = DHCP_IP_CHANGED;
-					dhcp_ip_update();
-               #ifdef _DHCP_DEBUG_
-                  printf(">IP changed.\r\n");
-               #endif
-					
-				}
-         #ifdef _DHCP_DEBUG_
-            else printf(">IP is continued.\r\n");
-         #endif            				
-				reset_DHCP_timeout();
-				dhcp_state = STATE_DHCP_LEASED;
+				ret = check_DHCP_renewed_IP();
 			} else if (type == DHCP_NAK) {
 
 #ifdef _DHCP_DEBUG_
@@ -827,8 +894,43 @@ uint8_t DHCP_run(void)
 				reset_DHCP_timeout();
 
 				dhcp_state = STATE_DHCP_DISCOVER;
-			} else ret = check_DHCP_timeout();
+				ret = DHCP_IP_EXPIRED;
+			} else if (get_DHCP_rebind_time() < dhcp_lease_tick) {
+				//M20261019 : Keep the lease until T2 instead of giving up after MAX_DHCP_RETRY
+#ifdef _DHCP_DEBUG_
+				printf("> T2 expired, rebinding\r\n");
+#endif
+				dhcp_state = STATE_DHCP_REBIND;
+				send_DHCP_REQUEST();
+				reset_DHCP_timeout();
+			} else if (dhcp_tick_next < dhcp_tick_1s) {
+				send_DHCP_REQUEST();
+				dhcp_tick_1s = 0;
+				dhcp_tick_next = DHCP_WAIT_TIME;
+			}
+	   	break;
+
+		case STATE_DHCP_REBIND :
+		   ret = DHCP_IP_LEASED;
+			if (type == DHCP_ACK) {
+				ret = check_DHCP_renewed_IP();
+			} else if (type == DHCP_NAK || dhcp_lease_time <= dhcp_lease_tick) {
+
+#ifdef _DHCP_DEBUG_
+				printf("> Lease expired\r\n");
+#endif
+
+				reset_DHCP_timeout();
+
+				dhcp_state = STATE_DHCP_INIT;
+				ret = DHCP_IP_EXPIRED;
+			} else if (dhcp_tick_next < dhcp_tick_1s) {
+				send_DHCP_REQUEST();
+				dhcp_tick_1s = 0;
+				dhcp_tick_next = DHCP_WAIT_TIME;
+			}
 	   	break;
+
 		default :
    		break;
 	}
@@ -975,6 +1077,7 @@ void reset_DHCP_timeout(void)
 void DHCP_time_handler(void)
 {
 	dhcp_tick_1s++;
+	dhcp_lease_tick++;
 }
 
 void getIPfromDHCP(uint8_t* ip)
@@ -82,7 +82,8 @@ enum
    DHCP_IP_ASSIGN,   ///< First Occupy IP from DHPC server      (if cbfunc == null, act as default default_ip_assign)
    DHCP_IP_CHANGED,  ///< Change IP address by new ip from DHCP (if cbfunc == null, act as default default_ip_update)
    DHCP_IP_LEASED,   ///< Stand by 
-   DHCP_STOPPED      ///< Stop processing DHCP protocol
+   DHCP_STOPPED,     ///< Stop processing DHCP protocol
+   DHCP_IP_EXPIRED   ///< Lease could not be renewed or rebound, the IP address is no longer valid
 };
 
 /*
@@ -115,6 +116,7 @@ void reg_dhcp_cbfunc(void(*ip_assign)(void), void(*ip_update)(void), void(*ip_co
  *            @ref DHCP_IP_CHANGED \n
  * 			  @ref DHCP_IP_LEASED  \n
  *            @ref DHCP_STOPPED    \n
+ *            @ref DHCP_IP_EXPIRED \n
  *
  * @note This function is always called by you main task.
  */ 
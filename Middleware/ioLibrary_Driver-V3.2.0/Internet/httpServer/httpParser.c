@@ -19,6 +19,35 @@ uint8_t BUFPUB[256];
  ****************************************************************************/
 static void replacetochar(uint8_t * str, uint8_t oldchar, uint8_t newchar); 	/* Replace old character with new character in the string */
 static uint8_t C2D(uint8_t c); 												/* Convert a character to HEX */
+static uint8_t equal_http_token(const uint8_t * str, uint16_t len, const char * method); 	/* Compare a token with a name, case insensitive */
+static const uint8_t * find_http_query_param(const uint8_t * query, uint16_t query_len, const char * name, uint16_t * len); 	/* Find a parameter in a query string */
+
+//A20261019 : States of the request parser
+#define HTTP_PARSER_METHOD			0			/* Request method */
+#define HTTP_PARSER_URI				1			/* Request target, path and query */
+#define HTTP_PARSER_VERSION			2			/* HTTP version, up to the end of the request line */
+#define HTTP_PARSER_LINE			3			/* Start of a header line, or the empty line */
+#define HTTP_PARSER_NAME			4			/* Header field name */
+#define HTTP_PARSER_VALUE_WS		5			/* White space before the field value */
+#define HTTP_PARSER_VALUE			6			/* Header field value, up to the end of the line */
+#define HTTP_PARSER_END_LF			7			/* LF of the empty line */
+#define HTTP_PARSER_FINISH			8			/* Header completed */
+#define HTTP_PARSER_FAIL			9			/* Malformed request */
+
+//A20261019 : MIME type by file name extension, replaces the strstr() chain of find_http_uri_type()
+static const struct
+{
+	char	ext[5];
+	uint8_t	type;
+} http_uri_types[] =
+{
+	{"htm",  PTYPE_HTML},	{"html", PTYPE_HTML},	{"gif",  PTYPE_GIF},	{"text", PTYPE_TEXT},
+	{"txt",  PTYPE_TEXT},	{"log",  PTYPE_TEXT},	{"csv",  PTYPE_TEXT},	{"jpeg", PTYPE_JPEG},
+	{"jpg",  PTYPE_JPEG},	{"swf",  PTYPE_FLASH},	{"cgi",  PTYPE_CGI},	{"json", PTYPE_JSON},
+	{"js",   PTYPE_JS},		{"xml",  PTYPE_XML},	{"css",  PTYPE_CSS},	{"png",  PTYPE_PNG},
+	{"ico",  PTYPE_ICO},	{"ttf",  PTYPE_TTF},	{"otf",  PTYPE_OTF},	{"woff", PTYPE_WOFF},
+	{"eot",  PTYPE_EOT},	{"svg",  PTYPE_SVG},
+};
 
 /**
  @brief	convert escape characters(%XX) to ASCII character
@@ -45,7 +74,8 @@ void unescape_http_url(
 void make_http_response_head(
 	char * buf, 	/**< pointer to response header to be made */
 	char type, 	/**< response type */
-	uint32_t len	/**< size of response header */
+	uint32_t len,	/**< size of response header */
+	uint8_t keep_alive	/**< 'Connection: keep-alive' or 'Connection: close' */ //A20261019
 	)
 {
 	char * head;
@@ -69,20 +99,26 @@ void make_http_response_head(
 	else if (type == PTYPE_WOFF)	head = RES_WOFFHEAD_OK;
 	else if (type == PTYPE_EOT)		head = RES_EOTHEAD_OK;
 	else if (type == PTYPE_SVG)		head = RES_SVGHEAD_OK;
+	else if (type == PTYPE_METRICS)	head = RES_METRICSHEAD_OK; //A20261019
+	//M20261019 : Files on SD card may have any extension, send them as binary instead of strcpy() from NULL
 #ifdef _HTTPPARSER_DEBUG_
 	else
 	{
-		head = NULL;
+		head = RES_BINHEAD_OK;
 		printf("\r\n\r\n-MAKE HEAD UNKNOWN-\r\n");
 	}
 #else
-	else head = NULL;
+	else head = RES_BINHEAD_OK;
 #endif	
 
 	sprintf(tmp, "%ld", len);
 	strcpy(buf, head);
 	strcat(buf, tmp);
-	strcat(buf, "\r\n\r\n");
+	//M20261019 : Connection header
+	//strcat(buf, "\r\n\r\n");
+	strcat(buf, "\r\n");
+	strcat(buf, keep_alive ? RES_CONNECTION_KEEPALIVE : RES_CONNECTION_CLOSE);
+	strcat(buf, "\r\n");
 }
 
 
@@ -95,29 +131,28 @@ void find_http_uri_type(
 	) 
 {
 	/* Decide type according to extension*/
+	//M20261019 : Look up the extension after the last '.' of the name, case insensitive
+	const char * ext = NULL;
+	const char * buf;
+	uint8_t i;
+
+	for(buf = (const char *)buff; *buf; buf++)
+	{
+		if(*buf == '.') ext = buf + 1;
+		else if(*buf == '/') ext = NULL;
+	}
 
-	char * buf;
-	buf = (char *)buff;
-
-	if 	(strstr(buf, ".htm")	|| strstr(buf, ".html"))	*type = PTYPE_HTML;
-	else if (strstr(buf, ".gif"))							*type = PTYPE_GIF;
-	else if (strstr(buf, ".text") 	|| strstr(buf,".txt"))	*type = PTYPE_TEXT;
-	else if (strstr(buf, ".jpeg") 	|| strstr(buf,".jpg"))	*type = PTYPE_JPEG;
-	else if (strstr(buf, ".swf")) 							*type = PTYPE_FLASH;
-	else if (strstr(buf, ".cgi") 	|| strstr(buf,".CGI"))	*type = PTYPE_CGI;
-	else if (strstr(buf, ".json") 	|| strstr(buf,".JSON"))	*type = PTYPE_JSON;
-	else if (strstr(buf, ".js") 	|| strstr(buf,".JS"))	*type = PTYPE_JS;
-	else if (strstr(buf, ".CGI") 	|| strstr(buf,".cgi"))	*type = PTYPE_CGI;
-	else if (strstr(buf, ".xml") 	|| strstr(buf,".XML"))	*type = PTYPE_XML;
-	else if (strstr(buf, ".css") 	|| strstr(buf,".CSS"))	*type = PTYPE_CSS;
-	else if (strstr(buf, ".png") 	|| strstr(buf,".PNG"))	*type = PTYPE_PNG;
-	else if (strstr(buf, ".ico") 	|| strstr(buf,".ICO"))	*type = PTYPE_ICO;
-	else if (strstr(buf, ".ttf") 	|| strstr(buf,".TTF"))	*type = PTYPE_TTF;
-	else if (strstr(buf, ".otf") 	|| strstr(buf,".OTF"))	*type = PTYPE_OTF;
-	else if (strstr(buf, ".woff") 	|| strstr(buf,".WOFF"))	*type = PTYPE_WOFF;
-	else if (strstr(buf, ".eot") 	|| strstr(buf,".EOT"))	*type = PTYPE_EOT;
-	else if (strstr(buf, ".svg") 	|| strstr(buf,".SVG"))	*type = PTYPE_SVG;
-	else 													*type = PTYPE_ERR;
+	*type = PTYPE_ERR;
+	if(!ext) return;
+
+	for(i = 0; i < sizeof(http_uri_types) / sizeof(http_uri_types[0]); i++)
+	{
+		if(equal_http_token((const uint8_t *)ext, buf - ext, http_uri_types[i].ext))
+		{
+			*type = http_uri_types[i].type;
+			return;
+		}
+	}
 }
 
 
@@ -129,41 +164,233 @@ void parse_http_request(
 	uint8_t * buf				/**< pointer to be parsed */
 	)
 {
-  char * nexttok;
-  nexttok = strtok((char*)buf," ");
-  if(!nexttok)
-  {
-    request->METHOD = METHOD_ERR;
-    return;
-  }
-  if(!strcmp(nexttok, "GET") || !strcmp(nexttok,"get"))
-  {
-    request->METHOD = METHOD_GET;
-    nexttok = strtok(NULL," ");
-
-  }
-  else if (!strcmp(nexttok, "HEAD") || !strcmp(nexttok,"head"))
-  {
-    request->METHOD = METHOD_HEAD;
-    nexttok = strtok(NULL," ");
-
-  }
-  else if (!strcmp(nexttok, "POST") || !strcmp(nexttok,"post"))
-  {
-    nexttok = strtok(NULL,"\0");
-    request->METHOD = METHOD_POST;
-  }
-  else
-  {
-    request->METHOD = METHOD_ERR;
-  }
-
-  if(!nexttok)
-  {
-    request->METHOD = METHOD_ERR;
-    return;
-  }
-  strcpy((char *)request->URI, nexttok);
+	//M20261019 : Single pass over the buffer instead of strtok(), buf is not modified
+	st_http_parser parser;
+	uint16_t len = strlen((char *)buf);
+
+	http_parser_init(&parser, NULL, NULL);
+	http_parser_execute(&parser, buf, len);
+	http_parser_get_request(&parser, buf, len, request);
+}
+
+
+/**
+ @brief	initialize the request parser for a new request
+ */
+void http_parser_init(
+	st_http_parser * parser,	/**< parser to be initialized */
+	http_header_cb on_header,	/**< called for each header field, may be NULL */
+	void * arg					/**< first argument of on_header */
+	)
+{
+	memset(parser, 0, sizeof(st_http_parser));
+	parser->state = HTTP_PARSER_METHOD;
+	parser->method = METHOD_ERR;
+	parser->on_header = on_header;
+	parser->arg = arg;
+}
+
+
+/**
+ @brief	parse the request header in buf, continuing where the last call stopped
+ @return	HTTP_PARSER_DONE when the empty line is reached, HTTP_PARSER_MORE when more data is needed,
+ 			HTTP_PARSER_ERROR on a malformed request
+ */
+int8_t http_parser_execute(
+	st_http_parser * parser,	/**< parser state */
+	const uint8_t * buf,		/**< request from its first byte */
+	uint16_t len				/**< bytes in buf */
+	)
+{
+	const uint8_t * lf;
+	uint16_t i = parser->pos;
+	uint16_t end;
+	uint8_t state = parser->state;
+	uint8_t c;
+
+	if(state == HTTP_PARSER_FINISH) return HTTP_PARSER_DONE;
+	if(state == HTTP_PARSER_FAIL) return HTTP_PARSER_ERROR;
+
+	// Each state scans its whole token in a tight loop; the parser is only written at token boundaries
+	while(i < len)
+	{
+		switch(state)
+		{
+			case HTTP_PARSER_METHOD :
+				for(; (i < len) && (buf[i] != ' '); i++)
+				{
+					if((buf[i] < 'A') || (buf[i] > 'z')) goto fail;
+				}
+				if(i == len) break;
+				if(i == parser->token) goto fail;
+
+				if(equal_http_token(buf + parser->token, i - parser->token, "GET")) parser->method = METHOD_GET;
+				else if(equal_http_token(buf + parser->token, i - parser->token, "HEAD")) parser->method = METHOD_HEAD;
+				else if(equal_http_token(buf + parser->token, i - parser->token, "POST")) parser->method = METHOD_POST;
+				else parser->method = METHOD_ERR;
+				parser->uri = ++i;
+				state = HTTP_PARSER_URI;
+				break;
+
+			case HTTP_PARSER_URI :
+				for(; i < len; i++)
+				{
+					c = buf[i];
+					if(c == ' ') break;
+					if((c == '?') && !parser->query)
+					{
+						parser->uri_len = i - parser->uri;
+						parser->query = i + 1;
+					}
+					else if((c < ' ') || (c == 0x7F)) goto fail; // HTTP/0.9 request line is not supported
+				}
+				if(i == len) break;
+				if(i == parser->uri) goto fail;
+
+				if(parser->query) parser->query_len = i - parser->query;
+				else parser->uri_len = i - parser->uri;
+				parser->token = ++i;
+				state = HTTP_PARSER_VERSION;
+				break;
+
+			case HTTP_PARSER_VERSION :
+			case HTTP_PARSER_VALUE :
+				// Rest of the line, the optional CR before LF and trailing white space are not part of it
+				lf = memchr(buf + i, '\n', len - i);
+				if(!lf)
+				{
+					i = len;
+					break;
+				}
+				i = lf - buf;
+				end = i;
+
+				if(state == HTTP_PARSER_VERSION)
+				{
+					if((end > parser->token) && (buf[end - 1] == '\r')) end--;
+					if((end - parser->token != 8) || memcmp(buf + parser->token, "HTTP/1.", 7) ||
+						(buf[end - 1] < '0') || (buf[end - 1] > '9')) goto fail;
+					parser->version = (buf[end - 1] == '0') ? 10 : 11;
+				}
+				else
+				{
+					while((end > parser->value) && ((buf[end - 1] == ' ') || (buf[end - 1] == '\t') || (buf[end - 1] == '\r'))) end--;
+					if(parser->on_header)
+						parser->on_header(parser->arg, (const char *)buf + parser->token, parser->name_len,
+							(const char *)buf + parser->value, end - parser->value);
+				}
+				i++;
+				state = HTTP_PARSER_LINE;
+				break;
+
+			case HTTP_PARSER_LINE :
+				c = buf[i];
+				if(c == '\r')
+				{
+					i++;
+					state = HTTP_PARSER_END_LF;
+				}
+				else if(c == '\n') goto done;
+				else if((c <= ' ') || (c == ':')) goto fail; // Obsolete line folding is rejected
+				else
+				{
+					parser->token = i++;
+					state = HTTP_PARSER_NAME;
+				}
+				break;
+
+			case HTTP_PARSER_NAME :
+				for(; (i < len) && (buf[i] != ':'); i++)
+				{
+					if(buf[i] <= ' ') goto fail;
+				}
+				if(i == len) break;
+
+				parser->name_len = i - parser->token;
+				i++;
+				state = HTTP_PARSER_VALUE_WS;
+				break;
+
+			case HTTP_PARSER_VALUE_WS :
+				for(; (i < len) && ((buf[i] == ' ') || (buf[i] == '\t')); i++);
+				if(i == len) break;
+
+				parser->value = i;
+				state = HTTP_PARSER_VALUE;
+				break;
+
+			case HTTP_PARSER_END_LF :
+				if(buf[i] != '\n') goto fail;
+				goto done;
+
+			default :
+				goto fail;
+		}
+	}
+
+	parser->pos = len;
+	parser->state = state;
+	return HTTP_PARSER_MORE;
+
+done:
+	parser->body = i + 1;
+	parser->pos = i + 1;
+	parser->state = HTTP_PARSER_FINISH;
+	return HTTP_PARSER_DONE;
+
+fail:
+#ifdef _HTTPPARSER_DEBUG_
+	printf("  malformed request at %d\r\n", i);
+#endif
+	parser->pos = i;
+	parser->state = HTTP_PARSER_FAIL;
+	return HTTP_PARSER_ERROR;
+}
+
+
+/**
+ @brief	fill request with the method and URI found by the parser
+ @details	For GET and HEAD, URI is the path and the query. For POST, URI is everything from the path to the end
+ 			of buf, headers and body included, as get_http_param_value() expects.
+ 			METHOD is METHOD_ERR until the request line is parsed.
+ */
+void http_parser_get_request(
+	const st_http_parser * parser,	/**< parser after http_parser_execute() */
+	const uint8_t * buf,			/**< request from its first byte */
+	uint16_t len,					/**< bytes of the request in buf */
+	st_http_request * request		/**< request to be returned */
+	)
+{
+	uint16_t end;
+
+	request->QUERY = 0;
+	request->QUERY_LEN = 0;
+	request->BODY = 0;
+	request->BODY_LEN = 0;
+
+	if((parser->state < HTTP_PARSER_LINE) || (parser->state == HTTP_PARSER_FAIL))
+	{
+		request->METHOD = METHOD_ERR;
+		request->URI[0] = 0;
+		return;
+	}
+
+	request->METHOD = parser->method;
+	request->QUERY = parser->query;
+	request->QUERY_LEN = parser->query_len;
+	if((parser->state == HTTP_PARSER_FINISH) && (parser->body < len))
+	{
+		request->BODY = parser->body;
+		request->BODY_LEN = len - parser->body;
+	}
+	if(parser->method == METHOD_POST) end = len;
+	else if(parser->query) end = parser->query + parser->query_len;
+	else end = parser->uri + parser->uri_len;
+
+	// Long URIs overflowed URI[] and the uri_buf[] copies made from it, truncate to MAX_URI_SIZE
+	if(end - parser->uri >= MAX_URI_SIZE) end = parser->uri + MAX_URI_SIZE - 1;
+	memmove(request->URI, buf + parser->uri, end - parser->uri);
+	request->URI[end - parser->uri] = 0;
 }
 
 #ifdef _OLD_
@@ -280,15 +507,17 @@ uint8_t * get_http_uri_name(uint8_t * uri)
 
 uint8_t get_http_uri_name(uint8_t * uri, uint8_t * uri_buf)
 {
-	uint8_t * uri_ptr;
+	uint16_t i;
 	if(!uri) return 0;
 
-	strcpy((char *)uri_buf, (char *)uri);
-
-	uri_ptr = (uint8_t *)strtok((char *)uri_buf, " ?");
-
-	if(strcmp((char *)uri_ptr,"/")) uri_ptr++;
-	strcpy((char *)uri_buf, (char *)uri_ptr);
+	//M20261019 : Copy the path once, without the leading '/' (except for "/") and up to ' ' or '?'
+	//strcpy((char *)uri_buf, (char *)uri);
+	//uri_ptr = (uint8_t *)strtok((char *)uri_buf, " ?");
+	//if(strcmp((char *)uri_ptr,"/")) uri_ptr++;
+	//strcpy((char *)uri_buf, (char *)uri_ptr);
+	if((uri[0] == '/') && uri[1] && (uri[1] != ' ') && (uri[1] != '?')) uri++;
+	for(i = 0; uri[i] && (uri[i] != ' ') && (uri[i] != '?'); i++) uri_buf[i] = uri[i];
+	uri_buf[i] = '\0';
 
 #ifdef _HTTPPARSER_DEBUG_
 	printf("  uri_name = %s\r\n", uri_buf);
@@ -299,6 +528,101 @@ uint8_t get_http_uri_name(uint8_t * uri, uint8_t * uri_buf)
 
 #endif
 
+/**
+ @brief	get a parameter of a query string, '%XX' and '+' are decoded
+ @return	1 if the parameter is found, value is truncated to size - 1 characters
+ */
+uint8_t get_http_query_value(
+	const uint8_t * query,	/**< query string without '?', or a form body */
+	uint16_t query_len,		/**< length of the query string */
+	const char * name,		/**< parameter name */
+	char * value,			/**< buffer for the value */
+	uint16_t size			/**< size of value */
+	)
+{
+	const uint8_t * param;
+	uint16_t len, i, n = 0;
+
+	if(!size || !(param = find_http_query_param(query, query_len, name, &len))) return 0;
+
+	for(i = 0; (i < len) && (n < size - 1); i++, n++)
+	{
+		if((param[i] == '%') && (i + 2 < len))
+		{
+			value[n] = C2D(param[i + 1]) * 0x10 + C2D(param[i + 2]);
+			i += 2;
+		}
+		else value[n] = (param[i] == '+') ? ' ' : param[i];
+	}
+	value[n] = '\0';
+
+#ifdef _HTTPPARSER_DEBUG_
+	printf("  %s=%s\r\n", name, value);
+#endif
+	return 1;
+}
+
+/**
+ @brief	get a decimal integer parameter of a query string
+ @return	1 if the parameter is found and is a number in the range of int32_t
+ */
+uint8_t get_http_query_int(
+	const uint8_t * query,	/**< query string without '?', or a form body */
+	uint16_t query_len,		/**< length of the query string */
+	const char * name,		/**< parameter name */
+	int32_t * value			/**< the number */
+	)
+{
+	const uint8_t * param;
+	uint16_t len, i = 0;
+	uint32_t num = 0;
+	uint8_t negative = 0;
+
+	if(!(param = find_http_query_param(query, query_len, name, &len))) return 0;
+
+	if((len > 0) && ((param[0] == '-') || (param[0] == '+')))
+	{
+		negative = (param[0] == '-');
+		i++;
+	}
+	if(i == len) return 0;
+
+	for(; i < len; i++)
+	{
+		if((param[i] < '0') || (param[i] > '9')) return 0;
+		if(num > ((uint32_t)INT32_MAX + negative - (param[i] - '0')) / 10) return 0;
+		num = num * 10 + (param[i] - '0');
+	}
+
+	*value = negative ? (int32_t)(0 - num) : (int32_t)num;
+	return 1;
+}
+
+/**
+ @brief	get a boolean parameter of a query string: 1/true/on/yes, 0/false/off/no, or only the name ("?debug") for true
+ @return	1 if the parameter is found and is one of these
+ */
+uint8_t get_http_query_bool(
+	const uint8_t * query,	/**< query string without '?', or a form body */
+	uint16_t query_len,		/**< length of the query string */
+	const char * name,		/**< parameter name */
+	uint8_t * value			/**< 1 or 0 */
+	)
+{
+	const uint8_t * param;
+	uint16_t len;
+
+	if(!(param = find_http_query_param(query, query_len, name, &len))) return 0;
+
+	if(!len || equal_http_token(param, len, "1") || equal_http_token(param, len, "TRUE") ||
+		equal_http_token(param, len, "ON") || equal_http_token(param, len, "YES")) *value = 1;
+	else if(equal_http_token(param, len, "0") || equal_http_token(param, len, "FALSE") ||
+		equal_http_token(param, len, "OFF") || equal_http_token(param, len, "NO")) *value = 0;
+	else return 0;
+
+	return 1;
+}
+
 void inet_addr_(uint8_t * addr, uint8_t *ip)
 {
 	uint8_t i;
@@ -364,6 +688,65 @@ void mid(char* src, char* s1, char* s2, char* sub)
 // Static functions
 ////////////////////////////////////////////////////////////////////
 
+/**
+@brief	find 'name=value' (or only 'name') in a query string separated by '&'
+@return	the value, not null terminated, NULL if not found
+*/
+static const uint8_t * find_http_query_param(
+		const uint8_t * query,	/**< query string */
+		uint16_t query_len,		/**< length of the query string */
+		const char * name,		/**< parameter name */
+		uint16_t * len			/**< length of the value */
+	)
+{
+	uint16_t name_len = strlen(name);
+	uint16_t start, i = 0;
+
+	if(!query) return NULL;
+
+	while(i < query_len)
+	{
+		for(start = i; (i < query_len) && (query[i] != '&'); i++);
+
+		if((i - start >= name_len) && !memcmp(query + start, name, name_len))
+		{
+			if(i - start == name_len)
+			{
+				*len = 0;
+				return query + i;
+			}
+			if(query[start + name_len] == '=')
+			{
+				*len = i - start - name_len - 1;
+				return query + start + name_len + 1;
+			}
+		}
+		i++;
+	}
+
+	return NULL;
+}
+
+/**
+@brief	compare len characters of str with a method name or an extension (case insensitive)
+@return	1 if equal, 0 if not
+*/
+static uint8_t equal_http_token(
+		const uint8_t * str,	/**< token, not null terminated */
+		uint16_t len,			/**< length of the token */
+		const char * method		/**< name, letters and digits only */
+	)
+{
+	uint16_t i;
+
+	for(i = 0; i < len; i++)
+	{
+		if(!method[i] || ((str[i] & ~0x20) != (uint8_t)(method[i] & ~0x20))) return 0;
+	}
+
+	return (method[i] == '\0');
+}
+
 /**
 @brief	replace the specified character in a string with new character
 */
@@ -38,6 +38,8 @@ extern "C" {
 #define		PTYPE_JSON		12		/**< JSON (JavaScript Standard Object Notation) file.	*/
 #define		PTYPE_PNG		13		/**< PNG file. 	*/
 #define		PTYPE_ICO		14		/**< ICON file. */
+//A20261019 : Prometheus text exposition format
+#define		PTYPE_METRICS	15		/**< Prometheus metrics. */
 
 #define		PTYPE_TTF		20		/**< Font type: TTF file. */
 #define		PTYPE_OTF		21		/**< Font type: OTF file. */
@@ -64,14 +66,19 @@ extern "C" {
 #define		STATUS_SERV_UNAVAIL	503
 
 /* HTML Doc. for ERROR */
-static const char  	ERROR_HTML_PAGE[] = "HTTP/1.1 404 Not Found\r\nContent-Type: text/html\r\nContent-Length: 78\r\n\r\n<HTML>\r\n<BODY>\r\nSorry, the page you requested was not found.\r\n</BODY>\r\n</HTML>\r\n\0";
-static const char 	ERROR_REQUEST_PAGE[] = "HTTP/1.1 400 OK\r\nContent-Type: text/html\r\nContent-Length: 50\r\n\r\n<HTML>\r\n<BODY>\r\nInvalid request.\r\n</BODY>\r\n</HTML>\r\n\0";
+//M20261019 : Content-Length 78 -> 80 and 50 -> 52, the trailing CRLF was not counted and broke keep-alive framing
+//M20261019 : Head and body apart, send_http_response_header() puts 'Connection' between them
+#define ERROR_HTML_HEAD		"HTTP/1.1 404 Not Found\r\nContent-Type: text/html\r\nContent-Length: 80\r\n"
+#define ERROR_HTML_BODY		"<HTML>\r\n<BODY>\r\nSorry, the page you requested was not found.\r\n</BODY>\r\n</HTML>\r\n"
+#define ERROR_REQUEST_HEAD	"HTTP/1.1 400 OK\r\nContent-Type: text/html\r\nContent-Length: 52\r\n"
+#define ERROR_REQUEST_BODY	"<HTML>\r\n<BODY>\r\nInvalid request.\r\n</BODY>\r\n</HTML>\r\n"
 
 /* HTML Doc. for CGI result  */
 #define HTML_HEADER "HTTP/1.1 200 OK\r\nContent-Type: text/html\r\nContent-Length: "
 
 /* Response header for HTML*/
-#define RES_HTMLHEAD_OK	"HTTP/1.1 200 OK\r\nContent-Type: text/html\r\nConnection: keep-alive\r\nContent-Length: "
+//M20261019 : 'Connection' is added by make_http_response_head()
+#define RES_HTMLHEAD_OK	"HTTP/1.1 200 OK\r\nContent-Type: text/html\r\nContent-Length: "
 
 /* Response head for TEXT */
 #define RES_TEXTHEAD_OK	"HTTP/1.1 200 OK\r\nContent-Type: text/plain\r\nContent-Length: "
@@ -89,7 +96,7 @@ static const char 	ERROR_REQUEST_PAGE[] = "HTTP/1.1 400 OK\r\nContent-Type: text
 #define RES_FLASHHEAD_OK "HTTP/1.1 200 OK\r\nContent-Type: application/x-shockwave-flash\r\nContent-Length: "
 
 /* Response head for XML */
-#define RES_XMLHEAD_OK "HTTP/1.1 200 OK\r\nContent-Type: text/xml\r\nConnection: keep-alive\r\nContent-Length: "
+#define RES_XMLHEAD_OK "HTTP/1.1 200 OK\r\nContent-Type: text/xml\r\nContent-Length: "
 
 /* Response head for CSS */
 #define RES_CSSHEAD_OK	"HTTP/1.1 200 OK\r\nContent-Type: text/css\r\nContent-Length: "		
@@ -121,6 +128,25 @@ static const char 	ERROR_REQUEST_PAGE[] = "HTTP/1.1 400 OK\r\nContent-Type: text
 /* Response head for SVG, Font */
 #define RES_SVGHEAD_OK	"HTTP/1.1 200 OK\r\nContent-Type: image/svg+xml\r\nContent-Length: "
 
+//A20261019 : Response head for Prometheus metrics, scrapers select the parser by the version parameter
+#define RES_METRICSHEAD_OK	"HTTP/1.1 200 OK\r\nContent-Type: text/plain; version=0.0.4; charset=utf-8\r\nContent-Length: "
+
+//A20261019 : Response head for other files
+#define RES_BINHEAD_OK	"HTTP/1.1 200 OK\r\nContent-Type: application/octet-stream\r\nContent-Length: "
+
+//A20261019 : Response head for 304, no body
+#define RES_NOT_MODIFIED_HEAD	"HTTP/1.1 304 Not Modified\r\n"
+
+//A20261019 : Connection header, follows Content-Length
+#define RES_CONNECTION_KEEPALIVE	"Connection: keep-alive\r\n"
+#define RES_CONNECTION_CLOSE		"Connection: close\r\n"
+
+//A20261019 : Interim response to 'Expect: 100-continue', the client sends the body after it
+#define RES_CONTINUE_HEAD	"HTTP/1.1 100 Continue\r\n\r\n"
+
+//A20261019 : Response head for the WebSocket opening handshake, followed by the Sec-WebSocket-Accept value
+#define RES_WEBSOCKET_HEAD	"HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\nConnection: Upgrade\r\nSec-WebSocket-Accept: "
+
 /**
  @brief 	Structure of HTTP REQUEST 
  */
@@ -132,16 +158,66 @@ typedef struct _st_http_request
 {
 	uint8_t	METHOD;						/**< request method(METHOD_GET...). */
 	uint8_t	TYPE;						/**< request type(PTYPE_HTML...).   */
+	//A20261019 : Offsets in the received request, for the route handlers
+	uint16_t	QUERY;					/**< query string (after '?'), 0 if none. */
+	uint16_t	QUERY_LEN;				/**< length of the query string.    */
+	uint16_t	BODY;					/**< request body.                  */
+	uint16_t	BODY_LEN;				/**< received length of the body.   */
 	uint8_t	URI[MAX_URI_SIZE];			/**< request file name.             */
 }st_http_request;
 
+//A20261019 : Single-pass request parser
+/*********************************************
+* HTTP request parser return value
+*********************************************/
+#define HTTP_PARSER_ERROR			-1			/* Malformed request line or header */
+#define HTTP_PARSER_MORE			0			/* Header is not completed, call again with more data */
+#define HTTP_PARSER_DONE			1			/* Header is completed, the body starts at 'body' */
+
+/**
+ @brief 	Callback for each header field. name and value point into the request buffer and are not null terminated;
+ 			the value has no leading and trailing white space.
+ */
+typedef void (*http_header_cb)(void * arg, const char * name, uint16_t name_len, const char * value, uint16_t value_len);
+
+/**
+ @brief 	State of the request parser. Offsets are from the start of the request buffer.
+ @details	The parser never copies; every call parses only the bytes after 'pos', so the buffer must hold the same
+ 			request from its first byte each time (e.g. peeked again from the socket RX buffer), with more bytes appended.
+ */
+typedef struct _st_http_parser
+{
+	uint8_t			state;			/**< Internal state */
+	uint8_t			method;			/**< METHOD_GET, METHOD_HEAD, METHOD_POST or METHOD_ERR */
+	uint8_t			version;		/**< 10: HTTP/1.0, 11: HTTP/1.1 */
+	uint16_t		pos;			/**< Bytes already parsed */
+	uint16_t		token;			/**< Start of the token being parsed */
+	uint16_t		uri;			/**< Start of the URI */
+	uint16_t		uri_len;		/**< Length of the path, without the query */
+	uint16_t		query;			/**< Start of the query (after '?'), 0 if none */
+	uint16_t		query_len;		/**< Length of the query */
+	uint16_t		name_len;		/**< Length of the header name being parsed */
+	uint16_t		value;			/**< Start of the header value being parsed */
+	uint16_t		body;			/**< Start of the body, valid after HTTP_PARSER_DONE */
+	http_header_cb	on_header;		/**< Called for each header field, may be NULL */
+	void *			arg;			/**< First argument of on_header */
+}st_http_parser;
+
+void http_parser_init(st_http_parser * parser, http_header_cb on_header, void * arg);
+int8_t http_parser_execute(st_http_parser * parser, const uint8_t * buf, uint16_t len);
+void http_parser_get_request(const st_http_parser * parser, const uint8_t * buf, uint16_t len, st_http_request * request);
+
 // HTTP Parsing functions
 void unescape_http_url(char * url);								/* convert escape character to ascii */
 void parse_http_request(st_http_request *, uint8_t *);			/* parse request from peer */
 void find_http_uri_type(uint8_t *, uint8_t *);					/* find MIME type of a file */
-void make_http_response_head(char *, char, uint32_t);			/* make response header */
+void make_http_response_head(char *, char, uint32_t, uint8_t);	/* make response header */
 uint8_t * get_http_param_value(char* uri, char* param_name);	/* get the user-specific parameter value */
 uint8_t get_http_uri_name(uint8_t * uri, uint8_t * uri_buf);	/* get the requested URI name */
+//A20261019 : Typed parameters of a query string or form body ("a=1&b=x"), the return value is 1 if name is found
+uint8_t get_http_query_value(const uint8_t * query, uint16_t query_len, const char * name, char * value, uint16_t size);
+uint8_t get_http_query_int(const uint8_t * query, uint16_t query_len, const char * name, int32_t * value);
+uint8_t get_http_query_bool(const uint8_t * query, uint16_t query_len, const char * name, uint8_t * value);
 #ifdef _OLD_
 uint8_t * get_http_uri_name(uint8_t * uri);
 #endif
@@ -0,0 +1,123 @@
+/**
+ * @file	httpRomfs.c
+ * @brief	Read-only web content image: mount, binary search of the sorted index and content read
+ * @version 1.0
+ * @date	2026/10/19
+ * @par Revision
+ *			2026/10/19 - 1.0 Release
+ * @author
+ */
+
+#include <string.h>
+
+#include "httpRomfs.h"
+
+#define HTTP_ROMFS_MAX_NAME		255		/* name_len is 8 bits */
+
+/**
+ @brief	mount an image, memory mapped (image) or read through read_cb
+ @return	1 if the image is valid, 0 if not (nothing is mounted)
+ */
+uint8_t http_romfs_mount(
+	st_http_romfs * fs,				/**< image to be mounted */
+	const uint8_t * image,			/**< start of an image in the address space, 4-byte aligned; NULL to use read_cb */
+	http_romfs_read_cb read_cb		/**< reads an image that is not memory mapped */
+	)
+{
+	st_http_romfs_header header;
+
+	memset(fs, 0, sizeof(st_http_romfs));
+	if(image) memcpy(&header, image, sizeof(header));
+	else if(read_cb) read_cb(0, (uint8_t *)&header, sizeof(header));
+	else return 0;
+
+	// Erased flash reads 0xFF, an image of another version can't be read
+	if((header.magic != HTTP_ROMFS_MAGIC) || (header.version != HTTP_ROMFS_VERSION)) return 0;
+	if(header.size < sizeof(header) + (uint32_t)header.count * sizeof(st_http_romfs_entry)) return 0;
+
+	fs->image = image;
+	fs->read_cb = read_cb;
+	fs->count = header.count;
+	fs->size = header.size;
+
+	return 1;
+}
+
+/**
+ @brief	find a content by its name, O(log n) compares
+ @return	1 if found, 0 if not
+ */
+uint8_t http_romfs_find(
+	const st_http_romfs * fs,		/**< mounted image */
+	const uint8_t * name,			/**< name without the leading '/' (as get_http_uri_name() gives) */
+	st_http_romfs_entry * entry		/**< entry found */
+	)
+{
+	const st_http_romfs_entry * index = NULL;
+	uint8_t buf[HTTP_ROMFS_MAX_NAME + 1];
+	const uint8_t * entry_name;
+	uint16_t low = 0, high = fs->count, mid;
+	int cmp;
+
+	if(fs->image) index = (const st_http_romfs_entry *)(fs->image + sizeof(st_http_romfs_header));
+
+	while(low < high)
+	{
+		mid = (low + high) / 2;
+
+		if(index)
+		{
+			// In place, no copy of the entry or the name
+			entry_name = fs->image + index[mid].name;
+			cmp = strcmp((const char *)name, (const char *)entry_name);
+			if(cmp == 0) memcpy(entry, &index[mid], sizeof(st_http_romfs_entry));
+		}
+		else
+		{
+			fs->read_cb(sizeof(st_http_romfs_header) + (uint32_t)mid * sizeof(st_http_romfs_entry), (uint8_t *)entry, sizeof(st_http_romfs_entry));
+			fs->read_cb(entry->name, buf, entry->name_len + 1);
+			buf[entry->name_len] = '\0';
+			cmp = strcmp((const char *)name, (const char *)buf);
+		}
+
+		if(cmp == 0) return 1;
+		if(cmp < 0) high = mid;
+		else low = mid + 1;
+	}
+
+	return 0;
+}
+
+/**
+ @brief	read a part of the image
+ @return	bytes read, less than len at the end of the image
+ */
+uint16_t http_romfs_read(
+	const st_http_romfs * fs,		/**< mounted image */
+	uint32_t offset,				/**< offset in the image */
+	uint8_t * buf,					/**< buffer */
+	uint16_t len					/**< bytes to be read */
+	)
+{
+	if(offset >= fs->size) return 0;
+	if(len > fs->size - offset) len = fs->size - offset;
+
+	if(fs->image) memcpy(buf, fs->image + offset, len);
+	else fs->read_cb(offset, buf, len);
+
+	return len;
+}
+
+/**
+ @brief	address of a part of a memory mapped image, to be sent without a copy
+ @return	pointer to offset, NULL if the image is read through read_cb
+ */
+const uint8_t * http_romfs_map(
+	const st_http_romfs * fs,		/**< mounted image */
+	uint32_t offset					/**< offset in the image */
+	)
+{
+	if(!fs->image || (offset >= fs->size)) return NULL;
+
+	return fs->image + offset;
+}
\ No newline at end of file
@@ -0,0 +1,85 @@
+/**
+ * @file	httpRomfs.h
+ * @brief	Header File for the read-only web content image of the HTTP Server
+ * @version 1.0
+ * @date	2026/10/19
+ * @par Revision
+ *			2026/10/19 - 1.0 Release
+ * @author
+ */
+
+#ifndef	__HTTPROMFS_H__
+#define	__HTTPROMFS_H__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************************************
+* Image layout, made by Tools/web_assets/web_assets.py
+*
+*   st_http_romfs_header
+*   st_http_romfs_entry[count]		sorted by name (strcmp), found by binary search
+*   names, ETags and response heads
+*   contents and gzip variants		each aligned to the 'align' of the generator
+*
+* All fields are little endian and 4-byte aligned; an image in internal flash is used in place.
+*********************************************/
+#define HTTP_ROMFS_MAGIC			0x53465257	/* "WRFS" */
+#define HTTP_ROMFS_VERSION			1
+
+typedef struct _st_http_romfs_header
+{
+	uint32_t	magic;		/**< HTTP_ROMFS_MAGIC */
+	uint16_t	version;	/**< HTTP_ROMFS_VERSION */
+	uint16_t	count;		/**< Number of entries */
+	uint32_t	size;		/**< Size of the image */
+	uint32_t	crc;		/**< CRC-32 of the image after the header, tells images apart */
+}st_http_romfs_header;
+
+/**
+ @brief 	An entry of the index. Offsets are from the start of the image.
+ 			The head is the response header without 'Connection' and the empty line, e.g.
+ 			"HTTP/1.1 200 OK\r\nContent-Type: text/html\r\nContent-Length: 1443\r\nETag: ...\r\n".
+ */
+typedef struct _st_http_romfs_entry
+{
+	uint32_t	name;			/**< Name without the leading '/', null terminated */
+	uint32_t	etag;			/**< ETag with the quotes, null terminated; the gzip variant adds HTTP_GZIP_ETAG_SUFFIX */
+	uint32_t	head;			/**< Head for the content, the head for the gzip variant follows it */
+	uint16_t	head_len;
+	uint16_t	gzip_head_len;	/**< 0 if no gzip variant */
+	uint32_t	data;			/**< Content */
+	uint32_t	data_len;
+	uint32_t	gzip;			/**< gzip variant ('Content-Encoding: gzip'), 0 if none */
+	uint32_t	gzip_len;
+	uint8_t		name_len;
+	uint8_t		etag_len;
+	uint16_t	reserved;
+}st_http_romfs_entry;
+
+/**
+ @brief 	Reads len bytes at offset of an image that is not memory mapped (e.g. in SPI flash)
+ */
+typedef void (*http_romfs_read_cb)(uint32_t offset, uint8_t * buf, uint16_t len);
+
+typedef struct _st_http_romfs
+{
+	const uint8_t *		image;	/**< Memory mapped image, NULL if it is read by read_cb */
+	http_romfs_read_cb	read_cb;
+	uint16_t			count;	/**< Entries, 0 if nothing is mounted */
+	uint32_t			size;
+}st_http_romfs;
+
+uint8_t http_romfs_mount(st_http_romfs * fs, const uint8_t * image, http_romfs_read_cb read_cb);
+uint8_t http_romfs_find(const st_http_romfs * fs, const uint8_t * name, st_http_romfs_entry * entry);
+uint16_t http_romfs_read(const st_http_romfs * fs, uint32_t offset, uint8_t * buf, uint16_t len);
+const uint8_t * http_romfs_map(const st_http_romfs * fs, uint32_t offset);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
\ No newline at end of file
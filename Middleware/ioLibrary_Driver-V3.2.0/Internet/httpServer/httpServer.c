@@ -1,6 +1,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <ctype.h>
 
 #include "socket.h"
 #include "wizchip_conf.h"
@@ -17,6 +18,13 @@
 	#define DATA_BUF_SIZE		2048
 #endif
 
+//A20261019 : Room for the response header in front of the body made by a route handler
+#define HTTP_ROUTE_HEAD_SIZE	160
+
+#if (MAX_HTTP_ROUTE & (MAX_HTTP_ROUTE - 1))
+	#error "MAX_HTTP_ROUTE must be a power of two"
+#endif
+
 /*****************************************************************************
  * Private types/enumerations/variables
  ****************************************************************************/
@@ -30,6 +38,11 @@ static uint8_t * http_response;						/**< Pointer to HTTP response */
 
 // Number of registered web content in code flash memory
 static uint16_t total_content_cnt = 0;
+
+//A20261019 : Routes and their hashed index; a slot holds the route number + 1, 0 is empty
+static httpServer_route http_route[MAX_HTTP_ROUTE];
+static uint16_t http_route_index[HTTP_ROUTE_HASH_SIZE];
+static uint16_t total_route_cnt = 0;
 /*****************************************************************************
  * Public types/enumerations/variables
  ****************************************************************************/
@@ -41,9 +54,19 @@ st_http_socket HTTPSock_Status[_WIZCHIP_SOCK_NUM_] = { {STATE_HTTP_IDLE, }, };
 httpServer_webContent web_content[MAX_CONTENT_CALLBACK];
 
 #ifdef	_USE_SDCARD_
-FIL fs;		// FatFs: File object
-FRESULT fr;	// FatFs: File function return code
+//M20261019 : One file object for each HTTP socket, the file stays open until the response is sent
+//FIL fs;		// FatFs: File object
+//FRESULT fr;	// FatFs: File function return code
+static FIL HTTPSock_File[_WIZCHIP_SOCK_NUM_];	// FatFs: File object
+static uint8_t HTTPSock_Forward;				// Socket number for forward_http_response_file()
 #endif
+//A20261019 : Request parser of each HTTP socket, keeps its place while a request arrives in parts
+static st_http_parser HTTPSock_Parser[_WIZCHIP_SOCK_NUM_];
+//A20261019 : Web content image, and the entry each socket is sending
+static st_http_romfs http_romfs;
+static st_http_romfs_entry HTTPSock_Romfs[_WIZCHIP_SOCK_NUM_];
+//A20261019 : Body decoder of each HTTP socket, for an upload in STATE_HTTP_REQ_INPROC
+static st_http_upload HTTPSock_Upload[_WIZCHIP_SOCK_NUM_];
 
 /*****************************************************************************
  * Private functions
@@ -52,11 +75,41 @@ void httpServer_Sockinit(uint8_t cnt, uint8_t * socklist);
 static uint8_t getHTTPSocketNum(uint8_t seqnum);
 static int8_t getHTTPSequenceNum(uint8_t socket);
 static int8_t http_disconnect(uint8_t sn);
+static uint16_t recv_http_request(uint8_t s, int8_t seqnum, uint8_t * buf, uint16_t len);
+static void on_http_request_header(void * arg, const char * name, uint16_t name_len, const char * value, uint16_t value_len);
+static void reset_http_request(int8_t seqnum);
+static uint32_t http_route_hash(const uint8_t * path);
+static httpServer_route * add_http_route(const uint8_t * path);
+static httpServer_route * find_http_route(const uint8_t * path);
+static void process_http_route(uint8_t s, httpServer_route * route, st_http_request * p_http_request, uint8_t * uri_name);
+static void open_http_websocket(uint8_t s, httpServer_route * route, st_http_request * p_http_request);
+static void process_http_websocket(uint8_t s, int8_t seqnum);
+static void close_http_websocket(uint8_t s, uint16_t code);
+static void send_http_route_response(uint8_t s, int8_t seqnum, uint8_t type, uint8_t method, uint16_t len);
+static void open_http_upload(uint8_t s, httpServer_route * route, st_http_request * p_http_request, uint8_t * uri_name);
+static void process_http_upload(uint8_t s, int8_t seqnum);
+static void close_http_upload(uint8_t s, int8_t seqnum, int8_t ret);
+static uint8_t on_http_upload_part(void * arg, const char * name, const char * filename);
+static uint8_t on_http_upload_data(void * arg, const uint8_t * data, uint16_t len);
+static uint16_t match_http_token(const char * str, const char * token);
+static uint8_t find_http_token(const char * list, const char * token);
+static void add_http_response_header(char * head, const char * name, const char * value);
 
 static void http_process_handler(uint8_t s, st_http_request * p_http_request);
 static void send_http_response_header(uint8_t s, uint8_t content_type, uint32_t body_len, uint16_t http_status);
 static void send_http_response_body(uint8_t s, uint8_t * uri_name, uint8_t * buf, uint32_t start_addr, uint32_t file_len);
 static void send_http_response_cgi(uint8_t s, uint8_t * buf, uint8_t * http_body, uint16_t file_len);
+static uint8_t open_http_response_romfs(int8_t seqnum, uint8_t * uri_name, uint32_t * file_len);
+static void send_http_response_romfs_header(uint8_t s, int8_t seqnum);
+static void send_http_response_romfs(uint8_t s, int8_t seqnum);
+static void open_http_response_document(uint8_t s, httpServer_route * route, st_http_request * p_http_request, uint8_t * uri_name);
+static void send_http_response_document(uint8_t s, int8_t seqnum);
+static void close_http_response_document(int8_t seqnum);
+#ifdef _USE_SDCARD_
+static FRESULT open_http_response_file(int8_t seqnum, uint8_t * uri_name, uint32_t * file_len);
+static void send_http_response_file(uint8_t s, int8_t seqnum);
+static void close_http_response_file(int8_t seqnum);
+#endif
 
 /*****************************************************************************
  * Public functions
@@ -75,6 +128,7 @@ void httpServer_Sockinit(uint8_t cnt, uint8_t * socklist)
 	{
 		// Mapping the H/W socket numbers to the sequential index numbers
 		HTTPSock_Num[i] = socklist[i];
+		reset_http_request(i); //A20261019
 	}
 }
 
@@ -139,6 +193,7 @@ void httpServer_run(uint8_t seqnum)
 			if(getSn_IR(s) & Sn_IR_CON)
 			{
 				setSn_IR(s, Sn_IR_CON);
+				HTTPSock_Status[seqnum].idle_time = get_httpServer_timecount(); //A20261019
 			}
 
 			// HTTP Process states
@@ -146,14 +201,17 @@ void httpServer_run(uint8_t seqnum)
 			{
 
 				case STATE_HTTP_IDLE :
-					if ((len = getSn_RX_RSR(s)) > 0)
+					//M20261019 : Take one complete request out of the RX buffer, pipelined requests wait there in order
+					//if ((len = getSn_RX_RSR(s)) > 0)
+					//{
+					//	if (len > DATA_BUF_SIZE) len = DATA_BUF_SIZE;
+					//	len = recv(s, (uint8_t *)http_request, len);
+					//
+					//	*(((uint8_t *)http_request) + len) = '\0';
+					//M20261019 : recv_http_request() parses the request while framing it
+					if (((len = getSn_RX_RSR(s)) > 0) && ((len = recv_http_request(s, seqnum, (uint8_t *)http_request, len)) > 0))
 					{
-						if (len > DATA_BUF_SIZE) len = DATA_BUF_SIZE;
-						len = recv(s, (uint8_t *)http_request, len);
-
-						*(((uint8_t *)http_request) + len) = '\0';
-
-						parse_http_request(parsed_http_request, (uint8_t *)http_request);
+						//parse_http_request(parsed_http_request, (uint8_t *)http_request);
 #ifdef _HTTPSERVER_DEBUG_
 						getSn_DIPR(s, destip);
 						destport = getSn_DPORT(s);
@@ -167,9 +225,10 @@ void httpServer_run(uint8_t seqnum)
 						// HTTP 'response' handler; includes send_http_response_header / body function
 						http_process_handler(s, parsed_http_request);
 
+						//M20261019 : Handlers are bound to their paths with reg_httpServer_route()
 						// 用户自定义处理函数
-						extern void handler_user_funcion(char *url);
-						handler_user_funcion((char *)parsed_http_request->URI);
+						//extern void handler_user_funcion(char *url);
+						//handler_user_funcion((char *)parsed_http_request->URI);
 
 						gettime = get_httpServer_timecount();
 						// Check the TX socket buffer for End of HTTP response sends
@@ -184,9 +243,27 @@ void httpServer_run(uint8_t seqnum)
 							}
 						}
 
+						//A20261019 : The connection is upgraded, no HTTP response follows
+						if(HTTPSock_Status[seqnum].sock_status == STATE_HTTP_WEBSOCKET) break;
+						//A20261019 : The body of an upload is being received, the response follows it
+						if(HTTPSock_Status[seqnum].sock_status == STATE_HTTP_REQ_INPROC) break;
+
 						if(HTTPSock_Status[seqnum].file_len > 0) HTTPSock_Status[seqnum].sock_status = STATE_HTTP_RES_INPROC;
 						else HTTPSock_Status[seqnum].sock_status = STATE_HTTP_RES_DONE; // Send the 'HTTP response' end
 					}
+					//A20261019 : Idle keep-alive connection, or a request never completed
+					else if((get_httpServer_timecount() - HTTPSock_Status[seqnum].idle_time) > HTTP_MAX_TIMEOUT_SEC)
+					{
+#ifdef _HTTPSERVER_DEBUG_
+						printf("> HTTPSocket[%d] : Keep-alive timeout\r\n", s);
+#endif
+						http_disconnect(s);
+					}
+					break;
+
+				//A20261019 : Body of an upload, decoded and given to the route while it arrives
+				case STATE_HTTP_REQ_INPROC :
+					process_http_upload(s, seqnum);
 					break;
 
 				case STATE_HTTP_RES_INPROC :
@@ -195,6 +272,13 @@ void httpServer_run(uint8_t seqnum)
 					printf("> HTTPSocket[%d] : [State] STATE_HTTP_RES_INPROC\r\n", s);
 #endif
 					// Repeatedly send remaining data to client
+					if(HTTPSock_Status[seqnum].storage_type == ROMFS) send_http_response_romfs(s, seqnum); //A20261019
+					else if(HTTPSock_Status[seqnum].storage_type == DOCUMENT) send_http_response_document(s, seqnum); //A20261019
+					else
+#ifdef _USE_SDCARD_
+					if(HTTPSock_Status[seqnum].storage_type == SDCARD) send_http_response_file(s, seqnum);
+					else
+#endif
 					send_http_response_body(s, 0, http_response, 0, 0);
 
 					if(HTTPSock_Status[seqnum].file_len == 0) HTTPSock_Status[seqnum].sock_status = STATE_HTTP_RES_DONE;
@@ -210,13 +294,22 @@ void httpServer_run(uint8_t seqnum)
 					HTTPSock_Status[seqnum].file_start = 0;
 					HTTPSock_Status[seqnum].sock_status = STATE_HTTP_IDLE;
 
-//#ifdef _USE_SDCARD_
-//					f_close(&fs);
-//#endif
+					close_http_response_document(seqnum); //A20261019
+#ifdef _USE_SDCARD_
+					close_http_response_file(seqnum);
+#endif
 #ifdef _USE_WATCHDOG_
 					HTTPServer_WDT_Reset();
 #endif
-					http_disconnect(s);
+					//M20261019 : Keep the connection for the next (or already pipelined) request
+					//http_disconnect(s);
+					if(HTTPSock_Status[seqnum].keep_alive) HTTPSock_Status[seqnum].idle_time = get_httpServer_timecount();
+					else http_disconnect(s);
+					break;
+
+				//A20261019 : Frames in both directions, the response to a frame is sent before the next one is read
+				case STATE_HTTP_WEBSOCKET :
+					process_http_websocket(s, seqnum);
 					break;
 
 				default :
@@ -225,6 +318,12 @@ void httpServer_run(uint8_t seqnum)
 			break;
 
 		case SOCK_CLOSE_WAIT:
+			//A20261019 : The client may close its side right after the body; receive the rest of an upload first
+			if((HTTPSock_Status[seqnum].sock_status == STATE_HTTP_REQ_INPROC) && getSn_RX_RSR(s))
+			{
+				process_http_upload(s, seqnum);
+				break;
+			}
 #ifdef _HTTPSERVER_DEBUG_
 		printf("> HTTPSocket[%d] : ClOSE_WAIT\r\n", s);	// if a peer requests to close the current connection
 #endif
@@ -234,6 +333,22 @@ void httpServer_run(uint8_t seqnum)
 		case SOCK_CLOSED:
 #ifdef _HTTPSERVER_DEBUG_
 			printf("> HTTPSocket[%d] : CLOSED\r\n", s);
+#endif
+			//A20261019 : The peer may close the connection in the middle of a response, drop the remaining parts
+			if((HTTPSock_Status[seqnum].sock_status == STATE_HTTP_WEBSOCKET) && HTTPSock_Status[seqnum].websocket->on_close)
+				HTTPSock_Status[seqnum].websocket->on_close(seqnum);
+			HTTPSock_Status[seqnum].websocket = NULL;
+			if((HTTPSock_Status[seqnum].sock_status == STATE_HTTP_REQ_INPROC) && HTTPSock_Status[seqnum].upload->upload->on_end)
+				HTTPSock_Status[seqnum].upload->upload->on_end(seqnum, 0, NULL, NULL);
+			HTTPSock_Status[seqnum].upload = NULL;
+			HTTPSock_Status[seqnum].file_len = 0;
+			HTTPSock_Status[seqnum].file_offset = 0;
+			HTTPSock_Status[seqnum].file_start = 0;
+			HTTPSock_Status[seqnum].sock_status = STATE_HTTP_IDLE;
+			reset_http_request(seqnum);
+			close_http_response_document(seqnum); //A20261019
+#ifdef _USE_SDCARD_
+			close_http_response_file(seqnum);
 #endif
 			if(socket(s, Sn_MR_TCP, HTTP_SERVER_PORT, 0x00) == s)    /* Reinitialize the socket */
 			{
@@ -265,6 +380,14 @@ void httpServer_run(uint8_t seqnum)
 ////////////////////////////////////////////
 static void send_http_response_header(uint8_t s, uint8_t content_type, uint32_t body_len, uint16_t http_status)
 {
+	int8_t get_seqnum;
+
+	if((get_seqnum = getHTTPSequenceNum(s)) == -1) return; // exception handling; invalid number
+
+	//A20261019 : Only a response with Content-Length (200, 404) or without body (304) can keep the connection,
+	//             after a bad request the rest of the stream can not be trusted
+	if((http_status != STATUS_OK) && (http_status != STATUS_NOT_MODIF) && (http_status != STATUS_NOT_FOUND)) HTTPSock_Status[get_seqnum].keep_alive = 0;
+
 	switch(http_status)
 	{
 		case STATUS_OK: 		// HTTP/1.1 200 OK
@@ -273,7 +396,16 @@ static void send_http_response_header(uint8_t s, uint8_t content_type, uint32_t
 #ifdef _HTTPSERVER_DEBUG_
 			printf("> HTTPSocket[%d] : HTTP Response Header - STATUS_OK\r\n", s);
 #endif
-				make_http_response_head((char*)http_response, content_type, body_len);
+				make_http_response_head((char*)http_response, content_type, body_len, HTTPSock_Status[get_seqnum].keep_alive);
+				//A20261019 : Validator and encoding of the content; 'no-cache' makes the browser revalidate with If-None-Match
+				if(HTTPSock_Status[get_seqnum].etag[0])
+				{
+					add_http_response_header((char *)http_response, "ETag", (char *)HTTPSock_Status[get_seqnum].etag);
+					add_http_response_header((char *)http_response, "Cache-Control", "no-cache");
+					add_http_response_header((char *)http_response, "Vary", "Accept-Encoding");
+				}
+				if(HTTPSock_Status[get_seqnum].content_gzip)
+					add_http_response_header((char *)http_response, "Content-Encoding", "gzip");
 			}
 			else
 			{
@@ -282,19 +414,35 @@ static void send_http_response_header(uint8_t s, uint8_t content_type, uint32_t
 #endif
 				// CGI/XML type request does not respond HTTP header to client
 				http_status = 0;
+				HTTPSock_Status[get_seqnum].keep_alive = 0; //A20261019 : No framing, the end of the body is the close
 			}
 			break;
+		case STATUS_NOT_MODIF:	// HTTP/1.1 304 Not Modified //A20261019
+#ifdef _HTTPSERVER_DEBUG_
+			printf("> HTTPSocket[%d] : HTTP Response Header - STATUS_NOT_MODIF\r\n", s);
+#endif
+			sprintf((char *)http_response, "%s%s\r\n", RES_NOT_MODIFIED_HEAD,
+				HTTPSock_Status[get_seqnum].keep_alive ? RES_CONNECTION_KEEPALIVE : RES_CONNECTION_CLOSE);
+			add_http_response_header((char *)http_response, "ETag", (char *)HTTPSock_Status[get_seqnum].etag);
+			add_http_response_header((char *)http_response, "Cache-Control", "no-cache");
+			add_http_response_header((char *)http_response, "Vary", "Accept-Encoding");
+			break;
 		case STATUS_BAD_REQ: 	// HTTP/1.1 400 OK
 #ifdef _HTTPSERVER_DEBUG_
 			printf("> HTTPSocket[%d] : HTTP Response Header - STATUS_BAD_REQ\r\n", s);
 #endif
-			memcpy(http_response, ERROR_REQUEST_PAGE, sizeof(ERROR_REQUEST_PAGE));
+			//M20261019 : The close is announced
+			//memcpy(http_response, ERROR_REQUEST_PAGE, sizeof(ERROR_REQUEST_PAGE));
+			sprintf((char *)http_response, "%s%s\r\n%s", ERROR_REQUEST_HEAD, RES_CONNECTION_CLOSE, ERROR_REQUEST_BODY);
 			break;
 		case STATUS_NOT_FOUND:	// HTTP/1.1 404 Not Found
 #ifdef _HTTPSERVER_DEBUG_
 			printf("> HTTPSocket[%d] : HTTP Response Header - STATUS_NOT_FOUND\r\n", s);
 #endif
-			memcpy(http_response, ERROR_HTML_PAGE, sizeof(ERROR_HTML_PAGE));
+			//M20261019 : A missing asset does not drop the requests pipelined behind it
+			//memcpy(http_response, ERROR_HTML_PAGE, sizeof(ERROR_HTML_PAGE));
+			sprintf((char *)http_response, "%s%s\r\n%s", ERROR_HTML_HEAD,
+				HTTPSock_Status[get_seqnum].keep_alive ? RES_CONNECTION_KEEPALIVE : RES_CONNECTION_CLOSE, ERROR_HTML_BODY);
 			break;
 		default:
 			break;
@@ -317,9 +465,6 @@ static void send_http_response_body(uint8_t s, uint8_t * uri_name, uint8_t * buf
 
 	uint8_t flag_datasend_end = 0;
 
-#ifdef _USE_SDCARD_
-	uint16_t blocklen;
-#endif
 #ifdef _USE_FLASH_
 	uint32_t addr = 0;
 #endif
@@ -399,26 +544,9 @@ static void send_http_response_body(uint8_t s, uint8_t * uri_name, uint8_t * buf
 	if(HTTPSock_Status[get_seqnum].storage_type == CODEFLASH)
 	{
 		if(HTTPSock_Status[get_seqnum].file_len) start_addr = HTTPSock_Status[get_seqnum].file_start;
-		read_userReg_webContent(start_addr, &buf[0], HTTPSock_Status[get_seqnum].file_offset, send_len);
-	}
-#ifdef _USE_SDCARD_
-	else if(HTTPSock_Status[get_seqnum].storage_type == SDCARD)
-	{
-		// Data read from SD Card
-		fr = f_read(&fs, &buf[0], send_len, (void *)&blocklen);
-		if(fr != FR_OK)
-		{
-			send_len = 0;
-#ifdef _HTTPSERVER_DEBUG_
-		printf("> HTTPSocket[%d] : [FatFs] Error code return: %d (File Read) / HTTP Send Failed - %s\r\n", s, fr, HTTPSock_Status[get_seqnum].file_name);
-#endif
-		}
-		else
-		{
-			*(buf+send_len+1) = 0; // Insert '/0' for indicates the 'End of String' (null terminated)
-		}
+		read_userReg_webContent(start_addr, &buf[0], HTTPSock_Status[get_seqnum].file_offset, send_len, HTTPSock_Status[get_seqnum].content_gzip);
 	}
-#endif
+	//M20261019 : Files on SD card are streamed by send_http_response_file() without copying to buf
 
 #ifdef _USE_FLASH_
 	else if(HTTPSock_Status[get_seqnum]->storage_type == DATAFLASH)
@@ -454,22 +582,22 @@ static void send_http_response_body(uint8_t s, uint8_t * uri_name, uint8_t * buf
 		printf("> HTTPSocket[%d] : HTTP Response body - offset [ %ld ]\r\n", s, HTTPSock_Status[get_seqnum].file_offset);
 #endif
 	}
-
-// ## 20141219 Eric added, for 'File object structure' (fs) allocation reduced (8 -> 1)
-#ifdef _USE_SDCARD_
-	f_close(&fs);
-#endif
-// ## 20141219 added end
 }
 
 static void send_http_response_cgi(uint8_t s, uint8_t * buf, uint8_t * http_body, uint16_t file_len)
 {
 	uint16_t send_len = 0;
+	int8_t get_seqnum;
+
+	if((get_seqnum = getHTTPSequenceNum(s)) == -1) return; // exception handling; invalid number
 
 #ifdef _HTTPSERVER_DEBUG_
 	printf("> HTTPSocket[%d] : HTTP Response Header + Body - CGI\r\n", s);
 #endif
-	send_len = sprintf((char *)buf, "%s%d\r\n\r\n%s", RES_CGIHEAD_OK, file_len, http_body);
+	//M20261019 : Connection header
+	//send_len = sprintf((char *)buf, "%s%d\r\n\r\n%s", RES_CGIHEAD_OK, file_len, http_body);
+	send_len = sprintf((char *)buf, "%s%d\r\n%s\r\n%s", RES_CGIHEAD_OK, file_len,
+		HTTPSock_Status[get_seqnum].keep_alive ? RES_CONNECTION_KEEPALIVE : RES_CONNECTION_CLOSE, http_body);
 #ifdef _HTTPSERVER_DEBUG_
 	printf("> HTTPSocket[%d] : HTTP Response Header + Body - send len [ %d ]byte\r\n", s, send_len);
 #endif
@@ -478,219 +606,1203 @@ static void send_http_response_cgi(uint8_t s, uint8_t * buf, uint8_t * http_body
 }
 
 
-static int8_t http_disconnect(uint8_t sn)
+//A20261019 : Run the handler of route and send its body with a Content-Length, the connection can be kept
+static void process_http_route(uint8_t s, httpServer_route * route, st_http_request * p_http_request, uint8_t * uri_name)
 {
-	setSn_CR(sn,Sn_CR_DISCON);
-	/* wait to process the command... */
-	while(getSn_CR(sn));
+	st_http_route_request request;
+	uint16_t len = DATA_BUF_SIZE - HTTP_ROUTE_HEAD_SIZE;
+	int8_t get_seqnum;
+	uint8_t ret;
 
-	return SOCK_OK;
-}
+	if((get_seqnum = getHTTPSequenceNum(s)) == -1) return; // exception handling; invalid number
 
+	// query and body are in the received request; the handler writes to pHTTP_TX, where p_http_request is
+	request.method = p_http_request->METHOD;
+	request.path = uri_name;
+	request.query = p_http_request->QUERY ? (uint8_t *)http_request + p_http_request->QUERY : NULL;
+	request.query_len = p_http_request->QUERY_LEN;
+	request.body = p_http_request->BODY ? (uint8_t *)http_request + p_http_request->BODY : NULL;
+	request.body_len = p_http_request->BODY_LEN;
 
-static void http_process_handler(uint8_t s, st_http_request * p_http_request)
-{
-	uint8_t * uri_name;
-	uint32_t content_addr = 0;
-	uint16_t content_num = 0;
-	uint32_t file_len = 0;
+	if(!(route->methods & (1 << request.method)) || ((ret = route->handler(&request, pHTTP_TX, &len)) == HTTP_FAILED))
+	{
+#ifdef _HTTPSERVER_DEBUG_
+		printf("> HTTPSocket[%d] : Route [%s] rejected the request\r\n", s, uri_name);
+#endif
+		send_http_response_header(s, 0, 0, STATUS_BAD_REQ);
+		return;
+	}
 
-	uint8_t uri_buf[MAX_URI_SIZE]={0x00, };
+#ifdef _HTTPSERVER_DEBUG_
+	printf("> HTTPSocket[%d] : Route [%s] / Response len [ %d ]byte\r\n", s, uri_name, len);
+#endif
+	send_http_route_response(s, get_seqnum, route->type, request.method, len);
 
-	uint16_t http_status;
-	int8_t get_seqnum;
-	uint8_t content_found;
+	// Reset the H/W for apply to the change configuration information
+	if(ret == HTTP_RESET) HTTPServer_ReStart();
+}
 
-	if((get_seqnum = getHTTPSequenceNum(s)) == -1) return; // exception handling; invalid number
+//A20261019 : Head with the Content-Length and the body made in pHTTP_TX, in one send
+static void send_http_route_response(uint8_t s, int8_t seqnum, uint8_t type, uint8_t method, uint16_t len)
+{
+	uint16_t send_len;
 
-	http_status = 0;
-	http_response = pHTTP_RX;
-	file_len = 0;
+	if(len > DATA_BUF_SIZE - HTTP_ROUTE_HEAD_SIZE) len = DATA_BUF_SIZE - HTTP_ROUTE_HEAD_SIZE;
 
-	//method Analyze
-	switch (p_http_request->METHOD)
+	make_http_response_head((char *)http_response, type, len, HTTPSock_Status[seqnum].keep_alive);
+	send_len = strlen((char *)http_response);
+	if(method != METHOD_HEAD)
 	{
-		case METHOD_ERR :
-			http_status = STATUS_BAD_REQ;
-			send_http_response_header(s, 0, 0, http_status);
-			break;
+		memcpy(http_response + send_len, pHTTP_TX, len);
+		send_len += len;
+	}
+	send(s, http_response, send_len);
+}
 
-		case METHOD_HEAD :
-		case METHOD_GET :
-			get_http_uri_name(p_http_request->URI, uri_buf);
-			uri_name = uri_buf;
+//A20261019 : Accept the request of an upload route; the body is received in STATE_HTTP_REQ_INPROC
+static void open_http_upload(uint8_t s, httpServer_route * route, st_http_request * p_http_request, uint8_t * uri_name)
+{
+	st_http_socket * status;
+	st_http_route_request request;
+	const uint8_t * boundary = NULL;
+	uint16_t used;
+	int8_t get_seqnum;
+	int8_t ret;
 
-			if (!strcmp((char *)uri_name, "/")) strcpy((char *)uri_name, INITIAL_WEBPAGE);	// If URI is "/", respond by index.html
-			if (!strcmp((char *)uri_name, "m")) strcpy((char *)uri_name, M_INITIAL_WEBPAGE);
-			if (!strcmp((char *)uri_name, "mobile")) strcpy((char *)uri_name, MOBILE_INITIAL_WEBPAGE);
-			find_http_uri_type(&p_http_request->TYPE, uri_name);	// Checking requested file types (HTML, TEXT, GIF, JPEG and Etc. are included)
+	if((get_seqnum = getHTTPSequenceNum(s)) == -1) return; // exception handling; invalid number
+	status = &HTTPSock_Status[get_seqnum];
 
+	// The route gets the body through on_part() and on_data(), on_begin() only the query
+	request.method = p_http_request->METHOD;
+	request.path = uri_name;
+	request.query = p_http_request->QUERY ? (uint8_t *)http_request + p_http_request->QUERY : NULL;
+	request.query_len = p_http_request->QUERY_LEN;
+	request.body = NULL;
+	request.body_len = 0;
+
+	if(route->upload->on_begin && (route->upload->on_begin(get_seqnum, &request) != HTTP_OK))
+	{
 #ifdef _HTTPSERVER_DEBUG_
-			printf("\r\n> HTTPSocket[%d] : HTTP Method GET\r\n", s);
-			printf("> HTTPSocket[%d] : Request Type = %d\r\n", s, p_http_request->TYPE);
-			printf("> HTTPSocket[%d] : Request URI = %s\r\n", s, uri_name);
+		printf("> HTTPSocket[%d] : Upload [%s] rejected the request\r\n", s, route->path);
 #endif
+		send_http_response_header(s, 0, 0, STATUS_BAD_REQ);
+		return;
+	}
 
-			if(p_http_request->TYPE == PTYPE_CGI)
-			{
-				content_found = http_get_cgi_handler(uri_name, pHTTP_TX, &file_len);
-				if(content_found && (file_len <= (DATA_BUF_SIZE-(strlen(RES_CGIHEAD_OK)+8))))
-				{
-					send_http_response_cgi(s, http_response, pHTTP_TX, (uint16_t)file_len);
-				}
-				else
-				{
-					send_http_response_header(s, PTYPE_CGI, 0, STATUS_NOT_FOUND);
-				}
-			}
-			else
-			{
-				// Find the User registered index for web content
-				if(find_userReg_webContent(uri_buf, &content_num, &file_len))
-				{
-					content_found = 1; // Web content found in code flash memory
-					content_addr = (uint32_t)content_num;
-					HTTPSock_Status[get_seqnum].storage_type = CODEFLASH;
-				}
-				// Not CGI request, Web content in 'SD card' or 'Data flash' requested
-#ifdef _USE_SDCARD_
 #ifdef _HTTPSERVER_DEBUG_
-				printf("\r\n> HTTPSocket[%d] : Searching the requested content\r\n", s);
+	printf("> HTTPSocket[%d] : Upload [%s] / %s body [ %ld ]byte\r\n", s, route->path,
+		status->chunked ? "Chunked" : "Content-Length", status->content_len);
 #endif
-				if((fr = f_open(&fs, (const char *)uri_name, FA_READ)) == 0)
-				{
-					content_found = 1; // file open succeed
+	if(status->boundary) boundary = (uint8_t *)http_request + status->boundary;
+	http_upload_init(&HTTPSock_Upload[get_seqnum], status->chunked, status->content_len, boundary, status->boundary_len,
+		on_http_upload_part, on_http_upload_data, (void *)(intptr_t)get_seqnum);
+	status->upload = route;
+	status->sock_status = STATE_HTTP_REQ_INPROC;
+	status->idle_time = get_httpServer_timecount();
+
+	// The first part of the body came with the header
+	ret = http_upload_execute(&HTTPSock_Upload[get_seqnum], (uint8_t *)http_request + p_http_request->BODY, p_http_request->BODY_LEN, &used);
+	if(ret != HTTP_UPLOAD_MORE)
+	{
+		close_http_upload(s, get_seqnum, ret);
+		return;
+	}
 
-					file_len = fs.fsize;
-					content_addr = fs.sclust;
-					HTTPSock_Status[get_seqnum].storage_type = SDCARD;
-				}
-#elif _USE_FLASH_
-				else if(/* Read content from Dataflash */)
-				{
-					content_found = 1;
-					HTTPSock_Status[get_seqnum]->storage_type = DATAFLASH;
-					; // To do
-				}
-#endif
-				else
-				{
-					content_found = 0; // fail to find content
-				}
+	if(status->expect_continue)
+	{
+		send(s, (uint8_t *)RES_CONTINUE_HEAD, sizeof(RES_CONTINUE_HEAD) - 1);
+		status->expect_continue = 0;
+	}
+}
 
-				if(!content_found)
-				{
-#ifdef _HTTPSERVER_DEBUG_
-					printf("> HTTPSocket[%d] : Unknown Page Request\r\n", s);
-#endif
-					http_status = STATUS_NOT_FOUND;
-				}
-				else
-				{
-#ifdef _HTTPSERVER_DEBUG_
-					printf("> HTTPSocket[%d] : Find Content [%s] ok - Start [%ld] len [ %ld ]byte\r\n", s, uri_name, content_addr, file_len);
-#endif
-					http_status = STATUS_OK;
-				}
+//A20261019 : Next part of the body, as much as the buffer takes; the RX buffer is read only up to the end of the body,
+//            a pipelined request after it stays there
+static void process_http_upload(uint8_t s, int8_t seqnum)
+{
+	st_http_socket * status = &HTTPSock_Status[seqnum];
+	st_http_upload * upload = &HTTPSock_Upload[seqnum];
+	uint16_t len, used;
+	int8_t ret;
 
-				// Send HTTP header
-				if(http_status)
-				{
+	if((len = getSn_RX_RSR(s)) == 0)
+	{
+		if((get_httpServer_timecount() - status->idle_time) > HTTP_MAX_TIMEOUT_SEC)
+		{
 #ifdef _HTTPSERVER_DEBUG_
-					printf("> HTTPSocket[%d] : Requested content len = [ %ld ]byte\r\n", s, file_len);
+			printf("> HTTPSocket[%d] : Upload timeout, %ld byte received\r\n", s, upload->received);
 #endif
-					send_http_response_header(s, p_http_request->TYPE, file_len, http_status);
-				}
+			close_http_upload(s, seqnum, HTTP_UPLOAD_ERROR);
+		}
+		return;
+	}
+	if(len > DATA_BUF_SIZE) len = DATA_BUF_SIZE;
+	if(!upload->chunked && (len > upload->remaining)) len = upload->remaining;
 
-				// Send HTTP body (content)
-				if(http_status == STATUS_OK)
-				{
-					send_http_response_body(s, uri_name, http_response, content_addr, file_len);
-				}
-			}
-			break;
+	// pHTTP_RX is free; the data of the body is given to the route in place
+	wiz_recv_peek(s, 0, pHTTP_RX, len);
+	ret = http_upload_execute(upload, pHTTP_RX, len, &used);
+	if(used)
+	{
+		wiz_recv_ignore(s, used);
+		setSn_CR(s, Sn_CR_RECV);
+		while(getSn_CR(s));
+	}
+	status->idle_time = get_httpServer_timecount();
 
-		case METHOD_POST :
-			mid((char *)p_http_request->URI, "/", " HTTP", (char *)uri_buf);
-			uri_name = uri_buf;
-			find_http_uri_type(&p_http_request->TYPE, uri_name);	// Check file type (HTML, TEXT, GIF, JPEG are included)
+	if(ret != HTTP_UPLOAD_MORE) close_http_upload(s, seqnum, ret);
+}
 
-#ifdef _HTTPSERVER_DEBUG_
-			printf("\r\n> HTTPSocket[%d] : HTTP Method POST\r\n", s);
-			printf("> HTTPSocket[%d] : Request URI = %s ", s, uri_name);
-			printf("Type = %d\r\n", p_http_request->TYPE);
-#endif
+//A20261019 : End of an upload, the route makes the response; after a failure the rest of the body is not read
+static void close_http_upload(uint8_t s, int8_t seqnum, int8_t ret)
+{
+	st_http_socket * status = &HTTPSock_Status[seqnum];
+	const httpServer_route * route = status->upload;
+	uint16_t len = 0;
+	uint8_t result = (ret == HTTP_UPLOAD_DONE) ? HTTP_OK : HTTP_FAILED;
 
-			if(p_http_request->TYPE == PTYPE_CGI)	// HTTP POST Method; CGI Process
-			{
-				content_found = http_post_cgi_handler(uri_name, p_http_request, http_response, &file_len);
 #ifdef _HTTPSERVER_DEBUG_
-				printf("> HTTPSocket[%d] : [CGI: %s] / Response len [ %ld ]byte\r\n", s, content_found?"Content found":"Content not found", file_len);
+	printf("> HTTPSocket[%d] : Upload [%s] %s, %ld byte\r\n", s, route->path,
+		(ret == HTTP_UPLOAD_DONE) ? "completed" : (ret == HTTP_UPLOAD_ABORT) ? "stopped" : "failed", HTTPSock_Upload[seqnum].received);
 #endif
-				if(content_found && (file_len <= (DATA_BUF_SIZE-(strlen(RES_CGIHEAD_OK)+8))))
-				{
-					send_http_response_cgi(s, pHTTP_TX, http_response, (uint16_t)file_len);
-
-					// Reset the H/W for apply to the change configuration information
-					if(content_found == HTTP_RESET) HTTPServer_ReStart();
-				}
-				else
-				{
-					send_http_response_header(s, PTYPE_CGI, 0, STATUS_NOT_FOUND);
-				}
-			}
-			else	// HTTP POST Method; Content not found
-			{
-				send_http_response_header(s, 0, 0, STATUS_NOT_FOUND);
-			}
-			break;
+	status->upload = NULL;
+	status->sock_status = STATE_HTTP_RES_DONE;
+	if(ret != HTTP_UPLOAD_DONE) status->keep_alive = 0;
 
-		default :
-			http_status = STATUS_BAD_REQ;
-			send_http_response_header(s, 0, 0, http_status);
-			break;
+	if(route->upload->on_end)
+	{
+		len = DATA_BUF_SIZE - HTTP_ROUTE_HEAD_SIZE;
+		result = route->upload->on_end(seqnum, ret == HTTP_UPLOAD_DONE, pHTTP_TX, &len);
 	}
+	if(result == HTTP_FAILED) send_http_response_header(s, 0, 0, STATUS_BAD_REQ);
+	else send_http_route_response(s, seqnum, route->type, METHOD_POST, len);
+
+	// Reset the H/W for apply to the change configuration information (e.g. new firmware)
+	if(result == HTTP_RESET) HTTPServer_ReStart();
 }
 
-void httpServer_time_handler(void)
+//A20261019 : Callbacks of the body decoder of socket arg
+static uint8_t on_http_upload_part(void * arg, const char * name, const char * filename)
 {
-	httpServer_tick_1s++;
+	int8_t seqnum = (int8_t)(intptr_t)arg;
+	const httpServer_upload * upload = HTTPSock_Status[seqnum].upload->upload;
+
+	return upload->on_part ? upload->on_part(seqnum, name, filename) : 1;
 }
 
-uint32_t get_httpServer_timecount(void)
+static uint8_t on_http_upload_data(void * arg, const uint8_t * data, uint16_t len)
 {
-	return httpServer_tick_1s;
+	int8_t seqnum = (int8_t)(intptr_t)arg;
+	const httpServer_upload * upload = HTTPSock_Status[seqnum].upload->upload;
+
+	return upload->on_data ? upload->on_data(seqnum, data, len) : 1;
 }
 
-void reg_httpServer_webContent(uint8_t * content_name, uint8_t * content)
+//A20261019 : Answer the opening handshake with 101 and switch the connection to WebSocket frames
+static void open_http_websocket(uint8_t s, httpServer_route * route, st_http_request * p_http_request)
 {
-	uint16_t name_len;
-	uint32_t content_len;
+	st_http_socket * status;
+	char accept[WEBSOCKET_ACCEPT_LEN + 1];
+	int8_t get_seqnum;
 
-	if(content_name == NULL || content == NULL)
-	{
-		return;
-	}
-	else if(total_content_cnt >= MAX_CONTENT_CALLBACK)
+	if((get_seqnum = getHTTPSequenceNum(s)) == -1) return; // exception handling; invalid number
+	status = &HTTPSock_Status[get_seqnum];
+
+	if((p_http_request->METHOD != METHOD_GET) || (status->upgrade != HTTP_UPGRADE_ALL))
 	{
+#ifdef _HTTPSERVER_DEBUG_
+		printf("> HTTPSocket[%d] : Not a WebSocket handshake\r\n", s);
+#endif
+		send_http_response_header(s, 0, 0, STATUS_BAD_REQ);
 		return;
 	}
 
-	name_len = strlen((char *)content_name);
-	content_len = strlen((char *)content);
-
-	web_content[total_content_cnt].content_name = malloc(name_len+1);
-	strcpy((char *)web_content[total_content_cnt].content_name, (const char *)content_name);
-	web_content[total_content_cnt].content_len = content_len;
-	web_content[total_content_cnt].content = content;
+	websocket_make_accept((char *)status->ws_key, accept);
+	sprintf((char *)http_response, "%s%s\r\n\r\n", RES_WEBSOCKET_HEAD, accept);
+#ifdef _HTTPSERVER_DEBUG_
+	printf("> HTTPSocket[%d] : WebSocket [%s] open\r\n", s, route->path);
+#endif
+	send(s, http_response, strlen((char *)http_response));
 
-	total_content_cnt++;
+	status->sock_status = STATE_HTTP_WEBSOCKET;
+	status->websocket = route->websocket;
+	status->ws_rx_time = get_httpServer_timecount();
+	status->ws_ping = 0;
+	if(status->websocket->on_open) status->websocket->on_open(get_seqnum);
 }
 
-uint8_t display_reg_webContent_list(void)
+//A20261019 : One received frame and one frame from on_send() each call. Nothing is read while the last frame is
+//            being sent, so a ping or close is always answered and the client is slowed down by TCP, not dropped.
+static void process_http_websocket(uint8_t s, int8_t seqnum)
 {
-	uint16_t i;
-	uint8_t ret;
+	st_http_socket * status = &HTTPSock_Status[seqnum];
+	const httpServer_websocket * websocket = status->websocket;
+	st_websocket_frame frame;
+	uint16_t freesize;
+	uint16_t len;
+	int32_t ret;
+
+	if(send_buffered(s, 0) != SOCK_OK) return;
+	if(getSn_TX_FSR(s) < WEBSOCKET_MAX_HEAD_LEN + WEBSOCKET_MAX_CONTROL_LEN) return;
+
+	// pHTTP_RX is free; no other socket's request is kept between calls
+	ret = websocket_recv_frame(s, pHTTP_RX, DATA_BUF_SIZE, &frame);
+	if(ret < 0)
+	{
+#ifdef _HTTPSERVER_DEBUG_
+		printf("> HTTPSocket[%d] : WebSocket frame error %ld\r\n", s, ret);
+#endif
+		close_http_websocket(s, (ret == WEBSOCKET_ERR_TOO_BIG) ? WEBSOCKET_CLOSE_TOO_BIG : WEBSOCKET_CLOSE_PROTOCOL);
+		return;
+	}
+	if(ret > 0)
+	{
+		status->ws_rx_time = get_httpServer_timecount();
+		status->ws_ping = 0;
+
+		switch(frame.opcode)
+		{
+			case WEBSOCKET_OP_CONTINUATION :
+			case WEBSOCKET_OP_TEXT :
+			case WEBSOCKET_OP_BINARY :
+				if(websocket->on_message) websocket->on_message(seqnum, frame.opcode, pHTTP_RX, frame.len);
+				break;
+
+			case WEBSOCKET_OP_PING :
+				websocket_send_frame(s, WEBSOCKET_OP_PONG, pHTTP_RX, frame.len);
+				return;
+
+			case WEBSOCKET_OP_CLOSE :
+				// Echo the status code, then close the TCP connection
+#ifdef _HTTPSERVER_DEBUG_
+				printf("> HTTPSocket[%d] : WebSocket closed by the client\r\n", s);
+#endif
+				websocket_send_frame(s, WEBSOCKET_OP_CLOSE, pHTTP_RX, (frame.len > 2) ? 2 : frame.len);
+				http_disconnect(s);
+				return;
+
+			case WEBSOCKET_OP_PONG :
+				break;
+
+			default :
+				close_http_websocket(s, WEBSOCKET_CLOSE_PROTOCOL);
+				return;
+		}
+	}
+	else if((get_httpServer_timecount() - status->ws_rx_time) > 2 * HTTP_WEBSOCKET_PING_SEC)
+	{
+#ifdef _HTTPSERVER_DEBUG_
+		printf("> HTTPSocket[%d] : WebSocket ping timeout\r\n", s);
+#endif
+		http_disconnect(s);
+		return;
+	}
+	else if(!status->ws_ping && ((get_httpServer_timecount() - status->ws_rx_time) > HTTP_WEBSOCKET_PING_SEC))
+	{
+		// Any frame from the client proves the connection, the pong is not waited for separately
+		if(websocket_send_frame(s, WEBSOCKET_OP_PING, NULL, 0) > 0) status->ws_ping = 1;
+		return;
+	}
+
+	// Server push; on_send() is only called when its frame can be sent as a whole
+	if(!websocket->on_send || (send_buffered(s, 0) != SOCK_OK)) return;
+	if((freesize = getSn_TX_FSR(s)) <= WEBSOCKET_MAX_HEAD_LEN) return;
+	freesize -= WEBSOCKET_MAX_HEAD_LEN;
+	if(freesize > DATA_BUF_SIZE) freesize = DATA_BUF_SIZE;
+
+	if((len = websocket->on_send(seqnum, pHTTP_TX, freesize)) > 0)
+	{
+		if(len > freesize) len = freesize;
+		websocket_send_frame(s, WEBSOCKET_OP_TEXT, pHTTP_TX, len);
+	}
+}
+
+//A20261019 : Close frame with a status code, then close the TCP connection
+static void close_http_websocket(uint8_t s, uint16_t code)
+{
+	uint8_t payload[2];
+	uint16_t len;
+
+	payload[0] = code >> 8;
+	payload[1] = code & 0xFF;
+	websocket_send_frame(s, WEBSOCKET_OP_CLOSE, payload, sizeof(payload));
+
+	// Drop the rest of the bad frame; the FIN of the client can't arrive while the RX buffer is full
+	if((len = getSn_RX_RSR(s)) > 0)
+	{
+		wiz_recv_ignore(s, len);
+		setSn_CR(s, Sn_CR_RECV);
+		while(getSn_CR(s));
+	}
+	http_disconnect(s);
+}
+
+
+//A20261019 : The gzip variant is another representation and needs its own ETag, "-gz" is put before the closing quote
+//             A validator that can not be marked is dropped, sharing one would let a cache answer with the wrong encoding
+static void make_http_gzip_etag(uint8_t * etag)
+{
+	uint16_t len = strlen((char *)etag);
+
+	if((len < 2) || (etag[len - 1] != '"') || (len + sizeof(HTTP_GZIP_ETAG_SUFFIX) - 1 >= MAX_CONTENT_ETAG_LEN))
+	{
+		etag[0] = '\0';
+		return;
+	}
+	strcpy((char *)etag + len - 1, HTTP_GZIP_ETAG_SUFFIX "\"");
+}
+
+//A20261019 : Web content in the image; file_start is the offset of the content (or its gzip variant) in the image
+static uint8_t open_http_response_romfs(int8_t seqnum, uint8_t * uri_name, uint32_t * file_len)
+{
+	st_http_socket * status = &HTTPSock_Status[seqnum];
+	st_http_romfs_entry * entry = &HTTPSock_Romfs[seqnum];
+
+	if(!http_romfs.count || !http_romfs_find(&http_romfs, uri_name, entry)) return 0;
+
+	if(entry->gzip_head_len && status->accept_gzip)
+	{
+		status->content_gzip = 1;
+		status->file_start = entry->gzip;
+		*file_len = entry->gzip_len;
+	}
+	else
+	{
+		status->file_start = entry->data;
+		*file_len = entry->data_len;
+	}
+	if(entry->etag_len < MAX_CONTENT_ETAG_LEN) http_romfs_read(&http_romfs, entry->etag, status->etag, entry->etag_len + 1);
+	if(status->content_gzip) make_http_gzip_etag(status->etag);
+
+	return 1;
+}
+
+//A20261019 : Head from the image; only 'Connection' depends on the request
+static void send_http_response_romfs_header(uint8_t s, int8_t seqnum)
+{
+	st_http_romfs_entry * entry = &HTTPSock_Romfs[seqnum];
+	uint16_t len;
+
+	if(HTTPSock_Status[seqnum].content_gzip) len = http_romfs_read(&http_romfs, entry->head + entry->head_len, http_response, entry->gzip_head_len);
+	else len = http_romfs_read(&http_romfs, entry->head, http_response, entry->head_len);
+
+	len += sprintf((char *)http_response + len, "%s\r\n", HTTPSock_Status[seqnum].keep_alive ? RES_CONNECTION_KEEPALIVE : RES_CONNECTION_CLOSE);
+#ifdef _HTTPSERVER_DEBUG_
+	printf("> HTTPSocket[%d] : [Send] HTTP Response Header (image) [ %d ]byte\r\n", s, len);
+#endif
+	send(s, http_response, len);
+}
+
+//A20261019 : Next part of the content in the image; a memory mapped image is written to the socket without a copy
+static void send_http_response_romfs(uint8_t s, int8_t seqnum)
+{
+	st_http_socket * status = &HTTPSock_Status[seqnum];
+	const uint8_t * data;
+	uint32_t send_len;
+	int32_t ret;
+
+	ret = send_buffered(s, 0);
+	if(ret == SOCK_BUSY) return;
+
+	if(ret == SOCK_OK)
+	{
+		send_len = status->file_len - status->file_offset;
+		if(send_len > getSn_TX_FSR(s)) send_len = getSn_TX_FSR(s); // Socket buffer sized chunks
+		if(send_len == 0) return;
+
+		if((data = http_romfs_map(&http_romfs, status->file_start + status->file_offset)) == NULL)
+		{
+			if(send_len > DATA_BUF_SIZE) send_len = DATA_BUF_SIZE;
+			send_len = http_romfs_read(&http_romfs, status->file_start + status->file_offset, http_response, send_len);
+			data = http_response;
+		}
+
+		if(send_len)
+		{
+			wiz_send_data(s, (uint8_t *)data, (uint16_t)send_len);
+			ret = send_buffered(s, (uint16_t)send_len);
+#ifdef _HTTPSERVER_DEBUG_
+			printf("> HTTPSocket[%d] : [Send] HTTP Response body [ %ld ]byte\r\n", s, send_len);
+#endif
+			status->file_offset += send_len;
+		}
+		else
+		{
+			// Past the end of the image, the response can't be completed; close the connection after it
+			status->file_offset = status->file_len;
+			status->keep_alive = 0;
+		}
+	}
+
+	if((ret < 0) || (status->file_offset >= status->file_len))
+	{
+		// Send process end, or the socket is not usable any more
+		status->file_start = 0;
+		status->file_len = 0;
+		status->file_offset = 0;
+	}
+}
+
+//A20261019 : Body of a document route; it stays in the buffer of the route until close_http_response_document()
+static void open_http_response_document(uint8_t s, httpServer_route * route, st_http_request * p_http_request, uint8_t * uri_name)
+{
+	st_http_socket * status;
+	st_http_route_request request;
+	const uint8_t * body;
+	const char * etag = NULL;
+	uint32_t len = 0;
+	int8_t get_seqnum;
+
+	if((get_seqnum = getHTTPSequenceNum(s)) == -1) return; // exception handling; invalid number
+	status = &HTTPSock_Status[get_seqnum];
+
+	request.method = p_http_request->METHOD;
+	request.path = uri_name;
+	request.query = p_http_request->QUERY ? (uint8_t *)http_request + p_http_request->QUERY : NULL;
+	request.query_len = p_http_request->QUERY_LEN;
+	request.body = NULL;
+	request.body_len = 0;
+
+	if((body = route->document->open(get_seqnum, &request, &len, &etag)) == NULL)
+	{
+#ifdef _HTTPSERVER_DEBUG_
+		printf("> HTTPSocket[%d] : Document [%s] rejected the request\r\n", s, uri_name);
+#endif
+		send_http_response_header(s, 0, 0, STATUS_BAD_REQ);
+		return;
+	}
+	status->document = route;
+	status->document_body = body;
+
+	status->content_gzip = 0;
+	status->etag[0] = '\0';
+	if(etag && (strlen(etag) < MAX_CONTENT_ETAG_LEN)) strcpy((char *)status->etag, etag);
+
+	// The client has the same version, e.g. a dashboard polling a document that did not change
+	if(status->etag[0] && (!strcmp((char *)status->if_none_match, "*") || strstr((char *)status->if_none_match, (char *)status->etag)))
+	{
+		send_http_response_header(s, 0, 0, STATUS_NOT_MODIF);
+		return;
+	}
+
+#ifdef _HTTPSERVER_DEBUG_
+	printf("> HTTPSocket[%d] : Document [%s] / Response len [ %ld ]byte\r\n", s, uri_name, len);
+#endif
+	send_http_response_header(s, route->type, len, STATUS_OK);
+	if((request.method != METHOD_HEAD) && len)
+	{
+		status->storage_type = DOCUMENT;
+		status->file_start = 0;
+		status->file_len = len;
+		status->file_offset = 0;
+	}
+}
+
+//A20261019 : Next part of the body of a document route, written to the socket from its buffer
+static void send_http_response_document(uint8_t s, int8_t seqnum)
+{
+	st_http_socket * status = &HTTPSock_Status[seqnum];
+	uint32_t send_len;
+	int32_t ret;
+
+	ret = send_buffered(s, 0);
+	if(ret == SOCK_BUSY) return;
+
+	if(ret == SOCK_OK)
+	{
+		send_len = status->file_len - status->file_offset;
+		if(send_len > getSn_TX_FSR(s)) send_len = getSn_TX_FSR(s); // Socket buffer sized chunks
+		if(send_len == 0) return;
+
+		wiz_send_data(s, (uint8_t *)status->document_body + status->file_offset, (uint16_t)send_len);
+		ret = send_buffered(s, (uint16_t)send_len);
+#ifdef _HTTPSERVER_DEBUG_
+		printf("> HTTPSocket[%d] : [Send] HTTP Response body [ %ld ]byte\r\n", s, send_len);
+#endif
+		status->file_offset += send_len;
+	}
+
+	if((ret < 0) || (status->file_offset >= status->file_len))
+	{
+		// Send process end, or the socket is not usable any more
+		status->file_len = 0;
+		status->file_offset = 0;
+	}
+}
+
+//A20261019 : The body of the response is not used any more
+static void close_http_response_document(int8_t seqnum)
+{
+	st_http_socket * status = &HTTPSock_Status[seqnum];
+
+	if(status->document && status->document->document->close) status->document->document->close(seqnum);
+	status->document = NULL;
+	status->document_body = NULL;
+}
+
+#ifdef _USE_SDCARD_
+//A20261019 : Web content on SD card
+static FRESULT open_http_response_file(int8_t seqnum, uint8_t * uri_name, uint32_t * file_len)
+{
+	char path[sizeof(HTTP_SDCARD_ROOT) + MAX_URI_SIZE + 4];
+	FILINFO info;
+	FRESULT fr = FR_NO_FILE;
+
+	close_http_response_file(seqnum);
+
+#ifdef _HTTPSERVER_DEBUG_
+	printf("\r\n> HTTPSocket[%d] : Searching the requested content\r\n", getHTTPSocketNum(seqnum));
+#endif
+	//A20261019 : 'name.gz' next to 'name' is the precompressed variant
+	if(HTTPSock_Status[seqnum].accept_gzip)
+	{
+		snprintf(path, sizeof(path), "%s/%s.gz", HTTP_SDCARD_ROOT, (char *)uri_name);
+		if((fr = f_open(&HTTPSock_File[seqnum], path, FA_READ)) == FR_OK) HTTPSock_Status[seqnum].content_gzip = 1;
+	}
+	if(fr != FR_OK)
+	{
+		snprintf(path, sizeof(path), "%s/%s", HTTP_SDCARD_ROOT, (char *)uri_name);
+		fr = f_open(&HTTPSock_File[seqnum], path, FA_READ);
+	}
+	if(fr == FR_OK)
+	{
+		*file_len = (uint32_t)f_size(&HTTPSock_File[seqnum]);
+
+		//A20261019 : ETag from the size and the modified time of the file that is sent
+		if(f_stat(path, &info) == FR_OK)
+		{
+			snprintf((char *)HTTPSock_Status[seqnum].etag, MAX_CONTENT_ETAG_LEN, "\"%lx-%04x%04x\"",
+				(unsigned long)info.fsize, info.fdate, info.ftime);
+			if(HTTPSock_Status[seqnum].content_gzip) make_http_gzip_etag(HTTPSock_Status[seqnum].etag);
+		}
+	}
+
+	return fr;
+}
+
+/* f_forward() streaming function: 'data' points to the FatFs sector buffer, write it to the socket TX buffer directly */
+static UINT forward_http_response_file(const BYTE * data, UINT len)
+{
+	if(len == 0) return 1; // Always ready, the total size is limited to the free TX buffer by the caller
+
+	wiz_send_data(HTTPSock_Forward, (uint8_t *)data, (uint16_t)len);
+	return len;
+}
+
+static void send_http_response_file(uint8_t s, int8_t seqnum)
+{
+	st_http_socket * status = &HTTPSock_Status[seqnum];
+	uint32_t send_len;
+	uint16_t freesize;
+	int32_t ret;
+	UINT forward_len = 0;
+	FRESULT fr = FR_OK;
+
+	// Wait for the previous SEND; the next chunk is written only when the last one is out
+	ret = send_buffered(s, 0);
+	if(ret == SOCK_BUSY) return;
+
+	if(ret == SOCK_OK)
+	{
+		send_len = status->file_len - status->file_offset;
+		freesize = getSn_TX_FSR(s);
+		if(send_len > freesize) send_len = freesize; // Socket buffer sized chunks
+		if(send_len == 0) return;
+
+		HTTPSock_Forward = s;
+		fr = f_forward(&HTTPSock_File[seqnum], forward_http_response_file, send_len, &forward_len);
+		if(forward_len) ret = send_buffered(s, (uint16_t)forward_len);
+#ifdef _HTTPSERVER_DEBUG_
+		printf("> HTTPSocket[%d] : [Send] HTTP Response body [ %d ]byte\r\n", s, forward_len);
+#endif
+		status->file_offset += forward_len;
+	}
+
+	if((ret < 0) || (fr != FR_OK) || (forward_len == 0) || (status->file_offset >= status->file_len))
+	{
+#ifdef _HTTPSERVER_DEBUG_
+		if(fr != FR_OK) printf("> HTTPSocket[%d] : [FatFs] Error code return: %d (File Read) / HTTP Send Failed\r\n", s, fr);
+		printf("> HTTPSocket[%d] : HTTP Response end - file len [ %ld ]byte\r\n", s, status->file_offset);
+#endif
+		// Send process end, or the socket is not usable any more
+		status->file_start = 0;
+		status->file_len = 0;
+		status->file_offset = 0;
+		close_http_response_file(seqnum);
+	}
+}
+
+static void close_http_response_file(int8_t seqnum)
+{
+	// f_close() returns FR_INVALID_OBJECT for a file object not opened
+	f_close(&HTTPSock_File[seqnum]);
+}
+#endif
+
+//A20261019 : Copy exactly one request (header and Content-Length body) to buf and remove it from the RX buffer.
+//            Returns 0 while the request is incomplete; the bytes after it stay in the RX buffer for the next call.
+static uint16_t recv_http_request(uint8_t s, int8_t seqnum, uint8_t * buf, uint16_t len)
+{
+	st_http_parser * parser = &HTTPSock_Parser[seqnum];
+	st_http_socket * status = &HTTPSock_Status[seqnum];
+	uint16_t req_len;
+	int8_t ret;
+
+	if(len > DATA_BUF_SIZE - 1) len = DATA_BUF_SIZE - 1;
+
+	// Peek, the RX read pointer is not moved. The shared buffer may hold another socket's request since the
+	// last call, so peek from the start; the parser skips the part it has already seen.
+	wiz_recv_peek(s, 0, buf, len);
+	buf[len] = '\0';
+
+	if(parser->pos == 0)
+	{
+		// First part of a new request, the fields of the last one were used by its response
+		status->content_len = 0;
+		status->connection = HTTP_CONNECTION_NONE;
+		status->accept_gzip = 0;
+		status->if_none_match[0] = '\0';
+		status->upgrade = 0;
+		status->ws_key[0] = '\0';
+		status->chunked = 0;
+		status->expect_continue = 0;
+		status->boundary = 0;
+		status->boundary_len = 0;
+	}
+
+	ret = http_parser_execute(parser, buf, len);
+	if(ret == HTTP_PARSER_DONE)
+	{
+		// HTTP/1.1 keeps the connection unless 'Connection: close', HTTP/1.0 only with 'Connection: keep-alive'
+		if(status->connection == HTTP_CONNECTION_NONE) status->keep_alive = (parser->version != 10);
+		else status->keep_alive = (status->connection == HTTP_CONNECTION_KEEPALIVE);
+
+		req_len = parser->body;
+		//M20261019 : A body that is not framed by Content-Length or is larger than the buffer stays in the socket,
+		//            an upload route receives it (http_process_handler() closes the connection for the others)
+		if(status->chunked)
+		{
+			; // Decoded while it arrives, none of it is taken with the header
+		}
+		else if(req_len + status->content_len <= len)
+		{
+			req_len += status->content_len;
+		}
+		else if(req_len + status->content_len < DATA_BUF_SIZE)
+		{
+			// The client waits for the interim response before it sends the body
+			if(status->expect_continue)
+			{
+				send(s, (uint8_t *)RES_CONTINUE_HEAD, sizeof(RES_CONTINUE_HEAD) - 1);
+				status->expect_continue = 0;
+			}
+			return 0; // Wait for the rest of the body
+		}
+		else
+		{
+			req_len = len; // Body larger than the buffer, the first part of it comes with the header
+			//status->keep_alive = 0;
+		}
+	}
+	else if((ret == HTTP_PARSER_MORE) && (len < DATA_BUF_SIZE - 1))
+	{
+		return 0; // Wait for the rest of the header
+	}
+	else
+	{
+		req_len = len; // Malformed, or header longer than the buffer; answer what we have, then close
+		status->keep_alive = 0;
+	}
+
+	wiz_recv_ignore(s, req_len);
+	setSn_CR(s, Sn_CR_RECV);
+	while(getSn_CR(s));
+
+	buf[req_len] = '\0';
+	http_parser_get_request(parser, buf, req_len, parsed_http_request);
+	if(ret == HTTP_PARSER_ERROR) parsed_http_request->METHOD = METHOD_ERR;
+
+	reset_http_request(seqnum);
+
+	return req_len;
+}
+
+//A20261019 : Header fields the server cares about, called by the parser of socket arg
+static void on_http_request_header(void * arg, const char * name, uint16_t name_len, const char * value, uint16_t value_len)
+{
+	st_http_socket * status = &HTTPSock_Status[(int8_t)(intptr_t)arg];
+	char tmp[MAX_CONTENT_ETAG_LEN];
+	uint16_t raw_len = value_len; // Not cut like the copy
+	uint16_t i;
+
+	// Null terminated copy of the value, long values only matter for their start
+	if(value_len > sizeof(tmp) - 1) value_len = sizeof(tmp) - 1;
+	memcpy(tmp, value, value_len);
+	tmp[value_len] = '\0';
+
+	if((name_len == 10) && match_http_token(name, "Connection"))
+	{
+		if(find_http_token(tmp, "close")) status->connection = HTTP_CONNECTION_CLOSE;
+		else if(find_http_token(tmp, "keep-alive")) status->connection = HTTP_CONNECTION_KEEPALIVE;
+		if(find_http_token(tmp, "upgrade")) status->upgrade |= HTTP_UPGRADE_CONNECTION; // e.g. 'keep-alive, Upgrade'
+	}
+	else if((name_len == 14) && match_http_token(name, "Content-Length"))
+	{
+		status->content_len = strtoul(tmp, NULL, 10);
+	}
+	//A20261019 : Body of an upload
+	else if((name_len == 17) && match_http_token(name, "Transfer-Encoding"))
+	{
+		status->chunked = find_http_token(tmp, "chunked");
+	}
+	else if((name_len == 6) && match_http_token(name, "Expect"))
+	{
+		status->expect_continue = find_http_token(tmp, "100-continue");
+	}
+	else if((name_len == 12) && match_http_token(name, "Content-Type"))
+	{
+		// 'multipart/form-data; boundary=...', the boundary may be longer than tmp; it stays in the received request
+		if(!match_http_token(value, "multipart/form-data")) return;
+		for(i = 19; i + 9 < raw_len; i++)
+		{
+			if(match_http_token(value + i, "boundary=")) break;
+		}
+		if(i + 9 >= raw_len) return;
+		value += i + 9;
+		raw_len -= i + 9;
+		if(value[0] == '"')
+		{
+			value++;
+			raw_len--;
+		}
+		for(i = 0; (i < raw_len) && (value[i] != '"') && (value[i] != ';'); i++);
+		while(i && (value[i - 1] == ' ')) i--;
+		if(i && (i <= HTTP_UPLOAD_MAX_BOUNDARY))
+		{
+			status->boundary = (uint16_t)((const uint8_t *)value - (const uint8_t *)http_request);
+			status->boundary_len = (uint8_t)i;
+		}
+	}
+	else if((name_len == 15) && match_http_token(name, "Accept-Encoding"))
+	{
+		// Content negotiation for the response
+		status->accept_gzip = find_http_token(tmp, "gzip");
+	}
+	else if((name_len == 13) && match_http_token(name, "If-None-Match"))
+	{
+		// Cache validation for the response
+		for(i = 0; i <= value_len; i++) status->if_none_match[i] = tmp[i];
+	}
+	//A20261019 : WebSocket opening handshake
+	else if((name_len == 7) && match_http_token(name, "Upgrade"))
+	{
+		if(find_http_token(tmp, "websocket")) status->upgrade |= HTTP_UPGRADE_WEBSOCKET;
+	}
+	else if((name_len == 21) && match_http_token(name, "Sec-WebSocket-Version"))
+	{
+		if(!strcmp(tmp, "13")) status->upgrade |= HTTP_UPGRADE_VERSION;
+	}
+	else if((name_len == 17) && match_http_token(name, "Sec-WebSocket-Key"))
+	{
+		if(value_len == WEBSOCKET_KEY_LEN)
+		{
+			memcpy(status->ws_key, tmp, WEBSOCKET_KEY_LEN + 1);
+			status->upgrade |= HTTP_UPGRADE_KEY;
+		}
+	}
+}
+
+//A20261019 : Start over with the next request of the socket
+static void reset_http_request(int8_t seqnum)
+{
+	http_parser_init(&HTTPSock_Parser[seqnum], on_http_request_header, (void *)(intptr_t)seqnum);
+}
+
+//A20261019 : Length of token if str starts with it (case insensitive), 0 if not
+static uint16_t match_http_token(const char * str, const char * token)
+{
+	uint16_t i;
+
+	for(i = 0; token[i]; i++)
+	{
+		if(toupper((uint8_t)str[i]) != toupper((uint8_t)token[i])) return 0;
+	}
+
+	return i;
+}
+
+//A20261019 : Whether the comma separated header value has token, "gzip;q=0" means refused
+static uint8_t find_http_token(const char * list, const char * token)
+{
+	const char * item = list;
+	uint16_t len;
+
+	while(*item && (*item != '\r'))
+	{
+		while(*item == ' ' || *item == ',') item++;
+		if((len = match_http_token(item, token)) && strchr(",; \r", item[len]))
+		{
+			item += len;
+			while(*item == ' ') item++;
+			if((*item == ';') && (item = strstr(item, "q=")) && (strtod(item + 2, NULL) == 0)) return 0;
+			return 1;
+		}
+		while(*item && (*item != ',') && (*item != '\r')) item++;
+	}
+
+	return 0;
+}
+
+//A20261019 : Insert 'name: value' before the empty line that ends head
+static void add_http_response_header(char * head, const char * name, const char * value)
+{
+	char * end = head + strlen(head) - 2;
+
+	sprintf(end, "%s: %s\r\n\r\n", name, value);
+}
+
+static int8_t http_disconnect(uint8_t sn)
+{
+	setSn_CR(sn,Sn_CR_DISCON);
+	/* wait to process the command... */
+	while(getSn_CR(sn));
+
+	return SOCK_OK;
+}
+
+
+static void http_process_handler(uint8_t s, st_http_request * p_http_request)
+{
+	uint8_t * uri_name;
+	uint32_t content_addr = 0;
+	uint16_t content_num = 0;
+	uint32_t file_len = 0;
+
+	uint8_t uri_buf[MAX_URI_SIZE]={0x00, };
+	httpServer_route * route; //A20261019
+
+	uint16_t http_status;
+	int8_t get_seqnum;
+	uint8_t content_found;
+	uint8_t body_left; //A20261019
+
+	if((get_seqnum = getHTTPSequenceNum(s)) == -1) return; // exception handling; invalid number
+
+	http_status = 0;
+	http_response = pHTTP_RX;
+	file_len = 0;
+
+	//A20261019 : Part of the body is still in the socket; only an upload route reads it, after any other response the
+	//            connection is closed since the rest can't be told from the next request
+	body_left = HTTPSock_Status[get_seqnum].chunked || (p_http_request->BODY_LEN < HTTPSock_Status[get_seqnum].content_len);
+
+	//method Analyze
+	switch (p_http_request->METHOD)
+	{
+		case METHOD_ERR :
+			http_status = STATUS_BAD_REQ;
+			send_http_response_header(s, 0, 0, http_status);
+			break;
+
+		case METHOD_HEAD :
+		case METHOD_GET :
+			if(body_left) HTTPSock_Status[get_seqnum].keep_alive = 0; //A20261019
+			get_http_uri_name(p_http_request->URI, uri_buf);
+			uri_name = uri_buf;
+
+			if (!strcmp((char *)uri_name, "/")) strcpy((char *)uri_name, INITIAL_WEBPAGE);	// If URI is "/", respond by index.html
+			if (!strcmp((char *)uri_name, "m")) strcpy((char *)uri_name, M_INITIAL_WEBPAGE);
+			if (!strcmp((char *)uri_name, "mobile")) strcpy((char *)uri_name, MOBILE_INITIAL_WEBPAGE);
+
+			//A20261019 : One lookup finds a route handler or registered web content
+			route = find_http_route(uri_name);
+			if(route && route->handler)
+			{
+				process_http_route(s, route, p_http_request, uri_name);
+				break;
+			}
+			if(route && route->websocket)
+			{
+				open_http_websocket(s, route, p_http_request);
+				break;
+			}
+			if(route && route->upload)
+			{
+				send_http_response_header(s, 0, 0, STATUS_BAD_REQ); // POST only
+				break;
+			}
+			if(route && route->document)
+			{
+				open_http_response_document(s, route, p_http_request, uri_name);
+				break;
+			}
+
+			find_http_uri_type(&p_http_request->TYPE, uri_name);	// Checking requested file types (HTML, TEXT, GIF, JPEG and Etc. are included)
+
+#ifdef _HTTPSERVER_DEBUG_
+			printf("\r\n> HTTPSocket[%d] : HTTP Method GET\r\n", s);
+			printf("> HTTPSocket[%d] : Request Type = %d\r\n", s, p_http_request->TYPE);
+			printf("> HTTPSocket[%d] : Request URI = %s\r\n", s, uri_name);
+#endif
+
+			if(p_http_request->TYPE == PTYPE_CGI)
+			{
+				content_found = http_get_cgi_handler(uri_name, pHTTP_TX, &file_len);
+				if(content_found && (file_len <= (DATA_BUF_SIZE-(strlen(RES_CGIHEAD_OK)+strlen(RES_CONNECTION_KEEPALIVE)+8))))
+				{
+					send_http_response_cgi(s, http_response, pHTTP_TX, (uint16_t)file_len);
+				}
+				else
+				{
+					send_http_response_header(s, PTYPE_CGI, 0, STATUS_NOT_FOUND);
+				}
+			}
+			else
+			{
+				//A20261019 : Set by the storage that has the content
+				HTTPSock_Status[get_seqnum].content_gzip = 0;
+				HTTPSock_Status[get_seqnum].etag[0] = '\0';
+
+				// Find the User registered index for web content
+				//M20261019 : Already found by find_http_route()
+				//if(find_userReg_webContent(uri_buf, &content_num, &file_len))
+				if(route)
+				{
+					content_num = route->content_num;
+					file_len = web_content[content_num].content_len;
+					content_found = 1; // Web content found in code flash memory
+					content_addr = (uint32_t)content_num;
+					HTTPSock_Status[get_seqnum].storage_type = CODEFLASH;
+
+					//A20261019 : Precompressed variant and ETag
+					if(web_content[content_num].gzip_content && HTTPSock_Status[get_seqnum].accept_gzip)
+					{
+						HTTPSock_Status[get_seqnum].content_gzip = 1;
+						file_len = web_content[content_num].gzip_len;
+					}
+					if(web_content[content_num].etag)
+					{
+						strncpy((char *)HTTPSock_Status[get_seqnum].etag, (char *)web_content[content_num].etag, MAX_CONTENT_ETAG_LEN - 1);
+						HTTPSock_Status[get_seqnum].etag[MAX_CONTENT_ETAG_LEN - 1] = '\0';
+						if(HTTPSock_Status[get_seqnum].content_gzip) make_http_gzip_etag(HTTPSock_Status[get_seqnum].etag);
+					}
+				}
+				//A20261019 : Web content image, the head of the response is in the image
+				else if(open_http_response_romfs(get_seqnum, uri_name, &file_len))
+				{
+					content_found = 1;
+					content_addr = HTTPSock_Status[get_seqnum].file_start;
+					HTTPSock_Status[get_seqnum].storage_type = ROMFS;
+				}
+				// Not CGI request, Web content in 'SD card' or 'Data flash' requested
+#ifdef _USE_SDCARD_
+				//M20261019 : 'else if', content in code flash was overwritten by the SD card result
+				else if(open_http_response_file(get_seqnum, uri_name, &file_len) == FR_OK)
+				{
+					content_found = 1; // file open succeed
+
+					content_addr = 0;
+					HTTPSock_Status[get_seqnum].storage_type = SDCARD;
+				}
+#elif _USE_FLASH_
+				else if(/* Read content from Dataflash */)
+				{
+					content_found = 1;
+					HTTPSock_Status[get_seqnum]->storage_type = DATAFLASH;
+					; // To do
+				}
+#endif
+				else
+				{
+					content_found = 0; // fail to find content
+				}
+
+				if(!content_found)
+				{
+#ifdef _HTTPSERVER_DEBUG_
+					printf("> HTTPSocket[%d] : Unknown Page Request\r\n", s);
+#endif
+					http_status = STATUS_NOT_FOUND;
+				}
+				else
+				{
+#ifdef _HTTPSERVER_DEBUG_
+					printf("> HTTPSocket[%d] : Find Content [%s] ok - Start [%ld] len [ %ld ]byte\r\n", s, uri_name, content_addr, file_len);
+#endif
+					http_status = STATUS_OK;
+
+					//A20261019 : The client has the same version cached
+					if(HTTPSock_Status[get_seqnum].etag[0] && (!strcmp((char *)HTTPSock_Status[get_seqnum].if_none_match, "*")
+						|| strstr((char *)HTTPSock_Status[get_seqnum].if_none_match, (char *)HTTPSock_Status[get_seqnum].etag)))
+					{
+						http_status = STATUS_NOT_MODIF;
+						file_len = 0;
+					}
+				}
+
+				// Send HTTP header
+				if(http_status)
+				{
+#ifdef _HTTPSERVER_DEBUG_
+					printf("> HTTPSocket[%d] : Requested content len = [ %ld ]byte\r\n", s, file_len);
+#endif
+					//M20261019 : The head of content in the image is not made again
+					//send_http_response_header(s, p_http_request->TYPE, file_len, http_status);
+					//A20261019 : The error page always has its body, the close ends the response to HEAD
+					if((http_status == STATUS_NOT_FOUND) && (p_http_request->METHOD == METHOD_HEAD)) HTTPSock_Status[get_seqnum].keep_alive = 0;
+					if((http_status == STATUS_OK) && (HTTPSock_Status[get_seqnum].storage_type == ROMFS))
+						send_http_response_romfs_header(s, get_seqnum);
+					else
+						send_http_response_header(s, p_http_request->TYPE, file_len, http_status);
+				}
+
+				// Send HTTP body (content)
+				//M20261019 : No body for HEAD, the next response on the connection would be corrupted
+				//if(http_status == STATUS_OK)
+				if((http_status == STATUS_OK) && (p_http_request->METHOD != METHOD_HEAD))
+				{
+					//A20261019 : Streamed from the image in STATE_HTTP_RES_INPROC
+					if(HTTPSock_Status[get_seqnum].storage_type == ROMFS)
+					{
+						HTTPSock_Status[get_seqnum].file_len = file_len;
+						HTTPSock_Status[get_seqnum].file_offset = 0;
+					}
+					else
+#ifdef _USE_SDCARD_
+					//A20261019 : The file is sent in STATE_HTTP_RES_INPROC, once the header is out
+					if(HTTPSock_Status[get_seqnum].storage_type == SDCARD)
+					{
+						HTTPSock_Status[get_seqnum].file_len = file_len;
+						HTTPSock_Status[get_seqnum].file_offset = 0;
+					}
+					else
+#endif
+					send_http_response_body(s, uri_name, http_response, content_addr, file_len);
+				}
+			}
+			break;
+
+		case METHOD_POST :
+			//A20261019 : Route handler first, then the CGI processors
+			get_http_uri_name(p_http_request->URI, uri_buf);
+			route = find_http_route(uri_buf);
+			if(route && route->upload)
+			{
+				open_http_upload(s, route, p_http_request, uri_buf);
+				break;
+			}
+			if(body_left) HTTPSock_Status[get_seqnum].keep_alive = 0;
+			if(route && route->handler)
+			{
+				process_http_route(s, route, p_http_request, uri_buf);
+				break;
+			}
+
+			mid((char *)p_http_request->URI, "/", " HTTP", (char *)uri_buf);
+			uri_name = uri_buf;
+			find_http_uri_type(&p_http_request->TYPE, uri_name);	// Check file type (HTML, TEXT, GIF, JPEG are included)
+
+#ifdef _HTTPSERVER_DEBUG_
+			printf("\r\n> HTTPSocket[%d] : HTTP Method POST\r\n", s);
+			printf("> HTTPSocket[%d] : Request URI = %s ", s, uri_name);
+			printf("Type = %d\r\n", p_http_request->TYPE);
+#endif
+
+			if(p_http_request->TYPE == PTYPE_CGI)	// HTTP POST Method; CGI Process
+			{
+				content_found = http_post_cgi_handler(uri_name, p_http_request, http_response, &file_len);
+#ifdef _HTTPSERVER_DEBUG_
+				printf("> HTTPSocket[%d] : [CGI: %s] / Response len [ %ld ]byte\r\n", s, content_found?"Content found":"Content not found", file_len);
+#endif
+				if(content_found && (file_len <= (DATA_BUF_SIZE-(strlen(RES_CGIHEAD_OK)+strlen(RES_CONNECTION_KEEPALIVE)+8))))
+				{
+					send_http_response_cgi(s, pHTTP_TX, http_response, (uint16_t)file_len);
+
+					// Reset the H/W for apply to the change configuration information
+					if(content_found == HTTP_RESET) HTTPServer_ReStart();
+				}
+				else
+				{
+					send_http_response_header(s, PTYPE_CGI, 0, STATUS_NOT_FOUND);
+				}
+			}
+			else	// HTTP POST Method; Content not found
+			{
+				send_http_response_header(s, 0, 0, STATUS_NOT_FOUND);
+			}
+			break;
+
+		default :
+			http_status = STATUS_BAD_REQ;
+			send_http_response_header(s, 0, 0, http_status);
+			break;
+	}
+}
+
+void httpServer_time_handler(void)
+{
+	httpServer_tick_1s++;
+}
+
+uint32_t get_httpServer_timecount(void)
+{
+	return httpServer_tick_1s;
+}
+
+void reg_httpServer_webContent(uint8_t * content_name, uint8_t * content)
+{
+	if(content == NULL) return;
+
+	//M20261019 : Text content, no gzip variant and no ETag
+	reg_httpServer_webContent_ex(content_name, content, strlen((char *)content), NULL, 0, NULL);
+}
+
+//A20261019 : Binary content with gzip variant and ETag
+void reg_httpServer_webContent_ex(uint8_t * content_name, uint8_t * content, uint32_t content_len,
+								  uint8_t * gzip_content, uint32_t gzip_len, uint8_t * etag)
+{
+	uint16_t name_len;
+	httpServer_route * route;
+
+	if(content_name == NULL || content == NULL)
+	{
+		return;
+	}
+	else if(total_content_cnt >= MAX_CONTENT_CALLBACK)
+	{
+		return;
+	}
+
+	name_len = strlen((char *)content_name);
+
+	web_content[total_content_cnt].content_name = malloc(name_len+1);
+	strcpy((char *)web_content[total_content_cnt].content_name, (const char *)content_name);
+
+	//A20261019 : The name is found through the route table; the first content of a name is kept, as before
+	if((route = add_http_route(web_content[total_content_cnt].content_name)) == NULL)
+	{
+		free(web_content[total_content_cnt].content_name);
+		return;
+	}
+	route->handler = NULL;
+	route->websocket = NULL;
+	route->upload = NULL;
+	route->document = NULL;
+	route->content_num = total_content_cnt;
+	route->methods = HTTP_ROUTE_GET | HTTP_ROUTE_HEAD;
+	find_http_uri_type(&route->type, web_content[total_content_cnt].content_name);
+	web_content[total_content_cnt].content_len = content_len;
+	web_content[total_content_cnt].content = content;
+	web_content[total_content_cnt].gzip_len = gzip_content ? gzip_len : 0;
+	web_content[total_content_cnt].gzip_content = gzip_content;
+	web_content[total_content_cnt].etag = etag;
+
+	total_content_cnt++;
+}
+
+uint8_t display_reg_webContent_list(void)
+{
+	uint16_t i;
+	uint8_t ret;
 
 	if(total_content_cnt == 0)
 	{
@@ -718,36 +1830,194 @@ uint8_t display_reg_webContent_list(void)
 
 uint8_t find_userReg_webContent(uint8_t * content_name, uint16_t * content_num, uint32_t * file_len)
 {
-	uint16_t i;
+	//M20261019 : Hashed lookup instead of comparing with every registered name
+	httpServer_route * route;
 	uint8_t ret = 0; // '0' means 'File Not Found'
 
-	for(i = 0; i < total_content_cnt; i++)
+	route = find_http_route(content_name);
+	if(route && !route->handler && !route->websocket && !route->upload && !route->document)
 	{
-		if(!strcmp((char *)content_name, (char *)web_content[i].content_name))
-		{
-			*file_len = web_content[i].content_len;
-			*content_num = i;
-			ret = 1; // If the requested content found, ret set to '1' (Found)
-			break;
-		}
+		*file_len = web_content[route->content_num].content_len;
+		*content_num = route->content_num;
+		ret = 1; // If the requested content found, ret set to '1' (Found)
 	}
 	return ret;
 }
 
+//A20261019 : Route handler for a path
+uint8_t reg_httpServer_route(const char * path, uint8_t methods, uint8_t type, http_route_handler handler)
+{
+	httpServer_route * route;
+
+	if(path == NULL || handler == NULL) return 0;
+	if((route = add_http_route((const uint8_t *)path)) == NULL) return 0;
+
+	route->handler = handler;
+	route->websocket = NULL;
+	route->upload = NULL;
+	route->document = NULL;
+	route->content_num = 0;
+	route->methods = methods;
+	route->type = type;
+
+	return 1;
+}
+
+//A20261019 : Web content image
+uint8_t reg_httpServer_romfs(const uint8_t * image, http_romfs_read_cb read_cb)
+{
+	if(!http_romfs_mount(&http_romfs, image, read_cb))
+	{
+#ifdef _HTTPSERVER_DEBUG_
+		printf("> HTTPServer : No web content image\r\n");
+#endif
+		return 0;
+	}
+#ifdef _HTTPSERVER_DEBUG_
+	printf("> HTTPServer : Web content image, %d files / %ld byte\r\n", http_romfs.count, http_romfs.size);
+#endif
+	return 1;
+}
+
+//A20261019 : WebSocket endpoint for a path, only GET with the opening handshake headers is accepted
+uint8_t reg_httpServer_websocket(const char * path, const httpServer_websocket * websocket)
+{
+	httpServer_route * route;
+
+	if(path == NULL || websocket == NULL) return 0;
+	if((route = add_http_route((const uint8_t *)path)) == NULL) return 0;
+
+	route->handler = NULL;
+	route->websocket = websocket;
+	route->upload = NULL;
+	route->document = NULL;
+	route->content_num = 0;
+	route->methods = HTTP_ROUTE_GET;
+	route->type = 0;
+
+	return 1;
+}
+
+//A20261019 : Upload endpoint for a path, only POST is accepted
+uint8_t reg_httpServer_upload(const char * path, uint8_t type, const httpServer_upload * upload)
+{
+	httpServer_route * route;
+
+	if(path == NULL || upload == NULL) return 0;
+	if((route = add_http_route((const uint8_t *)path)) == NULL) return 0;
+
+	route->handler = NULL;
+	route->websocket = NULL;
+	route->upload = upload;
+	route->document = NULL;
+	route->content_num = 0;
+	route->methods = HTTP_ROUTE_POST;
+	route->type = type;
+
+	return 1;
+}
+
+//A20261019 : Document endpoint for a path, GET and HEAD
+uint8_t reg_httpServer_document(const char * path, uint8_t type, const httpServer_document * document)
+{
+	httpServer_route * route;
+
+	if(path == NULL || document == NULL || document->open == NULL) return 0;
+	if((route = add_http_route((const uint8_t *)path)) == NULL) return 0;
+
+	route->handler = NULL;
+	route->websocket = NULL;
+	route->upload = NULL;
+	route->document = document;
+	route->content_num = 0;
+	route->methods = HTTP_ROUTE_GET | HTTP_ROUTE_HEAD;
+	route->type = type;
+
+	return 1;
+}
+
+//A20261019 : FNV-1a hash of a path
+static uint32_t http_route_hash(const uint8_t * path)
+{
+	uint32_t hash = 2166136261u;
+
+	while(*path)
+	{
+		hash ^= *path++;
+		hash *= 16777619u;
+	}
+
+	return hash;
+}
+
+//A20261019 : New route for path (the leading '/' is dropped), NULL if the table is full or path is registered
+static httpServer_route * add_http_route(const uint8_t * path)
+{
+	httpServer_route * route;
+	uint32_t hash;
+	uint16_t slot;
+
+	if((path[0] == '/') && path[1]) path++;
+	if(total_route_cnt >= MAX_HTTP_ROUTE) return NULL;
+
+	// Linear probing; the index has twice the slots of routes, so an empty slot is always found
+	hash = http_route_hash(path);
+	for(slot = hash & (HTTP_ROUTE_HASH_SIZE - 1); http_route_index[slot]; slot = (slot + 1) & (HTTP_ROUTE_HASH_SIZE - 1))
+	{
+		route = &http_route[http_route_index[slot] - 1];
+		if((route->hash == hash) && !strcmp((const char *)route->path, (const char *)path)) return NULL;
+	}
+
+	route = &http_route[total_route_cnt++];
+	route->path = path;
+	route->hash = hash;
+	http_route_index[slot] = total_route_cnt;
+
+	return route;
+}
+
+//A20261019 : Route of path (without the leading '/', as get_http_uri_name() gives), NULL if none
+static httpServer_route * find_http_route(const uint8_t * path)
+{
+	httpServer_route * route;
+	uint32_t hash = http_route_hash(path);
+	uint16_t slot;
+
+	for(slot = hash & (HTTP_ROUTE_HASH_SIZE - 1); http_route_index[slot]; slot = (slot + 1) & (HTTP_ROUTE_HASH_SIZE - 1))
+	{
+		route = &http_route[http_route_index[slot] - 1];
+		if((route->hash == hash) && !strcmp((const char *)route->path, (const char *)path)) return route;
+	}
+
+	return NULL;
+}
+
 
-uint16_t read_userReg_webContent(uint16_t content_num, uint8_t * buf, uint32_t offset, uint16_t size)
+uint16_t read_userReg_webContent(uint16_t content_num, uint8_t * buf, uint32_t offset, uint16_t size, uint8_t gzip)
 {
 	uint16_t ret = 0;
 	uint8_t * ptr;
+	uint32_t len;
 
-	if(content_num > total_content_cnt) return 0;
+	//M20261019 : '>=', and memcpy() instead of strncpy(); gzip content has zero bytes
+	if(content_num >= total_content_cnt) return 0;
 
-	ptr = web_content[content_num].content;
-	if(offset) ptr += offset;
+	if(gzip && web_content[content_num].gzip_content)
+	{
+		ptr = web_content[content_num].gzip_content;
+		len = web_content[content_num].gzip_len;
+	}
+	else
+	{
+		ptr = web_content[content_num].content;
+		len = web_content[content_num].content_len;
+	}
+	if(offset >= len) return 0;
+	if(size > len - offset) size = len - offset;
 
-	strncpy((char *)buf, (char *)ptr, size);
+	memcpy(buf, ptr + offset, size);
 	*(buf+size) = 0; // Insert '/0' for indicates the 'End of String' (null terminated)
 
-	ret = strlen((void *)buf);
+	ret = size;
 	return ret;
 }
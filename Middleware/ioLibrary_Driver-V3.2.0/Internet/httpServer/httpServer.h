@@ -5,6 +5,10 @@
 
 #include <stdint.h>
 
+#include "httpWebSocket.h" //A20261019
+#include "httpRomfs.h" //A20261019
+#include "httpUpload.h" //A20261019
+
 #ifndef	__HTTPSERVER_H__
 #define	__HTTPSERVER_H__
 
@@ -20,11 +24,17 @@ extern "C" {
 #define MOBILE_INITIAL_WEBPAGE		"mobile/index.html"
 
 /* Web Server Content Storage Select */
-//#define _USE_SDCARD_
+//M20261019 : Serve the files on SD card (FatFs), content registered by reg_httpServer_webContent() is searched first
+#define _USE_SDCARD_
 #ifndef _USE_SDCARD_
 //#define _USE_FLASH_
 #endif
 
+#ifdef _USE_SDCARD_
+// Directory of the web content on SD card, "/index.html" is read from HTTP_SDCARD_ROOT"/index.html"
+#define HTTP_SDCARD_ROOT			"0:/www"
+#endif
+
 #if !defined(_USE_SDCARD_) && !defined(_USE_FLASH_)
 #define _NOTUSED_STORAGE_
 #endif
@@ -37,10 +47,12 @@ extern "C" {
 * HTTP Process states list
 *********************************************/
 #define STATE_HTTP_IDLE             0           /* IDLE, Waiting for data received (TCP established) */
-#define STATE_HTTP_REQ_INPROC  		1           /* Received HTTP request from HTTP client */
+//#define STATE_HTTP_REQ_INPROC  		1           /* Received HTTP request from HTTP client */
+#define STATE_HTTP_REQ_INPROC  		1           /* Receiving the body of a request for an upload route */ //M20261019
 #define STATE_HTTP_REQ_DONE    		2           /* The end of HTTP request parse */
 #define STATE_HTTP_RES_INPROC  		3           /* Sending the HTTP response to HTTP client (in progress) */
 #define STATE_HTTP_RES_DONE    		4           /* The end of HTTP response send (HTTP transaction ended) */
+#define STATE_HTTP_WEBSOCKET		5           /* Upgraded to WebSocket, frames are exchanged until the connection is closed */ //A20261019
 
 /*********************************************
 * HTTP Simple Return Value
@@ -53,20 +65,45 @@ extern "C" {
 * HTTP Content NAME length
 *********************************************/
 #define MAX_CONTENT_NAME_LEN		128
+//A20261019 : ETag with the quotes, also the longest 'If-None-Match' kept from a request
+#define MAX_CONTENT_ETAG_LEN		40
+//A20261019 : Put before the closing quote of the ETag of a gzip variant
+#define HTTP_GZIP_ETAG_SUFFIX		"-gz"
 
 /*********************************************
 * HTTP Timeout
 *********************************************/
 #define HTTP_MAX_TIMEOUT_SEC		3			// Sec.
+//A20261019 : A keep-alive connection is closed when no complete request arrives for HTTP_MAX_TIMEOUT_SEC
+//A20261019 : A WebSocket is pinged after HTTP_WEBSOCKET_PING_SEC without a frame from the client, closed after twice that
+#ifndef HTTP_WEBSOCKET_PING_SEC
+#define HTTP_WEBSOCKET_PING_SEC		10			// Sec.
+#endif
 
 typedef enum
 {
    NONE,		///< Web storage none
    CODEFLASH,	///< Code flash memory
    SDCARD,    	///< SD card
-   DATAFLASH	///< External data flash memory
+   DATAFLASH,	///< External data flash memory
+   ROMFS,		///< Web content image (httpRomfs.h), in code flash or data flash //A20261019
+   DOCUMENT		///< Body made by a document route, sent from its buffer //A20261019
 }StorageType;
 
+//A20261019 : 'Connection' header of the request
+#define HTTP_CONNECTION_NONE		0
+#define HTTP_CONNECTION_CLOSE		1
+#define HTTP_CONNECTION_KEEPALIVE	2
+
+//A20261019 : Headers of a WebSocket opening handshake found in the request, all of them are required
+#define HTTP_UPGRADE_CONNECTION		0x01		// 'Connection: Upgrade'
+#define HTTP_UPGRADE_WEBSOCKET		0x02		// 'Upgrade: websocket'
+#define HTTP_UPGRADE_VERSION		0x04		// 'Sec-WebSocket-Version: 13'
+#define HTTP_UPGRADE_KEY			0x08		// 'Sec-WebSocket-Key'
+#define HTTP_UPGRADE_ALL			0x0F
+
+struct _httpServer_websocket;
+
 typedef struct _st_http_socket
 {
 	uint8_t			sock_status;
@@ -75,27 +112,166 @@ typedef struct _st_http_socket
 	uint32_t 		file_len;
 	uint32_t 		file_offset; // (start addr + sent size...)
 	uint8_t			storage_type; // Storage type; Code flash, SDcard, Data flash ...
+	//A20261019 : HTTP/1.1 persistent connection
+	uint8_t			keep_alive;   // Keep the connection after the response
+	uint32_t		idle_time;    // httpServer tick of the last response (or the connection)
+	//A20261019 : Precompressed content and cache validation
+	uint8_t			accept_gzip;  // Request has 'Accept-Encoding: gzip'
+	uint8_t			content_gzip; // Response body is the gzip variant
+	uint8_t			if_none_match[MAX_CONTENT_ETAG_LEN]; // 'If-None-Match' of the request
+	uint8_t			etag[MAX_CONTENT_ETAG_LEN];          // ETag of the response, empty if none
+	//A20261019 : Header fields collected by the request parser
+	uint32_t		content_len;  // 'Content-Length' of the request
+	uint8_t			connection;   // 'Connection' of the request: HTTP_CONNECTION_NONE, _CLOSE or _KEEPALIVE
+	//A20261019 : WebSocket
+	uint8_t			upgrade;      // HTTP_UPGRADE_xxx headers of the request
+	uint8_t			ws_key[WEBSOCKET_KEY_LEN + 1]; // 'Sec-WebSocket-Key' of the request
+	const struct _httpServer_websocket * websocket; // Endpoint of the connection in STATE_HTTP_WEBSOCKET
+	uint32_t		ws_rx_time;   // httpServer tick of the last frame from the client
+	uint8_t			ws_ping;      // A ping is sent and not answered yet
+	//A20261019 : Request body streamed to an upload route
+	uint8_t			chunked;      // 'Transfer-Encoding: chunked' of the request
+	uint8_t			expect_continue; // 'Expect: 100-continue' of the request, no '100 Continue' sent yet
+	uint16_t		boundary;     // multipart/form-data boundary of the request, offset in the received request; 0 if none
+	uint8_t			boundary_len;
+	const struct _httpServer_route * upload; // Route of the connection in STATE_HTTP_REQ_INPROC
+	//A20261019 : Response body in the buffer of a document route
+	const struct _httpServer_route * document; // Route of the response, closed after it
+	const uint8_t *	document_body;
 }st_http_socket;
 
 // Web content structure for file in code flash memory
-#define MAX_CONTENT_CALLBACK		20
+//M20261019 : Content names are found through the hashed route table, the count is only limited by RAM
+//#define MAX_CONTENT_CALLBACK		20
+#ifndef MAX_CONTENT_CALLBACK
+#define MAX_CONTENT_CALLBACK		64
+#endif
 
 typedef struct _httpServer_webContent
 {
 	uint8_t	*	content_name;
 	uint32_t	content_len;
 	uint8_t * 	content;
+	//A20261019 : Precompressed variant and build-time ETag, NULL if none
+	uint32_t	gzip_len;
+	uint8_t *	gzip_content;
+	uint8_t *	etag;
 }httpServer_webContent;
 
+//A20261019 : Route table, paths of web content and of request handlers in one hashed index
+#ifndef MAX_HTTP_ROUTE
+#define MAX_HTTP_ROUTE				128			// Web content included
+#endif
+#define HTTP_ROUTE_HASH_SIZE		(2 * MAX_HTTP_ROUTE)	// Slots of the index, at most half used
+
+// Methods of a route
+#define HTTP_ROUTE_GET				(1 << METHOD_GET)
+#define HTTP_ROUTE_HEAD				(1 << METHOD_HEAD)
+#define HTTP_ROUTE_POST				(1 << METHOD_POST)
+
+/**
+ @brief 	Request passed to a route handler. query and body point into the received request and are not null
+ 			terminated; use get_http_query_value(), get_http_query_int() or get_http_query_bool() for the parameters.
+ */
+typedef struct _st_http_route_request
+{
+	uint8_t			method;			// METHOD_GET, METHOD_HEAD or METHOD_POST
+	const uint8_t *	path;			// Path without the leading '/'
+	const uint8_t *	query;			// Query string without '?'
+	uint16_t		query_len;
+	const uint8_t *	body;			// Body of a POST request (e.g. a form)
+	uint16_t		body_len;
+}st_http_route_request;
+
+/**
+ @brief 	Route handler, writes the response body to buf (at most *len bytes) and sets *len to its length.
+ @return	HTTP_OK, HTTP_RESET (the MCU is reset after the response) or HTTP_FAILED (400 Bad Request)
+ */
+typedef uint8_t (*http_route_handler)(const st_http_route_request * request, uint8_t * buf, uint16_t * len);
+
+/**
+ @brief 	WebSocket endpoint. seqnum is the HTTP socket of the connection; any callback can be NULL.
+ 			on_message gets each data frame (a fragment keeps its opcode WEBSOCKET_OP_CONTINUATION),
+ 			on_send is called whenever the socket can take a frame and writes a text message to buf (at most size
+ 			bytes), the return value is its length, 0 if there is nothing to send.
+ */
+typedef struct _httpServer_websocket
+{
+	void		(*on_open)(uint8_t seqnum);
+	void		(*on_message)(uint8_t seqnum, uint8_t opcode, uint8_t * data, uint16_t len);
+	uint16_t	(*on_send)(uint8_t seqnum, uint8_t * buf, uint16_t size);
+	void		(*on_close)(uint8_t seqnum);
+}httpServer_websocket;
+
+/**
+ @brief 	Upload endpoint; the body is given to it while it arrives, so it can be larger than the buffer. Any callback can
+ 			be NULL. on_begin gets the request without the body and returns HTTP_OK to accept it (otherwise 400).
+ 			on_part is called when a part of a multipart/form-data body starts (name and filename from its
+ 			Content-Disposition), or once with both NULL before a body of any other type; on_data gets the data of the
+ 			part, in place in the buffer. Both return 0 to stop the upload.
+ 			on_end tells whether the whole body was received and writes the response body like a route handler;
+ 			buf is NULL when the connection is closed and no response can be sent.
+ */
+typedef struct _httpServer_upload
+{
+	uint8_t		(*on_begin)(uint8_t seqnum, const st_http_route_request * request);
+	uint8_t		(*on_part)(uint8_t seqnum, const char * name, const char * filename);
+	uint8_t		(*on_data)(uint8_t seqnum, const uint8_t * data, uint16_t len);
+	uint8_t		(*on_end)(uint8_t seqnum, uint8_t complete, uint8_t * buf, uint16_t * len);
+}httpServer_upload;
+
+/**
+ @brief 	Document endpoint; the response body stays in a buffer of the route and is sent from there without a copy,
+ 			in as many parts as the socket takes, so it can be larger than the buffer of the server and be shared by
+ 			all the connections. open returns the body and its length (NULL for 400) and may set *etag to its
+ 			validator (e.g. "\"5\""), a request with the same If-None-Match gets 304. The body must not change until
+ 			close is called for the same seqnum, after the response or when the connection is closed.
+ */
+typedef struct _httpServer_document
+{
+	const uint8_t *	(*open)(uint8_t seqnum, const st_http_route_request * request, uint32_t * len, const char ** etag);
+	void			(*close)(uint8_t seqnum);
+}httpServer_document;
+
+typedef struct _httpServer_route
+{
+	const uint8_t *		path;		// Without the leading '/', must stay valid
+	uint32_t			hash;		// Hash of path
+	http_route_handler	handler;	// NULL for web content
+	const httpServer_websocket * websocket; // WebSocket endpoint, NULL if none //A20261019
+	const httpServer_upload * upload; // Upload endpoint, NULL if none //A20261019
+	const httpServer_document * document; // Document endpoint, NULL if none //A20261019
+	uint16_t			content_num;// Index of web_content[] if handler is NULL
+	uint8_t				methods;	// HTTP_ROUTE_GET | HTTP_ROUTE_HEAD | HTTP_ROUTE_POST
+	uint8_t				type;		// Content type of the response (PTYPE_JSON...)
+}httpServer_route;
+
 
 void httpServer_init(uint8_t * tx_buf, uint8_t * rx_buf, uint8_t cnt, uint8_t * socklist);
 void reg_httpServer_cbfunc(void(*mcu_reset)(void), void(*wdt_reset)(void));
 void httpServer_run(uint8_t seqnum);
 
 void reg_httpServer_webContent(uint8_t * content_name, uint8_t * content);
+//A20261019 : Binary content with an optional gzip variant (sent when the client accepts it) and ETag (e.g. "\"1f3a9c\""),
+//             the gzip variant is sent with HTTP_GZIP_ETAG_SUFFIX added to it
+void reg_httpServer_webContent_ex(uint8_t * content_name, uint8_t * content, uint32_t content_len,
+								  uint8_t * gzip_content, uint32_t gzip_len, uint8_t * etag);
 uint8_t find_userReg_webContent(uint8_t * content_name, uint16_t * content_num, uint32_t * file_len);
-uint16_t read_userReg_webContent(uint16_t content_num, uint8_t * buf, uint32_t offset, uint16_t size);
+//M20261019 : gzip selects the precompressed variant
+uint16_t read_userReg_webContent(uint16_t content_num, uint8_t * buf, uint32_t offset, uint16_t size, uint8_t gzip);
 uint8_t display_reg_webContent_list(void);
+//A20261019 : Bind path (e.g. "/api/led") to handler, the return value is 0 if the table is full or path is registered
+uint8_t reg_httpServer_route(const char * path, uint8_t methods, uint8_t type, http_route_handler handler);
+//A20261019 : Web content image made by Tools/web_assets/web_assets.py; image is its address if memory mapped,
+//            otherwise NULL and read_cb reads it. Searched after the registered content, before SD card.
+uint8_t reg_httpServer_romfs(const uint8_t * image, http_romfs_read_cb read_cb);
+//A20261019 : WebSocket endpoint at path (e.g. "/ws/telemetry"), the handlers must stay valid
+uint8_t reg_httpServer_websocket(const char * path, const httpServer_websocket * websocket);
+//A20261019 : Upload endpoint at path (e.g. "/api/upload") for POST, Content-Length or chunked, multipart/form-data or not;
+//            type is the content type of the response made by on_end
+uint8_t reg_httpServer_upload(const char * path, uint8_t type, const httpServer_upload * upload);
+//A20261019 : Document endpoint at path (e.g. "/api/status") for GET and HEAD; type is the content type of the body
+uint8_t reg_httpServer_document(const char * path, uint8_t type, const httpServer_document * document);
 
 /*
  * @brief HTTP Server 1sec Tick Timer handler
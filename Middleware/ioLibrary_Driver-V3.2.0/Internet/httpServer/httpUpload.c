@@ -0,0 +1,383 @@
+/**
+ * @file	httpUpload.c
+ * @brief	Streaming request body decoder: Content-Length or chunked transfer coding, multipart/form-data
+ * @version 1.0
+ * @date	2026/10/19
+ * @par Revision
+ *			2026/10/19 - 1.0 Release
+ * @author
+ */
+
+#include <string.h>
+#include <ctype.h>
+
+#include "httpUpload.h"
+
+/* Transfer coding */
+#define HTTP_UPLOAD_BODY			0		/* Content-Length body */
+#define HTTP_UPLOAD_CHUNK_SIZE		1		/* First digit of a chunk size */
+#define HTTP_UPLOAD_CHUNK_DIGITS	2		/* Rest of a chunk size */
+#define HTTP_UPLOAD_CHUNK_EXT		3		/* Chunk extension, up to the LF */
+#define HTTP_UPLOAD_CHUNK_DATA		4
+#define HTTP_UPLOAD_CHUNK_CR		5		/* CRLF after the chunk data */
+#define HTTP_UPLOAD_CHUNK_LF		6
+#define HTTP_UPLOAD_TRAILER			7		/* Start of a trailer line, an empty line ends the body */
+#define HTTP_UPLOAD_TRAILER_CR		8
+#define HTTP_UPLOAD_TRAILER_LINE	9
+#define HTTP_UPLOAD_FINISH			10
+#define HTTP_UPLOAD_FAIL			11
+
+/* multipart/form-data */
+#define HTTP_UPLOAD_PART_START		0		/* Body that is not multipart, on_part() not called yet */
+#define HTTP_UPLOAD_PART_RAW		1		/* Body that is not multipart */
+#define HTTP_UPLOAD_PART_PREAMBLE	2		/* Before the first delimiter */
+#define HTTP_UPLOAD_PART_DATA		3
+#define HTTP_UPLOAD_PART_DELIMITER	4		/* After a delimiter: "--" ends the body, CRLF starts a part */
+#define HTTP_UPLOAD_PART_CLOSE		5		/* Second '-' of the close delimiter */
+#define HTTP_UPLOAD_PART_LF			6
+#define HTTP_UPLOAD_PART_HEADER		7		/* Header lines of a part */
+#define HTTP_UPLOAD_PART_END		8		/* After the close delimiter, the epilogue is ignored */
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+static int8_t http_upload_body(st_http_upload * upload, const uint8_t * buf, uint16_t len);
+static int8_t http_upload_multipart(st_http_upload * upload, const uint8_t * buf, uint16_t len);
+static uint16_t http_upload_delimiter(st_http_upload * upload, const uint8_t * buf, uint16_t len, int8_t * ret);
+static void http_upload_header(st_http_upload * upload);
+static void http_upload_param(const char * params, const char * name, char * value, uint16_t size);
+static uint16_t match_http_upload_token(const char * str, const char * token);
+
+/**
+ @brief	initialize the decoder for the body of a request
+ */
+void http_upload_init(
+	st_http_upload * upload,		/**< decoder to be initialized */
+	uint8_t chunked,				/**< Transfer-Encoding: chunked */
+	uint32_t content_len,			/**< Content-Length, not used if chunked */
+	const uint8_t * boundary,		/**< boundary of a multipart/form-data body, NULL if the body is not multipart */
+	uint8_t boundary_len,			/**< length of boundary */
+	http_upload_part_cb on_part,	/**< called when a part starts */
+	http_upload_data_cb on_data,	/**< called for the data of the part */
+	void * arg						/**< first argument of the callbacks */
+	)
+{
+	memset(upload, 0, sizeof(st_http_upload));
+	upload->chunked = chunked;
+	upload->on_part = on_part;
+	upload->on_data = on_data;
+	upload->arg = arg;
+
+	if(chunked) upload->state = HTTP_UPLOAD_CHUNK_SIZE;
+	else if(content_len) upload->state = HTTP_UPLOAD_BODY;
+	else upload->state = HTTP_UPLOAD_FINISH;
+	upload->remaining = chunked ? 0 : content_len;
+
+	if(boundary && boundary_len && (boundary_len <= HTTP_UPLOAD_MAX_BOUNDARY))
+	{
+		upload->multipart = 1;
+		memcpy(upload->delimiter, "\r\n--", 4);
+		memcpy(upload->delimiter + 4, boundary, boundary_len);
+		upload->delimiter_len = boundary_len + 4;
+		// The first delimiter is at the start of the body, without the CRLF in front of it
+		upload->match = 2;
+		upload->part_state = HTTP_UPLOAD_PART_PREAMBLE;
+	}
+}
+
+/**
+ @brief	decode the next part of the body
+ @return	HTTP_UPLOAD_MORE until the body is completed, then HTTP_UPLOAD_DONE;
+ 			HTTP_UPLOAD_ERROR or HTTP_UPLOAD_ABORT, after which the decoder stays failed
+ */
+int8_t http_upload_execute(
+	st_http_upload * upload,	/**< decoder state */
+	const uint8_t * buf,		/**< next bytes of the body, as received */
+	uint16_t len,				/**< bytes in buf */
+	uint16_t * used				/**< bytes of buf that belong to the body; the rest is the next request */
+	)
+{
+	uint16_t i = 0;
+	uint32_t n;
+	int8_t ret = HTTP_UPLOAD_MORE;
+	uint8_t c;
+
+	*used = 0;
+	if(upload->state == HTTP_UPLOAD_FAIL) return HTTP_UPLOAD_ERROR;
+
+	if(upload->part_state == HTTP_UPLOAD_PART_START)
+	{
+		upload->part_state = HTTP_UPLOAD_PART_RAW;
+		if(upload->on_part && !upload->on_part(upload->arg, NULL, NULL)) ret = HTTP_UPLOAD_ABORT;
+	}
+
+	while((i < len) && (ret == HTTP_UPLOAD_MORE) && (upload->state != HTTP_UPLOAD_FINISH))
+	{
+		switch(upload->state)
+		{
+			case HTTP_UPLOAD_BODY :
+			case HTTP_UPLOAD_CHUNK_DATA :
+				n = len - i;
+				if(n > upload->remaining) n = upload->remaining;
+				ret = http_upload_body(upload, buf + i, (uint16_t)n);
+				i += n;
+				upload->remaining -= n;
+				if(upload->remaining == 0) upload->state = (upload->state == HTTP_UPLOAD_BODY) ? HTTP_UPLOAD_FINISH : HTTP_UPLOAD_CHUNK_CR;
+				break;
+
+			case HTTP_UPLOAD_CHUNK_SIZE :
+			case HTTP_UPLOAD_CHUNK_DIGITS :
+				c = buf[i++];
+				if(isxdigit(c))
+				{
+					if(upload->remaining > 0x0FFFFFFF) ret = HTTP_UPLOAD_ERROR;
+					upload->remaining = (upload->remaining << 4) | (isdigit(c) ? c - '0' : (toupper(c) - 'A' + 10));
+					upload->state = HTTP_UPLOAD_CHUNK_DIGITS;
+				}
+				else if(upload->state == HTTP_UPLOAD_CHUNK_SIZE) ret = HTTP_UPLOAD_ERROR;
+				else if(c == '\n') upload->state = upload->remaining ? HTTP_UPLOAD_CHUNK_DATA : HTTP_UPLOAD_TRAILER;
+				else upload->state = HTTP_UPLOAD_CHUNK_EXT; // ';' extension, white space or CR
+				break;
+
+			case HTTP_UPLOAD_CHUNK_EXT :
+				if(buf[i++] == '\n') upload->state = upload->remaining ? HTTP_UPLOAD_CHUNK_DATA : HTTP_UPLOAD_TRAILER;
+				break;
+
+			case HTTP_UPLOAD_CHUNK_CR :
+				c = buf[i++];
+				if(c == '\r') upload->state = HTTP_UPLOAD_CHUNK_LF;
+				else if(c == '\n') upload->state = HTTP_UPLOAD_CHUNK_SIZE;
+				else ret = HTTP_UPLOAD_ERROR;
+				break;
+
+			case HTTP_UPLOAD_CHUNK_LF :
+				if(buf[i++] == '\n') upload->state = HTTP_UPLOAD_CHUNK_SIZE;
+				else ret = HTTP_UPLOAD_ERROR;
+				break;
+
+			case HTTP_UPLOAD_TRAILER :
+				c = buf[i++];
+				if(c == '\n') upload->state = HTTP_UPLOAD_FINISH;
+				else if(c == '\r') upload->state = HTTP_UPLOAD_TRAILER_CR;
+				else upload->state = HTTP_UPLOAD_TRAILER_LINE;
+				break;
+
+			case HTTP_UPLOAD_TRAILER_CR :
+				if(buf[i++] == '\n') upload->state = HTTP_UPLOAD_FINISH;
+				else ret = HTTP_UPLOAD_ERROR;
+				break;
+
+			case HTTP_UPLOAD_TRAILER_LINE :
+				if(buf[i++] == '\n') upload->state = HTTP_UPLOAD_TRAILER;
+				break;
+
+			default :
+				ret = HTTP_UPLOAD_ERROR;
+				break;
+		}
+	}
+
+	*used = i;
+	if((ret == HTTP_UPLOAD_MORE) && (upload->state == HTTP_UPLOAD_FINISH))
+	{
+		// A multipart body that ends before its close delimiter is cut off
+		if(upload->multipart && (upload->part_state != HTTP_UPLOAD_PART_END)) ret = HTTP_UPLOAD_ERROR;
+		else ret = HTTP_UPLOAD_DONE;
+	}
+	if(ret < 0) upload->state = HTTP_UPLOAD_FAIL;
+
+	return ret;
+}
+
+/* Decoded bytes of the body */
+static int8_t http_upload_body(st_http_upload * upload, const uint8_t * buf, uint16_t len)
+{
+	upload->received += len;
+
+	if(upload->multipart) return http_upload_multipart(upload, buf, len);
+	if(len && upload->on_data && !upload->on_data(upload->arg, buf, len)) return HTTP_UPLOAD_ABORT;
+
+	return HTTP_UPLOAD_MORE;
+}
+
+/* Split the body into parts at the delimiters; the data of a part is given to on_data() in place */
+static int8_t http_upload_multipart(st_http_upload * upload, const uint8_t * buf, uint16_t len)
+{
+	uint16_t i = 0;
+	int8_t ret = HTTP_UPLOAD_MORE;
+	uint8_t c;
+
+	while((i < len) && (ret == HTTP_UPLOAD_MORE))
+	{
+		switch(upload->part_state)
+		{
+			case HTTP_UPLOAD_PART_PREAMBLE :
+			case HTTP_UPLOAD_PART_DATA :
+				i += http_upload_delimiter(upload, buf + i, len - i, &ret);
+				break;
+
+			case HTTP_UPLOAD_PART_DELIMITER :
+				c = buf[i++];
+				if(c == '-') upload->part_state = HTTP_UPLOAD_PART_CLOSE;
+				else if(c == '\r') upload->part_state = HTTP_UPLOAD_PART_LF;
+				else if(c == '\n') upload->part_state = HTTP_UPLOAD_PART_HEADER;
+				else if((c != ' ') && (c != '\t')) ret = HTTP_UPLOAD_ERROR; // Only padding may follow the boundary
+				break;
+
+			case HTTP_UPLOAD_PART_CLOSE :
+				if(buf[i++] == '-') upload->part_state = HTTP_UPLOAD_PART_END;
+				else ret = HTTP_UPLOAD_ERROR;
+				break;
+
+			case HTTP_UPLOAD_PART_LF :
+				if(buf[i++] == '\n') upload->part_state = HTTP_UPLOAD_PART_HEADER;
+				else ret = HTTP_UPLOAD_ERROR;
+				break;
+
+			case HTTP_UPLOAD_PART_HEADER :
+				c = buf[i++];
+				if(c != '\n')
+				{
+					if(upload->line_len < HTTP_UPLOAD_MAX_LINE - 1) upload->line[upload->line_len++] = c;
+					break;
+				}
+				if(upload->line_len && (upload->line[upload->line_len - 1] == '\r')) upload->line_len--;
+				if(upload->line_len)
+				{
+					upload->line[upload->line_len] = '\0';
+					http_upload_header(upload);
+					upload->line_len = 0;
+					break;
+				}
+				// Empty line, the data of the part follows
+				upload->part_state = HTTP_UPLOAD_PART_DATA;
+				if(upload->on_part && !upload->on_part(upload->arg, upload->name, upload->filename)) ret = HTTP_UPLOAD_ABORT;
+				break;
+
+			case HTTP_UPLOAD_PART_END :
+				i = len;
+				break;
+
+			default :
+				ret = HTTP_UPLOAD_ERROR;
+				break;
+		}
+	}
+
+	return ret;
+}
+
+/**
+ * Look for the delimiter, the bytes before it are data (dropped in the preamble). Bytes that may be the start of
+ * the delimiter are held back at the end of buf; they are the first 'match' bytes of the delimiter, so they are
+ * given from there if the match fails in the next call. The delimiter has a CR only as its first byte, so after a
+ * failed match the search goes on from the byte that failed.
+ */
+static uint16_t http_upload_delimiter(st_http_upload * upload, const uint8_t * buf, uint16_t len, int8_t * ret)
+{
+	const uint8_t * cr;
+	uint8_t data = (upload->part_state == HTTP_UPLOAD_PART_DATA);
+	uint8_t held = upload->match;		// Matched bytes from the last call, not in buf
+	uint16_t candidate = 0;				// Start of the match in buf, the data before it is not given yet
+	uint16_t i = 0;
+
+	while(i < len)
+	{
+		if(upload->match == 0)
+		{
+			if((cr = memchr(buf + i, '\r', len - i)) == NULL)
+			{
+				i = len;
+				break;
+			}
+			i = cr - buf;
+			candidate = i++;
+			upload->match = 1;
+			continue;
+		}
+
+		if(buf[i] == upload->delimiter[upload->match])
+		{
+			i++;
+			if(++upload->match < upload->delimiter_len) continue;
+
+			// Delimiter found; the data ends where it starts
+			if(data && candidate && upload->on_data && !upload->on_data(upload->arg, buf, candidate)) *ret = HTTP_UPLOAD_ABORT;
+			upload->match = 0;
+			upload->part_state = HTTP_UPLOAD_PART_DELIMITER;
+			upload->line_len = 0;
+			upload->name[0] = '\0';
+			upload->filename[0] = '\0';
+			return i;
+		}
+
+		// Not the delimiter; the held bytes were data
+		if(held)
+		{
+			if(data && upload->on_data && !upload->on_data(upload->arg, upload->delimiter, held))
+			{
+				*ret = HTTP_UPLOAD_ABORT;
+				return len;
+			}
+			held = 0;
+		}
+		upload->match = 0;
+	}
+
+	// The match (if any) at the end is held back until the next call decides it
+	if(upload->match) i = held ? 0 : candidate;
+	if(data && i && upload->on_data && !upload->on_data(upload->arg, buf, i)) *ret = HTTP_UPLOAD_ABORT;
+
+	return len;
+}
+
+/* A header line of a part; only Content-Disposition is used */
+static void http_upload_header(st_http_upload * upload)
+{
+	const char * params;
+
+	if(!match_http_upload_token((const char *)upload->line, "Content-Disposition:")) return;
+	if((params = strchr((const char *)upload->line, ';')) == NULL) return;
+
+	http_upload_param(params, "name", upload->name, sizeof(upload->name));
+	http_upload_param(params, "filename", upload->filename, sizeof(upload->filename));
+}
+
+/* Value of a parameter in '; name="value"; ...', quoted or not; "" if not found */
+static void http_upload_param(const char * params, const char * name, char * value, uint16_t size)
+{
+	const char * p = params;
+	uint16_t name_len;
+	uint16_t i = 0;
+	char end;
+
+	value[0] = '\0';
+	while((p = strchr(p, ';')) != NULL)
+	{
+		p++;
+		while((*p == ' ') || (*p == '\t')) p++;
+		if(!(name_len = match_http_upload_token(p, name)) || (p[name_len] != '=')) continue;
+
+		p += name_len + 1;
+		end = (*p == '"') ? '"' : ';';
+		if(*p == '"') p++;
+		while(*p && (*p != end) && (i < size - 1)) value[i++] = *p++;
+		// A token value has no trailing white space
+		while((end == ';') && i && (value[i - 1] == ' ')) i--;
+		value[i] = '\0';
+		return;
+	}
+}
+
+/* Length of token if str starts with it (case insensitive), 0 if not */
+static uint16_t match_http_upload_token(const char * str, const char * token)
+{
+	uint16_t i;
+
+	for(i = 0; token[i]; i++)
+	{
+		if(toupper((uint8_t)str[i]) != toupper((uint8_t)token[i])) return 0;
+	}
+
+	return i;
+}
\ No newline at end of file
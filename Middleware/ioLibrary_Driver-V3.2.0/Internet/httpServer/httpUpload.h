@@ -0,0 +1,80 @@
+/**
+ * @file	httpUpload.h
+ * @brief	Header File for the streaming request body decoder of the HTTP Server (upload)
+ * @version 1.0
+ * @date	2026/10/19
+ * @par Revision
+ *			2026/10/19 - 1.0 Release
+ * @author
+ */
+
+#ifndef	__HTTPUPLOAD_H__
+#define	__HTTPUPLOAD_H__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************************************
+* http_upload_execute() return value
+*********************************************/
+#define HTTP_UPLOAD_ERROR			-1			/* Malformed chunk or multipart body, or it ends too early */
+#define HTTP_UPLOAD_ABORT			-2			/* A callback refused the data (e.g. the SD card is full) */
+#define HTTP_UPLOAD_MORE			0			/* Call again with the next part of the body */
+#define HTTP_UPLOAD_DONE			1			/* The body is completed */
+
+#define HTTP_UPLOAD_MAX_BOUNDARY	70			/* RFC 2046 */
+#define HTTP_UPLOAD_MAX_LINE		128			/* Header line of a part, longer lines are cut */
+#define HTTP_UPLOAD_MAX_NAME		32			/* 'name' of a part, with the null */
+#define HTTP_UPLOAD_MAX_FILENAME	64			/* 'filename' of a part, with the null */
+
+/**
+ @brief 	A part starts. name and filename are from its Content-Disposition ("" if none), both are NULL for a body
+ 			that is not multipart/form-data. The return value is 0 to abort the upload.
+ */
+typedef uint8_t (*http_upload_part_cb)(void * arg, const char * name, const char * filename);
+
+/**
+ @brief 	Data of the current part, pointing into the buffer given to http_upload_execute().
+ 			The return value is 0 to abort the upload.
+ */
+typedef uint8_t (*http_upload_data_cb)(void * arg, const uint8_t * data, uint16_t len);
+
+/**
+ @brief 	State of the body decoder.
+ @details	Transfer coding (Content-Length or chunked) and multipart/form-data are decoded in one pass without
+ 			copying; a delimiter that is split between two calls is kept as the number of its bytes matched so far,
+ 			which are given back from 'delimiter' when the match fails. Memory is this structure, whatever the size
+ 			of the body.
+ */
+typedef struct _st_http_upload
+{
+	uint8_t				state;			/**< Internal state of the transfer coding */
+	uint8_t				part_state;		/**< Internal state of the multipart body */
+	uint8_t				chunked;		/**< Transfer-Encoding: chunked */
+	uint8_t				multipart;		/**< multipart/form-data */
+	uint32_t			remaining;		/**< Bytes left of the body (Content-Length) or of the chunk */
+	uint32_t			received;		/**< Bytes of the body decoded so far */
+	uint8_t				delimiter[HTTP_UPLOAD_MAX_BOUNDARY + 4];	/**< CRLF "--" boundary */
+	uint8_t				delimiter_len;
+	uint8_t				match;			/**< Bytes of the delimiter matched */
+	uint8_t				line[HTTP_UPLOAD_MAX_LINE];	/**< Header line of a part */
+	uint8_t				line_len;
+	char				name[HTTP_UPLOAD_MAX_NAME];
+	char				filename[HTTP_UPLOAD_MAX_FILENAME];
+	http_upload_part_cb	on_part;
+	http_upload_data_cb	on_data;
+	void *				arg;			/**< First argument of the callbacks */
+}st_http_upload;
+
+void http_upload_init(st_http_upload * upload, uint8_t chunked, uint32_t content_len, const uint8_t * boundary,
+					  uint8_t boundary_len, http_upload_part_cb on_part, http_upload_data_cb on_data, void * arg);
+int8_t http_upload_execute(st_http_upload * upload, const uint8_t * buf, uint16_t len, uint16_t * used);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
\ No newline at end of file
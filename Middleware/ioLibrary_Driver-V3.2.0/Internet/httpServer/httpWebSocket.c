@@ -0,0 +1,259 @@
+/**
+ * @file	httpWebSocket.c
+ * @brief	WebSocket (RFC 6455) on the HTTP Server: opening handshake key, frame receive and send
+ * @version 1.0
+ * @date	2026/10/19
+ * @par Revision
+ *			2026/10/19 - 1.0 Release
+ * @author
+ */
+
+#include <string.h>
+
+#include "socket.h"
+#include "httpWebSocket.h"
+
+#define WEBSOCKET_GUID	"258EAFA5-E914-47DA-95CA-C5AB0DC85B11"
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+static void sha1_block(uint32_t * state, const uint8_t * block);
+static void sha1(const uint8_t * data, uint16_t len, uint8_t * digest);
+static void base64_encode(const uint8_t * data, uint16_t len, char * out);
+
+/**
+ @brief	make Sec-WebSocket-Accept of the opening handshake: base64(SHA-1(key + GUID))
+ */
+void websocket_make_accept(
+	const char * key,	/**< Sec-WebSocket-Key of the request */
+	char * accept		/**< WEBSOCKET_ACCEPT_LEN + 1 bytes, null terminated */
+	)
+{
+	uint8_t buf[WEBSOCKET_KEY_LEN + sizeof(WEBSOCKET_GUID)];
+	uint8_t digest[20];
+	uint16_t len = strlen(key);
+
+	if(len > WEBSOCKET_KEY_LEN) len = WEBSOCKET_KEY_LEN;
+	memcpy(buf, key, len);
+	memcpy(buf + len, WEBSOCKET_GUID, sizeof(WEBSOCKET_GUID) - 1);
+
+	sha1(buf, len + sizeof(WEBSOCKET_GUID) - 1, digest);
+	base64_encode(digest, sizeof(digest), accept);
+}
+
+/**
+ @brief	receive one frame from a client when all of it is in the socket RX buffer
+ @return	bytes consumed from the RX buffer, 0 if the frame is not completed yet,
+ 			WEBSOCKET_ERR_PROTOCOL or WEBSOCKET_ERR_TOO_BIG (the connection should be closed)
+ */
+int32_t websocket_recv_frame(
+	uint8_t sn,						/**< socket number */
+	uint8_t * buf,					/**< payload, unmasked */
+	uint16_t size,					/**< size of buf */
+	st_websocket_frame * frame		/**< header of the frame */
+	)
+{
+	uint8_t head[14];
+	uint8_t * mask;
+	uint16_t rsr, head_len, i;
+	uint32_t len;
+
+	rsr = getSn_RX_RSR(sn);
+	if(rsr < 2) return 0;
+
+	// Peek the header, the RX read pointer is moved when the whole frame is there
+	wiz_recv_peek(sn, 0, head, 2);
+
+	// A client frame is always masked; no extension is negotiated, so RSV1..3 must be 0
+	if(!(head[1] & 0x80) || (head[0] & 0x70)) return WEBSOCKET_ERR_PROTOCOL;
+
+	len = head[1] & 0x7F;
+	head_len = (len == 126) ? 8 : ((len == 127) ? 14 : 6);
+	if(rsr < head_len) return 0;
+	wiz_recv_peek(sn, 0, head, head_len);
+
+	frame->fin = head[0] >> 7;
+	frame->opcode = head[0] & 0x0F;
+	if(frame->opcode & 0x08)
+	{
+		if(!frame->fin || (len > WEBSOCKET_MAX_CONTROL_LEN)) return WEBSOCKET_ERR_PROTOCOL;
+	}
+
+	if(len == 126) len = ((uint16_t)head[2] << 8) | head[3];
+	else if(len == 127)
+	{
+		if(head[2] | head[3] | head[4] | head[5] | head[6] | head[7]) return WEBSOCKET_ERR_TOO_BIG;
+		len = ((uint16_t)head[8] << 8) | head[9];
+	}
+	if(len > size) return WEBSOCKET_ERR_TOO_BIG;
+	if(len + head_len > getSn_RxMAX(sn)) return WEBSOCKET_ERR_TOO_BIG; // Never fits in the RX buffer
+	if(rsr < head_len + len) return 0;
+
+	wiz_recv_peek(sn, head_len, buf, len);
+	wiz_recv_ignore(sn, head_len + len);
+	setSn_CR(sn, Sn_CR_RECV);
+	while(getSn_CR(sn));
+
+	// Unmask, the mask is repeated every 4 bytes
+	mask = head + head_len - 4;
+	for(i = 0; i < len; i++) buf[i] ^= mask[i & 3];
+
+	frame->len = len;
+	return head_len + len;
+}
+
+/**
+ @brief	send one unmasked frame, the whole frame or nothing
+ @return	bytes of the frame, SOCK_BUSY if the last send is not completed or the TX buffer is full, or a socket error
+ */
+int32_t websocket_send_frame(
+	uint8_t sn,				/**< socket number */
+	uint8_t opcode,			/**< WEBSOCKET_OP_xxx, sent as a single fragment */
+	const uint8_t * data,	/**< payload */
+	uint16_t len			/**< payload length */
+	)
+{
+	uint8_t head[WEBSOCKET_MAX_HEAD_LEN];
+	uint16_t head_len = 2;
+	int32_t ret;
+
+	if((ret = send_buffered(sn, 0)) != SOCK_OK) return ret;
+
+	head[0] = 0x80 | opcode;
+	if(len < 126)
+	{
+		head[1] = len;
+	}
+	else
+	{
+		head[1] = 126;
+		head[2] = len >> 8;
+		head[3] = len & 0xFF;
+		head_len = 4;
+	}
+	if(getSn_TX_FSR(sn) < head_len + len) return SOCK_BUSY;
+
+	wiz_send_data(sn, head, head_len);
+	if(len) wiz_send_data(sn, (uint8_t *)data, len);
+
+	return send_buffered(sn, head_len + len);
+}
+
+////////////////////////////////////////////////////////////////////
+// Static functions
+////////////////////////////////////////////////////////////////////
+
+#define SHA1_ROL(x, n)	(((x) << (n)) | ((x) >> (32 - (n))))
+
+/**
+@brief	SHA-1 compression of one 64-byte block
+*/
+static void sha1_block(
+		uint32_t * state,		/**< hash state, 5 words */
+		const uint8_t * block	/**< 64 bytes */
+	)
+{
+	uint32_t w[16];
+	uint32_t a = state[0], b = state[1], c = state[2], d = state[3], e = state[4];
+	uint32_t f, k, tmp;
+	uint8_t i;
+
+	for(i = 0; i < 16; i++)
+		w[i] = ((uint32_t)block[i * 4] << 24) | ((uint32_t)block[i * 4 + 1] << 16) | ((uint32_t)block[i * 4 + 2] << 8) | block[i * 4 + 3];
+
+	for(i = 0; i < 80; i++)
+	{
+		// The message schedule is kept in a 16-word ring
+		if(i >= 16)
+		{
+			tmp = w[(i + 13) & 15] ^ w[(i + 8) & 15] ^ w[(i + 2) & 15] ^ w[i & 15];
+			w[i & 15] = SHA1_ROL(tmp, 1);
+		}
+
+		if(i < 20)		{ f = (b & c) | (~b & d);			k = 0x5A827999; }
+		else if(i < 40)	{ f = b ^ c ^ d;					k = 0x6ED9EBA1; }
+		else if(i < 60)	{ f = (b & c) | (b & d) | (c & d);	k = 0x8F1BBCDC; }
+		else			{ f = b ^ c ^ d;					k = 0xCA62C1D6; }
+
+		tmp = SHA1_ROL(a, 5) + f + e + k + w[i & 15];
+		e = d;
+		d = c;
+		c = SHA1_ROL(b, 30);
+		b = a;
+		a = tmp;
+	}
+
+	state[0] += a;
+	state[1] += b;
+	state[2] += c;
+	state[3] += d;
+	state[4] += e;
+}
+
+/**
+@brief	SHA-1 of a short message
+*/
+static void sha1(
+		const uint8_t * data,	/**< message */
+		uint16_t len,			/**< message length */
+		uint8_t * digest		/**< 20 bytes */
+	)
+{
+	uint32_t state[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+	uint8_t block[64];
+	uint32_t bits = (uint32_t)len * 8;
+	uint16_t i;
+
+	for(; len >= 64; data += 64, len -= 64) sha1_block(state, data);
+
+	// Padding: 0x80, zeros, then the message length in bits (big endian) in the last 8 bytes
+	memset(block, 0, sizeof(block));
+	memcpy(block, data, len);
+	block[len] = 0x80;
+	if(len >= 56)
+	{
+		sha1_block(state, block);
+		memset(block, 0, sizeof(block));
+	}
+	block[60] = bits >> 24;
+	block[61] = bits >> 16;
+	block[62] = bits >> 8;
+	block[63] = bits;
+	sha1_block(state, block);
+
+	for(i = 0; i < 20; i++) digest[i] = state[i / 4] >> (24 - (i % 4) * 8);
+}
+
+/**
+@brief	base64 of data, null terminated
+*/
+static void base64_encode(
+		const uint8_t * data,	/**< data */
+		uint16_t len,			/**< data length */
+		char * out				/**< (len + 2) / 3 * 4 + 1 bytes */
+	)
+{
+	static const char table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+	uint32_t v;
+	uint16_t i;
+
+	for(i = 0; i + 2 < len; i += 3)
+	{
+		v = ((uint32_t)data[i] << 16) | ((uint32_t)data[i + 1] << 8) | data[i + 2];
+		*out++ = table[v >> 18];
+		*out++ = table[(v >> 12) & 0x3F];
+		*out++ = table[(v >> 6) & 0x3F];
+		*out++ = table[v & 0x3F];
+	}
+	if(i < len)
+	{
+		v = (uint32_t)data[i] << 16;
+		if(i + 1 < len) v |= (uint32_t)data[i + 1] << 8;
+		*out++ = table[v >> 18];
+		*out++ = table[(v >> 12) & 0x3F];
+		*out++ = (i + 1 < len) ? table[(v >> 6) & 0x3F] : '=';
+		*out++ = '=';
+	}
+	*out = '\0';
+}
\ No newline at end of file
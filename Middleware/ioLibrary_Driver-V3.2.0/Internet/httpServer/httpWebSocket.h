@@ -0,0 +1,66 @@
+/**
+ * @file	httpWebSocket.h
+ * @brief	Header File for WebSocket (RFC 6455) on the HTTP Server
+ * @version 1.0
+ * @date	2026/10/19
+ * @par Revision
+ *			2026/10/19 - 1.0 Release
+ * @author
+ */
+
+#ifndef	__HTTPWEBSOCKET_H__
+#define	__HTTPWEBSOCKET_H__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************************************
+* WebSocket opcodes
+*********************************************/
+#define WEBSOCKET_OP_CONTINUATION	0x0
+#define WEBSOCKET_OP_TEXT			0x1
+#define WEBSOCKET_OP_BINARY			0x2
+#define WEBSOCKET_OP_CLOSE			0x8
+#define WEBSOCKET_OP_PING			0x9
+#define WEBSOCKET_OP_PONG			0xA
+
+/*********************************************
+* WebSocket close status codes
+*********************************************/
+#define WEBSOCKET_CLOSE_NORMAL		1000
+#define WEBSOCKET_CLOSE_PROTOCOL	1002
+#define WEBSOCKET_CLOSE_TOO_BIG		1009
+
+/*********************************************
+* websocket_recv_frame() errors
+*********************************************/
+#define WEBSOCKET_ERR_PROTOCOL		-1			/* Unmasked frame, reserved bits or a bad control frame */
+#define WEBSOCKET_ERR_TOO_BIG		-2			/* Payload longer than the buffer */
+
+#define WEBSOCKET_KEY_LEN			24			/* Sec-WebSocket-Key: base64 of 16 bytes */
+#define WEBSOCKET_ACCEPT_LEN		28			/* Sec-WebSocket-Accept: base64 of the SHA-1 */
+#define WEBSOCKET_MAX_HEAD_LEN		4			/* Header of a server frame, payload up to 65535 bytes */
+#define WEBSOCKET_MAX_CONTROL_LEN	125			/* Payload of a control frame */
+
+/**
+ @brief 	A received frame, the payload is unmasked in the buffer given to websocket_recv_frame()
+ */
+typedef struct _st_websocket_frame
+{
+	uint8_t		fin;		/**< Last fragment of a message */
+	uint8_t		opcode;		/**< WEBSOCKET_OP_xxx */
+	uint16_t	len;		/**< Payload length */
+}st_websocket_frame;
+
+void websocket_make_accept(const char * key, char * accept);
+int32_t websocket_recv_frame(uint8_t sn, uint8_t * buf, uint16_t size, st_websocket_frame * frame);
+int32_t websocket_send_frame(uint8_t sn, uint8_t opcode, const uint8_t * data, uint16_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
\ No newline at end of file
@@ -0,0 +1,121 @@
+#include "binlog.h"
+
+#include "stm32f4xx_hal.h"
+#include "bsp_systick.h"
+
+BinLog_t g_binlog;
+
+static const Metrics_Entry_t g_binlog_metrics[] =
+{
+    {
+        .name = "binlog_records_total",
+        .help = "Binary log records written",
+        .type = METRICS_TYPE_COUNTER,
+        .value = &g_binlog.records
+    },
+    {
+        .name = "binlog_dropped_records_total",
+        .help = "Binary log records dropped because the buffer was full",
+        .type = METRICS_TYPE_COUNTER,
+        .value = &g_binlog.dropped
+    }
+};
+
+/**
+ * @brief 二进制日志初始化函数
+ * 
+ * @param output 发送一条完整记录的函数，放不下时返回false，记录留在缓冲区里下次再发
+ */
+void BinLog_Init(bool (*output)(const uint8_t *data, uint16_t length))
+{
+    g_binlog.head = 0;
+    g_binlog.tail = 0;
+    g_binlog.output = output;
+
+    for (uint8_t i = 0; i < sizeof(g_binlog_metrics) / sizeof(g_binlog_metrics[0]); i++)
+    {
+        Metrics_Register(&g_binlog_metrics[i]);
+    }
+}
+
+/**
+ * @brief 写入一条日志记录，由BINLOG()调用
+ * 
+ * @param id 格式ID，即格式化字符串在.binlog段内的偏移
+ * @param args 32位的参数
+ * @param count 参数个数，不大于BINLOG_MAX_ARGS
+ * 
+ * @note 可以在中断里调用，只在拷贝记录的几十个周期里关中断；缓冲区满时丢弃整条记录，线上的记录不会被截断
+ */
+void BinLog_Write(uint16_t id, const uint32_t *args, uint8_t count)
+{
+    uint32_t mask = BINLOG_BUFFER_SIZE - 1;
+    uint32_t timestamp = 0;
+    uint32_t length = BINLOG_HEADER_SIZE + count * 4;
+    uint32_t primask = __get_PRIMASK();
+    uint32_t head = 0;
+
+    __disable_irq();
+
+    // 在临界区里取时间戳，缓冲区里记录的时间戳才是递增的，解码工具据此判断回绕
+    timestamp = SysTick_GetMicros();
+    head = g_binlog.head;
+    if (BINLOG_BUFFER_SIZE - (head - g_binlog.tail) < length)
+    {
+        g_binlog.dropped++;
+        __set_PRIMASK(primask);
+        return;
+    }
+
+    g_binlog.buffer[head++ & mask] = count;
+    g_binlog.buffer[head++ & mask] = id;
+    g_binlog.buffer[head++ & mask] = id >> 8;
+    for (uint8_t i = 0; i < 4; i++)
+    {
+        g_binlog.buffer[head++ & mask] = timestamp >> (i * 8);
+    }
+    for (uint8_t i = 0; i < count; i++)
+    {
+        for (uint8_t j = 0; j < 4; j++)
+        {
+            g_binlog.buffer[head++ & mask] = args[i] >> (j * 8);
+        }
+    }
+
+    g_binlog.head = head;
+    g_binlog.records++;
+
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief 把缓冲区里的记录加上帧头和校验和发送出去，在主循环中调用
+ * 
+ */
+void BinLog_Process(void)
+{
+    uint32_t mask = BINLOG_BUFFER_SIZE - 1;
+    uint8_t record[BINLOG_RECORD_MAX + 2];
+    uint16_t length = 0;
+    uint8_t sum = 0;
+
+    while ((g_binlog.output != NULL) && (g_binlog.tail != g_binlog.head))
+    {
+        length = BINLOG_HEADER_SIZE + g_binlog.buffer[g_binlog.tail & mask] * 4;
+
+        record[0] = BINLOG_MAGIC;
+        sum = BINLOG_MAGIC;
+        for (uint16_t i = 0; i < length; i++)
+        {
+            record[i + 1] = g_binlog.buffer[(g_binlog.tail + i) & mask];
+            sum += record[i + 1];
+        }
+        record[length + 1] = -sum;                                              // 所有字节的和为0
+
+        if (!g_binlog.output(record, length + 2))
+        {
+            break;                                                              // 串口发送队列放不下，下次再发
+        }
+        g_binlog.tail += length;
+    }
+}
\ No newline at end of file
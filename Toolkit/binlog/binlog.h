@@ -0,0 +1,110 @@
+#ifndef __BINLOG_H__
+#define __BINLOG_H__
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "metrics/metrics.h"
+
+#ifndef BINLOG_ENABLE
+#define BINLOG_ENABLE                       1                                   // 0: BINLOG()退回printf()，不需要解码工具也能看日志
+#endif
+#define BINLOG_BUFFER_SIZE                  1024                                // 记录缓冲区大小，必须是2的幂
+#define BINLOG_MAX_ARGS                     8                                   // 一条记录最多的参数个数
+
+#define BINLOG_MAGIC                        0xA5                                // 线上每条记录的第一个字节
+#define BINLOG_HEADER_SIZE                  7                                   // 参数个数(1) + 格式ID(2) + 时间戳(4)
+#define BINLOG_RECORD_MAX                   (BINLOG_HEADER_SIZE + BINLOG_MAX_ARGS * 4)
+
+/**
+ * 延迟格式化的二进制日志。格式化字符串放在不占FLASH的.binlog段里，只留在ELF文件中，
+ * 它在段内的偏移就是格式ID。调用处只记录格式ID、时间戳和原始的32位参数，
+ * 主循环里再按记录发给串口，由Tools/binlog/binlog_decode.py对照ELF还原成文本。
+ *
+ * 线上的记录格式（小端）：
+ * | 0xA5 | 参数个数(1) | 格式ID(2) | 时间戳us(4) | 参数(4 * n) | 校验和(1) |
+ * 校验和使前面所有字节的和为0，printf()输出的文本可以和记录混在同一个串口上。
+ *
+ * 参数一律按32位记录：整数和指针原样保存，float和double转成float保存；
+ * 不支持64位整数（nano.specs的printf本来也不支持），%s只能还原FLASH里的常量字符串
+ */
+typedef struct BinLog_t
+{
+    uint8_t buffer[BINLOG_BUFFER_SIZE];
+    volatile uint32_t head;                                                     // 写入的总字节数
+    uint32_t tail;                                                              // 发送出去的总字节数，只在主循环里修改
+    bool (*output)(const uint8_t *data, uint16_t length);                       // 发送一条完整的记录，放不下时返回false，下次再发
+    volatile uint32_t records;                                                  // 写入的记录数
+    volatile uint32_t dropped;                                                  // 缓冲区满丢弃的记录数
+} BinLog_t;
+
+extern BinLog_t g_binlog;
+
+void BinLog_Init(bool (*output)(const uint8_t *data, uint16_t length));
+void BinLog_Write(uint16_t id, const uint32_t *args, uint8_t count);
+void BinLog_Process(void);
+
+// 参数转成32位：float和double按float的位模式保存，其它类型直接转换
+#define BINLOG_WORD(x)                      _Generic((x), float: BinLog_Float, double: BinLog_Float, default: BinLog_Word) \
+                                                (_Generic((x), float: (x), double: (x), default: (uintptr_t)(x)))
+
+#define BINLOG_NARGS(...)                   BINLOG_NARGS_(0, ##__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define BINLOG_NARGS_(_0, _1, _2, _3, _4, _5, _6, _7, _8, n, ...) n
+
+#define BINLOG_CONCAT(a, b)                 BINLOG_CONCAT_(a, b)
+#define BINLOG_CONCAT_(a, b)                a##b
+
+#define BINLOG_ARGS_0()                     NULL
+#define BINLOG_ARGS_1(a)                    (const uint32_t[]){BINLOG_WORD(a)}
+#define BINLOG_ARGS_2(a, b)                 (const uint32_t[]){BINLOG_WORD(a), BINLOG_WORD(b)}
+#define BINLOG_ARGS_3(a, b, c)              (const uint32_t[]){BINLOG_WORD(a), BINLOG_WORD(b), BINLOG_WORD(c)}
+#define BINLOG_ARGS_4(a, b, c, d)           (const uint32_t[]){BINLOG_WORD(a), BINLOG_WORD(b), BINLOG_WORD(c), BINLOG_WORD(d)}
+#define BINLOG_ARGS_5(a, b, c, d, e)        (const uint32_t[]){BINLOG_WORD(a), BINLOG_WORD(b), BINLOG_WORD(c), BINLOG_WORD(d), \
+                                                               BINLOG_WORD(e)}
+#define BINLOG_ARGS_6(a, b, c, d, e, f)     (const uint32_t[]){BINLOG_WORD(a), BINLOG_WORD(b), BINLOG_WORD(c), BINLOG_WORD(d), \
+                                                               BINLOG_WORD(e), BINLOG_WORD(f)}
+#define BINLOG_ARGS_7(a, b, c, d, e, f, g)  (const uint32_t[]){BINLOG_WORD(a), BINLOG_WORD(b), BINLOG_WORD(c), BINLOG_WORD(d), \
+                                                               BINLOG_WORD(e), BINLOG_WORD(f), BINLOG_WORD(g)}
+#define BINLOG_ARGS_8(a, b, c, d, e, f, g, h) \
+                                            (const uint32_t[]){BINLOG_WORD(a), BINLOG_WORD(b), BINLOG_WORD(c), BINLOG_WORD(d), \
+                                                               BINLOG_WORD(e), BINLOG_WORD(f), BINLOG_WORD(g), BINLOG_WORD(h)}
+
+#if BINLOG_ENABLE
+#define BINLOG(format, ...)                 do { \
+                                                static const char binlog_format[] __attribute__((section(".binlog"), used)) = format; \
+                                                BinLog_Write((uint16_t)(uintptr_t)binlog_format, \
+                                                             BINLOG_CONCAT(BINLOG_ARGS_, BINLOG_NARGS(__VA_ARGS__))(__VA_ARGS__), \
+                                                             BINLOG_NARGS(__VA_ARGS__)); \
+                                            } while (0)
+#else
+#define BINLOG(format, ...)                 printf(format, ##__VA_ARGS__)
+#endif
+
+/**
+ * @brief 整数和指针参数转成32位
+ * 
+ * @param value 参数
+ * @return uint32_t 32位的参数
+ */
+static inline uint32_t BinLog_Word(uint32_t value)
+{
+    return value;
+}
+
+/**
+ * @brief 浮点参数按float的位模式转成32位
+ * 
+ * @param value 参数
+ * @return uint32_t float的位模式
+ */
+static inline uint32_t BinLog_Float(float value)
+{
+    uint32_t word;
+
+    memcpy(&word, &value, sizeof(word));
+    return word;
+}
+
+#endif // !__BINLOG_H__
\ No newline at end of file
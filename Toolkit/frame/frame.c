@@ -0,0 +1,330 @@
+#include "frame.h"
+
+// CRC-16/CCITT-FALSE的查找表，多项式0x1021
+static const uint16_t g_frame_crc_table[256] =
+{
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+    0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+    0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+    0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+    0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+    0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+    0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+    0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+    0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+    0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+    0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+    0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+    0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+    0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+    0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+    0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+    0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+    0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+    0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+    0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+    0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+    0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+    0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+    0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+    0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+    0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+    0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+    0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+    0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+    0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+    0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0
+};
+
+/**
+ * @brief 计算CRC-16/CCITT-FALSE
+ * 
+ * @param crc 初始值，第一段数据传0xFFFF，分段计算时传上一段的结果
+ * @param data 数据
+ * @param length 数据长度
+ * @return uint16_t CRC
+ * 
+ * @note 数据后面按高字节在前接上自己的CRC，再算一遍结果为0
+ */
+uint16_t Frame_Crc16(uint16_t crc, const uint8_t *data, uint32_t length)
+{
+    while (length--)
+    {
+        crc = (crc << 8) ^ g_frame_crc_table[(crc >> 8) ^ *data++];
+    }
+    return crc;
+}
+
+// COBS编码的状态，code_index是当前块开销字节的位置
+typedef struct Frame_Encoder_t
+{
+    uint8_t *out;
+    uint16_t index;
+    uint16_t code_index;
+    uint8_t code;
+} Frame_Encoder_t;
+
+/**
+ * @brief COBS编码一个字节
+ * 
+ * @param encoder 编码状态
+ * @param byte 要编码的字节
+ */
+static void Frame_EncodeByte(Frame_Encoder_t *encoder, uint8_t byte)
+{
+    if (byte != 0)
+    {
+        encoder->out[encoder->index++] = byte;
+        encoder->code++;
+    }
+
+    if ((byte == 0) || (encoder->code == 0xFF))                                 // 遇到0或者块满254个字节，结束当前块
+    {
+        encoder->out[encoder->code_index] = encoder->code;
+        encoder->code_index = encoder->index++;
+        encoder->code = 1;
+    }
+}
+
+/**
+ * @brief 把数据编码成一帧
+ * 
+ * @param payload 数据
+ * @param length 数据长度
+ * @param out 保存编码结果的缓冲区
+ * @param size 缓冲区大小，不小于FRAME_ENCODED_SIZE(length)
+ * @return uint16_t 编码后的长度，包括结尾的分隔符，缓冲区不够时返回0
+ */
+uint16_t Frame_Encode(const uint8_t *payload, uint16_t length, uint8_t *out, uint16_t size)
+{
+    Frame_Encoder_t encoder = {out, 1, 0, 1};
+    uint16_t crc = Frame_Crc16(0xFFFF, payload, length);
+
+    if (size < FRAME_ENCODED_SIZE(length))
+    {
+        return 0;
+    }
+
+    for (uint16_t i = 0; i < length; i++)
+    {
+        Frame_EncodeByte(&encoder, payload[i]);
+    }
+    Frame_EncodeByte(&encoder, crc >> 8);
+    Frame_EncodeByte(&encoder, crc & 0xFF);
+
+    out[encoder.code_index] = encoder.code;
+    out[encoder.index++] = 0;                                                   // 帧分隔符
+
+    return encoder.index;
+}
+
+/**
+ * @brief 原地解码一帧并校验CRC
+ * 
+ * @param data 编码后的帧，不包括结尾的分隔符，解码后的数据从data开始存放
+ * @param length 编码后的长度
+ * @return int32_t 数据长度，FRAME_ERROR_COBS: 编码错误; FRAME_ERROR_CRC: CRC校验失败;
+ * 
+ * @note 解码后的位置总是在读取位置之前，可以原地解码
+ */
+int32_t Frame_Decode(uint8_t *data, uint16_t length)
+{
+    uint16_t in = 0;
+    uint16_t out = 0;
+    uint8_t code = 0;
+
+    while (in < length)
+    {
+        code = data[in++];
+        if ((code == 0) || (code - 1 > length - in))
+        {
+            return FRAME_ERROR_COBS;
+        }
+
+        for (uint8_t i = 1; i < code; i++)
+        {
+            data[out++] = data[in++];
+        }
+
+        if ((code != 0xFF) && (in < length))                                    // 块后面隐含一个0，最后一块除外
+        {
+            data[out++] = 0;
+        }
+    }
+
+    if (out < FRAME_CRC_SIZE)
+    {
+        return FRAME_ERROR_COBS;
+    }
+
+    if (Frame_Crc16(0xFFFF, data, out) != 0)
+    {
+        return FRAME_ERROR_CRC;
+    }
+
+    return out - FRAME_CRC_SIZE;
+}
+
+/**
+ * @brief 帧解析器初始化函数
+ * 
+ * @param parser 解析器
+ * @param buffer 跨回绕的帧用的缓冲区
+ * @param size 缓冲区大小，也是编码后帧的最大长度
+ * @param handler 收到有效帧的处理函数
+ * @param context 传给处理函数的参数
+ */
+void Frame_Parser_Init(Frame_Parser_t *parser, uint8_t *buffer, uint16_t size,
+                       void (*handler)(void *context, const uint8_t *payload, uint16_t length), void *context)
+{
+    memset(parser, 0, sizeof(Frame_Parser_t));
+    parser->buffer = buffer;
+    parser->size = size;
+    parser->handler = handler;
+    parser->context = context;
+}
+
+/**
+ * @brief 在两段的视图中查找分隔符
+ * 
+ * @param data 两段数据
+ * @param length 两段的长度
+ * @param position 开始查找的位置
+ * @return uint32_t 分隔符的位置，没有找到时返回总长度
+ */
+static uint32_t Frame_FindDelimiter(uint8_t *const data[2], const uint16_t length[2], uint32_t position)
+{
+    uint8_t *found = NULL;
+
+    if (position < length[0])
+    {
+        found = memchr(data[0] + position, 0, length[0] - position);
+        if (found != NULL)
+        {
+            return found - data[0];
+        }
+        position = length[0];
+    }
+
+    found = memchr(data[1] + position - length[0], 0, length[0] + length[1] - position);
+    return (found != NULL) ? length[0] + (found - data[1]) : length[0] + length[1];
+}
+
+/**
+ * @brief 解码一帧并交给处理函数
+ * 
+ * @param parser 解析器
+ * @param data 两段数据
+ * @param length 两段的长度
+ * @param start 帧在视图中的起点
+ * @param count 编码后的长度，不包括分隔符
+ */
+static void Frame_Deliver(Frame_Parser_t *parser, uint8_t *const data[2], const uint16_t length[2], uint32_t start, uint32_t count)
+{
+    uint8_t *frame = NULL;
+    int32_t result = 0;
+
+    if (parser->discarding)
+    {
+        parser->discarding = false;
+        return;
+    }
+
+    if (count == 0)                                                             // 连续的分隔符，用来冲掉线路上的杂波
+    {
+        return;
+    }
+
+    if (count > parser->size)
+    {
+        parser->oversize++;
+        return;
+    }
+
+    if (start + count <= length[0])
+    {
+        frame = data[0] + start;
+    }
+    else if (start >= length[0])
+    {
+        frame = data[1] + start - length[0];
+    }
+    else                                                                        // 跨回绕的帧拷贝成连续的再解码
+    {
+        memcpy(parser->buffer, data[0] + start, length[0] - start);
+        memcpy(parser->buffer + length[0] - start, data[1], count - (length[0] - start));
+        frame = parser->buffer;
+    }
+
+    result = Frame_Decode(frame, count);
+    if (result == FRAME_ERROR_CRC)
+    {
+        parser->crc_errors++;
+    }
+    else if (result < 0)
+    {
+        parser->cobs_errors++;
+    }
+    else
+    {
+        parser->frames++;
+        parser->handler(parser->context, frame, result);
+    }
+}
+
+/**
+ * @brief 从接收缓冲区的视图中解析出完整的帧
+ * 
+ * @param parser 解析器
+ * @param data 两段数据，环形缓冲区回绕时分成两段
+ * @param length 两段的长度
+ * @return uint32_t 处理完的字节数，调用者从接收缓冲区中消费这么多字节，不完整的帧留到下次
+ * 
+ * @note 帧在视图里原地解码，会修改视图中的数据
+ */
+uint32_t Frame_Parse(Frame_Parser_t *parser, uint8_t *const data[2], const uint16_t length[2])
+{
+    uint32_t total = length[0] + length[1];
+    uint32_t start = 0;
+    uint32_t end = 0;
+
+    while (1)
+    {
+        end = Frame_FindDelimiter(data, length, start + parser->scanned);
+        if (end == total)
+        {
+            break;
+        }
+
+        Frame_Deliver(parser, data, length, start, end - start);
+        start = end + 1;
+        parser->scanned = 0;
+    }
+
+    parser->scanned = total - start;
+    if (parser->scanned > parser->size)                                         // 帧太长，已经收到的部分不要了，丢弃到下一个分隔符
+    {
+        if (!parser->discarding)
+        {
+            parser->oversize++;
+            parser->discarding = true;
+        }
+        parser->scanned = 0;
+        return total;
+    }
+
+    return start;
+}
+
+/**
+ * @brief 底层丢了数据后重新同步，丢弃到下一个分隔符
+ * 
+ * @param parser 解析器
+ */
+void Frame_Resync(Frame_Parser_t *parser)
+{
+    parser->scanned = 0;
+    parser->discarding = true;
+    parser->resyncs++;
+}
\ No newline at end of file
@@ -0,0 +1,48 @@
+#ifndef __FRAME_H__
+#define __FRAME_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#define FRAME_MAX_PAYLOAD                   256                                 // 发送时一帧最多的数据字节数
+#define FRAME_CRC_SIZE                      2
+
+// 编码后的最大长度：数据 + CRC + COBS每254字节一个的开销字节 + 1个起始开销字节 + 分隔符
+#define FRAME_ENCODED_SIZE(length)          ((length) + FRAME_CRC_SIZE + ((length) + FRAME_CRC_SIZE) / 254 + 2)
+
+#define FRAME_ERROR_COBS                    -1                                  // COBS编码错误或者帧太短
+#define FRAME_ERROR_CRC                     -2                                  // CRC校验失败
+
+/**
+ * 二进制帧：数据后面加上CRC-16/CCITT-FALSE（高字节在前），整体做COBS编码，再以0x00结尾。
+ * 编码后的帧里不会出现0x00，接收端丢了字节或者从中间开始接收，到下一个0x00就能重新同步。
+ *
+ * 解析器直接在接收环形缓冲区上查找分隔符并原地解码，只有跨回绕的帧才拷贝到自己的缓冲区，
+ * 交给处理函数的数据在处理函数返回后就会被覆盖。固件和Tools/frame_codec共用这份代码
+ */
+typedef struct Frame_Parser_t
+{
+    uint8_t *buffer;                                                            // 跨回绕的帧拷贝到这里解码
+    uint16_t size;                                                              // 缓冲区大小，也是编码后帧的最大长度
+    void (*handler)(void *context, const uint8_t *payload, uint16_t length);    // 收到有效帧的处理函数
+    void *context;                                                              // 传给处理函数的参数
+    uint32_t scanned;                                                           // 当前帧已经找过分隔符的字节数，下次接着找
+    bool discarding;                                                            // 丢弃数据直到下一个分隔符
+    uint32_t frames;                                                            // 收到的有效帧数
+    uint32_t crc_errors;                                                        // CRC校验失败的帧数
+    uint32_t cobs_errors;                                                       // COBS编码错误或者太短的帧数
+    uint32_t oversize;                                                          // 超过最大长度被丢弃的帧数
+    uint32_t resyncs;                                                           // 底层丢了数据后重新同步的次数
+} Frame_Parser_t;
+
+uint16_t Frame_Crc16(uint16_t crc, const uint8_t *data, uint32_t length);
+uint16_t Frame_Encode(const uint8_t *payload, uint16_t length, uint8_t *out, uint16_t size);
+int32_t Frame_Decode(uint8_t *data, uint16_t length);
+
+void Frame_Parser_Init(Frame_Parser_t *parser, uint8_t *buffer, uint16_t size,
+                       void (*handler)(void *context, const uint8_t *payload, uint16_t length), void *context);
+uint32_t Frame_Parse(Frame_Parser_t *parser, uint8_t *const data[2], const uint16_t length[2]);
+void Frame_Resync(Frame_Parser_t *parser);
+
+#endif // !__FRAME_H__
\ No newline at end of file
@@ -0,0 +1,252 @@
+#include "metrics.h"
+
+#include <stdarg.h>
+
+Metrics_Registry_t g_metrics_registry;
+
+/**
+ * @brief 追加格式化的文本
+ * 
+ * @param buffer 缓冲区
+ * @param size 缓冲区大小
+ * @param length 已经写入的长度，放不下时设为size
+ * @param format 格式化字符串
+ * @param ... 格式化参数
+ */
+static void Metrics_Printf(char *buffer, uint32_t size, uint32_t *length, const char *format, ...)
+{
+    va_list args;
+    int n;
+
+    if (*length >= size)
+    {
+        return;
+    }
+
+    va_start(args, format);
+    n = vsnprintf(&buffer[*length], size - *length, format, args);
+    va_end(args);
+
+    *length = (n < 0 || (uint32_t)n >= size - *length) ? size : *length + n;
+}
+
+/**
+ * @brief 64位无符号数转换成十进制字符串，nano.specs的printf不支持%llu
+ * 
+ * @param value 数值
+ * @param text 至少21个字节
+ * @return char* text
+ */
+static char *Metrics_FormatU64(uint64_t value, char *text)
+{
+    char digits[20];
+    uint8_t n = 0;
+
+    do
+    {
+        digits[n++] = '0' + value % 10;
+        value /= 10;
+    } while (value);
+
+    for (uint8_t i = 0; i < n; i++)
+    {
+        text[i] = digits[n - 1 - i];
+    }
+    text[n] = '\0';
+
+    return text;
+}
+
+/**
+ * @brief 输出一个序列：名字、标签和值
+ * 
+ * @param buffer 缓冲区
+ * @param size 缓冲区大小
+ * @param length 已经写入的长度
+ * @param name 指标名
+ * @param suffix 名字的后缀，例如"_bucket"
+ * @param labels 固定的标签，NULL: 没有
+ * @param extra 另外的一个标签，例如"le=\"100\""，NULL: 没有
+ * @param value 值
+ */
+static void Metrics_RenderSample(char *buffer, uint32_t size, uint32_t *length, const char *name, const char *suffix,
+                                 const char *labels, const char *extra, const char *value)
+{
+    if (labels != NULL && extra != NULL)
+    {
+        Metrics_Printf(buffer, size, length, "%s%s{%s,%s} %s\n", name, suffix, labels, extra, value);
+    }
+    else if (labels != NULL || extra != NULL)
+    {
+        Metrics_Printf(buffer, size, length, "%s%s{%s} %s\n", name, suffix, labels != NULL ? labels : extra, value);
+    }
+    else
+    {
+        Metrics_Printf(buffer, size, length, "%s%s %s\n", name, suffix, value);
+    }
+}
+
+/**
+ * @brief 输出一个描述的所有序列
+ * 
+ * @param buffer 缓冲区
+ * @param size 缓冲区大小
+ * @param length 已经写入的长度
+ * @param entry 指标的描述
+ */
+static void Metrics_RenderEntry(char *buffer, uint32_t size, uint32_t *length, const Metrics_Entry_t *entry)
+{
+    Metrics_Histogram_t *histogram = entry->histogram;
+    char extra[32];
+    char value[21];
+    uint32_t cumulative = 0;
+
+    if (entry->type == METRICS_TYPE_HISTOGRAM)
+    {
+        // 桶的计数在输出时累加，和观测同时进行时各个数之间可能差一次观测
+        for (uint8_t i = 0; i < histogram->bound_count; i++)
+        {
+            cumulative += histogram->bucket[i];
+            snprintf(extra, sizeof(extra), "le=\"%lu\"", (unsigned long)histogram->bounds[i]);
+            Metrics_RenderSample(buffer, size, length, entry->name, "_bucket", entry->labels, extra,
+                                 Metrics_FormatU64(cumulative, value));
+        }
+        Metrics_RenderSample(buffer, size, length, entry->name, "_bucket", entry->labels, "le=\"+Inf\"",
+                             Metrics_FormatU64(histogram->count, value));
+        Metrics_RenderSample(buffer, size, length, entry->name, "_sum", entry->labels, NULL,
+                             Metrics_FormatU64(histogram->sum, value));
+        Metrics_RenderSample(buffer, size, length, entry->name, "_count", entry->labels, NULL,
+                             Metrics_FormatU64(histogram->count, value));
+    }
+    else if (entry->count > 0 && entry->value != NULL)
+    {
+        for (uint8_t i = 0; i < entry->count; i++)
+        {
+            snprintf(extra, sizeof(extra), "%s=\"%u\"", entry->index_label, i);
+            Metrics_RenderSample(buffer, size, length, entry->name, "", entry->labels, extra,
+                                 Metrics_FormatU64(entry->value[i], value));
+        }
+    }
+    else
+    {
+        Metrics_RenderSample(buffer, size, length, entry->name, "", entry->labels, NULL,
+                             Metrics_FormatU64(entry->value != NULL ? *entry->value : entry->read(), value));
+    }
+}
+
+/**
+ * @brief 注册一个指标
+ * 
+ * @param entry 指标的描述，必须一直有效
+ * @return int8_t 0: 成功或者已经注册过; -1: 注册表满了; -2: 描述不完整
+ */
+int8_t Metrics_Register(const Metrics_Entry_t *entry)
+{
+    Metrics_Registry_t *registry = &g_metrics_registry;
+
+    if (entry == NULL || entry->name == NULL || entry->help == NULL)
+    {
+        return -2;
+    }
+    if ((entry->type == METRICS_TYPE_HISTOGRAM && (entry->histogram == NULL || entry->histogram->bound_count > METRICS_HISTOGRAM_MAX_BOUNDS)) ||
+        (entry->type != METRICS_TYPE_HISTOGRAM && entry->value == NULL && entry->read == NULL) ||
+        (entry->count > 0 && (entry->value == NULL || entry->index_label == NULL)))
+    {
+        return -2;
+    }
+
+    // 驱动重新初始化时可能再次注册
+    for (uint8_t i = 0; i < registry->count; i++)
+    {
+        if (registry->entries[i] == entry)
+        {
+            return 0;
+        }
+    }
+
+    if (registry->count >= METRICS_MAX_COUNT)
+    {
+        return -1;
+    }
+    registry->entries[registry->count++] = entry;
+
+    return 0;
+}
+
+/**
+ * @brief 记录直方图的一次观测
+ * 
+ * @param histogram 直方图
+ * @param value 观测值，例如耗时的微秒数
+ * 
+ * @note 同一个直方图只能在一个上下文中观测
+ */
+void Metrics_Observe(Metrics_Histogram_t *histogram, uint32_t value)
+{
+    uint8_t i = 0;
+
+    while (i < histogram->bound_count && value > histogram->bounds[i])
+    {
+        i++;
+    }
+
+    histogram->bucket[i]++;
+    histogram->count++;
+    histogram->sum += value;
+}
+
+/**
+ * @brief 按Prometheus的文本格式输出所有指标
+ * 
+ * @param buffer 缓冲区
+ * @param size 缓冲区大小
+ * @return uint32_t 输出的长度，放不下时只输出完整的指标
+ */
+uint32_t Metrics_Render(char *buffer, uint32_t size)
+{
+    Metrics_Registry_t *registry = &g_metrics_registry;
+    const Metrics_Entry_t *entry;
+    const char *types[] = {"counter", "gauge", "histogram"};
+    uint32_t length = 0;
+    uint32_t complete = 0;
+    uint8_t rendered;
+
+    for (uint8_t i = 0; i < registry->count; i++)
+    {
+        entry = registry->entries[i];
+
+        // 同名的描述在第一个出现的地方一起输出，一个指标的序列必须连在一起
+        rendered = 0;
+        for (uint8_t j = 0; j < i && !rendered; j++)
+        {
+            rendered = strcmp(registry->entries[j]->name, entry->name) == 0;
+        }
+        if (rendered)
+        {
+            continue;
+        }
+
+        Metrics_Printf(buffer, size, &length, "# HELP %s %s\n# TYPE %s %s\n", entry->name, entry->help, entry->name,
+                       types[entry->type]);
+        for (uint8_t j = i; j < registry->count; j++)
+        {
+            if (strcmp(registry->entries[j]->name, entry->name) == 0)
+            {
+                Metrics_RenderEntry(buffer, size, &length, registry->entries[j]);
+            }
+        }
+
+        if (length >= size)
+        {
+            break;
+        }
+        complete = length;
+    }
+
+    if (size > 0)
+    {
+        buffer[complete] = '\0';
+    }
+
+    return complete;
+}
\ No newline at end of file
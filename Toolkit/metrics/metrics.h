@@ -0,0 +1,57 @@
+#ifndef __METRICS_H__
+#define __METRICS_H__
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+
+#define METRICS_MAX_COUNT                   32                                  // 注册表容量
+#define METRICS_HISTOGRAM_MAX_BOUNDS        12                                  // 直方图最多的桶数，不包括+Inf
+
+#define METRICS_TYPE_COUNTER                0                                   // 只增不减的计数
+#define METRICS_TYPE_GAUGE                  1                                   // 可增可减的当前值
+#define METRICS_TYPE_HISTOGRAM              2                                   // 按固定的桶统计的分布
+
+/**
+ * 直方图，桶的上界在注册前定好，观测时只是找到桶并加一，没有除法和浮点运算。
+ * 每个桶单独计数（不累计），输出时才累加成Prometheus的le桶
+ */
+typedef struct Metrics_Histogram_t
+{
+    const uint32_t *bounds;                                                     // 桶的上界，升序
+    uint8_t bound_count;                                                        // 桶数，不大于METRICS_HISTOGRAM_MAX_BOUNDS
+    uint32_t bucket[METRICS_HISTOGRAM_MAX_BOUNDS + 1];                          // 每个桶的观测次数，最后一个是+Inf
+    uint32_t count;                                                             // 观测次数
+    uint64_t sum;                                                               // 观测值的和
+} Metrics_Histogram_t;
+
+/**
+ * 一个指标的描述，由驱动定义成常量。值留在驱动自己的变量里，热路径上只是对变量加一，
+ * 注册表只在输出时读取。名字相同、标签不同的描述输出为同一个指标的多个序列
+ */
+typedef struct Metrics_Entry_t
+{
+    const char *name;                                                           // 指标名，计数以_total结尾
+    const char *help;                                                           // 说明
+    uint8_t type;                                                               // METRICS_TYPE_COUNTER、METRICS_TYPE_GAUGE或METRICS_TYPE_HISTOGRAM
+    const char *labels;                                                         // 固定的标签，例如"uart=\"1\""，NULL: 没有
+    const char *index_label;                                                    // 数组的下标的标签名，例如"socket"
+    uint8_t count;                                                              // 数组的元素个数，0: 单个值
+    const volatile uint32_t *value;                                             // 计数或者当前值
+    uint32_t (*read)(void);                                                     // value为NULL时，输出时调用它得到当前值
+    Metrics_Histogram_t *histogram;                                             // 直方图
+} Metrics_Entry_t;
+
+typedef struct Metrics_Registry_t
+{
+    const Metrics_Entry_t *entries[METRICS_MAX_COUNT];                          // 已注册的指标
+    uint8_t count;                                                              // 已注册的指标个数
+} Metrics_Registry_t;
+
+extern Metrics_Registry_t g_metrics_registry;
+
+int8_t Metrics_Register(const Metrics_Entry_t *entry);
+void Metrics_Observe(Metrics_Histogram_t *histogram, uint32_t value);
+uint32_t Metrics_Render(char *buffer, uint32_t size);
+
+#endif // !__METRICS_H__
\ No newline at end of file
@@ -1,5 +1,13 @@
 #include "mqtt.h"
 
+MQTT_TopicRegistry_t g_mqtt_topic_registry = {.version = MQTT_PROTOCOL_VERSION_3_1_1};
+
+static uint16_t g_mqtt_packet_id = 0;
+
+static uint16_t MQTT_EncodeRemainLength(uint8_t *buffer, uint32_t remain_length);
+static uint16_t MQTT_DecodeVariableInteger(uint8_t *buffer, uint16_t length, uint32_t *value);
+static uint16_t MQTT_NextPacketId(void);
+
 /**
  * @brief 构建MQTT连接包
  * 
@@ -128,14 +136,13 @@ uint16_t MQTT_ConnectMessage(uint8_t*mqtt_message,char *client_id,char *username
  */
 uint16_t MQTT_PublishMessage(uint8_t * mqtt_message, char * topic, char * message, uint8_t udp, uint8_t QoS, uint8_t retain)
 {
-    static uint16_t id = 0;
     uint16_t topic_length = strlen(topic);
     uint16_t message_length = strlen(message);
     uint16_t index = 0;
     uint16_t remain_length = 0;
 
     // MQTT发布报文类型
-    mqtt_message[index++] = 0x30 | (udp << 3) | (QoS << 2) | (retain);          // MQTT Message Type PUBLISH
+    mqtt_message[index++] = 0x30 | (udp << 3) | (QoS << 1) | (retain);          // MQTT Message Type PUBLISH
 
     // 剩余长度=可变报头长度（主题名长度（2） + 主题长度（topic_length） + 报文标识符长度（0或2））+ 有效载荷长度（消息长度）
     remain_length = 2 + topic_length + (QoS ? 2 : 0) + message_length;
@@ -162,9 +169,9 @@ uint16_t MQTT_PublishMessage(uint8_t * mqtt_message, char * topic, char * messag
     // 报文标识符，等级0没有
     if(QoS)
     {
+        uint16_t id = MQTT_NextPacketId();
         mqtt_message[index++] = (0xff00 & id) >> 8;
         mqtt_message[index++] = 0xff & id;
-        id++;
     }
 
     // 消息
@@ -175,4 +182,419 @@ uint16_t MQTT_PublishMessage(uint8_t * mqtt_message, char * topic, char * messag
     index += message_length;
 
     return index;
+}
+
+/**
+ * @brief 构建MQTT 5连接包
+ * 
+ * @param mqtt_message 保存构建的MQTT连接包
+ * @param client_id 客户端id
+ * @param username 用户名，为空字符串时不发送
+ * @param password 密码，为空字符串时不发送
+ * @return uint16_t 构建的MQTT连接报文长度
+ * 
+ * @note 与MQTT_ConnectMessage()相比，协议版本为5，并且在保活时间之后多了一个属性长度（这里为0）。
+ *       服务端会在CONNACK中通过主题别名最大值属性告知客户端可以使用的别名个数。
+ */
+uint16_t MQTT_ConnectMessageV5(uint8_t *mqtt_message, char *client_id, char *username, char *password)
+{
+    uint16_t client_id_length = strlen(client_id);
+    uint16_t username_length = strlen(username);
+    uint16_t password_length = strlen(password);
+    uint32_t remain_length = 0;
+    uint16_t index = 0;
+    uint8_t flags = 0x02;                                                       // Clean Start
+
+    // 剩余长度=可变报头长度（11）+客户端ID长度（2）+客户端ID（client_id_length）
+    remain_length = 11 + 2 + client_id_length;
+    if (username_length > 0)
+    {
+        remain_length += 2 + username_length;
+        flags |= 0x80;                                                          // User Name Flag
+    }
+    if (password_length > 0)
+    {
+        remain_length += 2 + password_length;
+        flags |= 0x40;                                                          // Password Flag
+    }
+
+    mqtt_message[index++] = 0x10;                                               // MQTT Message Type CONNECT
+    index += MQTT_EncodeRemainLength(&mqtt_message[index], remain_length);
+
+    // 协议名：00 04 MQTT
+    mqtt_message[index++] = 0x00;
+    mqtt_message[index++] = 0x04;
+    memcpy(&mqtt_message[index], "MQTT", 4);
+    index += 4;
+
+    mqtt_message[index++] = MQTT_PROTOCOL_VERSION_5;                            // 协议版本
+    mqtt_message[index++] = flags;                                              // 连接标志
+    mqtt_message[index++] = 0x00;                                               // Keep-alive Time Length MSB
+    mqtt_message[index++] = 0x64;                                               // Keep-alive Time Length LSB
+    mqtt_message[index++] = 0x00;                                               // 属性长度
+
+    // 客户端ID
+    mqtt_message[index++] = client_id_length >> 8;
+    mqtt_message[index++] = client_id_length & 0xFF;
+    memcpy(&mqtt_message[index], client_id, client_id_length);
+    index += client_id_length;
+
+    // 用户名
+    if (username_length > 0)
+    {
+        mqtt_message[index++] = username_length >> 8;
+        mqtt_message[index++] = username_length & 0xFF;
+        memcpy(&mqtt_message[index], username, username_length);
+        index += username_length;
+    }
+
+    // 密码
+    if (password_length > 0)
+    {
+        mqtt_message[index++] = password_length >> 8;
+        mqtt_message[index++] = password_length & 0xFF;
+        memcpy(&mqtt_message[index], password, password_length);
+        index += password_length;
+    }
+
+    return index;
+}
+
+/**
+ * @brief 解析MQTT连接确认包
+ * 
+ * @param data 接收到的CONNACK报文
+ * @param length 报文长度
+ * @param alias_maximum 保存服务端允许的主题别名最大值，MQTT 3.1.1或服务端未携带该属性时为0
+ * @return uint8_t 连接返回码，0: 连接成功; 0xFF: 报文格式错误; 其它: 服务端返回的错误码
+ */
+uint8_t MQTT_ParseConnAck(uint8_t *data, uint16_t length, uint16_t *alias_maximum)
+{
+    uint32_t remain_length = 0;
+    uint32_t property_length = 0;
+    uint16_t index = 1;
+    uint16_t used = 0;
+    uint16_t end = 0;
+    uint8_t reason_code = 0;
+
+    *alias_maximum = 0;
+
+    if (length < 4 || data[0] != 0x20)
+    {
+        return 0xFF;
+    }
+
+    used = MQTT_DecodeVariableInteger(&data[index], length - index, &remain_length);
+    if (used == 0 || index + used + remain_length > length || remain_length < 2)
+    {
+        return 0xFF;
+    }
+    index += used;
+    end = index + remain_length;
+
+    reason_code = data[index + 1];                                              // 跳过连接确认标志
+    index += 2;
+
+    // MQTT 3.1.1的CONNACK没有属性
+    if (index >= end)
+    {
+        return reason_code;
+    }
+
+    used = MQTT_DecodeVariableInteger(&data[index], end - index, &property_length);
+    if (used == 0 || index + used + property_length > end)
+    {
+        return 0xFF;
+    }
+    index += used;
+    end = index + property_length;
+
+    // 逐个跳过属性，只关心主题别名最大值
+    while (index < end)
+    {
+        uint8_t id = data[index++];
+
+        switch (id)
+        {
+        case 0x01: case 0x17: case 0x19: case 0x24: case 0x25: case 0x28: case 0x29: case 0x2A:
+            index += 1;                                                         // 单字节属性
+            break;
+
+        case MQTT_PROPERTY_TOPIC_ALIAS_MAXIMUM:
+            if (index + 2 > end)
+            {
+                return 0xFF;
+            }
+            *alias_maximum = (data[index] << 8) | data[index + 1];
+            index += 2;
+            break;
+
+        case 0x13: case 0x21: case 0x23:
+            index += 2;                                                         // 双字节属性
+            break;
+
+        case 0x02: case 0x11: case 0x18: case 0x27:
+            index += 4;                                                         // 四字节属性
+            break;
+
+        case 0x0B:
+            used = MQTT_DecodeVariableInteger(&data[index], end - index, &remain_length);
+            if (used == 0)
+            {
+                return 0xFF;
+            }
+            index += used;                                                      // 变长整数属性
+            break;
+
+        case 0x26:
+            if (index + 2 > end)
+            {
+                return 0xFF;
+            }
+            index += 2 + ((data[index] << 8) | data[index + 1]);                // 字符串对属性，先跳过键
+            // fall through
+        case 0x03: case 0x08: case 0x09: case 0x12: case 0x15: case 0x16: case 0x1A: case 0x1C: case 0x1F:
+            if (index + 2 > end)
+            {
+                return 0xFF;
+            }
+            index += 2 + ((data[index] << 8) | data[index + 1]);                // 字符串或二进制属性
+            break;
+
+        default:
+            return 0xFF;                                                        // 未知属性
+        }
+    }
+
+    return (index == end) ? reason_code : 0xFF;
+}
+
+/**
+ * @brief 初始化主题注册表
+ * 
+ * @param version 协议版本，可选值: [MQTT_PROTOCOL_VERSION_3_1_1, MQTT_PROTOCOL_VERSION_5]
+ */
+void MQTT_Topic_Init(uint8_t version)
+{
+    memset(&g_mqtt_topic_registry, 0, sizeof(g_mqtt_topic_registry));
+    g_mqtt_topic_registry.version = version;
+}
+
+/**
+ * @brief 注册主题，预先编码好主题长度和主题内容
+ * 
+ * @param topic 主题，例如: /sys/{ProductKey}/{deviceName}/thing/event/property/post
+ * @return int8_t 主题句柄，-1: 注册表已满或主题过长
+ */
+int8_t MQTT_Topic_Register(char *topic)
+{
+    uint16_t topic_length = strlen(topic);
+    MQTT_Topic_t *pTopic = NULL;
+
+    if (g_mqtt_topic_registry.count >= MQTT_TOPIC_MAX_COUNT || topic_length > MQTT_TOPIC_MAX_LENGTH)
+    {
+        return -1;
+    }
+
+    pTopic = &g_mqtt_topic_registry.topics[g_mqtt_topic_registry.count];
+    pTopic->encoded[0] = topic_length >> 8;
+    pTopic->encoded[1] = topic_length & 0xFF;
+    memcpy(&pTopic->encoded[2], topic, topic_length);
+    pTopic->encoded_length = topic_length + 2;
+    pTopic->alias = 0;
+    pTopic->alias_bound = false;
+
+    // 服务端已经告知过别名最大值时，新注册的主题也分配别名
+    if (g_mqtt_topic_registry.version == MQTT_PROTOCOL_VERSION_5 && g_mqtt_topic_registry.count < g_mqtt_topic_registry.alias_maximum)
+    {
+        pTopic->alias = g_mqtt_topic_registry.count + 1;
+    }
+
+    return g_mqtt_topic_registry.count++;
+}
+
+/**
+ * @brief 设置服务端允许的主题别名最大值，并重新分配主题别名
+ * 
+ * @param alias_maximum 主题别名最大值，由MQTT_ParseConnAck()得到
+ * 
+ * @note 主题别名只在一次网络连接内有效，每次收到CONNACK后都需要调用该函数，使别名在下一次发布时重新绑定。
+ */
+void MQTT_Topic_SetAliasMaximum(uint16_t alias_maximum)
+{
+    g_mqtt_topic_registry.alias_maximum = alias_maximum;
+
+    for (uint8_t i = 0; i < g_mqtt_topic_registry.count; i++)
+    {
+        MQTT_Topic_t *pTopic = &g_mqtt_topic_registry.topics[i];
+
+        pTopic->alias = (g_mqtt_topic_registry.version == MQTT_PROTOCOL_VERSION_5 && i < alias_maximum) ? (i + 1) : 0;
+        pTopic->alias_bound = false;
+    }
+}
+
+/**
+ * @brief 通过已注册的主题句柄构建MQTT发布包
+ * 
+ * @param mqtt_message 保存构建的MQTT发布数据包
+ * @param handle 主题句柄，由MQTT_Topic_Register()返回
+ * @param message 发布消息
+ * @param message_length 发布消息长度
+ * @param dup 重发标志, 0: 第一次发送; 1: 可能是之前报文的重发
+ * @param QoS 发布质量, 0: 最多分发一次; 1: 至少分发一次; 2: 只分发一次
+ * @param retain 是否保留消息, 0: 不保留 1: 保留
+ * @return uint16_t 构建的MQTT推送数据包长度，0表示句柄无效
+ * 
+ * @note 主题已经在注册时编码好，这里直接拷贝，不再计算主题长度。
+ *       MQTT 5下，主题第一次发布时同时携带主题名和别名完成绑定，之后主题名为空，只发送两个字节的别名。
+ *       构建时不修改绑定状态，发布包完整发送出去后调用MQTT_Topic_BindAlias()。
+ */
+uint16_t MQTT_PublishTopicMessage(uint8_t *mqtt_message, uint8_t handle, uint8_t *message, uint16_t message_length, uint8_t dup, uint8_t QoS, uint8_t retain)
+{
+    MQTT_Topic_t *pTopic = NULL;
+    uint32_t remain_length = 0;
+    uint16_t index = 0;
+    bool is_v5 = (g_mqtt_topic_registry.version == MQTT_PROTOCOL_VERSION_5);
+    bool send_name = true;
+
+    if (handle >= g_mqtt_topic_registry.count)
+    {
+        return 0;
+    }
+
+    pTopic = &g_mqtt_topic_registry.topics[handle];
+    send_name = !(is_v5 && pTopic->alias && pTopic->alias_bound);
+
+    // 剩余长度=主题字段长度 + 报文标识符长度（0或2）+ 属性（MQTT 5）+ 有效载荷长度
+    remain_length = (send_name ? pTopic->encoded_length : 2) + (QoS ? 2 : 0) + message_length;
+    if (is_v5)
+    {
+        remain_length += 1 + (pTopic->alias ? 3 : 0);
+    }
+
+    mqtt_message[index++] = 0x30 | (dup << 3) | (QoS << 1) | retain;            // MQTT Message Type PUBLISH
+    index += MQTT_EncodeRemainLength(&mqtt_message[index], remain_length);
+
+    // 主题
+    if (send_name)
+    {
+        memcpy(&mqtt_message[index], pTopic->encoded, pTopic->encoded_length);
+        index += pTopic->encoded_length;
+    }
+    else
+    {
+        mqtt_message[index++] = 0x00;                                           // 空主题，由别名代替
+        mqtt_message[index++] = 0x00;
+    }
+
+    // 报文标识符，等级0没有
+    if (QoS)
+    {
+        uint16_t id = MQTT_NextPacketId();
+        mqtt_message[index++] = id >> 8;
+        mqtt_message[index++] = id & 0xFF;
+    }
+
+    // 属性
+    if (is_v5)
+    {
+        if (pTopic->alias)
+        {
+            mqtt_message[index++] = 3;                                          // 属性长度
+            mqtt_message[index++] = MQTT_PROPERTY_TOPIC_ALIAS;
+            mqtt_message[index++] = pTopic->alias >> 8;
+            mqtt_message[index++] = pTopic->alias & 0xFF;
+        }
+        else
+        {
+            mqtt_message[index++] = 0;                                          // 属性长度
+        }
+    }
+
+    // 消息
+    memcpy(&mqtt_message[index], message, message_length);
+    index += message_length;
+
+    return index;
+}
+
+/**
+ * @brief 标记主题别名已经和主题绑定
+ * 
+ * @param handle 主题句柄，由MQTT_Topic_Register()返回
+ * 
+ * @note 携带主题名的发布包完整发送出去后才能调用，发送失败时服务端没有收到绑定，下一次发布还要带上主题名。
+ */
+void MQTT_Topic_BindAlias(uint8_t handle)
+{
+    if (handle < g_mqtt_topic_registry.count && g_mqtt_topic_registry.topics[handle].alias)
+    {
+        g_mqtt_topic_registry.topics[handle].alias_bound = true;
+    }
+}
+
+/**
+ * @brief 编码固定报头中的剩余长度
+ * 
+ * @param buffer 保存编码结果
+ * @param remain_length 剩余长度
+ * @return uint16_t 编码后的字节数
+ */
+static uint16_t MQTT_EncodeRemainLength(uint8_t *buffer, uint32_t remain_length)
+{
+    uint16_t index = 0;
+
+    do {
+        uint8_t temp = remain_length % 128;                                     // 剩余长度取余
+        remain_length = remain_length / 128;                                    // 剩余长度取整
+        if (remain_length > 0)
+        {
+            temp |= 0x80;                                                       // 按协议要求位7置位
+        }
+        buffer[index++] = temp;
+    } while (remain_length > 0);
+
+    return index;
+}
+
+/**
+ * @brief 解码MQTT变长整数
+ * 
+ * @param buffer 待解码的数据
+ * @param length 数据长度
+ * @param value 保存解码结果
+ * @return uint16_t 变长整数占用的字节数，0表示格式错误
+ */
+static uint16_t MQTT_DecodeVariableInteger(uint8_t *buffer, uint16_t length, uint32_t *value)
+{
+    uint32_t multiplier = 1;
+    uint16_t index = 0;
+
+    *value = 0;
+
+    do {
+        if (index >= length || index >= 4)
+        {
+            return 0;
+        }
+        *value += (buffer[index] & 0x7F) * multiplier;
+        multiplier *= 128;
+    } while (buffer[index++] & 0x80);
+
+    return index;
+}
+
+/**
+ * @brief 获取下一个报文标识符，报文标识符不能为0
+ * 
+ * @return uint16_t 报文标识符
+ */
+static uint16_t MQTT_NextPacketId(void)
+{
+    if (++g_mqtt_packet_id == 0)
+    {
+        g_mqtt_packet_id = 1;
+    }
+
+    return g_mqtt_packet_id;
 }
\ No newline at end of file
@@ -3,8 +3,45 @@
 
 #include <string.h>
 #include <stdint.h>
+#include <stdbool.h>
+
+#define MQTT_PROTOCOL_VERSION_3_1_1         0x04                                // MQTT 3.1.1
+#define MQTT_PROTOCOL_VERSION_5             0x05                                // MQTT 5
+
+#define MQTT_PROPERTY_TOPIC_ALIAS_MAXIMUM   0x22                                // CONNACK属性: 主题别名最大值
+#define MQTT_PROPERTY_TOPIC_ALIAS           0x23                                // PUBLISH属性: 主题别名
+
+#define MQTT_TOPIC_MAX_COUNT                8                                   // 主题注册表容量
+#define MQTT_TOPIC_MAX_LENGTH               128                                 // 单个主题的最大长度
+
+typedef struct MQTT_Topic_t
+{
+    uint8_t encoded[MQTT_TOPIC_MAX_LENGTH + 2];                                 // 预编码的主题，前两个字节为主题长度
+    uint16_t encoded_length;                                                    // 预编码主题的总长度
+    uint16_t alias;                                                             // MQTT 5主题别名，0表示不使用别名
+    bool alias_bound;                                                           // 当前连接中别名是否已经和主题绑定
+} MQTT_Topic_t;
+
+typedef struct MQTT_TopicRegistry_t
+{
+    MQTT_Topic_t topics[MQTT_TOPIC_MAX_COUNT];                                  // 已注册的主题
+    uint8_t count;                                                              // 已注册的主题个数
+    uint8_t version;                                                            // 协议版本
+    uint16_t alias_maximum;                                                     // 服务端允许的主题别名最大值
+} MQTT_TopicRegistry_t;
+
+extern MQTT_TopicRegistry_t g_mqtt_topic_registry;
 
 uint16_t MQTT_ConnectMessage(uint8_t*mqtt_message,char *client_id,char *username,char *password);
 uint16_t MQTT_PublishMessage(uint8_t * mqtt_message, char * topic, char * message, uint8_t udp, uint8_t QoS, uint8_t retain);
 
+uint16_t MQTT_ConnectMessageV5(uint8_t *mqtt_message, char *client_id, char *username, char *password);
+uint8_t MQTT_ParseConnAck(uint8_t *data, uint16_t length, uint16_t *alias_maximum);
+
+void MQTT_Topic_Init(uint8_t version);
+int8_t MQTT_Topic_Register(char *topic);
+void MQTT_Topic_SetAliasMaximum(uint16_t alias_maximum);
+void MQTT_Topic_BindAlias(uint8_t handle);
+uint16_t MQTT_PublishTopicMessage(uint8_t *mqtt_message, uint8_t handle, uint8_t *message, uint16_t message_length, uint8_t dup, uint8_t QoS, uint8_t retain);
+
 #endif // !__MQTT_H__
\ No newline at end of file
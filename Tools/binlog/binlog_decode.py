@@ -0,0 +1,247 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+BINLOG() 二进制日志解码工具，对照固件的ELF文件把记录还原成文本
+
+记录格式（小端），printf()输出的文本可以夹在记录之间，原样打印：
+| 0xA5 | count(1) | format_id(2) | timestamp_us(4) | args(4 * count) | checksum(1) |
+
+format_id是格式化字符串在ELF的.binlog段内的偏移，checksum使整条记录的字节和为0。
+参数都是32位：%f/%e/%g按float解释，%s按地址到ELF的FLASH段里找常量字符串。
+
+用法：
+    python3 binlog_decode.py build/Debug/stm32f4-project.elf --port /dev/ttyUSB0 --baud 115200
+    python3 binlog_decode.py build/Debug/stm32f4-project.elf --file capture.bin
+    python3 binlog_decode.py build/Debug/stm32f4-project.elf --table
+"""
+
+import argparse
+import os
+import re
+import struct
+import sys
+import termios
+import tty
+
+MAGIC = 0xA5
+MAX_ARGS = 8
+HEADER = struct.Struct("<BBHI")                 # magic, count, format_id, timestamp_us
+
+SHT_PROGBITS = 1
+SHF_ALLOC = 0x2
+
+CONVERSION = re.compile(r"%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d+))?(hh|h|ll|l|z|j|t)?([diouxXcspfFeEgGaA%])")
+
+
+class Image:
+    """ELF文件里的格式化字符串表和FLASH里的常量数据"""
+
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            data = f.read()
+        if data[:4] != b"\x7fELF" or data[4] != 1 or data[5] != 1:
+            raise ValueError("{}: not a 32-bit little-endian ELF file".format(path))
+
+        shoff, = struct.unpack_from("<I", data, 0x20)
+        shentsize, shnum, shstrndx = struct.unpack_from("<HHH", data, 0x2E)
+        sections = [struct.unpack_from("<IIIIII", data, shoff + i * shentsize) for i in range(shnum)]
+        names = sections[shstrndx]
+        strtab = data[names[4]:names[4] + names[5]]
+
+        self.formats = {}
+        self.segments = []
+        for name, kind, flags, addr, offset, size in sections:
+            name = strtab[name:strtab.index(b"\0", name)].decode()
+            body = data[offset:offset + size]
+            if name == ".binlog":
+                self.formats = self.split_formats(body)
+            elif kind == SHT_PROGBITS and flags & SHF_ALLOC:
+                self.segments.append((addr, body))
+
+    @staticmethod
+    def split_formats(body):
+        # 每个字符串从段开头或者前一个字节为0的位置开始，中间可能有对齐填充的0
+        formats = {}
+        start = 0
+        while start < len(body):
+            end = body.index(b"\0", start)
+            if end > start:
+                formats[start] = body[start:end].decode("utf-8", "replace")
+            start = end + 1
+        return formats
+
+    def string_at(self, address):
+        for base, body in self.segments:
+            if base <= address < base + len(body):
+                end = body.find(b"\0", address - base)
+                return body[address - base:end if end >= 0 else None].decode("utf-8", "replace")
+        return None
+
+
+def signed(value, bits):
+    value &= (1 << bits) - 1
+    return value - (1 << bits) if value >> (bits - 1) else value
+
+
+def render(image, fmt, args):
+    args = list(args)
+
+    def convert(match):
+        flags, width, precision, length, kind = match.groups()
+        if kind == "%":
+            return "%"
+        if width == "*":
+            width = str(signed(args.pop(0), 32)) if args else ""
+        if precision == "*":
+            precision = str(signed(args.pop(0), 32)) if args else ""
+        if not args:
+            return "<missing>"
+        value = args.pop(0)
+        spec = "%" + flags + (width or "") + ("." + precision if precision is not None else "")
+        bits = {"hh": 8, "h": 16}.get(length, 32)
+
+        if kind in "di":
+            return (spec + "d") % signed(value, bits)
+        if kind in "ouxX":
+            return (spec + kind) % (value & ((1 << bits) - 1))
+        if kind == "c":
+            return (spec + "c") % chr(value & 0xFF)
+        if kind == "p":
+            return (spec + "s") % "0x{:08x}".format(value)
+        if kind == "s":
+            text = image.string_at(value)
+            return (spec + "s") % (text if text is not None else "<0x{:08x}>".format(value))
+        return (spec + kind) % struct.unpack("<f", struct.pack("<I", value))[0]
+
+    return CONVERSION.sub(convert, fmt)
+
+
+class Decoder:
+    """从字节流里找出记录，记录之间的字节当作printf()的文本"""
+
+    def __init__(self, image, out):
+        self.image = image
+        self.out = out
+        self.buffer = bytearray()
+        self.text = bytearray()
+        self.epoch = 0                          # 时间戳每71分钟回绕一次
+        self.last_timestamp = None
+        self.records = 0
+        self.bad = 0                            # 以0xA5开头但校验不通过的位置
+
+    def feed(self, data, final=False):
+        self.buffer += data
+        pos = 0
+        while pos < len(self.buffer):
+            if self.buffer[pos] != MAGIC:
+                self.put_text(self.buffer[pos])
+                pos += 1
+                continue
+            if len(self.buffer) - pos < HEADER.size + 1:
+                if not final:
+                    break
+                self.put_text(self.buffer[pos])
+                pos += 1
+                continue
+            _, count, format_id, timestamp = HEADER.unpack_from(self.buffer, pos)
+            length = HEADER.size + count * 4 + 1
+            if count > MAX_ARGS or format_id not in self.image.formats:
+                self.reject(pos)
+                pos += 1
+                continue
+            if len(self.buffer) - pos < length:
+                if not final:
+                    break
+                self.reject(pos)
+                pos += 1
+                continue
+            if sum(self.buffer[pos:pos + length]) & 0xFF:
+                self.reject(pos)
+                pos += 1
+                continue
+            args = struct.unpack_from("<{}I".format(count), self.buffer, pos + HEADER.size)
+            self.put_record(format_id, timestamp, args)
+            pos += length
+        del self.buffer[:pos]
+        if final:
+            self.flush_text()
+
+    def reject(self, pos):
+        self.bad += 1
+        self.put_text(self.buffer[pos])
+
+    def put_text(self, byte):
+        self.text.append(byte)
+        if byte == 0x0A:
+            self.flush_text()
+
+    def flush_text(self):
+        if self.text:
+            self.out.write(self.text.decode("utf-8", "replace").rstrip("\r\n") + "\n")
+            self.text.clear()
+            self.out.flush()
+
+    def put_record(self, format_id, timestamp, args):
+        # 往回跳超过半圈才算回绕，小的倒退不能让后面的时间都多出71分钟
+        if self.last_timestamp is not None and self.last_timestamp - timestamp > 1 << 31:
+            self.epoch += 1 << 32
+        self.last_timestamp = timestamp
+        self.records += 1
+
+        self.flush_text()
+        message = render(self.image, self.image.formats[format_id], args)
+        self.out.write("[{:12.6f}] {}\n".format((self.epoch + timestamp) / 1e6, message.rstrip("\r\n")))
+        self.out.flush()
+
+
+def open_port(path, baud):
+    fd = os.open(path, os.O_RDONLY | os.O_NOCTTY)
+    tty.setraw(fd)
+    attrs = termios.tcgetattr(fd)
+    speed = getattr(termios, "B{}".format(baud))
+    attrs[4] = attrs[5] = speed
+    termios.tcsetattr(fd, termios.TCSANOW, attrs)
+    return fd
+
+
+def main():
+    parser = argparse.ArgumentParser(description="BINLOG binary log decoder")
+    parser.add_argument("elf", help="firmware ELF file with the .binlog section")
+    parser.add_argument("--port", help="serial device, e.g. /dev/ttyUSB0")
+    parser.add_argument("--baud", type=int, default=115200, help="serial baud rate")
+    parser.add_argument("--file", help="captured stream, - for stdin")
+    parser.add_argument("--table", action="store_true", help="print the format table and exit")
+    args = parser.parse_args()
+
+    image = Image(args.elf)
+    if args.table:
+        for format_id, fmt in sorted(image.formats.items()):
+            print("{:5d}  {!r}".format(format_id, fmt))
+        return
+
+    decoder = Decoder(image, sys.stdout)
+    if args.port:
+        fd = open_port(args.port, args.baud)
+        read = lambda: os.read(fd, 4096)
+    elif args.file:
+        stream = sys.stdin.buffer if args.file == "-" else open(args.file, "rb")
+        read = lambda: stream.read1(4096) if hasattr(stream, "read1") else stream.read(4096)
+    else:
+        parser.error("one of --port or --file is required")
+
+    try:
+        while True:
+            data = read()
+            if not data:
+                break
+            decoder.feed(data)
+    finally:
+        decoder.feed(b"", final=True)
+        sys.stderr.write("records {}  bad {}\n".format(decoder.records, decoder.bad))
+
+
+if __name__ == "__main__":
+    try:
+        main()
+    except KeyboardInterrupt:
+        pass
@@ -0,0 +1,292 @@
+/**
+ * Toolkit/frame的主机编解码工具，和固件共用frame.c
+ *
+ * 用法：
+ *     ./frame_codec encode [最大帧长] < data > wire      把输入切成帧编码输出
+ *     ./frame_codec decode < wire > data                解码，帧的数据依次输出，统计打印到stderr
+ *     ./frame_codec check [次数]                        随机数据往返测试
+ *
+ * decode和check都模拟固件的接收环形缓冲区：数据按随机的长度写进2的幂大小的缓冲区，
+ * 用两段的视图调用Frame_Parse()，和BSP_UART_ReceiveFrames()走同一条路径，包括跨回绕的帧。
+ * check还会随机翻转、丢弃和插入字节，检查没有被破坏的帧全部按顺序收到，被破坏的帧都没有交给处理函数。
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "frame/frame.h"
+
+#define CODEC_RING_SIZE     1024                                                // 和UART_RX_BUFFER_SIZE一样
+#define CODEC_FRAME_SIZE    FRAME_ENCODED_SIZE(FRAME_MAX_PAYLOAD)
+#define CODEC_CHECK_FRAMES  4096                                                // check每一轮的帧数
+
+/** @brief 模拟的接收环形缓冲区 */
+typedef struct Codec_Ring_t
+{
+    uint8_t buffer[CODEC_RING_SIZE];
+    uint32_t head;
+    uint32_t tail;
+} Codec_Ring_t;
+
+/** @brief check里一帧的期望结果 */
+typedef struct Codec_Expect_t
+{
+    uint8_t payload[FRAME_MAX_PAYLOAD];
+    uint16_t length;
+    uint8_t intact;                                                             // 编码后没有被破坏
+} Codec_Expect_t;
+
+static Codec_Ring_t g_codec_ring;
+static Frame_Parser_t g_codec_parser;
+static uint8_t g_codec_parser_buffer[CODEC_FRAME_SIZE];
+
+static Codec_Expect_t g_codec_expect[CODEC_CHECK_FRAMES];
+static uint32_t g_codec_next;                                                   // 下一个可能收到的帧
+static uint32_t g_codec_received;
+static uint32_t g_codec_mismatch;                                               // 收到的帧不是任何一个发出的帧
+static uint32_t g_codec_lost;                                                   // 没被破坏却没收到的帧
+static uint32_t g_codec_undetected;                                             // 被破坏了却通过了CRC校验的帧
+
+/**
+ * @brief 把数据写进环形缓冲区，再解析出所有完整的帧
+ *
+ * @param data 数据
+ * @param length 数据长度，不大于缓冲区的空闲空间
+ */
+static void Codec_Feed(const uint8_t *data, uint32_t length)
+{
+    Codec_Ring_t *ring = &g_codec_ring;
+    uint8_t *segment[2];
+    uint16_t size[2];
+    uint32_t offset;
+    uint32_t used;
+
+    for (uint32_t i = 0; i < length; i++)
+    {
+        ring->buffer[ring->head++ & (CODEC_RING_SIZE - 1)] = data[i];
+    }
+
+    used = ring->head - ring->tail;
+    offset = ring->tail & (CODEC_RING_SIZE - 1);
+    segment[0] = ring->buffer + offset;
+    size[0] = (used < CODEC_RING_SIZE - offset) ? used : CODEC_RING_SIZE - offset;
+    segment[1] = ring->buffer;
+    size[1] = used - size[0];
+
+    ring->tail += Frame_Parse(&g_codec_parser, segment, size);
+}
+
+/**
+ * @brief 按随机的长度把数据喂给环形缓冲区，模拟DMA的半传输和总线空闲事件
+ *
+ * @param data 数据
+ * @param length 数据长度
+ */
+static void Codec_FeedRandom(const uint8_t *data, uint32_t length)
+{
+    uint32_t chunk;
+    uint32_t space;
+
+    while (length > 0)
+    {
+        space = CODEC_RING_SIZE - (g_codec_ring.head - g_codec_ring.tail);
+        chunk = 1 + rand() % 300;
+        chunk = (chunk < length) ? chunk : length;
+        chunk = (chunk < space) ? chunk : space;
+        Codec_Feed(data, chunk);
+        data += chunk;
+        length -= chunk;
+    }
+}
+
+static void Codec_WriteHandler(void *context, const uint8_t *payload, uint16_t length)
+{
+    fwrite(payload, 1, length, (FILE *)context);
+}
+
+/**
+ * @brief 收到的帧按顺序和期望结果对比
+ * 
+ * @note 收到的帧只能是下一个没被破坏的帧，或者它前面某个被破坏的帧恰好通过了CRC校验
+ *       (CRC-16漏检，概率约1/65536)。漏检单独计数，没被破坏的帧没收到或者收到的内容不对都算失败
+ */
+static void Codec_CheckHandler(void *context, const uint8_t *payload, uint16_t length)
+{
+    uint32_t intact = g_codec_next;
+    uint32_t i = 0;
+
+    (void)context;
+
+    while (intact < CODEC_CHECK_FRAMES && !g_codec_expect[intact].intact)
+    {
+        intact++;
+    }
+
+    // 全0、全0xFF的帧可能连续几帧内容相同，先和没被破坏的帧比较
+    if (intact < CODEC_CHECK_FRAMES && g_codec_expect[intact].length == length &&
+        memcmp(g_codec_expect[intact].payload, payload, length) == 0)
+    {
+        g_codec_next = intact + 1;
+        g_codec_received++;
+        return;
+    }
+
+    if (intact == g_codec_next)
+    {
+        g_codec_mismatch++;
+        return;
+    }
+
+    g_codec_undetected++;
+    for (i = g_codec_next; i < intact; i++)                                     // 漏检的帧还原成了原来的数据
+    {
+        if (g_codec_expect[i].length == length && memcmp(g_codec_expect[i].payload, payload, length) == 0)
+        {
+            g_codec_next = i + 1;
+            break;
+        }
+    }
+}
+
+static void Codec_PrintStats(const Frame_Parser_t *parser)
+{
+    fprintf(stderr, "frames %u  crc_errors %u  cobs_errors %u  oversize %u  resyncs %u\n",
+            parser->frames, parser->crc_errors, parser->cobs_errors, parser->oversize, parser->resyncs);
+}
+
+static int Codec_Encode(uint16_t max)
+{
+    uint8_t payload[FRAME_MAX_PAYLOAD];
+    uint8_t wire[CODEC_FRAME_SIZE];
+    size_t length;
+
+    while ((length = fread(payload, 1, max, stdin)) > 0)
+    {
+        fwrite(wire, 1, Frame_Encode(payload, length, wire, sizeof(wire)), stdout);
+    }
+    return 0;
+}
+
+static int Codec_Decode(void)
+{
+    uint8_t data[512];
+    size_t length;
+
+    Frame_Parser_Init(&g_codec_parser, g_codec_parser_buffer, sizeof(g_codec_parser_buffer), Codec_WriteHandler, stdout);
+    while ((length = fread(data, 1, sizeof(data), stdin)) > 0)
+    {
+        Codec_FeedRandom(data, length);
+    }
+    Codec_PrintStats(&g_codec_parser);
+    return 0;
+}
+
+static int Codec_Check(uint32_t rounds)
+{
+    static uint8_t stream[CODEC_CHECK_FRAMES * (CODEC_FRAME_SIZE + 4)];
+    uint8_t wire[CODEC_FRAME_SIZE];
+    uint32_t intact = 0;
+    uint32_t total = 0;
+    uint32_t bytes = 0;
+    clock_t start;
+    double seconds;
+    uint16_t size;
+
+    srand(1);
+    Frame_Parser_Init(&g_codec_parser, g_codec_parser_buffer, sizeof(g_codec_parser_buffer), Codec_CheckHandler, NULL);
+
+    start = clock();
+    for (uint32_t round = 0; round < rounds; round++)
+    {
+        uint32_t length = 0;
+        int corrupt = round & 1;                                                // 奇数轮注入错误
+        int merged = 0;
+
+        for (uint32_t i = 0; i < CODEC_CHECK_FRAMES; i++)
+        {
+            Codec_Expect_t *expect = &g_codec_expect[i];
+            uint8_t fill = rand() % 4;
+
+            expect->length = rand() % (FRAME_MAX_PAYLOAD + 1);
+            for (uint16_t j = 0; j < expect->length; j++)
+            {
+                // 分别覆盖全零、全0xFF的长块和随机数据
+                expect->payload[j] = (fill == 0) ? 0 : (fill == 1) ? 0xFF : rand();
+            }
+
+            size = Frame_Encode(expect->payload, expect->length, wire, sizeof(wire));
+            expect->intact = !merged;
+            merged = 0;
+            if (corrupt && rand() % 8 == 0)
+            {
+                uint32_t position = rand() % size;
+
+                switch (rand() % 3)
+                {
+                case 0:
+                    wire[position] ^= 1 << (rand() % 8);                        // 翻转一位
+                    merged = (position == size - 1);                            // 分隔符坏了，和下一帧连在一起，下一帧也收不到
+                    break;
+                case 1:
+                    merged = (position == size - 1);
+                    memmove(wire + position, wire + position + 1, size - position - 1);
+                    size--;                                                     // 丢一个字节，可能是分隔符
+                    break;
+                default:
+                    stream[length++] = 1 + rand() % 255;                        // 帧前面插入杂波
+                    break;
+                }
+                expect->intact = 0;
+            }
+
+            memcpy(stream + length, wire, size);
+            length += size;
+            intact += expect->intact;
+        }
+
+        g_codec_next = 0;
+        Codec_FeedRandom(stream, length);
+        Codec_Feed((const uint8_t *)"", 1);                                     // 结尾补一个分隔符，冲掉最后一帧丢了分隔符的情况
+        for (; g_codec_next < CODEC_CHECK_FRAMES; g_codec_next++)               // 结尾没收到的帧
+        {
+            g_codec_lost += g_codec_expect[g_codec_next].intact;
+        }
+        total += CODEC_CHECK_FRAMES;
+        bytes += length;
+    }
+    seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    Codec_PrintStats(&g_codec_parser);
+    printf("%u frames, %u intact, %u received, %u lost, %u mismatched, %u undetected, %.1f MB/s\n",
+           total, intact, g_codec_received, g_codec_lost, g_codec_mismatch, g_codec_undetected, bytes / seconds / 1e6);
+
+    if (g_codec_mismatch != 0 || g_codec_lost != 0)
+    {
+        printf("FAILED\n");
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc >= 2 && strcmp(argv[1], "encode") == 0)
+    {
+        uint32_t max = (argc >= 3) ? strtoul(argv[2], NULL, 0) : FRAME_MAX_PAYLOAD;
+        return Codec_Encode((max > 0 && max <= FRAME_MAX_PAYLOAD) ? max : FRAME_MAX_PAYLOAD);
+    }
+    if (argc >= 2 && strcmp(argv[1], "decode") == 0)
+    {
+        return Codec_Decode();
+    }
+    if (argc >= 2 && strcmp(argv[1], "check") == 0)
+    {
+        return Codec_Check((argc >= 3) ? strtoul(argv[2], NULL, 0) : 16);
+    }
+
+    fprintf(stderr, "usage: %s encode [max] | decode | check [rounds]\n", argv[0]);
+    return 2;
+}
\ No newline at end of file
@@ -0,0 +1,432 @@
+/**
+ * httpParser的主机基准测试，比较单次扫描的http_parser_execute()和原来的strstr()/strtok()解析
+ *
+ * 用法：
+ *     make && ./http_parser_bench [requests.txt] [次数]
+ *
+ * 两种解析都从同一个请求缓冲区开始，取出服务器用到的内容：方法、URI、文件名、MIME类型、
+ * Content-Length、Connection、Accept-Encoding和If-None-Match。计时前先检查两者的结果一致，
+ * 并把每个请求在每个位置拆成两段、以及逐字节地喂给解析器，检查结果与一次收到时相同。
+ */
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "httpParser.h"
+
+#define BENCH_MAX_REQUEST 32
+#define BENCH_BUF_SIZE    2048
+
+/** @brief 服务器从一个请求里取出的内容 */
+typedef struct Bench_Result_t
+{
+    uint8_t method;
+    uint8_t type;
+    uint8_t keep_alive;
+    uint8_t accept_gzip;
+    uint32_t content_len;
+    char uri[MAX_URI_SIZE];
+    char name[MAX_URI_SIZE];
+    char if_none_match[40];
+} Bench_Result_t;
+
+typedef struct Bench_Request_t
+{
+    char *data;
+    uint16_t len;
+} Bench_Request_t;
+
+static Bench_Request_t g_bench_requests[BENCH_MAX_REQUEST];
+static int g_bench_request_count;
+
+static const char *g_bench_method_name[] = {"ERR", "GET", "HEAD", "POST"};
+
+static uint8_t g_bench_buf[BENCH_BUF_SIZE + 1];
+static st_http_request g_bench_request;
+
+/******************************** 原来的解析，从httpServer.c和httpParser.c复制 ********************************/
+
+static uint16_t Legacy_MatchToken(const char *str, const char *token)
+{
+    uint16_t i;
+
+    for (i = 0; token[i]; i++)
+    {
+        if (toupper((uint8_t)str[i]) != toupper((uint8_t)token[i])) return 0;
+    }
+
+    return i;
+}
+
+static const char *Legacy_FindHeader(const char *head, const char *name)
+{
+    const char *line;
+    uint16_t len;
+
+    for (line = strstr(head, "\r\n"); line; line = strstr(line, "\r\n"))
+    {
+        line += 2;
+        if (!(len = Legacy_MatchToken(line, name)) || (line[len] != ':')) continue;
+
+        line += len + 1;
+        while (*line == ' ' || *line == '\t') line++;
+        return line;
+    }
+
+    return NULL;
+}
+
+static uint8_t Legacy_FindToken(const char *list, const char *token)
+{
+    const char *item = list;
+    uint16_t len;
+
+    while (*item && (*item != '\r'))
+    {
+        while (*item == ' ' || *item == ',') item++;
+        if ((len = Legacy_MatchToken(item, token)) && strchr(",; \r", item[len]))
+        {
+            item += len;
+            while (*item == ' ') item++;
+            if ((*item == ';') && (item = strstr(item, "q=")) && (strtod(item + 2, NULL) == 0)) return 0;
+            return 1;
+        }
+        while (*item && (*item != ',') && (*item != '\r')) item++;
+    }
+
+    return 0;
+}
+
+static void Legacy_ParseRequest(st_http_request *request, uint8_t *buf)
+{
+    char *nexttok;
+    size_t len;
+
+    nexttok = strtok((char *)buf, " ");
+    if (!nexttok)
+    {
+        request->METHOD = METHOD_ERR;
+        return;
+    }
+    if (!strcmp(nexttok, "GET") || !strcmp(nexttok, "get"))
+    {
+        request->METHOD = METHOD_GET;
+        nexttok = strtok(NULL, " ");
+    }
+    else if (!strcmp(nexttok, "HEAD") || !strcmp(nexttok, "head"))
+    {
+        request->METHOD = METHOD_HEAD;
+        nexttok = strtok(NULL, " ");
+    }
+    else if (!strcmp(nexttok, "POST") || !strcmp(nexttok, "post"))
+    {
+        nexttok = strtok(NULL, "\0");
+        request->METHOD = METHOD_POST;
+    }
+    else
+    {
+        request->METHOD = METHOD_ERR;
+    }
+
+    if (!nexttok)
+    {
+        request->METHOD = METHOD_ERR;
+        return;
+    }
+    len = strlen(nexttok);
+    if (len >= MAX_URI_SIZE) len = MAX_URI_SIZE - 1;
+    memmove(request->URI, nexttok, len);
+    request->URI[len] = 0;
+}
+
+static void Legacy_GetUriName(uint8_t *uri, uint8_t *uri_buf)
+{
+    uint8_t *uri_ptr;
+
+    strcpy((char *)uri_buf, (char *)uri);
+    uri_ptr = (uint8_t *)strtok((char *)uri_buf, " ?");
+    if (strcmp((char *)uri_ptr, "/")) uri_ptr++;
+    memmove(uri_buf, uri_ptr, strlen((char *)uri_ptr) + 1);
+}
+
+static void Legacy_FindUriType(uint8_t *type, uint8_t *buff)
+{
+    char *buf = (char *)buff;
+
+    if (strstr(buf, ".htm") || strstr(buf, ".html"))       *type = PTYPE_HTML;
+    else if (strstr(buf, ".gif"))                           *type = PTYPE_GIF;
+    else if (strstr(buf, ".text") || strstr(buf, ".txt"))  *type = PTYPE_TEXT;
+    else if (strstr(buf, ".log") || strstr(buf, ".csv"))   *type = PTYPE_TEXT;
+    else if (strstr(buf, ".jpeg") || strstr(buf, ".jpg"))  *type = PTYPE_JPEG;
+    else if (strstr(buf, ".swf"))                           *type = PTYPE_FLASH;
+    else if (strstr(buf, ".cgi") || strstr(buf, ".CGI"))   *type = PTYPE_CGI;
+    else if (strstr(buf, ".json") || strstr(buf, ".JSON")) *type = PTYPE_JSON;
+    else if (strstr(buf, ".js") || strstr(buf, ".JS"))     *type = PTYPE_JS;
+    else if (strstr(buf, ".xml") || strstr(buf, ".XML"))   *type = PTYPE_XML;
+    else if (strstr(buf, ".css") || strstr(buf, ".CSS"))   *type = PTYPE_CSS;
+    else if (strstr(buf, ".png") || strstr(buf, ".PNG"))   *type = PTYPE_PNG;
+    else if (strstr(buf, ".ico") || strstr(buf, ".ICO"))   *type = PTYPE_ICO;
+    else if (strstr(buf, ".ttf") || strstr(buf, ".TTF"))   *type = PTYPE_TTF;
+    else if (strstr(buf, ".otf") || strstr(buf, ".OTF"))   *type = PTYPE_OTF;
+    else if (strstr(buf, ".woff") || strstr(buf, ".WOFF")) *type = PTYPE_WOFF;
+    else if (strstr(buf, ".eot") || strstr(buf, ".EOT"))   *type = PTYPE_EOT;
+    else if (strstr(buf, ".svg") || strstr(buf, ".SVG"))   *type = PTYPE_SVG;
+    else                                                    *type = PTYPE_ERR;
+}
+
+/**
+ * @brief 原来recv_http_request()和http_process_handler()里的解析过程
+ */
+static void Legacy_Run(const Bench_Request_t *request, Bench_Result_t *result)
+{
+    char *buf = (char *)g_bench_buf;
+    char *end;
+    const char *value;
+    uint16_t i;
+
+    memcpy(buf, request->data, request->len);
+    buf[request->len] = '\0';
+
+    result->content_len = 0;
+    result->if_none_match[0] = '\0';
+
+    end = strstr(buf, "\r\n\r\n");
+    *end = '\0';
+
+    value = Legacy_FindHeader(buf, "Connection");
+    if (value && Legacy_MatchToken(value, "close")) result->keep_alive = 0;
+    else if (value && Legacy_MatchToken(value, "keep-alive")) result->keep_alive = 1;
+    else result->keep_alive = (strstr(buf, "HTTP/1.0") == NULL);
+
+    value = Legacy_FindHeader(buf, "Content-Length");
+    if (value) result->content_len = strtoul(value, NULL, 10);
+
+    value = Legacy_FindHeader(buf, "Accept-Encoding");
+    result->accept_gzip = (value && Legacy_FindToken(value, "gzip"));
+
+    value = Legacy_FindHeader(buf, "If-None-Match");
+    if (value)
+    {
+        for (i = 0; (i < sizeof(result->if_none_match) - 1) && value[i] && (value[i] != '\r'); i++)
+            result->if_none_match[i] = value[i];
+        result->if_none_match[i] = '\0';
+    }
+    *end = '\r';
+
+    Legacy_ParseRequest(&g_bench_request, g_bench_buf);
+    result->method = g_bench_request.METHOD;
+    strcpy(result->uri, (char *)g_bench_request.URI);
+    Legacy_GetUriName(g_bench_request.URI, (uint8_t *)result->name);
+    Legacy_FindUriType(&result->type, (uint8_t *)result->name);
+}
+
+/******************************** 单次扫描的解析 ********************************/
+
+static void Parser_OnHeader(void *arg, const char *name, uint16_t name_len, const char *value, uint16_t value_len)
+{
+    Bench_Result_t *result = arg;
+    char tmp[sizeof(result->if_none_match)];
+
+    if (value_len > sizeof(tmp) - 1) value_len = sizeof(tmp) - 1;
+    memcpy(tmp, value, value_len);
+    tmp[value_len] = '\0';
+
+    if ((name_len == 10) && Legacy_MatchToken(name, "Connection"))
+    {
+        if (Legacy_FindToken(tmp, "close")) result->keep_alive = 0;
+        else if (Legacy_FindToken(tmp, "keep-alive")) result->keep_alive = 1;
+    }
+    else if ((name_len == 14) && Legacy_MatchToken(name, "Content-Length"))
+    {
+        result->content_len = strtoul(tmp, NULL, 10);
+    }
+    else if ((name_len == 15) && Legacy_MatchToken(name, "Accept-Encoding"))
+    {
+        result->accept_gzip = Legacy_FindToken(tmp, "gzip");
+    }
+    else if ((name_len == 13) && Legacy_MatchToken(name, "If-None-Match"))
+    {
+        memcpy(result->if_none_match, tmp, value_len + 1);
+    }
+}
+
+/**
+ * @brief 用http_parser_execute()解析，请求分成split和剩下的两段收到，split为0时一次收到，为-1时逐字节收到
+ * @return 解析成功返回0
+ */
+static int Parser_Run(const Bench_Request_t *request, Bench_Result_t *result, int split)
+{
+    st_http_parser parser;
+    uint16_t len;
+    int8_t ret = HTTP_PARSER_MORE;
+
+    result->content_len = 0;
+    result->keep_alive = 0xFF;
+    result->accept_gzip = 0;
+    result->if_none_match[0] = '\0';
+
+    http_parser_init(&parser, Parser_OnHeader, result);
+    if (split < 0)
+    {
+        for (len = 1; (len <= request->len) && (ret == HTTP_PARSER_MORE); len++)
+        {
+            memcpy(g_bench_buf, request->data, len);
+            ret = http_parser_execute(&parser, g_bench_buf, len);
+        }
+    }
+    else
+    {
+        if (split > 0)
+        {
+            memcpy(g_bench_buf, request->data, split);
+            ret = http_parser_execute(&parser, g_bench_buf, split);
+        }
+        if (ret == HTTP_PARSER_MORE)
+        {
+            memcpy(g_bench_buf, request->data, request->len);
+            ret = http_parser_execute(&parser, g_bench_buf, request->len);
+        }
+    }
+    if (ret != HTTP_PARSER_DONE) return -1;
+
+    if (result->keep_alive == 0xFF) result->keep_alive = (parser.version != 10);
+
+    http_parser_get_request(&parser, g_bench_buf, request->len, &g_bench_request);
+    result->method = g_bench_request.METHOD;
+    strcpy(result->uri, (char *)g_bench_request.URI);
+    get_http_uri_name(g_bench_request.URI, (uint8_t *)result->name);
+    find_http_uri_type(&result->type, (uint8_t *)result->name);
+
+    return 0;
+}
+
+/******************************** 测试 ********************************/
+
+/**
+ * @brief 读入请求文件，#开头的行是注释，%%行分隔请求，空行之前的每行以CRLF结束，空行之后是请求体
+ */
+static int Bench_LoadRequests(const char *path)
+{
+    static char text[BENCH_MAX_REQUEST * BENCH_BUF_SIZE];
+    char line[BENCH_BUF_SIZE];
+    char *data = text;
+    FILE *file = fopen(path, "r");
+    Bench_Request_t *request = NULL;
+    int body = 0;
+    size_t n;
+
+    if (!file)
+    {
+        perror(path);
+        return -1;
+    }
+
+    while (fgets(line, sizeof(line), file))
+    {
+        if (line[0] == '#') continue;
+        n = strcspn(line, "\r\n");
+        line[n] = '\0';
+
+        if (!strcmp(line, "%%"))
+        {
+            request = NULL;
+            continue;
+        }
+        if (!request)
+        {
+            if (g_bench_request_count == BENCH_MAX_REQUEST) break;
+            request = &g_bench_requests[g_bench_request_count++];
+            request->data = data;
+            request->len = 0;
+            body = 0;
+        }
+        if (request->len + n + 2 > BENCH_BUF_SIZE) continue;
+
+        if (body && request->len && (request->data[request->len - 1] != '\n'))
+        {
+            memcpy(data, "\r\n", 2);
+            data += 2;
+            request->len += 2;
+        }
+        memcpy(data, line, n);
+        data += n;
+        request->len += n;
+        if (!body)
+        {
+            memcpy(data, "\r\n", 2);
+            data += 2;
+            request->len += 2;
+            body = (n == 0);
+        }
+    }
+    fclose(file);
+
+    return g_bench_request_count;
+}
+
+static int Bench_Compare(const Bench_Result_t *a, const Bench_Result_t *b)
+{
+    return (a->method != b->method) || (a->type != b->type) || (a->keep_alive != b->keep_alive) ||
+           (a->accept_gzip != b->accept_gzip) || (a->content_len != b->content_len) ||
+           strcmp(a->uri, b->uri) || strcmp(a->name, b->name) || strcmp(a->if_none_match, b->if_none_match);
+}
+
+static double Bench_Seconds(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char *argv[])
+{
+    const char *path = (argc > 1) ? argv[1] : "requests.txt";
+    long iterations = (argc > 2) ? strtol(argv[2], NULL, 10) : 200000;
+    Bench_Result_t legacy, parsed;
+    double start, legacy_time, parser_time, legacy_total = 0, parser_total = 0;
+    int errors = 0;
+    int i, split;
+    long n;
+
+    if (Bench_LoadRequests(path) <= 0) return 1;
+
+    for (i = 0; i < g_bench_request_count; i++)
+    {
+        Legacy_Run(&g_bench_requests[i], &legacy);
+        for (split = -1; split < g_bench_requests[i].len; split++)
+        {
+            if (Parser_Run(&g_bench_requests[i], &parsed, split) || Bench_Compare(&legacy, &parsed))
+            {
+                printf("请求%d 拆分位置%d 结果不一致：%s | %s\n", i + 1, split, legacy.uri, parsed.uri);
+                errors++;
+                break;
+            }
+        }
+    }
+    if (errors) return 1;
+
+    printf("%-24s %6s %12s %12s %8s\n", "请求", "字节", "strstr(ns)", "单次扫描(ns)", "加速");
+    for (i = 0; i < g_bench_request_count; i++)
+    {
+        start = Bench_Seconds();
+        for (n = 0; n < iterations; n++) Legacy_Run(&g_bench_requests[i], &legacy);
+        legacy_time = (Bench_Seconds() - start) / iterations;
+
+        start = Bench_Seconds();
+        for (n = 0; n < iterations; n++) Parser_Run(&g_bench_requests[i], &parsed, 0);
+        parser_time = (Bench_Seconds() - start) / iterations;
+
+        legacy_total += legacy_time;
+        parser_total += parser_time;
+        printf("%-4s %-19.19s %6u %12.1f %12.1f %7.2fx\n", g_bench_method_name[parsed.method], parsed.name,
+               g_bench_requests[i].len, legacy_time * 1e9, parser_time * 1e9, legacy_time / parser_time);
+    }
+    printf("%-24s %6s %12.1f %12.1f %7.2fx\n", "合计", "", legacy_total * 1e9, parser_total * 1e9,
+           legacy_total / parser_total);
+
+    return 0;
+}
\ No newline at end of file
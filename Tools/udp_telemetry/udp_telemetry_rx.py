@@ -0,0 +1,120 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+W5500_UDPStream 数据流接收工具，每秒统计一次丢包和抖动
+
+数据报格式（大端）：
+| magic(2) | sample_size(2) | sample_count(2) | reserved(2) | sequence(4) | timestamp_us(4) | samples... |
+
+用法：
+    python3 udp_telemetry_rx.py --port 9000
+    python3 udp_telemetry_rx.py --port 9000 --group 239.1.2.3
+"""
+
+import argparse
+import socket
+import struct
+import time
+
+HEADER = struct.Struct(">HHHHII")
+MAGIC = 0x544D
+
+
+class StreamStats:
+    def __init__(self):
+        self.expected = None                # 下一个期望的序号
+        self.received = 0                   # 收到的数据报数
+        self.lost = 0                       # 序号跳过的数据报数
+        self.reordered = 0                  # 比期望序号小的数据报数
+        self.samples = 0
+        self.bytes = 0
+        self.jitter = 0.0                   # RFC 3550 到达间隔抖动，单位us
+        self.last_transit = None
+
+    def update(self, sequence, timestamp_us, sample_count, length, arrival_us):
+        self.received += 1
+        self.samples += sample_count
+        self.bytes += length
+
+        if self.expected is None:
+            self.expected = sequence
+        if sequence >= self.expected:
+            self.lost += sequence - self.expected
+            self.expected = sequence + 1
+        else:
+            self.reordered += 1
+            if self.lost > 0:
+                self.lost -= 1              # 迟到的数据报前面已经算作丢失
+
+        # 发送端时间戳每71分钟回绕一次，只使用相邻两次传输时间的差值
+        transit = (arrival_us - timestamp_us) & 0xFFFFFFFF
+        if self.last_transit is not None:
+            d = (transit - self.last_transit) & 0xFFFFFFFF
+            if d >= 0x80000000:
+                d = 0x100000000 - d
+            self.jitter += (d - self.jitter) / 16.0
+        self.last_transit = transit
+
+
+def main():
+    parser = argparse.ArgumentParser(description="W5500 UDP telemetry receiver")
+    parser.add_argument("--port", type=int, default=9000, help="listen port")
+    parser.add_argument("--bind", default="0.0.0.0", help="local address")
+    parser.add_argument("--group", help="multicast group to join")
+    parser.add_argument("--interval", type=float, default=1.0, help="report interval in seconds")
+    args = parser.parse_args()
+
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM, socket.IPPROTO_UDP)
+    sock.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    sock.setsockopt(socket.SOL_SOCKET, socket.SO_RCVBUF, 4 * 1024 * 1024)
+    sock.bind((args.bind, args.port))
+    if args.group:
+        mreq = struct.pack("4s4s", socket.inet_aton(args.group), socket.inet_aton("0.0.0.0"))
+        sock.setsockopt(socket.IPPROTO_IP, socket.IP_ADD_MEMBERSHIP, mreq)
+    sock.settimeout(args.interval)
+
+    stats = {}
+    window = {}
+    bad = 0
+    next_report = time.monotonic() + args.interval
+
+    print("listening on {}:{}{}".format(args.bind, args.port, " group " + args.group if args.group else ""))
+    while True:
+        try:
+            data, addr = sock.recvfrom(65535)
+            arrival_us = int(time.monotonic() * 1000000) & 0xFFFFFFFF
+            if len(data) < HEADER.size:
+                bad += 1
+                continue
+            magic, sample_size, sample_count, _, sequence, timestamp_us = HEADER.unpack_from(data)
+            if magic != MAGIC or HEADER.size + sample_size * sample_count != len(data):
+                bad += 1
+                continue
+            stream = stats.setdefault(addr, StreamStats())
+            stream.update(sequence, timestamp_us, sample_count, len(data), arrival_us)
+        except socket.timeout:
+            pass
+
+        now = time.monotonic()
+        if now < next_report:
+            continue
+        next_report = now + args.interval
+
+        for addr, stream in stats.items():
+            last = window.get(addr, (0, 0, 0))
+            received = stream.received - last[0]
+            samples = stream.samples - last[1]
+            length = stream.bytes - last[2]
+            window[addr] = (stream.received, stream.samples, stream.bytes)
+            total = stream.received + stream.lost
+            loss = 100.0 * stream.lost / total if total else 0.0
+            print("{}:{}  {:6.0f} pkt/s  {:8.0f} samples/s  {:7.1f} kB/s  lost {} ({:.3f}%)  reordered {}  jitter {:.0f} us  bad {}".format(
+                addr[0], addr[1], received / args.interval, samples / args.interval, length / args.interval / 1024,
+                stream.lost, loss, stream.reordered, stream.jitter, bad))
+
+
+if __name__ == "__main__":
+    try:
+        main()
+    except KeyboardInterrupt:
+        pass
@@ -0,0 +1,305 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+W5500吞吐量测试的主机端，配合固件中的W5500_Bench（main.c里NETWORK_BENCHMARK设为1）或者Tools/w5500_sim/sim_bench使用
+
+测试项目：
+    tcp_down    板子发送，主机接收
+    tcp_up      主机发送，板子接收
+    udp_down    板子发送UDP数据报，主机统计丢包
+    udp_up      主机按--udp-rate发送UDP数据报，板子统计收到的字节数
+
+每一项输出板子测得的吞吐量、每次send()/recv()的耗时、SPI总线字节数与有效数据的比值，
+以及按SPI时钟估算的总线占用率。--profiles和--prescalers给出多个值时依次切换测试。
+
+用法：
+    python3 w5500_bench.py --host 192.168.3.210
+    python3 w5500_bench.py --host 127.0.0.1 --profiles default,bulk --prescalers 2,4,8
+    python3 w5500_bench.py --host 127.0.0.1 --tests tcp_down --bytes 4000000 --csv result.csv
+"""
+
+import argparse
+import csv
+import socket
+import struct
+import time
+
+TESTS = ("tcp_down", "tcp_up", "udp_down", "udp_up")
+
+
+class Control:
+    """控制连接，一行命令对应一行应答"""
+
+    def __init__(self, host, port, timeout):
+        self.host = host
+        self.port = port
+        self.timeout = timeout
+        self.sock = None
+        self.buffer = b""
+
+    def connect(self, retry_seconds=10.0):
+        deadline = time.time() + retry_seconds
+        while True:
+            try:
+                self.sock = socket.create_connection((self.host, self.port), timeout=self.timeout)
+                self.sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+                self.buffer = b""
+                return
+            except OSError:
+                if time.time() > deadline:
+                    raise
+                time.sleep(0.2)             # 切换缓冲区方案时板子会关闭所有socket
+
+    def close(self):
+        if self.sock is not None:
+            self.sock.close()
+            self.sock = None
+
+    def send(self, line):
+        self.sock.sendall(line.encode() + b"\n")
+
+    def read_line(self, timeout=None):
+        self.sock.settimeout(timeout if timeout is not None else self.timeout)
+        while b"\n" not in self.buffer:
+            chunk = self.sock.recv(256)
+            if not chunk:
+                raise ConnectionError("控制连接被关闭")
+            self.buffer += chunk
+        line, self.buffer = self.buffer.split(b"\n", 1)
+        return line.decode(errors="replace").strip()
+
+    def command(self, line, expect=None):
+        self.send(line)
+        reply = self.read_line()
+        if expect is not None and not reply.startswith(expect):
+            raise RuntimeError("%s -> %s" % (line, reply))
+        return reply
+
+
+def parse_fields(line):
+    """把 "DONE key=value ..." 解析成字典，数字转换成int"""
+    fields = {}
+    for item in line.split()[1:]:
+        if "=" in item:
+            key, value = item.split("=", 1)
+            fields[key] = int(value) if value.isdigit() else value
+    return fields
+
+
+def wait_done(control, timeout):
+    reply = control.read_line(timeout)
+    if not reply.startswith("DONE"):
+        raise RuntimeError(reply)
+    return parse_fields(reply)
+
+
+def run_tcp_down(control, args):
+    control.command("TCP_TX %d %d" % (args.bytes, args.chunk), "READY")
+    data = socket.create_connection((args.host, args.data_port), timeout=args.timeout)
+    received = 0
+    start = time.time()
+    while received < args.bytes:
+        chunk = data.recv(65536)
+        if not chunk:
+            break
+        received += len(chunk)
+    host_seconds = time.time() - start
+    result = wait_done(control, args.timeout)
+    data.close()
+    result["host_bytes"] = received
+    result["host_seconds"] = host_seconds
+    return result
+
+
+def run_tcp_up(control, args):
+    control.command("TCP_RX %d" % args.bytes, "READY")
+    data = socket.create_connection((args.host, args.data_port), timeout=args.timeout)
+    payload = bytes(range(256)) * 256
+    sent = 0
+    start = time.time()
+    while sent < args.bytes:
+        sent += data.send(payload[:min(len(payload), args.bytes - sent)])
+    result = wait_done(control, args.timeout)
+    host_seconds = time.time() - start
+    data.close()
+    result["host_bytes"] = sent
+    result["host_seconds"] = host_seconds
+    return result
+
+
+def run_udp_down(control, args):
+    receiver = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    receiver.setsockopt(socket.SOL_SOCKET, socket.SO_RCVBUF, 4 * 1024 * 1024)
+    receiver.bind(("", args.udp_port))
+    receiver.settimeout(0.2)
+
+    control.command("UDP_TX %d %d %d" % (args.bytes, args.udp_size, args.udp_port), "READY")
+    sequences = set()
+    received = 0
+    first = last = None
+    result = None
+    control.sock.setblocking(False)
+    while True:
+        try:
+            datagram = receiver.recv(65536)
+            now = time.time()
+            first = first or now
+            last = now
+            received += len(datagram)
+            if len(datagram) >= 4:
+                sequences.add(struct.unpack(">I", datagram[:4])[0])
+            continue
+        except socket.timeout:
+            pass
+        if result is None:
+            try:
+                if b"\n" in control.buffer or control.sock.recv(1, socket.MSG_PEEK):
+                    control.sock.setblocking(True)
+                    result = wait_done(control, args.timeout)
+            except BlockingIOError:
+                pass
+        else:
+            break                           # 板子发送结束后再等一个超时周期，收完路上的数据报
+    receiver.close()
+
+    result["host_bytes"] = received
+    result["host_seconds"] = (last - first) if first and last else 0.0
+    result["lost"] = result.get("sends", 0) - len(sequences)
+    return result
+
+
+def run_udp_up(control, args):
+    control.command("UDP_RX %d" % args.bytes, "READY")
+    sender = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    payload = bytearray(args.udp_size)
+    interval = args.udp_size * 8 / (args.udp_rate * 1e6) if args.udp_rate > 0 else 0.0
+    sent = 0
+    sequence = 0
+    start = time.time()
+    next_send = start
+    while sent < args.bytes:
+        struct.pack_into(">I", payload, 0, sequence)
+        sender.sendto(payload, (args.host, args.data_port))
+        sent += len(payload)
+        sequence += 1
+        if interval:
+            next_send += interval
+            delay = next_send - time.time()
+            if delay > 0:
+                time.sleep(delay)
+    host_seconds = time.time() - start
+    result = wait_done(control, args.timeout)
+    sender.close()
+    result["host_bytes"] = sent
+    result["host_seconds"] = host_seconds
+    result["lost"] = sequence - result.get("sends", 0)
+    return result
+
+
+RUNNERS = {
+    "tcp_down": run_tcp_down,
+    "tcp_up": run_tcp_up,
+    "udp_down": run_udp_down,
+    "udp_up": run_udp_up,
+}
+
+
+def summarize(test, prescaler, result):
+    """计算吞吐量、SPI开销和总线占用率"""
+    board_bytes = result.get("bytes", 0)
+    board_us = result.get("us", 0)
+    spi = result.get("spi", 0)
+    clock = result.get("clock", 0)
+    bus_us = spi * 8 * 1e6 / clock if clock else 0.0
+    return {
+        "profile": result.get("profile", "?"),
+        "prescaler": prescaler,
+        "test": test,
+        "bytes": board_bytes,
+        "board_mbps": board_bytes * 8 / board_us if board_us else 0.0,
+        "host_mbps": result["host_bytes"] * 8 / result["host_seconds"] / 1e6 if result.get("host_seconds") else 0.0,
+        "spi_per_byte": spi / board_bytes if board_bytes else 0.0,
+        "bus_util": bus_us / board_us if board_us else 0.0,
+        "calls": result.get("sends", 0),
+        "busy": result.get("busy", 0),
+        "avg_us": result.get("avg", 0),
+        "max_us": result.get("max", 0),
+        "lost": result.get("lost", 0),
+    }
+
+
+COLUMNS = ("profile", "prescaler", "test", "bytes", "board_mbps", "host_mbps", "spi_per_byte",
+           "bus_util", "calls", "busy", "avg_us", "max_us", "lost")
+
+
+def print_row(row):
+    print("%-8s %4s %-9s %9d %9.2f %9.2f %7.3f %6.1f%% %7d %7d %7d %7d %6d" % (
+        row["profile"], row["prescaler"], row["test"], row["bytes"], row["board_mbps"], row["host_mbps"],
+        row["spi_per_byte"], row["bus_util"] * 100, row["calls"], row["busy"], row["avg_us"], row["max_us"],
+        row["lost"]))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="W5500吞吐量测试")
+    parser.add_argument("--host", required=True, help="板子的IP地址，仿真器用127.0.0.1")
+    parser.add_argument("--port", type=int, default=5201, help="控制端口")
+    parser.add_argument("--data-port", type=int, default=5202, help="数据端口")
+    parser.add_argument("--udp-port", type=int, default=5203, help="udp_down测试中主机接收的端口")
+    parser.add_argument("--tests", default=",".join(TESTS), help="测试项目，逗号分隔")
+    parser.add_argument("--bytes", type=int, default=1000000, help="每项测试传输的字节数")
+    parser.add_argument("--chunk", type=int, default=2048, help="tcp_down每次send()的长度")
+    parser.add_argument("--udp-size", type=int, default=1024, help="UDP数据报长度")
+    parser.add_argument("--udp-rate", type=float, default=5.0, help="udp_up的发送速率，单位Mbit/s，0表示不限速")
+    parser.add_argument("--profiles", default="", help="缓冲区方案，逗号分隔，例如default,bulk,server，默认不切换")
+    parser.add_argument("--prescalers", default="", help="SPI分频系数，逗号分隔，例如2,4,8，默认不切换")
+    parser.add_argument("--timeout", type=float, default=30.0)
+    parser.add_argument("--csv", help="把结果写到CSV文件")
+    args = parser.parse_args()
+
+    tests = [t for t in args.tests.split(",") if t]
+    for test in tests:
+        if test not in RUNNERS:
+            parser.error("未知的测试项目: %s" % test)
+    profiles = [p for p in args.profiles.split(",") if p] or [None]
+    prescalers = [int(p) for p in args.prescalers.split(",") if p] or [None]
+
+    control = Control(args.host, args.port, args.timeout)
+    control.connect()
+    rows = []
+
+    print("%-8s %4s %-9s %9s %9s %9s %7s %7s %7s %7s %7s %7s %6s" % (
+        "profile", "div", "test", "bytes", "board", "host", "spi/B", "bus", "calls", "busy", "avg_us", "max_us", "lost"))
+    print("%-8s %4s %-9s %9s %9s %9s" % ("", "", "", "", "Mbit/s", "Mbit/s"))
+
+    for profile in profiles:
+        if profile is not None:
+            control.command("PROFILE %s" % profile, "OK")
+            control.close()
+            time.sleep(0.3)
+            control.connect()
+            stats = parse_fields(control.command("STATS", "STATS"))
+            if stats.get("profile") != profile:
+                raise RuntimeError("缓冲区方案切换失败: %s" % stats)
+
+        for prescaler in prescalers:
+            if prescaler is not None:
+                control.command("PRESCALER %d" % prescaler, "OK")
+            current = prescaler if prescaler is not None else "-"
+
+            for test in tests:
+                result = RUNNERS[test](control, args)
+                row = summarize(test, current, result)
+                rows.append(row)
+                print_row(row)
+
+    control.close()
+
+    if args.csv:
+        with open(args.csv, "w", newline="") as f:
+            writer = csv.DictWriter(f, fieldnames=COLUMNS)
+            writer.writeheader()
+            writer.writerows(rows)
+
+
+if __name__ == "__main__":
+    main()
\ No newline at end of file
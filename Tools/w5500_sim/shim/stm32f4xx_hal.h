@@ -0,0 +1,208 @@
+#ifndef __STM32F4xx_HAL_H__
+#define __STM32F4xx_HAL_H__
+
+/**
+ * 主机仿真用的HAL替身头文件，只声明W5500驱动、ioLibrary和BSP头文件用到的类型和函数
+ * 
+ * 仿真程序把这个目录放在包含路径的最前面，固件源码不用做任何修改就能在Linux上编译，
+ * SPI和GPIO的访问由sim_hal.c转发给W5500寄存器模型
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef enum
+{
+    HAL_OK       = 0x00U,
+    HAL_ERROR    = 0x01U,
+    HAL_BUSY     = 0x02U,
+    HAL_TIMEOUT  = 0x03U
+} HAL_StatusTypeDef;
+
+typedef enum
+{
+    DMA2_Stream2_IRQn,
+    DMA2_Stream3_IRQn,
+    DMA2_Stream5_IRQn,
+    DMA2_Stream7_IRQn,
+    DMA1_Stream5_IRQn,
+    DMA1_Stream6_IRQn,
+    SPI1_IRQn,
+    USART1_IRQn,
+    USART2_IRQn,
+    EXTI9_5_IRQn,
+    TIM6_DAC_IRQn
+} IRQn_Type;
+
+/* ----------------------------------------------- GPIO ----------------------------------------------- */
+typedef struct
+{
+    uint8_t port;                                                               // 端口号，A=0
+} GPIO_TypeDef;
+
+extern GPIO_TypeDef g_sim_gpio[9];
+
+#define GPIOA                   (&g_sim_gpio[0])
+#define GPIOB                   (&g_sim_gpio[1])
+#define GPIOC                   (&g_sim_gpio[2])
+#define GPIOD                   (&g_sim_gpio[3])
+#define GPIOE                   (&g_sim_gpio[4])
+#define GPIOF                   (&g_sim_gpio[5])
+#define GPIOG                   (&g_sim_gpio[6])
+
+typedef enum
+{
+    GPIO_PIN_RESET = 0,
+    GPIO_PIN_SET
+} GPIO_PinState;
+
+typedef struct
+{
+    uint32_t Pin;
+    uint32_t Mode;
+    uint32_t Pull;
+    uint32_t Speed;
+    uint32_t Alternate;
+} GPIO_InitTypeDef;
+
+#define GPIO_PIN_0              ((uint16_t)0x0001)
+#define GPIO_PIN_1              ((uint16_t)0x0002)
+#define GPIO_PIN_2              ((uint16_t)0x0004)
+#define GPIO_PIN_3              ((uint16_t)0x0008)
+#define GPIO_PIN_4              ((uint16_t)0x0010)
+#define GPIO_PIN_5              ((uint16_t)0x0020)
+#define GPIO_PIN_6              ((uint16_t)0x0040)
+#define GPIO_PIN_7              ((uint16_t)0x0080)
+#define GPIO_PIN_8              ((uint16_t)0x0100)
+#define GPIO_PIN_9              ((uint16_t)0x0200)
+#define GPIO_PIN_10             ((uint16_t)0x0400)
+
+#define GPIO_MODE_INPUT         0x00000000U
+#define GPIO_MODE_OUTPUT_PP     0x00000001U
+#define GPIO_MODE_AF_PP         0x00000002U
+#define GPIO_MODE_IT_FALLING    0x10210000U
+
+#define GPIO_NOPULL             0x00000000U
+#define GPIO_PULLUP             0x00000001U
+#define GPIO_PULLDOWN           0x00000002U
+
+#define GPIO_SPEED_FREQ_LOW     0x00000000U
+#define GPIO_SPEED_FREQ_HIGH    0x00000002U
+
+#define __HAL_RCC_GPIOA_CLK_ENABLE()    do {} while (0)
+#define __HAL_RCC_GPIOD_CLK_ENABLE()    do {} while (0)
+#define __HAL_RCC_GPIOF_CLK_ENABLE()    do {} while (0)
+
+/* ----------------------------------------------- DMA ----------------------------------------------- */
+typedef struct
+{
+    uint8_t stream;
+} DMA_Stream_TypeDef;
+
+extern DMA_Stream_TypeDef g_sim_dma_stream[16];
+
+#define DMA1_Stream5            (&g_sim_dma_stream[5])
+#define DMA1_Stream6            (&g_sim_dma_stream[6])
+#define DMA2_Stream0            (&g_sim_dma_stream[8])
+#define DMA2_Stream2            (&g_sim_dma_stream[10])
+#define DMA2_Stream3            (&g_sim_dma_stream[11])
+#define DMA2_Stream5            (&g_sim_dma_stream[13])
+#define DMA2_Stream7            (&g_sim_dma_stream[15])
+
+#define DMA_CHANNEL_3           0x06000000U
+#define DMA_CHANNEL_4           0x08000000U
+#define DMA_NORMAL              0x00000000U
+#define DMA_CIRCULAR            0x00000100U
+#define DMA_PRIORITY_LOW        0x00000000U
+#define DMA_PRIORITY_MEDIUM     0x00010000U
+#define DMA_PRIORITY_HIGH       0x00020000U
+#define DMA_PRIORITY_VERY_HIGH  0x00030000U
+
+typedef struct
+{
+    DMA_Stream_TypeDef *Instance;
+    void *Parent;
+} DMA_HandleTypeDef;
+
+#define __HAL_LINKDMA(__HANDLE__, __PPP_DMA_FIELD__, __DMA_HANDLE__)   \
+    do {                                                                \
+        (__HANDLE__)->__PPP_DMA_FIELD__ = &(__DMA_HANDLE__);            \
+        (__DMA_HANDLE__).Parent = (__HANDLE__);                         \
+    } while (0)
+
+/* ----------------------------------------------- SPI ----------------------------------------------- */
+typedef struct
+{
+    uint32_t BaudRatePrescaler;
+} SPI_InitTypeDef;
+
+typedef struct
+{
+    void *Instance;
+    SPI_InitTypeDef Init;
+    DMA_HandleTypeDef *hdmatx;
+    DMA_HandleTypeDef *hdmarx;
+} SPI_HandleTypeDef;
+
+#define SPI_BAUDRATEPRESCALER_2     0x00000000U
+#define SPI_BAUDRATEPRESCALER_4     0x00000008U
+#define SPI_BAUDRATEPRESCALER_8     0x00000010U
+#define SPI_BAUDRATEPRESCALER_16    0x00000018U
+#define SPI_BAUDRATEPRESCALER_32    0x00000020U
+#define SPI_BAUDRATEPRESCALER_64    0x00000028U
+#define SPI_BAUDRATEPRESCALER_128   0x00000030U
+#define SPI_BAUDRATEPRESCALER_256   0x00000038U
+
+/* ----------------------------------------------- UART ----------------------------------------------- */
+typedef struct
+{
+    uint8_t index;
+} USART_TypeDef;
+
+typedef struct
+{
+    USART_TypeDef *Instance;
+} UART_HandleTypeDef;
+
+/* ----------------------------------------------- SD ----------------------------------------------- */
+typedef struct
+{
+    uint32_t BlockNbr;
+    uint32_t BlockSize;
+} HAL_SD_CardInfoTypeDef;
+
+typedef struct
+{
+    void *Instance;
+    HAL_SD_CardInfoTypeDef SdCard;
+} SD_HandleTypeDef;
+
+/* ----------------------------------------------- 函数 ----------------------------------------------- */
+uint32_t HAL_GetTick(void);
+void HAL_Delay(uint32_t Delay);
+
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority);
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn);
+void HAL_NVIC_DisableIRQ(IRQn_Type IRQn);
+
+void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init);
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState);
+
+uint32_t HAL_RCC_GetPCLK2Freq(void);
+
+HAL_StatusTypeDef HAL_SPI_Init(SPI_HandleTypeDef *hspi);
+HAL_StatusTypeDef HAL_SPI_Transmit(SPI_HandleTypeDef *hspi, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_SPI_Receive(SPI_HandleTypeDef *hspi, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_SPI_Transmit_DMA(SPI_HandleTypeDef *hspi, uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_SPI_Receive_DMA(SPI_HandleTypeDef *hspi, uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_SPI_Abort(SPI_HandleTypeDef *hspi);
+void HAL_SPI_IRQHandler(SPI_HandleTypeDef *hspi);
+void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef *hspi);
+void HAL_SPI_RxCpltCallback(SPI_HandleTypeDef *hspi);
+void HAL_SPI_TxRxCpltCallback(SPI_HandleTypeDef *hspi);
+void HAL_SPI_ErrorCallback(SPI_HandleTypeDef *hspi);
+
+void HAL_DMA_IRQHandler(DMA_HandleTypeDef *hdma);
+
+#endif // !__STM32F4xx_HAL_H__
\ No newline at end of file
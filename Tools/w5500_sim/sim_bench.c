@@ -0,0 +1,50 @@
+/**
+ * 在仿真器上运行吞吐量测试固件，使用g_w5500_net_info里的静态地址
+ * 
+ * 用法：
+ *     make && ./sim_bench
+ *     python3 ../w5500_bench/w5500_bench.py --host 127.0.0.1
+ * 
+ * 仿真器上的吞吐量只反映主机的速度，SPI字节数和每个有效字节的SPI开销与板子上一致，
+ * SPI时钟按分频系数换算，用来估计板子上的SPI总线占用时间。
+ */
+
+#include <signal.h>
+
+#include "w5500/w5500_bench.h"
+
+#include "w5500_sim.h"
+
+static volatile sig_atomic_t g_sim_running = 1;
+
+static void Sim_Stop(int signal_number)
+{
+    (void)signal_number;
+    g_sim_running = 0;
+}
+
+int main(void)
+{
+    SPI_HandleTypeDef spi_handle = {0};
+
+    signal(SIGINT, Sim_Stop);
+    signal(SIGTERM, Sim_Stop);
+    setvbuf(stdout, NULL, _IONBF, 0);
+
+    spi_handle.Init.BaudRatePrescaler = SPI_BAUDRATEPRESCALER_4;                // 和main.c中的BSP_SPI_Init()一致
+
+    W5500_Sim_Init();
+    W5500_Init(&spi_handle);
+    wizchip_init(NULL, NULL);
+    wizchip_setnetinfo(&g_w5500_net_info);
+    PrintInfo();
+
+    W5500_Bench_Start();
+
+    while (g_sim_running)
+    {
+        W5500_Bench_Process();
+    }
+
+    return 0;
+}
\ No newline at end of file
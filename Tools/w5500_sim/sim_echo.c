@@ -0,0 +1,126 @@
+/**
+ * 在仿真器上运行和Application/Src/main.c一样的网络程序：DHCP + 8080端口的TCP回显服务器
+ * 
+ * 用法：
+ *     make && ./sim_echo              使用DHCP
+ *     make && ./sim_echo -s           使用g_w5500_net_info里的静态地址
+ *     nc 127.0.0.1 8080
+ * 
+ * DHCP使用68/67端口，映射到主机的10068/10067，没有DHCP服务器时要等重试超时才回退到静态地址，
+ * 在这之前SIPR为0，socket()会失败，回显服务器不会开始监听。
+ * Ctrl+C退出时打印SPI统计信息。
+ */
+
+#include <signal.h>
+#include <string.h>
+
+#include "w5500/w5500_event.h"
+#include "w5500/w5500_tcp_server.h"
+#include "w5500/w5500_dhcp.h"
+
+#include "w5500_sim.h"
+
+uint16_t Echo_Receive(uint8_t socket_index, const W5500_RxView_t *view);
+void Network_Event(W5500_DHCPEvent_t event);
+
+const W5500_TCPServerHandler_t g_echo_handler = 
+{
+    .on_connect = NULL,
+    .on_receive = Echo_Receive,
+    .on_disconnect = NULL
+};
+
+static volatile sig_atomic_t g_sim_running = 1;
+
+static void Sim_Stop(int signal_number)
+{
+    (void)signal_number;
+    g_sim_running = 0;
+}
+
+int main(int argc, char *argv[])
+{
+    SPI_HandleTypeDef spi_handle = {0};
+    W5500_SimStats_t stats;
+    uint32_t second_tick = 0;
+
+    signal(SIGINT, Sim_Stop);
+    signal(SIGTERM, Sim_Stop);
+    setvbuf(stdout, NULL, _IONBF, 0);
+
+    W5500_Sim_Init();
+    W5500_Init(&spi_handle);
+    wizchip_init(NULL, NULL);                                                   // 缓冲区默认
+
+    W5500_Event_Init();
+    if (argc > 1 && strcmp(argv[1], "-s") == 0)
+    {
+        wizchip_setnetinfo(&g_w5500_net_info);
+        PrintInfo();
+    }
+    else
+    {
+        W5500_DHCP_Start(0, Network_Event);
+    }
+    W5500_TCPServer_Listen(8080, 1, W5500_SOCKET_COUNT - 1, &g_echo_handler);
+
+    second_tick = HAL_GetTick();
+    while (g_sim_running)
+    {
+        W5500_Event_Process();
+        W5500_DHCP_Process();
+        W5500_TCPServer_Process();
+        W5500_Coalesce_Process();
+
+        // 代替TIM6的1秒中断
+        if (HAL_GetTick() - second_tick >= 1000)
+        {
+            second_tick += 1000;
+            DHCP_time_handler();
+        }
+    }
+
+    W5500_Sim_GetStats(&stats);
+    printf("\r\nSPI frames: %llu, SPI bytes: %llu, TX payload: %llu, RX payload: %llu, commands: %llu\r\n",
+           (unsigned long long)stats.spi_frames, (unsigned long long)stats.spi_bytes,
+           (unsigned long long)stats.tx_payload, (unsigned long long)stats.rx_payload,
+           (unsigned long long)stats.commands);
+
+    return 0;
+}
+
+/**
+ * @brief 回显服务器的接收处理函数
+ * 
+ * @param socket_index socket索引
+ * @param view 接收到的数据
+ * @return uint16_t 消费的字节数
+ */
+uint16_t Echo_Receive(uint8_t socket_index, const W5500_RxView_t *view)
+{
+    uint16_t consumed = 0;
+
+    for (uint8_t i = 0; i < 2 && view->length[i] > 0; i++)
+    {
+        if (W5500_TCPServer_Send(socket_index, view->data[i], view->length[i]) != view->length[i])
+        {
+            break;
+        }
+        consumed += view->length[i];
+    }
+
+    return consumed;
+}
+
+/**
+ * @brief 网络地址变化的回调函数
+ * 
+ * @param event 事件
+ */
+void Network_Event(W5500_DHCPEvent_t event)
+{
+    if (event != W5500_DHCP_EVENT_CONFLICT)
+    {
+        PrintInfo();
+    }
+}
\ No newline at end of file
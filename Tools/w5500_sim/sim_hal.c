@@ -0,0 +1,200 @@
+#include <stdio.h>
+#include <time.h>
+
+#include "stm32f4xx_hal.h"
+
+#include "bsp_dma.h"
+#include "bsp_systick.h"
+#include "led/led.h"
+#include "w5500/w5500_device.h"
+
+#include "w5500_sim.h"
+
+/**
+ * HAL和BSP函数的主机实现
+ * 
+ * W5500的片选、复位、INT引脚和SPI收发转发给w5500_sim.c，DMA传输同步完成后直接调用完成回调，
+ * 其余外设只保留空函数
+ */
+
+GPIO_TypeDef g_sim_gpio[9] = {{0}, {1}, {2}, {3}, {4}, {5}, {6}, {7}, {8}};
+DMA_Stream_TypeDef g_sim_dma_stream[16];
+
+static void W5500_SimHal_Sleep(uint32_t us)
+{
+    struct timespec duration = {us / 1000000, (long)(us % 1000000) * 1000};
+
+    nanosleep(&duration, NULL);
+}
+
+static uint64_t W5500_SimHal_Micros(void)
+{
+    static uint64_t start = 0;
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    if (start == 0)
+    {
+        start = (uint64_t)now.tv_sec * 1000000 + (uint64_t)now.tv_nsec / 1000;
+    }
+    return (uint64_t)now.tv_sec * 1000000 + (uint64_t)now.tv_nsec / 1000 - start;
+}
+
+uint32_t HAL_GetTick(void)
+{
+    return (uint32_t)(W5500_SimHal_Micros() / 1000);
+}
+
+void HAL_Delay(uint32_t Delay)
+{
+    W5500_SimHal_Sleep(Delay * 1000);
+}
+
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority)
+{
+    (void)IRQn;
+    (void)PreemptPriority;
+    (void)SubPriority;
+}
+
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn)
+{
+    (void)IRQn;
+}
+
+void HAL_NVIC_DisableIRQ(IRQn_Type IRQn)
+{
+    (void)IRQn;
+}
+
+void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init)
+{
+    (void)GPIOx;
+    (void)GPIO_Init;
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
+{
+    if (GPIOx == W5500_INTERRUPT_GPIO_PORT && GPIO_Pin == W5500_INTERRUPT_GPIO_PIN)
+    {
+        return W5500_Sim_GetInterruptPin() ? GPIO_PIN_SET : GPIO_PIN_RESET;
+    }
+    return GPIO_PIN_RESET;
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState)
+{
+    if (GPIOx == W5500_CS_GPIO_PORT && GPIO_Pin == W5500_CS_GPIO_PIN)
+    {
+        PinState == GPIO_PIN_RESET ? W5500_Sim_Select() : W5500_Sim_Deselect();
+    }
+    else if (GPIOx == W5500_RESET_GPIO_PORT && GPIO_Pin == W5500_RESET_GPIO_PIN && PinState == GPIO_PIN_RESET)
+    {
+        W5500_Sim_Reset();
+    }
+}
+
+/**
+ * @note 和板子一样按168MHz系统时钟、APB2二分频计算，SPI时钟只用于统计，不影响仿真速度
+ */
+uint32_t HAL_RCC_GetPCLK2Freq(void)
+{
+    return 84000000;
+}
+
+HAL_StatusTypeDef HAL_SPI_Init(SPI_HandleTypeDef *hspi)
+{
+    (void)hspi;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_SPI_Transmit(SPI_HandleTypeDef *hspi, uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+    (void)hspi;
+    (void)Timeout;
+    W5500_Sim_Transfer(pData, NULL, Size);
+    return HAL_OK;
+}
+
+/**
+ * @note 和真实的全双工主机一样，把缓冲区原来的内容当作哑数据发出去
+ */
+HAL_StatusTypeDef HAL_SPI_Receive(SPI_HandleTypeDef *hspi, uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+    (void)hspi;
+    (void)Timeout;
+    W5500_Sim_Transfer(pData, pData, Size);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_SPI_Transmit_DMA(SPI_HandleTypeDef *hspi, uint8_t *pData, uint16_t Size)
+{
+    W5500_Sim_Transfer(pData, NULL, Size);
+    HAL_SPI_TxCpltCallback(hspi);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_SPI_Receive_DMA(SPI_HandleTypeDef *hspi, uint8_t *pData, uint16_t Size)
+{
+    W5500_Sim_Transfer(pData, pData, Size);
+    HAL_SPI_RxCpltCallback(hspi);                                               // 主机模式下借用TransmitReceive_DMA，但状态是BUSY_RX，完成时调用RxCplt
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_SPI_Abort(SPI_HandleTypeDef *hspi)
+{
+    (void)hspi;
+    return HAL_OK;
+}
+
+void HAL_SPI_IRQHandler(SPI_HandleTypeDef *hspi)
+{
+    (void)hspi;
+}
+
+void HAL_DMA_IRQHandler(DMA_HandleTypeDef *hdma)
+{
+    (void)hdma;
+}
+
+void BSP_DMA_MemoryToPeripheral_Init(DMA_HandleTypeDef *hdma, DMA_Stream_TypeDef *dma_stream, uint32_t channel, uint8_t dataLength, uint32_t mode, uint32_t priority)
+{
+    (void)channel;
+    (void)dataLength;
+    (void)mode;
+    (void)priority;
+    hdma->Instance = dma_stream;
+}
+
+void BSP_DMA_PeripheralToMemory_Init(DMA_HandleTypeDef *hdma, DMA_Stream_TypeDef *dma_stream, uint32_t channel, uint8_t dataLength, uint32_t mode,  uint32_t priority)
+{
+    (void)channel;
+    (void)dataLength;
+    (void)mode;
+    (void)priority;
+    hdma->Instance = dma_stream;
+}
+
+void Delay_Init(void)
+{
+}
+
+void Delay_us(uint32_t us)
+{
+    W5500_SimHal_Sleep(us);
+}
+
+void Delay_ms(uint32_t ms)
+{
+    W5500_SimHal_Sleep(ms * 1000);
+}
+
+uint32_t SysTick_GetMicros(void)
+{
+    return (uint32_t)W5500_SimHal_Micros();
+}
+
+void LED_SetStatus(GPIO_TypeDef *LED_Port, uint16_t LED_Pin, LED_State status)
+{
+    printf("LED P%c pin 0x%04X %s\r\n", 'A' + LED_Port->port, LED_Pin, status == LED_ON ? "ON" : "OFF");
+}
\ No newline at end of file
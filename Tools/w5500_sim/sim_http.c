@@ -0,0 +1,69 @@
+/**
+ * 在仿真器上运行ioLibrary的httpServer，socket 0~3处理80端口的请求
+ * 
+ * 用法：
+ *     make && ./sim_http
+ *     curl "http://127.0.0.1:10080/index.html?action=1"
+ * 
+ * 80端口映射到主机的10080，可以用W5500_SIM_PORT_OFFSET修改偏移。
+ * 没有注册的页面从SD卡镜像（默认sdcard.img，见sim_sdcard.c）的/www目录读取：
+ *     curl -o dashboard.bin http://127.0.0.1:10080/dashboard.bin
+ * 上传的文件写到SD卡镜像的/upload目录：
+ *     curl -F file=@firmware.bin http://127.0.0.1:10080/api/upload
+ */
+
+#include <signal.h>
+
+#include "w5500/w5500_device.h"
+#include "w5500/w5500_web_server.h"
+
+#include "w5500_sim.h"
+
+static uint8_t g_sim_http_socket_list[] = {0, 1, 2, 3};
+
+static volatile sig_atomic_t g_sim_running = 1;
+
+static void Sim_Stop(int signal_number)
+{
+    (void)signal_number;
+    g_sim_running = 0;
+}
+
+int main(void)
+{
+    SPI_HandleTypeDef spi_handle = {0};
+    W5500_SimStats_t stats;
+    uint32_t second_tick = 0;
+
+    signal(SIGINT, Sim_Stop);
+    signal(SIGTERM, Sim_Stop);
+    setvbuf(stdout, NULL, _IONBF, 0);
+
+    W5500_Sim_Init();
+    W5500_Init(&spi_handle);
+    wizchip_init(NULL, NULL);
+    wizchip_setnetinfo(&g_w5500_net_info);
+    PrintInfo();
+
+    W5500_WebServer_Init(g_sim_http_socket_list, sizeof(g_sim_http_socket_list), NULL, NULL);
+
+    second_tick = HAL_GetTick();
+    while (g_sim_running)
+    {
+        W5500_WebServer_Start();
+
+        if (HAL_GetTick() - second_tick >= 1000)
+        {
+            second_tick += 1000;
+            httpServer_time_handler();
+        }
+    }
+
+    W5500_Sim_GetStats(&stats);
+    printf("\r\nSPI frames: %llu, SPI bytes: %llu, TX payload: %llu, RX payload: %llu, commands: %llu\r\n",
+           (unsigned long long)stats.spi_frames, (unsigned long long)stats.spi_bytes,
+           (unsigned long long)stats.tx_payload, (unsigned long long)stats.rx_payload,
+           (unsigned long long)stats.commands);
+
+    return 0;
+}
\ No newline at end of file
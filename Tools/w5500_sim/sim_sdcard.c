@@ -0,0 +1,64 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "sdcard/sdcard.h"
+
+/**
+ * SD卡驱动的主机实现，diskio.c读写的扇区转发到一个磁盘镜像文件
+ * 
+ * 镜像文件由环境变量W5500_SIM_SDCARD指定，默认是当前目录下的sdcard.img，可以这样制作：
+ *     mkfs.vfat -C sdcard.img 65536
+ *     mcopy -i sdcard.img -s www ::/
+ */
+
+#define SIM_SDCARD_BLOCK_SIZE   512
+
+SD_HandleTypeDef g_sd_handler;
+
+static FILE *g_sim_sdcard_file;
+
+uint8_t SD_Init(void)
+{
+    const char *path = getenv("W5500_SIM_SDCARD");
+    long size = 0;
+
+    if (g_sim_sdcard_file != NULL)
+    {
+        return 0;
+    }
+
+    g_sim_sdcard_file = fopen(path ? path : "sdcard.img", "r+b");
+    if (g_sim_sdcard_file == NULL)
+    {
+        return 1;
+    }
+
+    fseek(g_sim_sdcard_file, 0, SEEK_END);
+    size = ftell(g_sim_sdcard_file);
+    g_sd_handler.SdCard.BlockSize = SIM_SDCARD_BLOCK_SIZE;
+    g_sd_handler.SdCard.BlockNbr = (uint32_t)(size / SIM_SDCARD_BLOCK_SIZE);
+
+    return 0;
+}
+
+uint8_t SD_ReadData(SD_HandleTypeDef *hsd, uint32_t blockAddress, uint32_t blockCount, uint8_t *buffer)
+{
+    if (g_sim_sdcard_file == NULL || blockAddress + blockCount > hsd->SdCard.BlockNbr)
+    {
+        return 1;
+    }
+
+    fseek(g_sim_sdcard_file, (long)blockAddress * SIM_SDCARD_BLOCK_SIZE, SEEK_SET);
+    return fread(buffer, SIM_SDCARD_BLOCK_SIZE, blockCount, g_sim_sdcard_file) == blockCount ? 0 : 1;
+}
+
+uint8_t SD_WriteData(SD_HandleTypeDef *hsd, uint32_t blockAddress, uint32_t blockCount, uint8_t *buffer)
+{
+    if (g_sim_sdcard_file == NULL || blockAddress + blockCount > hsd->SdCard.BlockNbr)
+    {
+        return 1;
+    }
+
+    fseek(g_sim_sdcard_file, (long)blockAddress * SIM_SDCARD_BLOCK_SIZE, SEEK_SET);
+    return fwrite(buffer, SIM_SDCARD_BLOCK_SIZE, blockCount, g_sim_sdcard_file) == blockCount ? 0 : 1;
+}
\ No newline at end of file
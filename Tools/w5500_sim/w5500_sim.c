@@ -0,0 +1,1078 @@
+#define _GNU_SOURCE                                                             // accept4()
+
+#include "w5500_sim.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <poll.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+// 通用寄存器地址
+#define SIM_MR                  0x00
+#define SIM_SIPR                0x0F
+#define SIM_IR                  0x15
+#define SIM_IMR                 0x16
+#define SIM_SIR                 0x17
+#define SIM_SIMR                0x18
+#define SIM_RTR                 0x19
+#define SIM_RCR                 0x1B
+#define SIM_PHYCFGR             0x2E
+#define SIM_VERSIONR            0x39
+#define SIM_COMMON_SIZE         0x40
+
+// socket寄存器地址
+#define SIM_Sn_MR               0x00
+#define SIM_Sn_CR               0x01
+#define SIM_Sn_IR               0x02
+#define SIM_Sn_SR               0x03
+#define SIM_Sn_PORT             0x04
+#define SIM_Sn_DHAR             0x06
+#define SIM_Sn_DIPR             0x0C
+#define SIM_Sn_DPORT            0x10
+#define SIM_Sn_TTL              0x16
+#define SIM_Sn_RXBUF_SIZE       0x1E
+#define SIM_Sn_TXBUF_SIZE       0x1F
+#define SIM_Sn_TX_FSR           0x20
+#define SIM_Sn_TX_RD            0x22
+#define SIM_Sn_TX_WR            0x24
+#define SIM_Sn_RX_RSR           0x26
+#define SIM_Sn_RX_RD            0x28
+#define SIM_Sn_RX_WR            0x2A
+#define SIM_Sn_IMR              0x2C
+#define SIM_Sn_FRAG             0x2D
+#define SIM_SOCKET_REG_SIZE     0x30
+
+// Sn_CR命令
+#define SIM_CMD_OPEN            0x01
+#define SIM_CMD_LISTEN          0x02
+#define SIM_CMD_CONNECT         0x04
+#define SIM_CMD_DISCON          0x08
+#define SIM_CMD_CLOSE           0x10
+#define SIM_CMD_SEND            0x20
+#define SIM_CMD_SEND_MAC        0x21
+#define SIM_CMD_SEND_KEEP       0x22
+#define SIM_CMD_RECV            0x40
+
+// Sn_SR状态
+#define SIM_SOCK_CLOSED         0x00
+#define SIM_SOCK_INIT           0x13
+#define SIM_SOCK_LISTEN         0x14
+#define SIM_SOCK_SYNSENT        0x15
+#define SIM_SOCK_ESTABLISHED    0x17
+#define SIM_SOCK_FIN_WAIT       0x18
+#define SIM_SOCK_CLOSE_WAIT     0x1C
+#define SIM_SOCK_UDP            0x22
+
+// Sn_IR中断位
+#define SIM_IR_CON              0x01
+#define SIM_IR_DISCON           0x02
+#define SIM_IR_RECV             0x04
+#define SIM_IR_TIMEOUT          0x08
+#define SIM_IR_SENDOK           0x10
+
+#define SIM_PROTOCOL_TCP        0x01
+#define SIM_PROTOCOL_UDP        0x02
+
+#define SIM_UDP_HEADER_SIZE     8                                               // UDP模式下RX缓冲区里每个数据报前面的IP(4)、端口(2)、长度(2)
+#define SIM_SEND_TIMEOUT_MS     1000
+
+typedef struct W5500_SimSocket_t
+{
+    int fd;                                                                     // TCP连接或者UDP的主机socket
+    int8_t listener;                                                            // LISTEN状态下使用的监听器，-1表示没有
+    uint8_t reg[SIM_SOCKET_REG_SIZE];                                           // socket寄存器
+    uint8_t tx[W5500_SIM_BUFFER_SIZE];                                          // TX缓冲区
+    uint8_t rx[W5500_SIM_BUFFER_SIZE];                                          // RX缓冲区
+} W5500_SimSocket_t;
+
+// 同一个端口上的LISTEN socket共用一个主机监听socket，新连接交给其中一个，和W5500的行为一致
+typedef struct W5500_SimListener_t
+{
+    int fd;
+    uint16_t port;                                                              // 仿真芯片上的端口
+    uint8_t users;                                                              // 使用这个监听器的socket个数
+} W5500_SimListener_t;
+
+typedef struct W5500_Sim_t
+{
+    uint8_t common[SIM_COMMON_SIZE];                                            // 通用寄存器
+    W5500_SimSocket_t socket[W5500_SIM_SOCKET_COUNT];
+    W5500_SimListener_t listener[W5500_SIM_SOCKET_COUNT];
+
+    uint8_t selected;                                                           // 片选是否有效
+    uint8_t header[3];                                                          // 地址(2) + 控制字节(1)
+    uint8_t header_length;
+    uint16_t address;                                                           // 数据阶段的当前地址，每个字节自增
+
+    struct in_addr peer;                                                        // 所有目标地址都转发到这个主机地址
+    uint16_t port_offset;
+
+    W5500_SimStats_t stats;
+} W5500_Sim_t;
+
+static W5500_Sim_t g_w5500_sim;
+static uint8_t g_w5500_sim_scratch[W5500_SIM_BUFFER_SIZE];
+
+static uint16_t W5500_Sim_Get16(const uint8_t *data)
+{
+    return (uint16_t)((data[0] << 8) | data[1]);
+}
+
+static uint32_t W5500_Sim_Get32(const uint8_t *data)
+{
+    return ((uint32_t)W5500_Sim_Get16(data) << 16) | W5500_Sim_Get16(data + 2);
+}
+
+static void W5500_Sim_Set16(uint8_t *data, uint16_t value)
+{
+    data[0] = (uint8_t)(value >> 8);
+    data[1] = (uint8_t)value;
+}
+
+/**
+ * @brief 1024以下的端口加上偏移，避免仿真程序需要root权限
+ * 
+ * @param port 仿真芯片上的端口
+ * @return uint16_t 主机上的端口
+ */
+static uint16_t W5500_Sim_MapPort(uint16_t port)
+{
+    return port < 1024 ? (uint16_t)(port + g_w5500_sim.port_offset) : port;
+}
+
+static uint16_t W5500_Sim_UnmapPort(uint16_t port)
+{
+    if (port >= g_w5500_sim.port_offset && port < g_w5500_sim.port_offset + 1024)
+    {
+        return (uint16_t)(port - g_w5500_sim.port_offset);
+    }
+    return port;
+}
+
+static uint16_t W5500_Sim_TxSize(W5500_SimSocket_t *sock)
+{
+    uint8_t kb = sock->reg[SIM_Sn_TXBUF_SIZE];
+    return kb > 16 ? W5500_SIM_BUFFER_SIZE : (uint16_t)(kb * 1024);
+}
+
+static uint16_t W5500_Sim_RxSize(W5500_SimSocket_t *sock)
+{
+    uint8_t kb = sock->reg[SIM_Sn_RXBUF_SIZE];
+    return kb > 16 ? W5500_SIM_BUFFER_SIZE : (uint16_t)(kb * 1024);
+}
+
+static uint16_t W5500_Sim_TxFree(W5500_SimSocket_t *sock)
+{
+    uint16_t used = W5500_Sim_Get16(&sock->reg[SIM_Sn_TX_WR]) - W5500_Sim_Get16(&sock->reg[SIM_Sn_TX_RD]);
+    uint16_t size = W5500_Sim_TxSize(sock);
+
+    return used >= size ? 0 : size - used;
+}
+
+static uint16_t W5500_Sim_RxUsed(W5500_SimSocket_t *sock)
+{
+    return W5500_Sim_Get16(&sock->reg[SIM_Sn_RX_WR]) - W5500_Sim_Get16(&sock->reg[SIM_Sn_RX_RD]);
+}
+
+static uint16_t W5500_Sim_RxFree(W5500_SimSocket_t *sock)
+{
+    uint16_t used = W5500_Sim_RxUsed(sock);
+    uint16_t size = W5500_Sim_RxSize(sock);
+
+    return used >= size ? 0 : size - used;
+}
+
+/**
+ * @brief 把数据写到RX缓冲区的写指针处，写指针按缓冲区大小回绕
+ * 
+ * @param sock socket
+ * @param data 数据
+ * @param length 长度，调用者保证不超过剩余空间
+ */
+static void W5500_Sim_RxWrite(W5500_SimSocket_t *sock, const uint8_t *data, uint16_t length)
+{
+    uint16_t mask = W5500_Sim_RxSize(sock) - 1;
+    uint16_t pointer = W5500_Sim_Get16(&sock->reg[SIM_Sn_RX_WR]);
+
+    for (uint16_t i = 0; i < length; i++)
+    {
+        sock->rx[(uint16_t)(pointer + i) & mask] = data[i];
+    }
+    W5500_Sim_Set16(&sock->reg[SIM_Sn_RX_WR], pointer + length);
+}
+
+static int W5500_Sim_Bind(int fd, uint16_t port)
+{
+    struct sockaddr_in address = {0};
+    int option = 1;
+
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &option, sizeof(option));
+
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(W5500_Sim_MapPort(port));
+
+    if (bind(fd, (struct sockaddr *)&address, sizeof(address)) < 0)
+    {
+        fprintf(stderr, "w5500_sim: bind %u failed: %s\n", ntohs(address.sin_port), strerror(errno));
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief socket不再监听，最后一个使用者离开时关闭主机监听socket
+ * 
+ * @param sock socket
+ */
+static void W5500_Sim_Unlisten(W5500_SimSocket_t *sock)
+{
+    W5500_SimListener_t *listener = NULL;
+
+    if (sock->listener < 0)
+    {
+        return;
+    }
+
+    listener = &g_w5500_sim.listener[sock->listener];
+    sock->listener = -1;
+    if (--listener->users == 0)
+    {
+        close(listener->fd);
+        listener->fd = -1;
+    }
+}
+
+/**
+ * @brief 找到端口对应的监听器，没有就新建一个
+ * 
+ * @param port 仿真芯片上的端口
+ * @return int8_t 监听器索引，-1表示失败
+ */
+static int8_t W5500_Sim_FindListener(uint16_t port)
+{
+    W5500_SimListener_t *listener = NULL;
+    int8_t free_index = -1;
+
+    for (int8_t i = 0; i < W5500_SIM_SOCKET_COUNT; i++)
+    {
+        listener = &g_w5500_sim.listener[i];
+        if (listener->users > 0 && listener->port == port)
+        {
+            listener->users++;
+            return i;
+        }
+        if (listener->users == 0 && free_index < 0)
+        {
+            free_index = i;
+        }
+    }
+
+    if (free_index < 0)
+    {
+        return -1;
+    }
+
+    listener = &g_w5500_sim.listener[free_index];
+    listener->fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    if (W5500_Sim_Bind(listener->fd, port) < 0 || listen(listener->fd, W5500_SIM_SOCKET_COUNT) < 0)
+    {
+        close(listener->fd);
+        listener->fd = -1;
+        return -1;
+    }
+    listener->port = port;
+    listener->users = 1;
+    return free_index;
+}
+
+static void W5500_Sim_CloseHost(W5500_SimSocket_t *sock)
+{
+    if (sock->fd >= 0)
+    {
+        close(sock->fd);
+        sock->fd = -1;
+    }
+    W5500_Sim_Unlisten(sock);
+}
+
+static void W5500_Sim_SetState(W5500_SimSocket_t *sock, uint8_t state, uint8_t event)
+{
+    sock->reg[SIM_Sn_SR] = state;
+    sock->reg[SIM_Sn_IR] |= event;
+}
+
+/**
+ * @brief 主机地址，所有目标IP都转发到peer，端口按MapPort()映射
+ * 
+ * @param sock socket
+ * @param address 输出的主机地址
+ */
+static void W5500_Sim_Destination(W5500_SimSocket_t *sock, struct sockaddr_in *address)
+{
+    memset(address, 0, sizeof(*address));
+    address->sin_family = AF_INET;
+    address->sin_addr = g_w5500_sim.peer;
+    address->sin_port = htons(W5500_Sim_MapPort(W5500_Sim_Get16(&sock->reg[SIM_Sn_DPORT])));
+}
+
+static void W5500_Sim_Open(W5500_SimSocket_t *sock)
+{
+    int option = 1;
+
+    W5500_Sim_CloseHost(sock);
+    W5500_Sim_Set16(&sock->reg[SIM_Sn_TX_RD], 0);
+    W5500_Sim_Set16(&sock->reg[SIM_Sn_TX_WR], 0);
+    W5500_Sim_Set16(&sock->reg[SIM_Sn_RX_RD], 0);
+    W5500_Sim_Set16(&sock->reg[SIM_Sn_RX_WR], 0);
+
+    switch (sock->reg[SIM_Sn_MR] & 0x0F)
+    {
+    case SIM_PROTOCOL_TCP:
+        sock->reg[SIM_Sn_SR] = SIM_SOCK_INIT;                                   // 主机socket在LISTEN或CONNECT时才创建
+        break;
+
+    case SIM_PROTOCOL_UDP:
+        sock->fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, 0);
+        setsockopt(sock->fd, SOL_SOCKET, SO_BROADCAST, &option, sizeof(option));
+        W5500_Sim_Bind(sock->fd, W5500_Sim_Get16(&sock->reg[SIM_Sn_PORT]));     // 绑定失败也能发送，只是收不到
+        sock->reg[SIM_Sn_SR] = SIM_SOCK_UDP;
+        break;
+
+    default:
+        fprintf(stderr, "w5500_sim: Sn_MR protocol 0x%02X not supported\n", sock->reg[SIM_Sn_MR] & 0x0F);
+        sock->reg[SIM_Sn_SR] = SIM_SOCK_CLOSED;
+        break;
+    }
+}
+
+static void W5500_Sim_Listen(W5500_SimSocket_t *sock)
+{
+    if (sock->reg[SIM_Sn_SR] != SIM_SOCK_INIT)
+    {
+        return;
+    }
+
+    sock->listener = W5500_Sim_FindListener(W5500_Sim_Get16(&sock->reg[SIM_Sn_PORT]));
+    if (sock->listener < 0)
+    {
+        W5500_Sim_SetState(sock, SIM_SOCK_CLOSED, SIM_IR_TIMEOUT);
+        return;
+    }
+    sock->reg[SIM_Sn_SR] = SIM_SOCK_LISTEN;
+}
+
+static void W5500_Sim_Connect(W5500_SimSocket_t *sock)
+{
+    struct sockaddr_in address;
+    int option = 1;
+
+    if (sock->reg[SIM_Sn_SR] != SIM_SOCK_INIT)
+    {
+        return;
+    }
+
+    sock->fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    setsockopt(sock->fd, IPPROTO_TCP, TCP_NODELAY, &option, sizeof(option));
+    W5500_Sim_Destination(sock, &address);
+
+    if (connect(sock->fd, (struct sockaddr *)&address, sizeof(address)) == 0)
+    {
+        W5500_Sim_SetState(sock, SIM_SOCK_ESTABLISHED, SIM_IR_CON);
+    }
+    else if (errno == EINPROGRESS)
+    {
+        sock->reg[SIM_Sn_SR] = SIM_SOCK_SYNSENT;
+    }
+    else
+    {
+        W5500_Sim_CloseHost(sock);
+        W5500_Sim_SetState(sock, SIM_SOCK_CLOSED, SIM_IR_TIMEOUT);
+    }
+}
+
+static void W5500_Sim_Disconnect(W5500_SimSocket_t *sock)
+{
+    switch (sock->reg[SIM_Sn_SR])
+    {
+    case SIM_SOCK_ESTABLISHED:
+        shutdown(sock->fd, SHUT_WR);
+        sock->reg[SIM_Sn_SR] = SIM_SOCK_FIN_WAIT;                               // 等对端的FIN，在Poll()里变成CLOSED
+        break;
+
+    case SIM_SOCK_CLOSE_WAIT:                                                   // 对端已经关闭，DISCON中断在收到FIN时已经置位
+    default:
+        W5500_Sim_CloseHost(sock);
+        sock->reg[SIM_Sn_SR] = SIM_SOCK_CLOSED;
+        break;
+    }
+}
+
+/**
+ * @brief 执行SEND命令，把TX_RD到TX_WR之间的数据发给主机socket
+ * 
+ * @param sock socket
+ * 
+ * @note TCP按阻塞方式全部写完，和W5500一样只有数据全部发出才置位SENDOK
+ */
+static void W5500_Sim_Send(W5500_SimSocket_t *sock)
+{
+    uint16_t read_pointer = W5500_Sim_Get16(&sock->reg[SIM_Sn_TX_RD]);
+    uint16_t write_pointer = W5500_Sim_Get16(&sock->reg[SIM_Sn_TX_WR]);
+    uint16_t length = write_pointer - read_pointer;
+    uint16_t mask = W5500_Sim_TxSize(sock) - 1;
+    struct sockaddr_in address;
+    struct pollfd pfd;
+    uint16_t sent = 0;
+    ssize_t result = 0;
+
+    if (length > W5500_Sim_TxSize(sock))
+    {
+        length = W5500_Sim_TxSize(sock);
+    }
+    for (uint16_t i = 0; i < length; i++)
+    {
+        g_w5500_sim_scratch[i] = sock->tx[(uint16_t)(read_pointer + i) & mask];
+    }
+
+    if (sock->reg[SIM_Sn_SR] == SIM_SOCK_UDP)
+    {
+        // 还没有IP地址或者发给自己的IP时ARP不会有回应，DHCP用这个方法检测地址冲突
+        if (W5500_Sim_Get32(&sock->reg[SIM_Sn_DIPR]) != 0xFFFFFFFF &&
+            (W5500_Sim_Get32(&g_w5500_sim.common[SIM_SIPR]) == 0 || memcmp(&sock->reg[SIM_Sn_DIPR], &g_w5500_sim.common[SIM_SIPR], 4) == 0))
+        {
+            sock->reg[SIM_Sn_IR] |= SIM_IR_TIMEOUT;
+            return;
+        }
+        W5500_Sim_Destination(sock, &address);
+        sendto(sock->fd, g_w5500_sim_scratch, length, 0, (struct sockaddr *)&address, sizeof(address));
+    }
+    else if (sock->reg[SIM_Sn_SR] == SIM_SOCK_ESTABLISHED || sock->reg[SIM_Sn_SR] == SIM_SOCK_CLOSE_WAIT)
+    {
+        while (sent < length)
+        {
+            result = send(sock->fd, g_w5500_sim_scratch + sent, length - sent, MSG_NOSIGNAL);
+            if (result > 0)
+            {
+                sent += (uint16_t)result;
+                continue;
+            }
+            if (result < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            {
+                pfd.fd = sock->fd;
+                pfd.events = POLLOUT;
+                if (poll(&pfd, 1, SIM_SEND_TIMEOUT_MS) > 0)
+                {
+                    continue;
+                }
+            }
+
+            // 对端复位或者一直不接收，相当于W5500重传超时
+            W5500_Sim_CloseHost(sock);
+            W5500_Sim_SetState(sock, SIM_SOCK_CLOSED, SIM_IR_TIMEOUT);
+            return;
+        }
+    }
+    else
+    {
+        return;
+    }
+
+    W5500_Sim_Set16(&sock->reg[SIM_Sn_TX_RD], write_pointer);
+    sock->reg[SIM_Sn_IR] |= SIM_IR_SENDOK;
+    g_w5500_sim.stats.tx_payload += length;
+}
+
+static void W5500_Sim_Command(W5500_SimSocket_t *sock, uint8_t command)
+{
+    g_w5500_sim.stats.commands++;
+
+    switch (command)
+    {
+    case SIM_CMD_OPEN:
+        W5500_Sim_Open(sock);
+        break;
+    case SIM_CMD_LISTEN:
+        W5500_Sim_Listen(sock);
+        break;
+    case SIM_CMD_CONNECT:
+        W5500_Sim_Connect(sock);
+        break;
+    case SIM_CMD_DISCON:
+        W5500_Sim_Disconnect(sock);
+        break;
+    case SIM_CMD_CLOSE:
+        W5500_Sim_CloseHost(sock);
+        sock->reg[SIM_Sn_SR] = SIM_SOCK_CLOSED;
+        break;
+    case SIM_CMD_SEND:
+    case SIM_CMD_SEND_MAC:
+        W5500_Sim_Send(sock);
+        break;
+    case SIM_CMD_SEND_KEEP:
+    case SIM_CMD_RECV:                                                          // RX_RD已经由主机写好，RSR按指针差值计算
+    default:
+        break;
+    }
+}
+
+static void W5500_Sim_SocketReset(W5500_SimSocket_t *sock)
+{
+    W5500_Sim_CloseHost(sock);
+    memset(sock->reg, 0, sizeof(sock->reg));
+
+    memset(&sock->reg[SIM_Sn_DHAR], 0xFF, 6);
+    sock->reg[SIM_Sn_TTL] = 0x80;
+    sock->reg[SIM_Sn_RXBUF_SIZE] = 2;
+    sock->reg[SIM_Sn_TXBUF_SIZE] = 2;
+    sock->reg[SIM_Sn_IMR] = 0xFF;
+    W5500_Sim_Set16(&sock->reg[SIM_Sn_FRAG], 0x4000);
+}
+
+/**
+ * @brief 仿真器初始化，读取环境变量W5500_SIM_PEER和W5500_SIM_PORT_OFFSET
+ * 
+ */
+void W5500_Sim_Init(void)
+{
+    const char *peer = getenv("W5500_SIM_PEER");
+    const char *offset = getenv("W5500_SIM_PORT_OFFSET");
+
+    for (uint8_t i = 0; i < W5500_SIM_SOCKET_COUNT; i++)
+    {
+        g_w5500_sim.socket[i].fd = -1;
+        g_w5500_sim.socket[i].listener = -1;
+        g_w5500_sim.listener[i].fd = -1;
+    }
+
+    g_w5500_sim.peer.s_addr = htonl(INADDR_LOOPBACK);
+    if (peer != NULL && inet_aton(peer, &g_w5500_sim.peer) == 0)
+    {
+        fprintf(stderr, "w5500_sim: invalid W5500_SIM_PEER %s\n", peer);
+        g_w5500_sim.peer.s_addr = htonl(INADDR_LOOPBACK);
+    }
+    g_w5500_sim.port_offset = offset != NULL ? (uint16_t)atoi(offset) : W5500_SIM_DEFAULT_PORT_OFFSET;
+
+    W5500_Sim_Reset();
+    W5500_Sim_ClearStats();
+}
+
+/**
+ * @brief 芯片复位，对应RESET引脚拉低或者MR寄存器的RST位
+ * 
+ */
+void W5500_Sim_Reset(void)
+{
+    for (uint8_t i = 0; i < W5500_SIM_SOCKET_COUNT; i++)
+    {
+        W5500_Sim_SocketReset(&g_w5500_sim.socket[i]);
+    }
+
+    memset(g_w5500_sim.common, 0, sizeof(g_w5500_sim.common));
+    W5500_Sim_Set16(&g_w5500_sim.common[SIM_RTR], 0x07D0);
+    g_w5500_sim.common[SIM_RCR] = 0x08;
+    g_w5500_sim.common[SIM_PHYCFGR] = 0xBF;                                     // 100M全双工，链路已连接
+    g_w5500_sim.common[SIM_VERSIONR] = 0x04;
+
+    g_w5500_sim.header_length = 0;
+}
+
+static uint8_t W5500_Sim_SocketInterrupt(void)
+{
+    uint8_t sir = 0;
+
+    for (uint8_t i = 0; i < W5500_SIM_SOCKET_COUNT; i++)
+    {
+        if (g_w5500_sim.socket[i].reg[SIM_Sn_IR] & g_w5500_sim.socket[i].reg[SIM_Sn_IMR])
+        {
+            sir |= (1 << i);
+        }
+    }
+    return sir;
+}
+
+static uint8_t W5500_Sim_ReadByte(uint8_t block, uint16_t address)
+{
+    W5500_SimSocket_t *sock = NULL;
+    uint16_t size = 0;
+
+    if (block == 0)
+    {
+        if (address == SIM_SIR)
+        {
+            return W5500_Sim_SocketInterrupt();
+        }
+        return address < SIM_COMMON_SIZE ? g_w5500_sim.common[address] : 0;
+    }
+
+    if ((block >> 2) >= W5500_SIM_SOCKET_COUNT)
+    {
+        return 0;
+    }
+    sock = &g_w5500_sim.socket[block >> 2];
+
+    switch (block & 0x03)
+    {
+    case 1:
+        if (address >= SIM_SOCKET_REG_SIZE || address == SIM_Sn_CR)
+        {
+            return 0;                                                           // 命令立即执行，读回来总是0
+        }
+        if (address == SIM_Sn_TX_FSR || address == SIM_Sn_TX_FSR + 1)
+        {
+            return address == SIM_Sn_TX_FSR ? W5500_Sim_TxFree(sock) >> 8 : W5500_Sim_TxFree(sock) & 0xFF;
+        }
+        if (address == SIM_Sn_RX_RSR || address == SIM_Sn_RX_RSR + 1)
+        {
+            return address == SIM_Sn_RX_RSR ? W5500_Sim_RxUsed(sock) >> 8 : W5500_Sim_RxUsed(sock) & 0xFF;
+        }
+        return sock->reg[address];
+
+    case 2:
+        size = W5500_Sim_TxSize(sock);
+        return size ? sock->tx[address & (size - 1)] : 0;
+
+    case 3:
+        size = W5500_Sim_RxSize(sock);
+        return size ? sock->rx[address & (size - 1)] : 0;
+
+    default:
+        return 0;
+    }
+}
+
+static void W5500_Sim_WriteByte(uint8_t block, uint16_t address, uint8_t value)
+{
+    W5500_SimSocket_t *sock = NULL;
+    uint16_t size = 0;
+
+    if (block == 0)
+    {
+        switch (address)
+        {
+        case SIM_MR:
+            if (value & 0x80)
+            {
+                W5500_Sim_Reset();
+                return;
+            }
+            g_w5500_sim.common[SIM_MR] = value;
+            break;
+        case SIM_IR:
+            g_w5500_sim.common[SIM_IR] &= ~value;                               // 写1清零
+            break;
+        case SIM_SIR:
+        case SIM_VERSIONR:
+            break;
+        case SIM_PHYCFGR:
+            g_w5500_sim.common[SIM_PHYCFGR] = 0x80 | (value & 0x78) | 0x07;     // PHY复位立即完成，链路一直是连接的
+            break;
+        default:
+            if (address < SIM_COMMON_SIZE)
+            {
+                g_w5500_sim.common[address] = value;
+            }
+            break;
+        }
+        return;
+    }
+
+    if ((block >> 2) >= W5500_SIM_SOCKET_COUNT)
+    {
+        return;
+    }
+    sock = &g_w5500_sim.socket[block >> 2];
+
+    switch (block & 0x03)
+    {
+    case 1:
+        switch (address)
+        {
+        case SIM_Sn_CR:
+            W5500_Sim_Command(sock, value);
+            break;
+        case SIM_Sn_IR:
+            sock->reg[SIM_Sn_IR] &= ~value;                                     // 写1清零
+            break;
+        case SIM_Sn_SR:
+        case SIM_Sn_TX_FSR:
+        case SIM_Sn_TX_FSR + 1:
+        case SIM_Sn_TX_RD:
+        case SIM_Sn_TX_RD + 1:
+        case SIM_Sn_RX_RSR:
+        case SIM_Sn_RX_RSR + 1:
+        case SIM_Sn_RX_WR:
+        case SIM_Sn_RX_WR + 1:
+            break;                                                              // 只读寄存器
+        default:
+            if (address < SIM_SOCKET_REG_SIZE)
+            {
+                sock->reg[address] = value;
+            }
+            break;
+        }
+        break;
+
+    case 2:
+        size = W5500_Sim_TxSize(sock);
+        if (size)
+        {
+            sock->tx[address & (size - 1)] = value;
+        }
+        break;
+
+    case 3:
+        size = W5500_Sim_RxSize(sock);
+        if (size)
+        {
+            sock->rx[address & (size - 1)] = value;
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief 片选有效，开始一个新的SPI帧
+ * 
+ * @note 每个帧开始前检查一次主机socket，芯片状态在帧内部保持不变
+ */
+void W5500_Sim_Select(void)
+{
+    W5500_Sim_Poll();
+
+    g_w5500_sim.selected = 1;
+    g_w5500_sim.header_length = 0;
+    g_w5500_sim.stats.spi_frames++;
+}
+
+void W5500_Sim_Deselect(void)
+{
+    g_w5500_sim.selected = 0;
+}
+
+/**
+ * @brief SPI全双工传输
+ * 
+ * @param tx_data MOSI上的数据，为NULL时发送0
+ * @param rx_data 保存MISO上的数据，为NULL时丢弃
+ * @param length 字节数
+ * 
+ * @note 帧格式：地址高字节、地址低字节、控制字节(BSB[7:3] RWB[2] OM[1:0])，之后是数据，地址每个字节自增
+ */
+void W5500_Sim_Transfer(const uint8_t *tx_data, uint8_t *rx_data, uint16_t length)
+{
+    uint8_t mosi = 0;
+    uint8_t miso = 0;
+    uint8_t control = 0;
+
+    g_w5500_sim.stats.spi_bytes += length;
+
+    for (uint16_t i = 0; i < length; i++)
+    {
+        mosi = tx_data != NULL ? tx_data[i] : 0;
+        miso = 0;
+
+        if (!g_w5500_sim.selected)
+        {
+            miso = 0xFF;
+        }
+        else if (g_w5500_sim.header_length < 3)
+        {
+            g_w5500_sim.header[g_w5500_sim.header_length++] = mosi;
+            g_w5500_sim.address = (uint16_t)((g_w5500_sim.header[0] << 8) | g_w5500_sim.header[1]);
+        }
+        else
+        {
+            control = g_w5500_sim.header[2];
+            if (control & 0x04)
+            {
+                W5500_Sim_WriteByte(control >> 3, g_w5500_sim.address, mosi);
+            }
+            else
+            {
+                miso = W5500_Sim_ReadByte(control >> 3, g_w5500_sim.address);
+            }
+            g_w5500_sim.address++;
+        }
+
+        if (rx_data != NULL)
+        {
+            rx_data[i] = miso;
+        }
+    }
+}
+
+/**
+ * @brief TCP连接上的数据和FIN
+ * 
+ * @param sock socket
+ */
+static void W5500_Sim_PollStream(W5500_SimSocket_t *sock)
+{
+    uint16_t space = W5500_Sim_RxFree(sock);
+    ssize_t length = recv(sock->fd, g_w5500_sim_scratch, space, 0);
+
+    if (length > 0)
+    {
+        W5500_Sim_RxWrite(sock, g_w5500_sim_scratch, (uint16_t)length);
+        sock->reg[SIM_Sn_IR] |= SIM_IR_RECV;
+        g_w5500_sim.stats.rx_payload += (uint64_t)length;
+    }
+    else if (length == 0)
+    {
+        if (sock->reg[SIM_Sn_SR] == SIM_SOCK_FIN_WAIT)
+        {
+            W5500_Sim_CloseHost(sock);
+            W5500_Sim_SetState(sock, SIM_SOCK_CLOSED, SIM_IR_DISCON);
+        }
+        else
+        {
+            W5500_Sim_SetState(sock, SIM_SOCK_CLOSE_WAIT, SIM_IR_DISCON);       // 对端关闭，本地还可以发送
+        }
+    }
+    else if (errno != EAGAIN && errno != EWOULDBLOCK)
+    {
+        W5500_Sim_CloseHost(sock);
+        W5500_Sim_SetState(sock, SIM_SOCK_CLOSED, SIM_IR_DISCON);               // 收到RST
+    }
+}
+
+/**
+ * @brief UDP数据报，RX缓冲区里每个数据报前面加8字节的头
+ * 
+ * @param sock socket
+ */
+static void W5500_Sim_PollDatagram(W5500_SimSocket_t *sock)
+{
+    struct sockaddr_in address;
+    socklen_t address_length = sizeof(address);
+    uint8_t header[SIM_UDP_HEADER_SIZE];
+    ssize_t length = 0;
+
+    while (1)
+    {
+        length = recv(sock->fd, NULL, 0, MSG_PEEK | MSG_TRUNC);
+        if (length < 0)
+        {
+            return;
+        }
+
+        if (length + SIM_UDP_HEADER_SIZE > W5500_Sim_RxSize(sock))
+        {
+            recv(sock->fd, NULL, 0, 0);                                         // 比整个RX缓冲区还大，W5500也会丢掉
+            continue;
+        }
+        if (length + SIM_UDP_HEADER_SIZE > W5500_Sim_RxFree(sock))
+        {
+            return;                                                             // 等主机读走数据
+        }
+
+        length = recvfrom(sock->fd, g_w5500_sim_scratch, sizeof(g_w5500_sim_scratch), 0, (struct sockaddr *)&address, &address_length);
+        if (length < 0)
+        {
+            return;
+        }
+
+        memcpy(header, &address.sin_addr.s_addr, 4);
+        W5500_Sim_Set16(&header[4], W5500_Sim_UnmapPort(ntohs(address.sin_port)));
+        W5500_Sim_Set16(&header[6], (uint16_t)length);
+        W5500_Sim_RxWrite(sock, header, SIM_UDP_HEADER_SIZE);
+        W5500_Sim_RxWrite(sock, g_w5500_sim_scratch, (uint16_t)length);
+
+        sock->reg[SIM_Sn_IR] |= SIM_IR_RECV;
+        g_w5500_sim.stats.rx_payload += (uint64_t)length;
+    }
+}
+
+/**
+ * @brief 监听器上有新连接，交给第一个处于LISTEN状态的socket
+ * 
+ * @param index 监听器索引
+ */
+static void W5500_Sim_Accept(int8_t index)
+{
+    W5500_SimListener_t *listener = &g_w5500_sim.listener[index];
+    W5500_SimSocket_t *sock = NULL;
+    struct sockaddr_in address;
+    socklen_t address_length = sizeof(address);
+    int option = 1;
+    int fd = -1;
+
+    for (uint8_t i = 0; i < W5500_SIM_SOCKET_COUNT; i++)
+    {
+        if (g_w5500_sim.socket[i].listener == index && g_w5500_sim.socket[i].reg[SIM_Sn_SR] == SIM_SOCK_LISTEN)
+        {
+            sock = &g_w5500_sim.socket[i];
+            break;
+        }
+    }
+
+    fd = accept4(listener->fd, (struct sockaddr *)&address, &address_length, SOCK_NONBLOCK);
+    if (sock == NULL || fd < 0)
+    {
+        return;
+    }
+
+    // 和W5500一样，一个socket只接受一个连接，建立之后就不再监听
+    W5500_Sim_Unlisten(sock);
+    sock->fd = fd;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &option, sizeof(option));
+
+    memcpy(&sock->reg[SIM_Sn_DIPR], &address.sin_addr.s_addr, 4);
+    W5500_Sim_Set16(&sock->reg[SIM_Sn_DPORT], W5500_Sim_UnmapPort(ntohs(address.sin_port)));
+    W5500_Sim_SetState(sock, SIM_SOCK_ESTABLISHED, SIM_IR_CON);
+}
+
+static void W5500_Sim_Connected(W5500_SimSocket_t *sock)
+{
+    int error = 0;
+    socklen_t length = sizeof(error);
+
+    getsockopt(sock->fd, SOL_SOCKET, SO_ERROR, &error, &length);
+    if (error == 0)
+    {
+        W5500_Sim_SetState(sock, SIM_SOCK_ESTABLISHED, SIM_IR_CON);
+    }
+    else
+    {
+        W5500_Sim_CloseHost(sock);
+        W5500_Sim_SetState(sock, SIM_SOCK_CLOSED, SIM_IR_TIMEOUT);
+    }
+}
+
+/**
+ * @brief 检查主机socket，更新socket状态、RX缓冲区和中断标志
+ * 
+ * @note 不会阻塞，每个SPI帧开始和读取INT引脚时调用
+ */
+void W5500_Sim_Poll(void)
+{
+    struct pollfd pfd[W5500_SIM_SOCKET_COUNT * 2];
+    int8_t index[W5500_SIM_SOCKET_COUNT * 2];                                   // 非负数是socket索引，负数是-1-监听器索引
+    W5500_SimSocket_t *sock = NULL;
+    nfds_t count = 0;
+
+    for (int8_t i = 0; i < W5500_SIM_SOCKET_COUNT; i++)
+    {
+        if (g_w5500_sim.listener[i].users == 0)
+        {
+            continue;
+        }
+        pfd[count].fd = g_w5500_sim.listener[i].fd;
+        pfd[count].events = POLLIN;
+        pfd[count].revents = 0;
+        index[count++] = -1 - i;
+    }
+
+    for (int8_t i = 0; i < W5500_SIM_SOCKET_COUNT; i++)
+    {
+        sock = &g_w5500_sim.socket[i];
+        pfd[count].revents = 0;
+
+        switch (sock->reg[SIM_Sn_SR])
+        {
+        case SIM_SOCK_SYNSENT:
+            pfd[count].fd = sock->fd;
+            pfd[count].events = POLLOUT;
+            break;
+        case SIM_SOCK_ESTABLISHED:
+        case SIM_SOCK_FIN_WAIT:
+            if (W5500_Sim_RxFree(sock) == 0)
+            {
+                continue;                                                       // RX缓冲区满，对端由TCP窗口限速
+            }
+            pfd[count].fd = sock->fd;
+            pfd[count].events = POLLIN;
+            break;
+        case SIM_SOCK_UDP:
+            if (sock->fd < 0 || W5500_Sim_RxFree(sock) <= SIM_UDP_HEADER_SIZE)
+            {
+                continue;
+            }
+            pfd[count].fd = sock->fd;
+            pfd[count].events = POLLIN;
+            break;
+        default:
+            continue;
+        }
+        index[count++] = i;
+    }
+
+    if (count == 0)
+    {
+        return;
+    }
+
+    g_w5500_sim.stats.polls++;
+    if (poll(pfd, count, 0) <= 0)
+    {
+        return;
+    }
+
+    for (nfds_t i = 0; i < count; i++)
+    {
+        if (pfd[i].revents == 0)
+        {
+            continue;
+        }
+
+        if (index[i] < 0)
+        {
+            W5500_Sim_Accept(-1 - index[i]);
+            continue;
+        }
+
+        sock = &g_w5500_sim.socket[index[i]];
+        switch (sock->reg[SIM_Sn_SR])
+        {
+        case SIM_SOCK_SYNSENT:
+            W5500_Sim_Connected(sock);
+            break;
+        case SIM_SOCK_ESTABLISHED:
+        case SIM_SOCK_FIN_WAIT:
+            W5500_Sim_PollStream(sock);
+            break;
+        case SIM_SOCK_UDP:
+            W5500_Sim_PollDatagram(sock);
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+/**
+ * @brief INT引脚电平，低电平有效
+ * 
+ * @return uint8_t 0: 有中断; 1: 没有中断
+ */
+uint8_t W5500_Sim_GetInterruptPin(void)
+{
+    W5500_Sim_Poll();
+
+    if ((g_w5500_sim.common[SIM_IR] & g_w5500_sim.common[SIM_IMR] & 0xF0) ||
+        (W5500_Sim_SocketInterrupt() & g_w5500_sim.common[SIM_SIMR]))
+    {
+        return 0;
+    }
+    return 1;
+}
+
+void W5500_Sim_GetStats(W5500_SimStats_t *stats)
+{
+    *stats = g_w5500_sim.stats;
+}
+
+void W5500_Sim_ClearStats(void)
+{
+    memset(&g_w5500_sim.stats, 0, sizeof(g_w5500_sim.stats));
+}
\ No newline at end of file
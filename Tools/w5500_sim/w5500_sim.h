@@ -0,0 +1,34 @@
+#ifndef __W5500_SIM_H__
+#define __W5500_SIM_H__
+
+#include <stdint.h>
+
+#define W5500_SIM_SOCKET_COUNT          8
+#define W5500_SIM_BUFFER_SIZE           16384                                   // 每个socket都按16KB分配，按Sn_TXBUF_SIZE/Sn_RXBUF_SIZE掩码回绕
+
+#define W5500_SIM_DEFAULT_PORT_OFFSET   10000                                   // 1024以下的端口加上这个偏移再映射到主机，不需要root权限
+
+typedef struct W5500_SimStats_t
+{
+    uint64_t spi_frames;                                                        // 片选次数，每次片选是一个SPI帧
+    uint64_t spi_bytes;                                                         // SPI总线上传输的字节数，包括3字节的帧头
+    uint64_t tx_payload;                                                        // SEND命令发到主机socket的字节数
+    uint64_t rx_payload;                                                        // 从主机socket收到并写入RX缓冲区的字节数
+    uint64_t commands;                                                          // 执行的Sn_CR命令个数
+    uint64_t polls;                                                             // 检查主机socket的次数
+} W5500_SimStats_t;
+
+void W5500_Sim_Init(void);
+void W5500_Sim_Reset(void);
+
+void W5500_Sim_Select(void);
+void W5500_Sim_Deselect(void);
+void W5500_Sim_Transfer(const uint8_t *tx_data, uint8_t *rx_data, uint16_t length);
+
+void W5500_Sim_Poll(void);
+uint8_t W5500_Sim_GetInterruptPin(void);
+
+void W5500_Sim_GetStats(W5500_SimStats_t *stats);
+void W5500_Sim_ClearStats(void);
+
+#endif // !__W5500_SIM_H__
\ No newline at end of file
@@ -0,0 +1,193 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+把网页目录打包成httpServer的只读镜像（格式见Internet/httpServer/httpRomfs.h）
+
+镜像的内容：
+    索引                按文件名排序，httpServer用二分查找，不用逐个注册
+    响应头              Content-Type、Content-Length、ETag等在生成时写好，只有Connection在运行时追加
+    原始内容            客户端不接受gzip时发送
+    gzip压缩后的内容    请求带Accept-Encoding: gzip时发送，压缩后不能变小的文件不生成
+ETag是内容的SHA-1前16位，gzip版本是另一种表示，在后面加上"-gz"（HTTP_GZIP_ETAG_SUFFIX）区分，
+请求的If-None-Match相同时回复304。
+
+压缩时mtime固定为0，同样的输入总是生成同样的输出，生成的文件可以直接提交。
+
+用法：
+    python3 web_assets.py www -o ../../Driver/Device/w5500/w5500_web_assets.c      镜像放在内部FLASH
+    python3 web_assets.py www -b www.rom --align 256                              镜像写到W25Q，
+                                                                                  见W5500_WebServer_InstallRomfs()
+"""
+
+import argparse
+import gzip
+import hashlib
+import os
+import struct
+import sys
+import zlib
+
+ROMFS_MAGIC = 0x53465257                                                        # "WRFS"
+ROMFS_VERSION = 1
+HEADER_FORMAT = "<IHHII"                                                        # st_http_romfs_header
+ENTRY_FORMAT = "<IIIHHIIIIBBH"                                                  # st_http_romfs_entry
+MAX_NAME_LEN = 127                                                              # MAX_CONTENT_NAME_LEN - 1
+GZIP_ETAG_SUFFIX = "-gz"                                                        # HTTP_GZIP_ETAG_SUFFIX
+
+# 和httpParser.c的http_uri_types[]、make_http_response_head()一致，其它扩展名按二进制发送
+MIME_TYPES = {
+    "htm": "text/html", "html": "text/html", "gif": "image/gif", "text": "text/plain", "txt": "text/plain",
+    "log": "text/plain", "csv": "text/plain", "jpeg": "image/jpeg", "jpg": "image/jpeg",
+    "swf": "application/x-shockwave-flash", "json": "application/json", "js": "application/javascript",
+    "xml": "text/xml", "css": "text/css", "png": "image/png", "ico": "image/x-icon",
+    "ttf": "application/x-font-truetype", "otf": "application/x-font-opentype", "woff": "application/font-woff",
+    "eot": "application/vnd.ms-fontobject", "svg": "image/svg+xml",
+}
+
+HEADER = """\
+/**
+ * 由Tools/web_assets/web_assets.py根据{source}生成，不要手动修改
+ * 
+{summary}
+ */
+
+#include "w5500_web_assets.h"
+"""
+
+
+def collect(root):
+    """路径用'/'分隔，和请求的URI相同（不带开头的'/'），按UTF-8字节排序，和strcmp()的顺序相同"""
+    assets = []
+    for directory, _, files in os.walk(root):
+        for file_name in files:
+            path = os.path.join(directory, file_name)
+            assets.append((os.path.relpath(path, root).replace(os.sep, "/").encode("utf-8"), path))
+    return sorted(assets)
+
+
+def mime_type(name):
+    extension = name.rsplit(b"/", 1)[-1].rpartition(b".")[2].decode("utf-8", "replace").lower()
+    return MIME_TYPES.get(extension, "application/octet-stream")
+
+
+def response_head(name, length, etag, gzip_encoded):
+    head = "HTTP/1.1 200 OK\r\nContent-Type: %s\r\nContent-Length: %d\r\n" % (mime_type(name), length)
+    head += "ETag: %s\r\nCache-Control: no-cache\r\nVary: Accept-Encoding\r\n" % etag
+    if gzip_encoded:
+        head += "Content-Encoding: gzip\r\n"
+    return head.encode("ascii")
+
+
+def gzip_etag(etag):
+    """和httpServer.c的make_http_gzip_etag()一致"""
+    return etag[:-1] + GZIP_ETAG_SUFFIX + '"'
+
+
+def align_up(value, align):
+    return (value + align - 1) // align * align
+
+
+def build(assets, align, use_gzip):
+    """返回镜像和每个文件的(名字, 原始大小, 发送大小, ETag)"""
+    files = []
+    for name, path in assets:
+        if len(name) > MAX_NAME_LEN:
+            sys.exit("文件名太长: %s" % name.decode("utf-8"))
+        with open(path, "rb") as f:
+            raw = f.read()
+        compressed = gzip.compress(raw, compresslevel=9, mtime=0) if use_gzip else None
+        if compressed is not None and len(compressed) >= len(raw):
+            compressed = None
+        etag = '"%s"' % hashlib.sha1(raw).hexdigest()[:16]
+        files.append((name, raw, compressed, etag))
+
+    # 头、索引、字符串区（文件名、ETag、响应头），然后是按align对齐的内容
+    strings = bytearray()
+    string_offsets = []
+    strings_start = struct.calcsize(HEADER_FORMAT) + len(files) * struct.calcsize(ENTRY_FORMAT)
+    for name, raw, compressed, etag in files:
+        name_offset = strings_start + len(strings)
+        strings += name + b"\0"
+        etag_offset = strings_start + len(strings)
+        strings += etag.encode("ascii") + b"\0"
+        head = response_head(name, len(raw), etag, False)
+        gzip_head = response_head(name, len(compressed), gzip_etag(etag), True) if compressed is not None else b""
+        head_offset = strings_start + len(strings)
+        strings += head + gzip_head
+        string_offsets.append((name_offset, etag_offset, head_offset, len(head), len(gzip_head)))
+
+    data = bytearray()
+    data_start = align_up(strings_start + len(strings), align)
+    data_offsets = []
+    for name, raw, compressed, etag in files:
+        offsets = []
+        for blob in (raw, compressed):
+            if blob is None:
+                offsets.append(0)
+                continue
+            data += bytes(align_up(data_start + len(data), align) - data_start - len(data))
+            offsets.append(data_start + len(data))
+            data += blob
+        data_offsets.append(offsets)
+
+    entries = bytearray()
+    for (name, raw, compressed, etag), strings_entry, offsets in zip(files, string_offsets, data_offsets):
+        name_offset, etag_offset, head_offset, head_len, gzip_head_len = strings_entry
+        entries += struct.pack(ENTRY_FORMAT, name_offset, etag_offset, head_offset, head_len, gzip_head_len,
+                               offsets[0], len(raw), offsets[1], len(compressed) if compressed is not None else 0,
+                               len(name), len(etag), 0)
+
+    body = entries + strings + bytes(data_start - strings_start - len(strings)) + data
+    size = struct.calcsize(HEADER_FORMAT) + len(body)
+    image = struct.pack(HEADER_FORMAT, ROMFS_MAGIC, ROMFS_VERSION, len(files), size, zlib.crc32(body)) + body
+
+    summary = [(name.decode("utf-8"), len(raw), len(compressed) if compressed is not None else len(raw), etag)
+               for name, raw, compressed, etag in files]
+    return image, summary
+
+
+def c_source(image, source, summary_lines):
+    lines = [HEADER.format(source=source, summary="\n".join(summary_lines))]
+    lines.append("const uint8_t g_w5500_web_romfs[%d] __attribute__((aligned(4))) = {" % len(image))
+    for i in range(0, len(image), 16):
+        lines.append("    " + ", ".join("0x%02x" % b for b in image[i:i + 16]) + ",")
+    lines.append("};\n")
+    lines.append("const uint32_t g_w5500_web_romfs_size = sizeof(g_w5500_web_romfs);")
+    return "\n".join(lines)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="生成网页资源的只读镜像")
+    parser.add_argument("source", help="网页目录")
+    parser.add_argument("-o", "--output", help="生成的C源文件，镜像编译进内部FLASH")
+    parser.add_argument("-b", "--binary", help="生成的镜像文件，写到W25Q")
+    parser.add_argument("--align", type=int, default=4, help="内容的对齐字节数，2的幂，不小于4，默认4")
+    parser.add_argument("--no-gzip", action="store_true", help="不生成gzip压缩的版本")
+    args = parser.parse_args()
+
+    if not args.output and not args.binary:
+        parser.error("至少指定-o或-b")
+    if args.align < 4 or args.align & (args.align - 1):
+        parser.error("--align必须是不小于4的2的幂")
+
+    image, summary = build(collect(args.source), args.align, not args.no_gzip)
+
+    total_raw = sum(s[1] for s in summary)
+    total_sent = sum(s[2] for s in summary)
+    summary_lines = [" * %-24s %7d -> %7d 字节  ETag %s" % s for s in summary]
+    summary_lines.append(" * %-22s %7d -> %7d 字节" % ("合计", total_raw, total_sent))
+    summary_lines.append(" * %-22s %7d 字节，内容按%d字节对齐" % ("镜像", len(image), args.align))
+
+    if args.output:
+        source = os.path.basename(os.path.normpath(args.source)) + "/"
+        with open(args.output, "w", encoding="utf-8", newline="\n") as f:
+            f.write(c_source(image, source, summary_lines))
+    if args.binary:
+        with open(args.binary, "wb") as f:
+            f.write(image)
+
+    print("%d个文件，%d字节，gzip后%d字节，镜像%d字节" % (len(summary), total_raw, total_sent, len(image)))
+
+
+if __name__ == "__main__":
+    main()
\ No newline at end of file